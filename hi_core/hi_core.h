@@ -196,6 +196,22 @@ If this is set to 1, the application will crash instantly if there is a drop out
 #define ENABLE_SCRIPTING_BREAKPOINTS 0
 #endif
 
+/** Config: HISE_USE_SCRIPT_BYTECODE
+
+If enabled, the callbacks of a script processor will be compiled to a register based bytecode that is executed instead of the statement tree.
+*/
+#ifndef HISE_USE_SCRIPT_BYTECODE
+#define HISE_USE_SCRIPT_BYTECODE 1
+#endif
+
+/** Config: HISE_USE_PRELOAD_CACHE
+
+If enabled, the preload buffers of every sample map will be stored in a cache file and loaded from there the next time the sample map is loaded (see PreloadCache).
+*/
+#ifndef HISE_USE_PRELOAD_CACHE
+#define HISE_USE_PRELOAD_CACHE 0
+#endif
+
 /** Config: ENABLE_ALL_PEAK_METERS
 
 Set this to 0 to deactivate peak collection for any other processor than the main synth chain
@@ -239,6 +255,14 @@ Set this to 0 to deactivate the CPU peak meter.
 #define ENABLE_CPU_MEASUREMENT 1
 #endif
 
+/** Config: HISE_NUM_AUDIO_WORKER_THREADS
+
+Set this to a value greater than 0 to render independent child synths of the main container on this amount of additional high priority threads.
+*/
+#ifndef HISE_NUM_AUDIO_WORKER_THREADS
+#define HISE_NUM_AUDIO_WORKER_THREADS 0
+#endif
+
 
 #ifndef ENABLE_APPLE_SANDBOX
 #define ENABLE_APPLE_SANDBOX 0
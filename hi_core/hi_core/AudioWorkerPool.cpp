@@ -0,0 +1,155 @@
+/*  ===========================================================================
+*
+*   This file is part of HISE.
+*   Copyright 2016 Christoph Hart
+*
+*   HISE is free software: you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation, either version 3 of the License, or
+*   (at your option) any later version.
+*
+*   HISE is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with HISE.  If not, see <http://www.gnu.org/licenses/>.
+*
+*   Commercial licenses for using HISE in an closed source project are
+*   available on request. Please visit the project's website to get more
+*   information about commercial licensing:
+*
+*   http://www.hise.audio/
+*
+*   HISE is based on the JUCE library,
+*   which must be separately licensed for closed source applications:
+*
+*   http://www.juce.com
+*
+*   ===========================================================================
+*/
+
+
+namespace hise { using namespace juce;
+
+class AudioWorkerPool::Worker : public Thread
+{
+public:
+
+	Worker(AudioWorkerPool& parent_, int index) :
+		Thread("Audio Worker " + String(index + 1)),
+		parent(parent_)
+	{}
+
+	void run() override
+	{
+		// The parts are rendered with the same floating point settings as the audio thread
+		ScopedNoDenormals snd;
+
+		while (!threadShouldExit())
+		{
+			wakeUpEvent.wait(500);
+
+			while (parent.renderNextPart())
+				;
+		}
+	}
+
+	WaitableEvent wakeUpEvent;
+
+private:
+
+	AudioWorkerPool& parent;
+};
+
+AudioWorkerPool::AudioWorkerPool(int numWorkersToUse) :
+	partState(0),
+	currentJob(nullptr),
+	numRenderedParts(0),
+	busy(false)
+{
+	for (int i = 0; i < numWorkersToUse; i++)
+	{
+		auto w = new Worker(*this, i);
+		workers.add(w);
+		w->startThread(9);
+	}
+}
+
+AudioWorkerPool::~AudioWorkerPool()
+{
+	for (auto w : workers)
+	{
+		w->signalThreadShouldExit();
+		w->wakeUpEvent.signal();
+	}
+
+	for (auto w : workers)
+		w->stopThread(1000);
+
+	workers.clear();
+}
+
+bool AudioWorkerPool::renderParallel(Job& job, int numParts)
+{
+	if (numParts <= 0)
+		return true;
+
+	bool expected = false;
+
+	if (!busy.compare_exchange_strong(expected, true))
+		return false;
+
+	currentJob.store(&job);
+	numRenderedParts.store(0);
+	partState.store((uint64)numParts << 32);
+
+	const int numWorkersToWake = jmin(workers.size(), numParts - 1);
+
+	for (int i = 0; i < numWorkersToWake; i++)
+		workers[i]->wakeUpEvent.signal();
+
+	while (renderNextPart())
+		;
+
+	// Wait for the parts that are still rendered by the workers
+	while (numRenderedParts.load() < numParts)
+		Thread::yield();
+
+	busy.store(false);
+
+	return true;
+}
+
+void* AudioWorkerPool::getWorkerThreadId(int workerIndex) const
+{
+	if (auto w = workers[workerIndex])
+		return w->getThreadId();
+
+	return nullptr;
+}
+
+bool AudioWorkerPool::renderNextPart()
+{
+	auto state = partState.load();
+
+	for (;;)
+	{
+		const int numParts = (int)(state >> 32);
+		const int partIndex = (int)(state & 0xFFFFFFFF);
+
+		if (partIndex >= numParts)
+			return false;
+
+		if (partState.compare_exchange_weak(state, state + 1))
+		{
+			// A new job can't be started before this part is rendered, so this is the job the part belongs to.
+			currentJob.load()->renderPart(partIndex);
+			numRenderedParts.fetch_add(1);
+			return true;
+		}
+	}
+}
+
+} // namespace hise
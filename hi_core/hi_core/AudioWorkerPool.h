@@ -0,0 +1,104 @@
+/*  ===========================================================================
+*
+*   This file is part of HISE.
+*   Copyright 2016 Christoph Hart
+*
+*   HISE is free software: you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation, either version 3 of the License, or
+*   (at your option) any later version.
+*
+*   HISE is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with HISE.  If not, see <http://www.gnu.org/licenses/>.
+*
+*   Commercial licenses for using HISE in an closed source project are
+*   available on request. Please visit the project's website to get more
+*   information about commercial licensing:
+*
+*   http://www.hise.audio/
+*
+*   HISE is based on the JUCE library,
+*   which must be separately licensed for closed source applications:
+*
+*   http://www.juce.com
+*
+*   ===========================================================================
+*/
+
+
+#ifndef AUDIOWORKERPOOL_H_INCLUDED
+#define AUDIOWORKERPOOL_H_INCLUDED
+
+namespace hise { using namespace juce;
+
+/** A pool of high priority threads that help the audio thread with rendering independent parts of the signal.
+*
+*	The audio thread passes a job with a number of parts to renderParallel(). The workers are woken up and
+*	render the parts together with the audio thread, which returns as soon as every part is rendered.
+*
+*	The parts are claimed with a single atomic counter, so the pool doesn't lock or allocate anything in the
+*	audio callback. Any part can be rendered by any thread, so the job must not depend on the order of the parts.
+*/
+class AudioWorkerPool
+{
+public:
+
+	/** A job that consists of independent parts. */
+	class Job
+	{
+	public:
+
+		virtual ~Job() {};
+
+		/** Renders the part with the given index. This is called either from the audio thread or from one of the workers. */
+		virtual void renderPart(int partIndex) = 0;
+	};
+
+	/** Creates a pool and starts the given amount of worker threads. */
+	AudioWorkerPool(int numWorkersToUse);
+
+	~AudioWorkerPool();
+
+	/** Renders all parts of the job and returns when they are done. 
+	*
+	*	The calling thread renders parts too, so this also works if the workers are not scheduled in time. If the pool is
+	*	already busy (eg. if this is called from within another job), it returns false and you have to render the parts yourself.
+	*/
+	bool renderParallel(Job& job, int numParts);
+
+	/** Returns true while a job is rendered. A nested job should be rendered serially then. */
+	bool isBusy() const noexcept { return busy.load(); }
+
+	/** Returns the number of worker threads (without the audio thread). */
+	int getNumWorkers() const noexcept { return workers.size(); }
+
+	/** Returns the thread id of the worker. It will be nullptr until the thread has started. */
+	void* getWorkerThreadId(int workerIndex) const;
+
+private:
+
+	class Worker;
+
+	/** Claims the next part of the current job and renders it. Returns false if all parts are claimed. */
+	bool renderNextPart();
+
+	// The upper 32 bit contain the number of parts, the lower 32 bit the index of the next part.
+	std::atomic<uint64> partState;
+
+	std::atomic<Job*> currentJob;
+	std::atomic<int> numRenderedParts;
+	std::atomic<bool> busy;
+
+	OwnedArray<Worker> workers;
+
+	JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(AudioWorkerPool);
+};
+
+} // namespace hise
+
+#endif  // AUDIOWORKERPOOL_H_INCLUDED
@@ -303,16 +303,128 @@ struct DebugLogger::Failure : public DebugLogger::Message
 };
 
 
+DebugLogger::TraceBuffer::TraceBuffer() :
+	owner(nullptr),
+	numActiveWrites(0),
+	numWrites(0),
+	writeIndex(0),
+	readIndex(0)
+{
+
+}
+
+void DebugLogger::TraceBuffer::allocate()
+{
+	if (records == nullptr)
+		records.calloc(NumRecords);
+}
+
+bool DebugLogger::TraceBuffer::push(const TraceRecord& r) noexcept
+{
+	jassert(records != nullptr);
+
+	const uint32 w = writeIndex.load(std::memory_order_relaxed);
+
+	if (w - readIndex.load(std::memory_order_acquire) >= (uint32)NumRecords)
+		return false;
+
+	records[w & (NumRecords - 1)] = r;
+	writeIndex.store(w + 1, std::memory_order_release);
+
+	return true;
+}
+
+bool DebugLogger::TraceBuffer::pop(TraceRecord& r) noexcept
+{
+	const uint32 readPos = readIndex.load(std::memory_order_relaxed);
+
+	if (readPos == writeIndex.load(std::memory_order_acquire))
+		return false;
+
+	r = records[readPos & (NumRecords - 1)];
+	readIndex.store(readPos + 1, std::memory_order_release);
+
+	return true;
+}
+
+bool DebugLogger::TraceBuffer::claim(void* threadId) noexcept
+{
+	void* expected = nullptr;
+	return owner.compare_exchange_strong(expected, threadId);
+}
+
+bool DebugLogger::TraceBuffer::beginWrite(void* threadId) noexcept
+{
+	// The counter is raised before the owner is checked, so releaseIfIdle() either sees the write or the write sees the release
+	numActiveWrites++;
+
+	if (owner.load() == threadId)
+		return true;
+
+	numActiveWrites--;
+	return false;
+}
+
+void DebugLogger::TraceBuffer::endWrite() noexcept
+{
+	numWrites.fetch_add(1, std::memory_order_relaxed);
+	numActiveWrites--;
+}
+
+bool DebugLogger::TraceBuffer::releaseIfIdle() noexcept
+{
+	void* currentOwner = owner.load();
+
+	if (currentOwner == nullptr)
+		return false;
+
+	const uint32 n = numWrites.load(std::memory_order_relaxed);
+
+	if (n != numWritesAtLastCheck || readIndex.load() != writeIndex.load())
+	{
+		numWritesAtLastCheck = n;
+		return false;
+	}
+
+	// The buffer itself is used as marker, so no other thread can claim it while a running write is checked
+	if (!owner.compare_exchange_strong(currentOwner, (void*)this))
+		return false;
+
+	if (numActiveWrites.load() != 0)
+	{
+		owner.store(currentOwner);
+		return false;
+	}
+
+	owner.store(nullptr);
+	return true;
+}
+
+void DebugLogger::TraceBuffer::reset() noexcept
+{
+	TraceRecord r;
+
+	while (pop(r))
+		;
+
+	owner = nullptr;
+	numWrites = 0;
+	numWritesAtLastCheck = 0;
+}
+
 DebugLogger::DebugLogger(MainController* mc_):
 	mc(mc_),
 	dumper(*this),
-    recordUptime(-1)
+    recordUptime(-1),
+	messageIndex(0),
+	numDroppedRecords(0),
+	numRecordsWithoutBuffer(0),
+	currentlyLogging(false)
 {
-	pendingEvents.ensureStorageAllocated(NUM_MESSAGE_SLOTS);
-	pendingFailures.ensureStorageAllocated(NUM_MESSAGE_SLOTS);
-	pendingPerformanceWarnings.ensureStorageAllocated(NUM_MESSAGE_SLOTS);
+	static_assert(sizeof(TraceRecord) == 88, "Bump the TraceVersion if you change the record layout");
+
 	pendingStringMessages.ensureStorageAllocated(NUM_MESSAGE_SLOTS);
-	pendingAudioChanges.ensureStorageAllocated(16);
+	drainedRecords.ensureStorageAllocated(TraceBuffer::NumRecords);
 }
 
 DebugLogger::~DebugLogger()
@@ -322,27 +434,74 @@ DebugLogger::~DebugLogger()
 
 double DebugLogger::getCurrentTimeStamp() const
 {
-	return 0.001 * (Time::getMillisecondCounterHiRes() - uptime);
+	return Time::highResolutionTicksToSeconds(Time::getHighResolutionTicks() - startTicks);
 }
 
-void DebugLogger::addFailure(const DebugLogger::Failure& f)
+DebugLogger::TraceRecord DebugLogger::createRecord(TraceRecord::Type type, Location l, const Processor* p) const noexcept
 {
-	ScopedLock sl(debugLock);
-	pendingFailures.add(f);
+	TraceRecord r;
+	zerostruct(r);
+
+	r.ticks = Time::getHighResolutionTicks();
+	r.processor = (uint64)(pointer_sized_uint)p;
+	r.callbackIndex = callbackIndex;
+	r.type = (uint8)type;
+	r.location = (uint8)l;
+
+	return r;
 }
 
-void DebugLogger::addPerformanceWarning(const PerformanceWarning& f)
+DebugLogger::TraceBuffer* DebugLogger::beginTraceWrite() noexcept
 {
-	ScopedLock sl(debugLock);
-	pendingPerformanceWarnings.add(f);
+	void* threadId = (void*)Thread::getCurrentThreadId();
+
+	for (auto& b : traceBuffers)
+	{
+		if (b.isOwnedBy(threadId) && b.beginWrite(threadId))
+			return &b;
+	}
+
+	// First record of this thread (or its buffer was released), so claim a free buffer
+	for (auto& b : traceBuffers)
+	{
+		if (b.claim(threadId) && b.beginWrite(threadId))
+			return &b;
+	}
+
+	return nullptr;
 }
 
+void DebugLogger::pushRecord(TraceRecord& r) noexcept
+{
+	r.sequenceIndex = messageIndex++;
+
+	auto b = beginTraceWrite();
+
+	if (b == nullptr)
+	{
+		numRecordsWithoutBuffer++;
+		return;
+	}
+
+	r.threadIndex = (uint8)(b - traceBuffers);
+
+	if (!b->push(r))
+		numDroppedRecords++;
+
+	b->endWrite();
+}
 
 void DebugLogger::addStreamingFailure(double voiceUptime)
 {
-	Failure f = Failure(messageIndex++, callbackIndex, Location::SampleRendering, FailureType::StreamingFailure, nullptr, getCurrentTimeStamp(), voiceUptime);
+	if (!isLogging())
+		return;
+
+	auto r = createRecord(TraceRecord::Type::Failure, Location::SampleRendering, nullptr);
 
-	addFailure(f);
+	r.failureType = (uint8)FailureType::StreamingFailure;
+	r.value1 = voiceUptime;
+
+	pushRecord(r);
 }
 
 void DebugLogger::logEvents(const HiseEventBuffer& masterBuffer)
@@ -356,11 +515,10 @@ void DebugLogger::logEvents(const HiseEventBuffer& masterBuffer)
 			if (e->isAftertouch())
 				continue;
 
-			ScopedLock sl(debugLock);
-
-			Event e2(messageIndex++, callbackIndex, *e);
+			auto r = createRecord(TraceRecord::Type::Event, Location::MainRenderCallback, nullptr);
+			r.setEvent(*e);
 
-			pendingEvents.add(e2);
+			pushRecord(r);
 		}
 	}
 }
@@ -374,6 +532,25 @@ void DebugLogger::logMessage(const String& errorMessage)
 	pendingStringMessages.add(m);
 }
 
+void DebugLogger::logStreamingCacheStatistics()
+{
+	auto& cache = getMainController()->getSampleManager().getGlobalSampleThreadPool()->getBlockCache();
+
+	const int64 numHits = cache.getNumHits();
+	const int64 numMisses = cache.getNumMisses();
+
+	if (!cache.isEnabled() || numHits + numMisses == 0)
+		return;
+
+	cache.resetStatistics();
+
+	const double hitRate = (double)numHits / (double)(numHits + numMisses);
+	const double megaBytes = (double)cache.getMemoryUsage() / 1024.0 / 1024.0;
+
+	logMessage("Streaming block cache: " + String(numHits) + " hits, " + String(numMisses) + " misses (" + 
+			   String(hitRate * 100.0, 1) + "% hit rate), " + String(megaBytes, 2) + " MB");
+}
+
 void DebugLogger::logPerformanceWarning(const PerformanceData& logData)
 {
 #if HISE_IOS
@@ -386,10 +563,15 @@ void DebugLogger::logPerformanceWarning(const PerformanceData& logData)
 	if (!isLogging())
 		return;
 
-	const int voiceAmount = logData.p->getMainController()->getNumActiveVoices();
+	auto r = createRecord(TraceRecord::Type::PerformanceWarning, (Location)logData.location, logData.p);
+
+	r.duration = logData.duration;
+	r.value1 = logData.thisPercentage;
+	r.value2 = logData.averagePercentage;
+	r.value3 = logData.limit;
+	r.intValue = logData.p->getMainController()->getNumActiveVoices();
 
-	PerformanceWarning f(messageIndex++, callbackIndex, logData, getCurrentTimeStamp(), voiceAmount);
-	addPerformanceWarning(f);
+	pushRecord(r);
 #endif
 }
 
@@ -429,6 +611,13 @@ void DebugLogger::checkAudioCallbackProperties(double sampleRate, int samplesPer
 
 	locationForErrorInCurrentCallback = Location::Empty;
 
+	auto r = createRecord(TraceRecord::Type::Callback, Location::MainRenderCallback, nullptr);
+
+	r.value1 = sampleRate;
+	r.intValue = samplesPerBlock;
+
+	pushRecord(r);
+
 	if (sampleRate != lastSampleRate)
 	{
 		addAudioDeviceChange(FailureType::SampleRateChange, lastSampleRate, sampleRate);
@@ -498,8 +687,13 @@ bool DebugLogger::checkSampleData(Processor* p, Location location, bool isLeftCh
 			failureType = isLeftChannel ? FailureType::BurstLeft : FailureType::BurstRight;
 		}
 
-		Failure f(messageIndex++, callbackIndex, location, failureType, p, getCurrentTimeStamp(), errorValue, id);
-		addFailure(f);
+		auto r = createRecord(TraceRecord::Type::Failure, location, p);
+
+		r.failureType = (uint8)failureType;
+		r.value1 = errorValue;
+		r.id = (uint64)(pointer_sized_uint)id.getCharPointer().getAddress();
+
+		pushRecord(r);
 
 		return false;
 	}
@@ -513,8 +707,12 @@ void DebugLogger::checkAssertion(Processor* p, Location location, bool result, d
 
 	if (!result)
 	{
-		Failure f(messageIndex++, callbackIndex, location, FailureType::Assertion, p, getCurrentTimeStamp(), extraData);
-		addFailure(f);
+		auto r = createRecord(TraceRecord::Type::Failure, location, p);
+
+		r.failureType = (uint8)FailureType::Assertion;
+		r.value1 = extraData;
+
+		pushRecord(r);
 	}
 }
 
@@ -531,8 +729,10 @@ bool DebugLogger::checkIsSoftBypassed(const ModulatorSynth* synth, Location loca
 
 	if (!silence)
 	{
-		Failure f(messageIndex++, callbackIndex, location, FailureType::SoftBypassFailure, synth, getCurrentTimeStamp(), 0.0);
-		addFailure(f);
+		auto r = createRecord(TraceRecord::Type::Failure, location, synth);
+		r.failureType = (uint8)FailureType::SoftBypassFailure;
+
+		pushRecord(r);
 		return false;
 	}
 
@@ -548,11 +748,14 @@ void DebugLogger::checkPriorityInversion(const CriticalSection& lockToCheck)
 
 	if (!sl.isLocked())
 	{
-		Failure f(messageIndex++, callbackIndex - 1, Location::MainRenderCallback, FailureType::PriorityInversion, nullptr, getCurrentTimeStamp(), 0.0);
+		auto r = createRecord(TraceRecord::Type::Failure, Location::MainRenderCallback, nullptr);
+
+		r.failureType = (uint8)FailureType::PriorityInversion;
+		r.callbackIndex = callbackIndex - 1;
 
 		actualBackTrace = messageCallbackStackBacktrace;
 
-		addFailure(f);
+		pushRecord(r);
 	}
 }
 
@@ -567,8 +770,12 @@ void DebugLogger::checkPriorityInversion(const SpinLock& spinLockToCheck, Locati
 		spinLockToCheck.exit();
 	else
 	{
-		Failure f(messageIndex++, callbackIndex, l, FailureType::PriorityInversion, p, getCurrentTimeStamp(), 0.0, id);
-		addFailure(f);
+		auto r = createRecord(TraceRecord::Type::Failure, l, p);
+
+		r.failureType = (uint8)FailureType::PriorityInversion;
+		r.id = (uint64)(pointer_sized_uint)id.getCharPointer().getAddress();
+
+		pushRecord(r);
 	}
 }
 
@@ -576,11 +783,13 @@ void DebugLogger::addAudioDeviceChange(FailureType changeType, double oldValue,
 {
 	if (isLogging())
 	{
-		AudioSettingChange f(messageIndex++, callbackIndex, getCurrentTimeStamp(), changeType, oldValue, newValue);
-		{
-			ScopedLock sl(debugLock);
-			pendingAudioChanges.add(f);
-		}
+		auto r = createRecord(TraceRecord::Type::AudioSettingChange, Location::MainRenderCallback, nullptr);
+
+		r.failureType = (uint8)changeType;
+		r.value1 = oldValue;
+		r.value2 = newValue;
+
+		pushRecord(r);
 	}
 }
 
@@ -597,7 +806,6 @@ void DebugLogger::startLogging()
 	}
 #endif
 
-	currentlyLogging = true;
 	currentLogFile.create();
 	numErrorsSinceLogStart = 0;
 
@@ -606,15 +814,48 @@ void DebugLogger::startLogging()
 
 	callbackIndex = 0;
 
-	uptime = Time::getMillisecondCounterHiRes();
+	startTicks = Time::getHighResolutionTicks();
 
-	FileOutputStream fos(currentLogFile);
+	{
+		FileOutputStream fos(currentLogFile);
 
-	fos << getHeader();
-	fos << getSystemSpecs();
-	
+		fos << getHeader();
+		fos << getSystemSpecs();
+	}
+
+	// The buffers are claimed again by the threads that write into this log
+	for (auto& b : traceBuffers)
+	{
+		b.allocate();
+		b.reset();
+	}
+
+	numDroppedRecords = 0;
+	numRecordsWithoutBuffer = 0;
+	writtenProcessorNames.clear();
+
+	auto traceFile = getCurrentTraceFile();
+	traceFile.deleteFile();
 
-	pendingFailures.ensureStorageAllocated(200);
+	traceStream = new FileOutputStream(traceFile);
+
+	if (traceStream->failedToOpen())
+	{
+		traceStream = nullptr;
+	}
+	else
+	{
+		traceStream->writeInt(TraceMagicNumber);
+		traceStream->writeInt(TraceVersion);
+		traceStream->writeInt((int)sizeof(TraceRecord));
+		traceStream->writeInt64(startTicks);
+		traceStream->writeDouble((double)Time::getHighResolutionTicksPerSecond());
+	}
+
+	numTimerCallbacks = 0;
+	getMainController()->getSampleManager().getGlobalSampleThreadPool()->getBlockCache().resetStatistics();
+
+	currentlyLogging = true;
 
 	startTimer(200);
 
@@ -642,59 +883,145 @@ struct MessageComparator
 };
 
 
-void DebugLogger::timerCallback()
+int DebugLogger::writeTraceRecords(Array<Message*>& messages, OwnedArray<Message>& messageStorage)
 {
-	Array<Failure> failureCopy;
-	Array<StringMessage> messageCopy;
-	Array<PerformanceWarning> warningCopy;
-	Array<Event> eventCopy;
-	Array<AudioSettingChange> audioCopy;
-	Array<ParameterChange> parameterCopy;
+	drainedRecords.clearQuick();
+
+	TraceRecord record;
 
+	for (auto& b : traceBuffers)
 	{
-		if (pendingFailures.size() != 0)
-		{
-			failureCopy.ensureStorageAllocated(pendingFailures.size());
+		while (b.pop(record))
+			drainedRecords.add(record);
 
-			ScopedLock sl(debugLock);
-			failureCopy.addArray(pendingFailures);
-			pendingFailures.clearQuick();
-		}
+		b.releaseIfIdle();
+	}
 
-		if (pendingStringMessages.size() != 0)
+	const int numDropped = numDroppedRecords.exchange(0);
+
+	if (numDropped != 0)
+	{
+		auto m = new StringMessage(messageIndex++, callbackIndex, String(numDropped) + " trace records were dropped because a trace buffer was full", getCurrentTimeStamp());
+
+		messageStorage.add(m);
+		messages.add(m);
+	}
+
+	const int numWithoutBuffer = numRecordsWithoutBuffer.exchange(0);
+
+	if (numWithoutBuffer != 0)
+	{
+		auto m = new StringMessage(messageIndex++, callbackIndex, String(numWithoutBuffer) + " trace records were dropped because more than " + String(NUM_TRACE_THREADS) + " threads were writing", getCurrentTimeStamp());
+
+		messageStorage.add(m);
+		messages.add(m);
+	}
+
+	if (drainedRecords.isEmpty())
+		return 0;
+
+	// The records only store the address, so they are resolved against the processors that still exist
+	HashMap<uint64, Processor*> liveProcessors;
+
+	Processor::Iterator<Processor> iter(mc->getMainSynthChain());
+
+	while (auto p = iter.getNextProcessor())
+		liveProcessors.set((uint64)(pointer_sized_uint)p, p);
+
+	if (traceStream != nullptr)
+	{
+		for (const auto& r : drainedRecords)
 		{
-			messageCopy.ensureStorageAllocated(pendingStringMessages.size());
+			if (auto p = liveProcessors[r.processor])
+			{
+				const String name = p->getId();
 
-			ScopedLock sl(messageLock);
-			messageCopy.addArray(pendingStringMessages);
-			pendingStringMessages.clearQuick();
+				if (!writtenProcessorNames.contains(r.processor) || writtenProcessorNames[r.processor] != name)
+				{
+					traceStream->writeInt(TraceChunkProcessorName);
+					traceStream->writeInt64((int64)r.processor);
+					traceStream->writeString(name);
+
+					writtenProcessorNames.set(r.processor, name);
+				}
+			}
 		}
 
-		if (pendingEvents.size() != 0)
+		traceStream->writeInt(TraceChunkRecords);
+		traceStream->writeInt(drainedRecords.size());
+		traceStream->write(drainedRecords.getRawDataPointer(), sizeof(TraceRecord) * (size_t)drainedRecords.size());
+		traceStream->flush();
+	}
+
+	int numErrors = 0;
+
+	for (const auto& r : drainedRecords)
+	{
+		Processor* p = liveProcessors[r.processor];
+
+		// The identifiers belong to the processor, so they are only safe to read while it exists
+		const Identifier id = (p != nullptr && r.id != 0) ? Identifier(String(CharPointer_UTF8((const char*)(pointer_sized_uint)r.id))) : Identifier();
+
+		const double timestamp = Time::highResolutionTicksToSeconds(r.ticks - startTicks);
+		const Location l = (Location)r.location;
+
+		Message* m = nullptr;
+
+		switch ((TraceRecord::Type)r.type)
+		{
+		case TraceRecord::Type::Failure:
+			m = new Failure(r.sequenceIndex, r.callbackIndex, l, (FailureType)r.failureType, p, timestamp, r.value1, id);
+			numErrors++;
+			break;
+		case TraceRecord::Type::PerformanceWarning:
 		{
-			eventCopy.ensureStorageAllocated(pendingEvents.size());
+			PerformanceData d((int)r.location, (float)r.value1, (float)r.value2, p);
+			d.limit = (float)r.value3;
+			d.duration = r.duration;
 
-			ScopedLock sl(debugLock);
-			eventCopy.addArray(pendingEvents);
-			pendingEvents.clearQuick();
+			m = new PerformanceWarning(r.sequenceIndex, r.callbackIndex, d, timestamp, r.intValue);
+			numErrors++;
+			break;
+		}
+		case TraceRecord::Type::Event:
+			m = new Event(r.sequenceIndex, r.callbackIndex, r.getEvent());
+			break;
+		case TraceRecord::Type::AudioSettingChange:
+			m = new AudioSettingChange(r.sequenceIndex, r.callbackIndex, timestamp, (FailureType)r.failureType, r.value1, r.value2);
+			break;
+		case TraceRecord::Type::Callback:
+		case TraceRecord::Type::Empty:
+		case TraceRecord::Type::numTypes:
+			break;
 		}
 
-		if (pendingPerformanceWarnings.size() != 0)
+		if (m != nullptr)
 		{
-			warningCopy.ensureStorageAllocated(pendingPerformanceWarnings.size());
-
-			ScopedLock sl(debugLock);
-			warningCopy.addArray(pendingPerformanceWarnings);
-			pendingPerformanceWarnings.clearQuick();
+			messageStorage.add(m);
+			messages.add(m);
 		}
+	}
 
-		if (pendingAudioChanges.size() != 0)
+	return numErrors;
+}
+
+void DebugLogger::timerCallback()
+{
+	// Every 5 seconds
+	if (++numTimerCallbacks % 25 == 0)
+		logStreamingCacheStatistics();
+
+	Array<StringMessage> messageCopy;
+	Array<ParameterChange> parameterCopy;
+
+	{
+		if (pendingStringMessages.size() != 0)
 		{
-			audioCopy.ensureStorageAllocated(pendingAudioChanges.size());
+			messageCopy.ensureStorageAllocated(pendingStringMessages.size());
 
-			ScopedLock sl(debugLock);
-			audioCopy.addArray(pendingAudioChanges);
-			pendingAudioChanges.clearQuick();
+			ScopedLock sl(messageLock);
+			messageCopy.addArray(pendingStringMessages);
+			pendingStringMessages.clearQuick();
 		}
 
 		if (pendingParameterChanges.size() != 0)
@@ -707,27 +1034,14 @@ void DebugLogger::timerCallback()
 		}
 	}
 
-	messageIndex = 0;
-
 	Array<Message*> messages;
+	OwnedArray<Message> traceMessages;
 
-	
-
-	for (int i = 0; i < warningCopy.size(); i++)
-		messages.add(&warningCopy.getReference(i));
-	
-	for (int i = 0; i < eventCopy.size(); i++)
-		messages.add(&eventCopy.getReference(i));
-
-	for (int i = 0; i < failureCopy.size(); i++)
-		messages.add(&failureCopy.getReference(i));
+	const int numErrors = writeTraceRecords(messages, traceMessages);
 
 	for (int i = 0; i < messageCopy.size(); i++)
 		messages.add(&messageCopy.getReference(i));
 
-	for (int i = 0; i < audioCopy.size(); i++)
-		messages.add(&audioCopy.getReference(i));
-
 	for (int i = 0; i < parameterCopy.size(); i++)
 		messages.add(&parameterCopy.getReference(i));
 
@@ -755,9 +1069,7 @@ void DebugLogger::timerCallback()
 			}
 		}
 
-		const bool containsError = warningCopy.size() != 0 || failureCopy.size() != 0;
-
-		if (containsError)
+		if (numErrors != 0)
 		{
 
 			for (int i = 0; i < listeners.size(); i++)
@@ -766,8 +1078,7 @@ void DebugLogger::timerCallback()
 					listeners[i]->errorDetected();
 			}
 
-			numErrorsSinceLogStart += failureCopy.size();
-			numErrorsSinceLogStart += warningCopy.size();
+			numErrorsSinceLogStart += numErrors;
 		}
 	}
 	else
@@ -786,6 +1097,32 @@ void DebugLogger::stopLogging()
 	currentlyLogging = false;
 	stopTimer();
 
+	if (traceStream != nullptr)
+	{
+		// Write the records that arrived since the last timer callback
+		timerCallback();
+
+		traceStream = nullptr;
+
+		auto traceFile = getCurrentTraceFile();
+		auto result = convertTraceToChromeFormat(traceFile, traceFile.withFileExtension("json"));
+
+		if (result.failed())
+		{
+			lastErrorMessage = "Trace conversion failed: " + result.getErrorMessage();
+			logMessage(lastErrorMessage);
+
+			// The timer is stopped, so write the message now
+			timerCallback();
+
+			for (int i = 0; i < listeners.size(); i++)
+			{
+				if (listeners[i].get() != nullptr)
+					listeners[i]->errorDetected();
+			}
+		}
+	}
+
 	for (int i = 0; i < listeners.size(); i++)
 	{
 		if (listeners[i].get() != nullptr)
@@ -949,6 +1286,182 @@ void DebugLogger::fillBufferWithJunk(float* data, int numSamples)
 	}
 }
 
+Result DebugLogger::convertTraceToChromeFormat(const File& traceFile, const File& jsonFile)
+{
+	FileInputStream fis(traceFile);
+
+	if (fis.failedToOpen())
+		return Result::fail("Can't open " + traceFile.getFullPathName());
+
+	if (fis.readInt() != TraceMagicNumber)
+		return Result::fail(traceFile.getFileName() + " is not a trace file");
+
+	const int version = fis.readInt();
+	const int recordSize = fis.readInt();
+
+	if (version != TraceVersion || recordSize != (int)sizeof(TraceRecord))
+		return Result::fail("Unsupported trace version " + String(version));
+
+	const int64 firstTicks = fis.readInt64();
+	const double ticksPerSecond = fis.readDouble();
+
+	if (ticksPerSecond <= 0.0)
+		return Result::fail("Invalid tick rate");
+
+	jsonFile.deleteFile();
+
+	FileOutputStream fos(jsonFile);
+
+	if (fos.failedToOpen())
+		return Result::fail("Can't write " + jsonFile.getFullPathName());
+
+	HashMap<uint64, String> processorNames;
+	bool usedThreads[NUM_TRACE_THREADS] = { false };
+	bool audioThreads[NUM_TRACE_THREADS] = { false };
+	bool isFirstEvent = true;
+
+	auto writeEvent = [&](DynamicObject* obj)
+	{
+		fos << (isFirstEvent ? "" : ",\n") << JSON::toString(var(obj), true);
+		isFirstEvent = false;
+	};
+
+	fos << "{\"traceEvents\":[\n";
+
+	while (!fis.isExhausted())
+	{
+		const int chunkType = fis.readInt();
+
+		if (chunkType == TraceChunkProcessorName)
+		{
+			const uint64 key = (uint64)fis.readInt64();
+			processorNames.set(key, fis.readString());
+		}
+		else if (chunkType == TraceChunkRecords)
+		{
+			const int numRecords = fis.readInt();
+
+			for (int i = 0; i < numRecords; i++)
+			{
+				TraceRecord r;
+
+				if (fis.read(&r, sizeof(TraceRecord)) != (int)sizeof(TraceRecord))
+					return Result::fail("The trace file is truncated");
+
+				const auto type = (TraceRecord::Type)r.type;
+				const int threadIndex = jlimit<int>(0, NUM_TRACE_THREADS - 1, r.threadIndex);
+				const bool validLocation = r.location < (uint8)Location::numLocations;
+				const bool validFailure = r.failureType < (uint8)FailureType::numFailureTypes;
+
+				usedThreads[threadIndex] = true;
+
+				DynamicObject::Ptr obj = new DynamicObject();
+				DynamicObject::Ptr args = new DynamicObject();
+
+				switch (type)
+				{
+				case TraceRecord::Type::Callback:
+					audioThreads[threadIndex] = true;
+					obj->setProperty("name", "Callback");
+					args->setProperty("sampleRate", r.value1);
+					args->setProperty("bufferSize", r.intValue);
+					break;
+				case TraceRecord::Type::Failure:
+					obj->setProperty("name", validFailure ? getNameForFailure((FailureType)r.failureType) : "Unknown failure");
+					args->setProperty("extraValue", r.value1);
+					break;
+				case TraceRecord::Type::PerformanceWarning:
+					obj->setProperty("name", validLocation ? getNameForLocation((Location)r.location) : "Unknown Location");
+					args->setProperty("peak", r.value1);
+					args->setProperty("average", r.value2);
+					args->setProperty("limit", r.value3);
+					args->setProperty("voiceAmount", r.intValue);
+					break;
+				case TraceRecord::Type::Event:
+				{
+					const HiseEvent e = r.getEvent();
+
+					obj->setProperty("name", e.getTypeAsString());
+					args->setProperty("eventId", e.getEventId());
+					args->setProperty("timestamp", e.getTimeStamp());
+					args->setProperty("number", e.getNoteNumber());
+					args->setProperty("value", e.getVelocity());
+					args->setProperty("channel", e.getChannel());
+					break;
+				}
+				case TraceRecord::Type::AudioSettingChange:
+					obj->setProperty("name", validFailure ? getNameForFailure((FailureType)r.failureType) : "Unknown failure");
+					args->setProperty("oldValue", r.value1);
+					args->setProperty("newValue", r.value2);
+					break;
+				case TraceRecord::Type::Empty:
+				case TraceRecord::Type::numTypes:
+					return Result::fail("Invalid record type " + String(r.type));
+				}
+
+				const double endTime = (double)(r.ticks - firstTicks) / ticksPerSecond;
+
+				obj->setProperty("cat", type == TraceRecord::Type::Event ? "Event" : type == TraceRecord::Type::Callback ? "Callback" : "Failure");
+				obj->setProperty("pid", 1);
+				obj->setProperty("tid", threadIndex);
+				obj->setProperty("ts", (endTime - r.duration) * 1000000.0);
+
+				if (r.duration > 0.0)
+				{
+					obj->setProperty("ph", "X");
+					obj->setProperty("dur", r.duration * 1000000.0);
+				}
+				else
+				{
+					obj->setProperty("ph", "i");
+					obj->setProperty("s", "t");
+				}
+
+				if (validLocation && r.location != (uint8)Location::Empty)
+					args->setProperty("location", getNameForLocation((Location)r.location));
+
+				if (r.processor != 0 && processorNames.contains(r.processor))
+					args->setProperty("processor", processorNames[r.processor]);
+
+				args->setProperty("callbackIndex", r.callbackIndex);
+				args->setProperty("sequenceIndex", r.sequenceIndex);
+
+				obj->setProperty("args", var(args.get()));
+
+				writeEvent(obj.get());
+			}
+		}
+		else
+		{
+			return Result::fail("Invalid chunk type " + String(chunkType));
+		}
+	}
+
+	for (int i = 0; i < NUM_TRACE_THREADS; i++)
+	{
+		if (!usedThreads[i])
+			continue;
+
+		DynamicObject::Ptr obj = new DynamicObject();
+		DynamicObject::Ptr args = new DynamicObject();
+
+		args->setProperty("name", audioThreads[i] ? "Audio Thread" : "Thread " + String(i));
+
+		obj->setProperty("name", "thread_name");
+		obj->setProperty("ph", "M");
+		obj->setProperty("pid", 1);
+		obj->setProperty("tid", i);
+		obj->setProperty("args", var(args.get()));
+
+		writeEvent(obj.get());
+	}
+
+	fos << "\n]}\n";
+	fos.flush();
+
+	return Result::ok();
+}
+
 void DebugLogger::setPerformanceWarningLevel(int newWarningLevel)
 {
 	logMessage("New Warning level selected: " + String(newWarningLevel));
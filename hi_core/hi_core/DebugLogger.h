@@ -136,9 +136,114 @@ public:
 		float thisPercentage;
 		float averagePercentage;
 		float limit;
+		double duration = 0.0; //< the time spent in the location in seconds
 		Processor* p;
 	};
 
+	/** A fixed size binary record that is written by the realtime threads and drained by the timer callback. 
+	*
+	*	The records are also written as they are into the binary trace file, so if you change this, bump the TraceVersion.
+	*/
+	struct TraceRecord
+	{
+		enum class Type : uint8
+		{
+			Empty = 0,
+			Callback, //< the start of an audio callback (value1 = sample rate, intValue = buffer size)
+			Failure, //< a failure in the location (value1 = extra value)
+			PerformanceWarning, //< a location that took too long (value1 = peak %, value2 = average %, value3 = limit)
+			Event, //< a HiseEvent from the master event buffer
+			AudioSettingChange, //< a change of the audio settings (value1 = old value, value2 = new value)
+			numTypes
+		};
+
+		int64 ticks; //< the high resolution ticks when the record was written
+		double duration; //< the duration in seconds that ended with the ticks (zero for single point records)
+		uint64 processor; //< the address of the processor or zero
+		uint64 id; //< the address of the pooled Identifier string (only resolved while the processor exists)
+		double value1;
+		double value2;
+		double value3;
+		int32 intValue;
+		int32 sequenceIndex;
+		int32 callbackIndex;
+		uint8 type;
+		uint8 location;
+		uint8 failureType;
+		uint8 threadIndex;
+
+		/** The raw data of the HiseEvent. It's not stored as HiseEvent so that the record stays trivially copyable. */
+		uint64 eventData[2];
+
+		void setEvent(const HiseEvent& e) noexcept
+		{
+			static_assert(sizeof(HiseEvent) == sizeof(eventData), "HiseEvent size mismatch");
+
+			const uint64* data = reinterpret_cast<const uint64*>(&e);
+
+			eventData[0] = data[0];
+			eventData[1] = data[1];
+		}
+
+		HiseEvent getEvent() const noexcept { return HiseEvent(*reinterpret_cast<const HiseEvent*>(eventData)); }
+	};
+
+	/** A lock free single producer / single consumer ring buffer of TraceRecords. 
+	*
+	*	Each thread that writes into the log claims its own buffer, so pushing a record never waits for another thread.
+	*	The draining thread releases the buffers of threads that stopped writing, so short-lived threads don't use them up.
+	*/
+	class TraceBuffer
+	{
+	public:
+
+		enum
+		{
+			NumRecords = 2048 // must be a power of two
+		};
+
+		TraceBuffer();
+
+		/** Allocates the records. Call this before the first push(). */
+		void allocate();
+
+		/** Adds a record. Returns false if the buffer is full. Only the owner thread may call this. */
+		bool push(const TraceRecord& r) noexcept;
+
+		/** Removes the oldest record. Only the thread that drains the buffers may call this. */
+		bool pop(TraceRecord& r) noexcept;
+
+		/** Claims the buffer for the thread if it's free. */
+		bool claim(void* threadId) noexcept;
+
+		bool isOwnedBy(void* threadId) const noexcept { return owner.load(std::memory_order_relaxed) == threadId; }
+
+		/** Returns true if the thread still owns the buffer. Call endWrite() after the push() if it does. */
+		bool beginWrite(void* threadId) noexcept;
+
+		void endWrite() noexcept;
+
+		/** Releases the buffer if it's empty and its owner didn't write since the last call. Only the draining thread may call this. */
+		bool releaseIfIdle() noexcept;
+
+		/** Clears the records and releases the buffer. Only call this while no thread writes into the log. */
+		void reset() noexcept;
+
+	private:
+
+		HeapBlock<TraceRecord> records;
+
+		std::atomic<void*> owner;
+		std::atomic<int> numActiveWrites;
+		std::atomic<uint32> numWrites;
+		uint32 numWritesAtLastCheck = 0;
+
+		std::atomic<uint32> writeIndex;
+		std::atomic<uint32> readIndex;
+
+		JUCE_DECLARE_NON_COPYABLE(TraceBuffer);
+	};
+
 	DebugLogger(MainController* mc);
 
 	~DebugLogger();
@@ -173,10 +278,6 @@ public:
 
 	double getCurrentTimeStamp() const;
 
-	void addFailure(const Failure& f);
-
-	void addPerformanceWarning(const PerformanceWarning& f);
-
 	void addStreamingFailure(double voiceUptime);
 
 	void logEvents(const HiseEventBuffer& masterBuffer);
@@ -187,6 +288,9 @@ public:
 
 	void logParameterChange(JavascriptProcessor* p, ReferenceCountedObject* control, const var& newValue);
 
+	/** Writes the hit rate and the memory usage of the StreamingBlockCache since the last call. */
+	void logStreamingCacheStatistics();
+
 	void checkAudioCallbackProperties(double sampleRate, int samplesPerBlock);
 
 	bool checkSampleData(Processor* p, Location location, bool isLeftChannel, const float* data, int numSamples, const Identifier& id=Identifier());
@@ -226,6 +330,12 @@ public:
 
 	static void fillBufferWithJunk(float* data, int numSamples);
 
+	/** Converts a binary trace file that was written during logging to the Chrome trace event format. 
+	*
+	*	You can load the JSON file into chrome://tracing or Perfetto.
+	*/
+	static Result convertTraceToChromeFormat(const File& traceFile, const File& jsonFile);
+
 	void setStackBacktrace(const String& newBackTrace) const
 	{
 		jassert(MessageManager::getInstance()->isThisTheMessageThread());
@@ -240,6 +350,12 @@ public:
 		return currentLogFile;
 	}
 
+	/** Returns the binary trace file that is written next to the log file. */
+	File getCurrentTraceFile() const
+	{
+		return currentLogFile.withFileExtension("hisetrace");
+	}
+
 	double getScaleFactorForWarningLevel() const
 	{
 		switch (warningLevel)
@@ -252,8 +368,6 @@ public:
 		return 1.0;
 	}
 
-	void addSorted(Array<Message*>& list, Message* m);
-
 	void startRecording()
 	{
 		ScopedLock sl(recorderLock);
@@ -333,8 +447,9 @@ private:
 	String lastErrorMessage = "";
 
 	int numErrorsSinceLogStart = 0;
+	int numTimerCallbacks = 0;
 	int callbackIndex = 0;
-	int messageIndex = 0;
+	std::atomic<int> messageIndex;
 
 	void addAudioDeviceChange(FailureType changeType, double oldValue, double newValue);
 
@@ -351,13 +466,37 @@ private:
 	String getSystemSpecs() const;
 
 #define NUM_MESSAGE_SLOTS 256
+#define NUM_TRACE_THREADS 16
+
+	enum
+	{
+		TraceMagicNumber = 0x43525448, // "HTRC"
+		TraceVersion = 1,
+		TraceChunkRecords = 1,
+		TraceChunkProcessorName = 2
+	};
+
+	TraceRecord createRecord(TraceRecord::Type type, Location l, const Processor* p) const noexcept;
+
+	/** Adds the record to the buffer of the current thread without locking or allocating. */
+	void pushRecord(TraceRecord& r) noexcept;
+
+	/** Returns the buffer of the current thread (or claims a free one) and begins a write. Returns nullptr if all buffers are in use. */
+	TraceBuffer* beginTraceWrite() noexcept;
+
+	/** Writes the drained records into the trace file and converts them to messages for the text log. Returns the number of errors. */
+	int writeTraceRecords(Array<Message*>& messages, OwnedArray<Message>& messageStorage);
+
+	TraceBuffer traceBuffers[NUM_TRACE_THREADS];
+	std::atomic<int> numDroppedRecords;
+	std::atomic<int> numRecordsWithoutBuffer;
+
+	Array<TraceRecord> drainedRecords;
+	HashMap<uint64, String> writtenProcessorNames;
+	ScopedPointer<FileOutputStream> traceStream;
 
-	Array<Failure> pendingFailures;
 	Array<StringMessage> pendingStringMessages;
 	Array<ParameterChange> pendingParameterChanges;
-	Array<PerformanceWarning> pendingPerformanceWarnings;
-	Array<AudioSettingChange> pendingAudioChanges;
-	Array<Event> pendingEvents;
 	
 	Array<WeakReference<Listener>> listeners;
 
@@ -365,10 +504,10 @@ private:
 	CriticalSection messageLock;
 
 	File currentLogFile;
-	bool currentlyLogging = false;
+	std::atomic<bool> currentlyLogging;
 	bool currentlyFailing = false;
 
-	double uptime = 0.0;
+	int64 startTicks = 0;
 
 	int warningLevel = 2;
 
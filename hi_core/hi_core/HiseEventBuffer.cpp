@@ -519,4 +519,296 @@ void HiseEventBuffer::insertEventAtPosition(const HiseEvent& e, int positionInBu
     }
 }
 
+LargeHiseEventBuffer::LargeHiseEventBuffer(int capacity_, int maxTimestamp)
+{
+	setCapacity(capacity_, maxTimestamp);
+}
+
+void LargeHiseEventBuffer::setCapacity(int newCapacity, int maxTimestamp)
+{
+	jassert(newCapacity > 0);
+
+	capacity = jmax<int>(1, newCapacity);
+	numBuckets = jmax<int>(0, maxTimestamp) / SubBlockSize + 1;
+
+	events.calloc(capacity);
+	next.calloc(capacity);
+	buckets.malloc(numBuckets);
+
+	for (int i = 0; i < numBuckets; i++)
+	{
+		buckets[i].head = -1;
+		buckets[i].tail = -1;
+	}
+
+	lowestBucket = numBuckets;
+	highestBucket = -1;
+	numUsed = 0;
+	numDropped = 0;
+}
+
+void LargeHiseEventBuffer::clear() noexcept
+{
+	// Only the buckets that were used need to be reset
+	for (int i = lowestBucket; i <= highestBucket; i++)
+	{
+		buckets[i].head = -1;
+		buckets[i].tail = -1;
+	}
+
+	lowestBucket = numBuckets;
+	highestBucket = -1;
+	numUsed = 0;
+	numDropped = 0;
+}
+
+bool LargeHiseEventBuffer::addEvent(const HiseEvent& hiseEvent) noexcept
+{
+	const uint16 timestamp = (uint16)hiseEvent.getTimeStamp();
+	const int bucketIndex = getBucketIndex(timestamp);
+
+	return insertAfter(bucketIndex, findInsertPosition(bucketIndex, -1, timestamp), hiseEvent) != -1;
+}
+
+void LargeHiseEventBuffer::addEvents(const HiseEventBuffer& otherBuffer) noexcept
+{
+	HiseEventBuffer::Iterator iter(otherBuffer);
+
+	mergeSortedEvents(iter);
+}
+
+void LargeHiseEventBuffer::addEvents(const LargeHiseEventBuffer& otherBuffer) noexcept
+{
+	jassert(&otherBuffer != this);
+
+	Iterator iter(otherBuffer);
+
+	mergeSortedEvents(iter);
+}
+
+template <typename IteratorType> void LargeHiseEventBuffer::mergeSortedEvents(IteratorType& iter) noexcept
+{
+	int cursorBucket = -1;
+	int cursor = -1;
+	uint16 lastTimestamp = 0;
+
+	while (const HiseEvent* e = iter.getNextConstEventPointer())
+	{
+		const uint16 timestamp = (uint16)e->getTimeStamp();
+		const int bucketIndex = getBucketIndex(timestamp);
+
+		// As long as the source is sorted, the search continues after the last inserted event
+		if (bucketIndex != cursorBucket || timestamp < lastTimestamp)
+		{
+			cursorBucket = bucketIndex;
+			cursor = -1;
+		}
+
+		const int position = findInsertPosition(bucketIndex, cursor, timestamp);
+		const int index = insertAfter(bucketIndex, position, *e);
+
+		if (index != -1)
+			cursor = index;
+
+		lastTimestamp = timestamp;
+	}
+}
+
+int LargeHiseEventBuffer::copyTo(HiseEventBuffer& target, int firstEvent/*=0*/, int maxNumEvents/*=HISE_EVENT_BUFFER_SIZE*/) const
+{
+	target.clear();
+
+	maxNumEvents = jmin<int>(maxNumEvents, HISE_EVENT_BUFFER_SIZE);
+
+	Iterator iter(*this);
+
+	int index = 0;
+
+	while (const HiseEvent* e = iter.getNextConstEventPointer())
+	{
+		if (index++ < firstEvent)
+			continue;
+
+		if (target.getNumUsed() >= maxNumEvents)
+			return index - 1;
+
+		target.addEvent(*e);
+	}
+
+	return numUsed;
+}
+
+bool LargeHiseEventBuffer::timeStampsAreSorted() const
+{
+	Iterator iter(*this);
+
+	uint16 timestamp = 0;
+
+	while (const HiseEvent* e = iter.getNextConstEventPointer())
+	{
+		if (e->getTimeStamp() < timestamp)
+			return false;
+
+		timestamp = (uint16)e->getTimeStamp();
+	}
+
+	return true;
+}
+
+int LargeHiseEventBuffer::findInsertPosition(int bucketIndex, int startPosition, uint16 timestamp) const noexcept
+{
+	const Bucket& b = buckets[bucketIndex];
+
+	// Fast path for events that arrive in timestamp order
+	if (b.tail == -1 || events[b.tail].getTimeStamp() <= timestamp)
+		return b.tail;
+
+	int position = startPosition;
+	int index = startPosition == -1 ? b.head : next[startPosition];
+
+	while (index != -1 && events[index].getTimeStamp() <= timestamp)
+	{
+		position = index;
+		index = next[index];
+	}
+
+	return position;
+}
+
+int LargeHiseEventBuffer::insertAfter(int bucketIndex, int position, const HiseEvent& e) noexcept
+{
+	if (numUsed >= capacity)
+	{
+		numDropped++;
+		return -1;
+	}
+
+	const int index = numUsed++;
+
+	events[index] = e;
+
+	Bucket& b = buckets[bucketIndex];
+
+	if (position == -1)
+	{
+		next[index] = b.head;
+		b.head = index;
+	}
+	else
+	{
+		next[index] = next[position];
+		next[position] = index;
+	}
+
+	if (b.tail == position)
+		b.tail = index;
+
+	lowestBucket = jmin<int>(lowestBucket, bucketIndex);
+	highestBucket = jmax<int>(highestBucket, bucketIndex);
+
+	return index;
+}
+
+LargeHiseEventBuffer::Iterator::Iterator(const LargeHiseEventBuffer& b) :
+	buffer(const_cast<LargeHiseEventBuffer*>(&b)),
+	bucketIndex(b.lowestBucket),
+	eventIndex(b.lowestBucket <= b.highestBucket ? b.buckets[b.lowestBucket].head : -1)
+{
+
+}
+
+const HiseEvent* LargeHiseEventBuffer::Iterator::getNextConstEventPointer(bool skipIgnoredEvents/*=false*/, bool skipArtificialNotes /*= false*/) const
+{
+	for (;;)
+	{
+		while (eventIndex == -1)
+		{
+			if (++bucketIndex > buffer->highestBucket)
+				return nullptr;
+
+			eventIndex = buffer->buckets[bucketIndex].head;
+		}
+
+		const HiseEvent* e = buffer->events + eventIndex;
+
+		eventIndex = buffer->next[eventIndex];
+
+		if ((skipArtificialNotes && e->isArtificial()) || (skipIgnoredEvents && e->isIgnored()))
+			continue;
+
+		return e;
+	}
+}
+
+HiseEvent* LargeHiseEventBuffer::Iterator::getNextEventPointer(bool skipIgnoredEvents/*=false*/, bool skipArtificialNotes /*= false*/)
+{
+	return const_cast<HiseEvent*>(getNextConstEventPointer(skipIgnoredEvents, skipArtificialNotes));
+}
+
+EventIdVoiceTable::EventIdVoiceTable()
+{
+	clear();
+}
+
+void EventIdVoiceTable::addVoice(int voiceIndex, uint16 eventId) noexcept
+{
+	if (!isPositiveAndBelow(voiceIndex, (int)MaxNumVoices) || eventId == 0)
+	{
+		jassertfalse;
+		return;
+	}
+
+	removeVoice(voiceIndex);
+
+	const int slot = getSlot(eventId);
+	const int oldHead = slots[slot];
+
+	eventIds[voiceIndex] = eventId;
+	previous[voiceIndex] = -1;
+	next[voiceIndex] = (int16)oldHead;
+
+	if (oldHead != -1)
+		previous[oldHead] = (int16)voiceIndex;
+
+	slots[slot] = (int16)voiceIndex;
+}
+
+void EventIdVoiceTable::removeVoice(int voiceIndex) noexcept
+{
+	if (!contains(voiceIndex))
+		return;
+
+	const int p = previous[voiceIndex];
+	const int n = next[voiceIndex];
+
+	if (p != -1)
+		next[p] = (int16)n;
+	else
+		slots[getSlot(eventIds[voiceIndex])] = (int16)n;
+
+	if (n != -1)
+		previous[n] = (int16)p;
+
+	eventIds[voiceIndex] = 0;
+	next[voiceIndex] = -1;
+	previous[voiceIndex] = -1;
+}
+
+void EventIdVoiceTable::clear() noexcept
+{
+	memset(slots, -1, sizeof(slots));
+	memset(next, -1, sizeof(next));
+	memset(previous, -1, sizeof(previous));
+	memset(eventIds, 0, sizeof(eventIds));
+}
+
+int EventIdVoiceTable::getNumVoicesForEventId(uint16 eventId) const noexcept
+{
+	int numVoices = 0;
+
+	forEachVoice(eventId, [&numVoices](int) { numVoices++; });
+
+	return numVoices;
+}
+
 } // namespace hise
\ No newline at end of file
@@ -549,6 +549,181 @@ private:
 };
 
 
+/** A HiseEventBuffer with a configurable capacity for dense event streams (MPE, scripted arpeggiators).
+*
+*	The events are stored in a preallocated pool and linked into buckets that cover SubBlockSize samples each, so
+*	adding an event only has to find its position inside its own bucket and appending in timestamp order is O(1).
+*	Events with the same timestamp keep the order in which they were added. Nothing is allocated after setCapacity(), 
+*	and events that don't fit are dropped and counted instead of overwriting other events.
+*/
+class LargeHiseEventBuffer
+{
+public:
+
+	enum
+	{
+		SubBlockShift = 5,
+		SubBlockSize = 1 << SubBlockShift,
+		DefaultCapacity = HISE_EVENT_BUFFER_SIZE * 16,
+		DefaultMaxTimestamp = 8192
+	};
+
+	LargeHiseEventBuffer(int capacity=DefaultCapacity, int maxTimestamp=DefaultMaxTimestamp);
+
+	/** Reallocates the buffer and clears it. Events with a timestamp above maxTimestamp go into the last bucket. 
+	*
+	*	Don't call this on the audio thread.
+	*/
+	void setCapacity(int newCapacity, int maxTimestamp=DefaultMaxTimestamp);
+
+	int getCapacity() const noexcept { return capacity; }
+
+	void clear() noexcept;
+	bool isEmpty() const noexcept { return numUsed == 0; };
+	int getNumUsed() const noexcept { return numUsed; }
+
+	/** Returns the amount of events that didn't fit into the buffer since the last clear(). */
+	int getNumDroppedEvents() const noexcept { return numDropped; }
+
+	/** Adds the event after all events with a smaller or equal timestamp. Returns false if the buffer is full. */
+	bool addEvent(const HiseEvent& hiseEvent) noexcept;
+
+	/** Merges the events of the other buffer. Sorted runs are inserted from the last position, so this is O(n + m). */
+	void addEvents(const HiseEventBuffer& otherBuffer) noexcept;
+
+	/** Merges the events of the other buffer. Sorted runs are inserted from the last position, so this is O(n + m). */
+	void addEvents(const LargeHiseEventBuffer& otherBuffer) noexcept;
+
+	/** Clears the target buffer and copies the events from firstEvent on until the target contains maxNumEvents events. 
+	*
+	*	Returns the index of the first event that wasn't copied (or getNumUsed() if all events were copied), 
+	*	so a buffer with more than HISE_EVENT_BUFFER_SIZE events can be handed out in multiple chunks.
+	*/
+	int copyTo(HiseEventBuffer& target, int firstEvent=0, int maxNumEvents=HISE_EVENT_BUFFER_SIZE) const;
+
+	bool timeStampsAreSorted() const;
+
+	class Iterator
+	{
+	public:
+
+		/** Creates an iterator which walks through the events in timestamp order. */
+		Iterator(const LargeHiseEventBuffer& b);
+
+		/** Returns a read pointer to the event in the buffer. */
+		const HiseEvent* getNextConstEventPointer(bool skipIgnoredEvents=false, bool skipArtificialNotes = false) const;
+
+		/** Returns a write pointer to the event in the buffer. Don't change the timestamp! */
+		HiseEvent* getNextEventPointer(bool skipIgnoredEvents=false, bool skipArtificialNotes = false);
+
+	private:
+
+		LargeHiseEventBuffer *buffer;
+
+		mutable int bucketIndex;
+		mutable int eventIndex;
+	};
+
+private:
+
+	friend class Iterator;
+
+	struct Bucket
+	{
+		int head;
+		int tail;
+	};
+
+	template <typename IteratorType> void mergeSortedEvents(IteratorType& iter) noexcept;
+
+	int getBucketIndex(uint16 timestamp) const noexcept { return jmin<int>(numBuckets - 1, timestamp >> SubBlockShift); }
+
+	/** Returns the last event in the bucket with a timestamp <= the given timestamp, starting after startPosition. */
+	int findInsertPosition(int bucketIndex, int startPosition, uint16 timestamp) const noexcept;
+
+	/** Stores the event in the pool and links it after the position (or at the start if position is -1). */
+	int insertAfter(int bucketIndex, int position, const HiseEvent& e) noexcept;
+
+	HeapBlock<HiseEvent> events;
+	HeapBlock<int> next;
+	HeapBlock<Bucket> buckets;
+
+	int capacity = 0;
+	int numBuckets = 0;
+	int numUsed = 0;
+	int numDropped = 0;
+
+	int lowestBucket = 0;
+	int highestBucket = -1;
+
+	JUCE_DECLARE_NON_COPYABLE(LargeHiseEventBuffer);
+};
+
+
+/** A dense table that maps event IDs to the indexes of the voices that are playing them.
+*
+*	The voices of each event ID are stored as a linked list of voice indexes, so adding or removing a voice and finding 
+*	the voices for a note off doesn't depend on the amount of voices. The slot is the lower bits of the event ID, so 
+*	sequential IDs only share a slot if more than NumSlots events are alive at the same time.
+*/
+class EventIdVoiceTable
+{
+public:
+
+	enum
+	{
+		NumSlots = 1024,
+		MaxNumVoices = NUM_POLYPHONIC_VOICES
+	};
+
+	EventIdVoiceTable();
+
+	/** Adds the voice to the list of the given event ID. If the voice is already in the table, it will be moved. */
+	void addVoice(int voiceIndex, uint16 eventId) noexcept;
+
+	/** Removes the voice from the table. This does nothing if the voice isn't in the table. */
+	void removeVoice(int voiceIndex) noexcept;
+
+	/** Removes all voices. */
+	void clear() noexcept;
+
+	/** Calls the function with the index of each voice that plays the given event ID. The function may remove the voice. */
+	template <typename FunctionType> void forEachVoice(uint16 eventId, const FunctionType& f) const
+	{
+		int voiceIndex = slots[getSlot(eventId)];
+
+		while (voiceIndex != -1)
+		{
+			const int nextIndex = next[voiceIndex];
+
+			if (eventIds[voiceIndex] == eventId)
+				f(voiceIndex);
+
+			voiceIndex = nextIndex;
+		}
+	}
+
+	/** Returns the amount of voices that play the given event ID. */
+	int getNumVoicesForEventId(uint16 eventId) const noexcept;
+
+	/** Checks if the voice is in the table. */
+	bool contains(int voiceIndex) const noexcept
+	{
+		return isPositiveAndBelow(voiceIndex, (int)MaxNumVoices) && eventIds[voiceIndex] != 0;
+	}
+
+private:
+
+	static int getSlot(uint16 eventId) noexcept { return eventId & (NumSlots - 1); }
+
+	int16 slots[NumSlots];
+	int16 next[MaxNumVoices];
+	int16 previous[MaxNumVoices];
+	uint16 eventIds[MaxNumVoices];
+
+	JUCE_DECLARE_NON_COPYABLE(EventIdVoiceTable);
+};
+
 
 } // namespace hise
 
@@ -62,7 +62,12 @@ public:
 		testMidiBufferIterators();
 		testEventBufferMoveOperations();
 		testEventHandler();
+		testEventIdVoiceTable();
+		testArtificialEventStress();
 		testEventBufferStack();
+		testLargeEventBuffer();
+		testLargeEventBufferThroughput();
+		testLargeEventBufferOverflow();
 		testStartOffset();
 	}
 
@@ -747,6 +752,313 @@ private:
 		
 	}
 
+	void testEventIdVoiceTable()
+	{
+		beginTest("Testing event ID voice table");
+
+		ScopedPointer<EventIdVoiceTable> table = new EventIdVoiceTable();
+
+		table->addVoice(0, 1);
+		table->addVoice(1, 1);
+		table->addVoice(2, 2);
+
+		// Shares the slot with event ID 1
+		table->addVoice(3, 1 + EventIdVoiceTable::NumSlots);
+
+		expectEquals<int>(table->getNumVoicesForEventId(1), 2, "Two voices for event ID 1");
+		expectEquals<int>(table->getNumVoicesForEventId(2), 1, "One voice for event ID 2");
+		expectEquals<int>(table->getNumVoicesForEventId(1 + EventIdVoiceTable::NumSlots), 1, "Slot collision");
+
+		table->removeVoice(0);
+
+		expectEquals<int>(table->getNumVoicesForEventId(1), 1, "Removed voice");
+		expect(!table->contains(0), "Voice 0 is not in the table");
+
+		table->addVoice(1, 2);
+
+		expectEquals<int>(table->getNumVoicesForEventId(1), 0, "Restarted voice was moved");
+		expectEquals<int>(table->getNumVoicesForEventId(2), 2, "Restarted voice was added");
+
+		table->forEachVoice(2, [&table](int voiceIndex) { table->removeVoice(voiceIndex); });
+
+		expectEquals<int>(table->getNumVoicesForEventId(2), 0, "Removing while iterating");
+
+		table->clear();
+
+		expect(!table->contains(3), "Table is empty");
+	}
+
+	void testArtificialEventStress()
+	{
+		beginTest("Testing 10000 overlapping artificial notes");
+
+		const int numNotes = 10000;
+
+		HiseEventBuffer b;
+		ScopedPointer<MainController::EventIdHandler> handler = new MainController::EventIdHandler(b);
+		ScopedPointer<EventIdVoiceTable> table = new EventIdVoiceTable();
+
+		Array<uint16> eventIds;
+		eventIds.ensureStorageAllocated(numNotes);
+
+		const double start = Time::getMillisecondCounterHiRes();
+
+		// This is what Synth.addNoteOn() does for every scripted note
+		for (int i = 0; i < numNotes; i++)
+		{
+			HiseEvent on(HiseEvent::Type::NoteOn, (uint8)(i % 128), 64, 1);
+			on.setArtificial();
+
+			handler->pushArtificialNoteOn(on);
+			table->addVoice(i % EventIdVoiceTable::MaxNumVoices, on.getEventId());
+
+			eventIds.add(on.getEventId());
+		}
+
+		int numFound = 0;
+
+		// Synth.noteOffByEventId() in reverse order
+		for (int i = numNotes; --i >= 0;)
+		{
+			const uint16 eventId = eventIds[i];
+
+			HiseEvent on = handler->popNoteOnFromEventId(eventId);
+
+			if (on.getEventId() == eventId)
+				numFound++;
+
+			table->forEachVoice(eventId, [&table](int voiceIndex) { table->removeVoice(voiceIndex); });
+		}
+
+		const double end = Time::getMillisecondCounterHiRes();
+
+		expectEquals<int>(numFound, numNotes, "All note ons found");
+
+		for (int i = 0; i < EventIdVoiceTable::MaxNumVoices; i++)
+			expect(!table->contains(i), "All voices removed");
+
+		expect(handler->popNoteOnFromEventId(eventIds.getFirst()).isEmpty(), "Note on was removed");
+
+		logMessage(String(numNotes) + " artificial notes: " + String(end - start, 2) + "ms");
+	}
+
+	void testLargeEventBuffer()
+	{
+		beginTest("Testing large event buffer");
+
+		ScopedPointer<LargeHiseEventBuffer> large = new LargeHiseEventBuffer(1024, 1024);
+		HiseEventBuffer b1;
+		HiseEventBuffer b2;
+
+		const int numToFill = r.nextInt(HISE_EVENT_BUFFER_SIZE / 2);
+
+		for (int i = 0; i < numToFill; i++)
+		{
+			HiseEvent e = generateRandomHiseEvent();
+
+			large->addEvent(e);
+			b1.addEvent(e);
+		}
+
+		for (int i = 0; i < numToFill; i++)
+		{
+			HiseEvent e = generateRandomHiseEvent();
+
+			b2.addEvent(e);
+		}
+
+		large->addEvents(b2);
+		b1.addEvents(b2);
+
+		expectEquals<int>(large->getNumUsed(), b1.getNumUsed(), "Size mismatch");
+		expect(large->timeStampsAreSorted(), "Timestamps are not sorted");
+
+		// Events with the same timestamp must keep the order of the HiseEventBuffer
+		LargeHiseEventBuffer::Iterator iter(*large);
+		HiseEventBuffer::Iterator refIter(b1);
+
+		int index = 0;
+
+		while (const HiseEvent* e = iter.getNextConstEventPointer())
+		{
+			const HiseEvent* ref = refIter.getNextConstEventPointer();
+
+			expect(ref != nullptr && *e == *ref, "Event mismatch at index " + String(index++));
+		}
+
+		HiseEventBuffer copy;
+
+		large->copyTo(copy);
+
+		expect(copy == b1, "copyTo");
+
+		beginTest("Copying a large event buffer in chunks");
+
+		large->clear();
+
+		const int numEvents = HISE_EVENT_BUFFER_SIZE * 2 + 17;
+
+		for (int i = 0; i < numEvents; i++)
+			large->addEvent(generateRandomHiseEvent());
+
+		LargeHiseEventBuffer::Iterator chunkIter(*large);
+
+		int firstEvent = 0;
+		int numChunks = 0;
+
+		while (firstEvent < large->getNumUsed())
+		{
+			const int nextEvent = large->copyTo(copy, firstEvent);
+
+			expectEquals<int>(copy.getNumUsed(), nextEvent - firstEvent, "Chunk size");
+			expect(copy.getNumUsed() > 0 && copy.getNumUsed() <= HISE_EVENT_BUFFER_SIZE, "Chunk doesn't fit");
+
+			HiseEventBuffer::Iterator copyIter(copy);
+
+			while (const HiseEvent* e = copyIter.getNextConstEventPointer())
+			{
+				const HiseEvent* ref = chunkIter.getNextConstEventPointer();
+				expect(ref != nullptr && *e == *ref, "Event mismatch in chunk " + String(numChunks));
+			}
+
+			firstEvent = nextEvent;
+			numChunks++;
+		}
+
+		expectEquals<int>(firstEvent, numEvents, "Copied events");
+		expectEquals<int>(numChunks, 3, "Number of chunks");
+		expect(chunkIter.getNextConstEventPointer() == nullptr, "Events were not copied");
+
+		const int maxChunkSize = HISE_EVENT_BUFFER_SIZE / 2;
+
+		expectEquals<int>(large->copyTo(copy, 0, maxChunkSize), maxChunkSize, "Limited chunk size");
+		expectEquals<int>(copy.getNumUsed(), maxChunkSize, "Limited chunk");
+
+		large->clear();
+
+		expect(large->isEmpty(), "Buffer is empty");
+		expect(LargeHiseEventBuffer::Iterator(*large).getNextConstEventPointer() == nullptr, "Empty iterator");
+	}
+
+	void testLargeEventBufferThroughput()
+	{
+		beginTest("Testing large event buffer throughput");
+
+		const int numEvents = HISE_EVENT_BUFFER_SIZE - 1;
+		const int numRuns = 1000;
+
+		HeapBlock<HiseEvent> events;
+		events.calloc(numEvents);
+
+		for (int i = 0; i < numEvents; i++)
+		{
+			HiseEvent e = generateRandomHiseEvent();
+			e.swapWith(events[i]);
+		}
+
+		HiseEventBuffer b;
+		ScopedPointer<LargeHiseEventBuffer> large = new LargeHiseEventBuffer();
+
+		const double start1 = Time::getMillisecondCounterHiRes();
+
+		for (int run = 0; run < numRuns; run++)
+		{
+			b.clear();
+
+			for (int i = 0; i < numEvents; i++)
+				b.addEvent(events[i]);
+		}
+
+		const double end1 = Time::getMillisecondCounterHiRes();
+
+		for (int run = 0; run < numRuns; run++)
+		{
+			large->clear();
+
+			for (int i = 0; i < numEvents; i++)
+				large->addEvent(events[i]);
+		}
+
+		const double end2 = Time::getMillisecondCounterHiRes();
+
+		expectEquals<int>(large->getNumUsed(), b.getNumUsed(), "Size mismatch");
+
+		logMessage("HiseEventBuffer: " + String(end1 - start1, 2) + "ms for " + String(numRuns * numEvents) + " events");
+		logMessage("LargeHiseEventBuffer: " + String(end2 - end1, 2) + "ms for " + String(numRuns * numEvents) + " events");
+
+		// Merge many sorted buffers into one large buffer
+		const int numBuffers = LargeHiseEventBuffer::DefaultCapacity / numEvents;
+
+		b.clear();
+
+		for (int i = 0; i < numEvents; i++)
+			b.addEvent(events[i]);
+
+		const double start3 = Time::getMillisecondCounterHiRes();
+
+		for (int run = 0; run < numRuns / 10; run++)
+		{
+			large->clear();
+
+			for (int i = 0; i < numBuffers; i++)
+				large->addEvents(b);
+		}
+
+		const double end3 = Time::getMillisecondCounterHiRes();
+
+		expectEquals<int>(large->getNumUsed(), numBuffers * numEvents, "Merged size");
+		expect(large->timeStampsAreSorted(), "Merged timestamps are not sorted");
+
+		logMessage("Merging " + String(numBuffers) + " buffers: " + String((end3 - start3) / (double)(numRuns / 10), 3) + "ms");
+	}
+
+	void testLargeEventBufferOverflow()
+	{
+		beginTest("Testing large event buffer overflow");
+
+		const int capacity = 512;
+		const int numToAdd = capacity * 4;
+
+		ScopedPointer<LargeHiseEventBuffer> large = new LargeHiseEventBuffer(capacity, 1024);
+
+		const double start = Time::getMillisecondCounterHiRes();
+
+		int numAdded = 0;
+
+		for (int i = 0; i < numToAdd; i++)
+		{
+			HiseEvent e(HiseEvent::Type::NoteOn, (uint8)(i % 128), 64, 1);
+			e.setTimeStamp(i % 1024);
+
+			if (large->addEvent(e))
+				numAdded++;
+		}
+
+		const double end = Time::getMillisecondCounterHiRes();
+
+		expectEquals<int>(numAdded, capacity, "Added events");
+		expectEquals<int>(large->getNumUsed(), capacity, "Used events");
+		expectEquals<int>(large->getNumDroppedEvents(), numToAdd - capacity, "Dropped events");
+		expect(large->timeStampsAreSorted(), "Timestamps are not sorted");
+
+		// The first events must not be overwritten
+		LargeHiseEventBuffer::Iterator iter(*large);
+
+		int index = 0;
+
+		while (const HiseEvent* e = iter.getNextConstEventPointer())
+		{
+			expectEquals<int>(e->getTimeStamp(), index, "Overwritten event");
+			index++;
+		}
+
+		logMessage(String(numToAdd) + " events with overflow: " + String(end - start, 3) + "ms");
+
+		large->clear();
+
+		expectEquals<int>(large->getNumDroppedEvents(), 0, "Dropped counter was reset");
+	}
+
 	Random r;
 
 	void testStartOffset()
@@ -365,6 +365,16 @@ void MainController::KillStateHandler::addThreadIdToAudioThreadList()
 void MainController::KillStateHandler::initAudioThreadId()
 {
 	addThreadIdToAudioThreadList();
+
+	// The workers render child synths on behalf of the audio thread
+	if (auto pool = mc->getAudioWorkerPool())
+	{
+		for (int i = 0; i < pool->getNumWorkers(); i++)
+		{
+			if (auto threadId = pool->getWorkerThreadId(i))
+				audioThreads.addIfNotAlreadyThere(threadId);
+		}
+	}
 }
 
 void MainController::KillStateHandler::executePendingAudioThreadFunctions()
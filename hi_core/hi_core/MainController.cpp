@@ -86,20 +86,43 @@ MainController::MainController():
 	toolbarProperties = DefaultFrontendBar::createDefaultProperties();
 
 	hostInfo = new DynamicObject();
+
+#if HISE_NUM_AUDIO_WORKER_THREADS > 0
+	audioWorkerPool = new AudioWorkerPool(HISE_NUM_AUDIO_WORKER_THREADS);
+#endif
     
 #if HI_RUN_UNIT_TESTS
 
-	UnitTestRunner runner;
+	// Some tests create their own MainController, so this must not recurse
+	static bool testsAreRunning = false;
+
+	if (!testsAreRunning)
+	{
+		testsAreRunning = true;
 
-	runner.setAssertOnFailure(false);
+		UnitTestRunner runner;
 
-	runner.runAllTests();
+		runner.setAssertOnFailure(false);
 
-	
+		runner.runAllTests();
+
+		testsAreRunning = false;
+	}
 
 #endif
 };
 
+void MainController::setNumAudioWorkerThreads(int numWorkers)
+{
+	if (audioWorkerPool != nullptr && audioWorkerPool->getNumWorkers() == numWorkers)
+		return;
+
+	audioWorkerPool = nullptr;
+
+	if (numWorkers > 0)
+		audioWorkerPool = new AudioWorkerPool(numWorkers);
+}
+
 
 MainController::~MainController()
 {
@@ -553,6 +576,54 @@ void MainController::storePlayheadIntoDynamicObject(AudioPlayHead::CurrentPositi
 	//hostInfo->setProperty(isLooping, newPosition.isLooping);
 }
 
+void MainController::addMidiInputToMasterBuffer(const MidiBuffer& midiMessages)
+{
+	// Most blocks fit into the master buffer, so they skip the large buffer
+	if (midiOverflow.isEmpty() && midiMessages.getNumEvents() <= MaxNumMidiInputEvents)
+	{
+		masterEventBuffer.addEvents(midiMessages);
+		return;
+	}
+
+	MidiBuffer::Iterator it(midiMessages);
+	MidiMessage m;
+	int samplePos;
+
+	while (it.getNextEvent(m, samplePos))
+	{
+		HiseEvent e(m);
+
+		if (e.isEmpty()) continue;
+
+		e.setTimeStamp(samplePos);
+
+		// The events from the last block have a zero timestamp, so they stay in front
+		midiOverflow.addEvent(e);
+	}
+
+	jassert(midiOverflow.getNumDroppedEvents() == 0);
+
+	const int numCopied = midiOverflow.copyTo(masterEventBuffer, 0, MaxNumMidiInputEvents);
+
+	midiOverflowScratch.clear();
+
+	LargeHiseEventBuffer::Iterator iter(midiOverflow);
+	int index = 0;
+
+	while (const HiseEvent* e = iter.getNextConstEventPointer())
+	{
+		if (index++ < numCopied)
+			continue;
+
+		HiseEvent delayedEvent(*e);
+		delayedEvent.setTimeStamp(0);
+		midiOverflowScratch.addEvent(delayedEvent);
+	}
+
+	midiOverflow.clear();
+	midiOverflow.addEvents(midiOverflowScratch);
+}
+
 void MainController::processBlockCommon(AudioSampleBuffer &buffer, MidiBuffer &midiMessages)
 {
 	ADD_GLITCH_DETECTOR(getMainSynthChain(), DebugLogger::Location::MainRenderCallback);
@@ -585,7 +656,7 @@ void MainController::processBlockCommon(AudioSampleBuffer &buffer, MidiBuffer &m
 
 	getMacroManager().getMidiControlAutomationHandler()->handleParameterData(midiMessages); // TODO_BUFFER: Move this after the next line...
 
-	masterEventBuffer.addEvents(midiMessages);
+	addMidiInputToMasterBuffer(midiMessages);
 
 	killStateHandler.handleKillState();
 
@@ -753,6 +824,8 @@ void MainController::processBlockCommon(AudioSampleBuffer &buffer, MidiBuffer &m
 
 #endif
 
+	userPresetHandler.processSwapFade(buffer, numSamplesThisBlock);
+
 #if ENABLE_CPU_MEASUREMENT
 	stopCpuBenchmark();
 #endif
@@ -1153,6 +1226,18 @@ double& MainController::SampleManager::getPreloadProgress()
 	return internalPreloadJob.progress;
 }
 
+File MainController::SampleManager::getPreloadCacheDirectory() const
+{
+#if USE_FRONTEND
+	return ProjectHandler::Frontend::getAppDataDirectory().getChildFile("PreloadCache");
+#else
+	if (!projectHandler.isActive())
+		return File();
+
+	return projectHandler.getWorkDirectory().getChildFile("PreloadCache");
+#endif
+}
+
 void MainController::SampleManager::cancelAllJobs()
 {
 	ScopedLock sl(getSamplerSoundLock());
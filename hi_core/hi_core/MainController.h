@@ -167,6 +167,14 @@ public:
 
 		double& getPreloadProgress();
 
+		/** Enables the PreloadCache for the sample maps. The default value is HISE_USE_PRELOAD_CACHE. */
+		void setUsePreloadCache(bool shouldUseCache) noexcept { usePreloadCache = shouldUseCache; }
+
+		bool shouldUsePreloadCache() const noexcept { return usePreloadCache; }
+
+		/** Returns the directory for the PreloadCache files (or File() if there is no valid location). */
+		File getPreloadCacheDirectory() const;
+
 		void cancelAllJobs();
 	private:
 
@@ -218,6 +226,7 @@ public:
 
 		bool hddMode = false;
 		bool skipPreloading = false;
+		bool usePreloadCache = HISE_USE_PRELOAD_CACHE;
 
 		PreloadJob internalPreloadJob;
 
@@ -319,6 +328,13 @@ public:
 
 	private:
 
+		/** Skips zero when the IDs wrap around, because zero is used for events without an ID. */
+		void incEventId() noexcept
+		{
+			if (++currentEventId == 0)
+				currentEventId = 1;
+		}
+
         std::atomic<int> firstCC;
         std::atomic<int> secondCC;
 
@@ -353,9 +369,68 @@ public:
 			WeakReference<Listener>::Master masterReference;
 		};
 
-		UserPresetHandler(MainController* mc_) :
-			mc(mc_)
-		{};
+		/** The way a user preset is applied. */
+		enum class LoadingMode
+		{
+			KillVoices = 0, ///< kills all voices and restores the preset on the sample loading thread (default)
+			FadeOutIn, ///< prepares the preset while the old one keeps playing, fades the output out, restores it and fades back in
+			numLoadingModes
+		};
+
+		/** The timings of the last preset swap in fade mode.
+		*
+		*	The output is silent for mutedMs, so check this value before you use the fade mode on stage:
+		*	the fade only hides the cut of the old voices, it doesn't remove the gap while the preset is restored.
+		*/
+		struct SwapReport
+		{
+			double mutedMs = 0.0; ///< the gap of silence between the end of the fade out and the start of the fade in
+			double preparationMs = 0.0; ///< the time between the load request and the prepared preset
+			double fadeOutMs = 0.0; ///< the time until the output was faded out and the voices were killed
+			double restoreMs = 0.0; ///< the time it took to restore the preset (a part of mutedMs)
+			double totalMs = 0.0; ///< the time from the load request until the output is faded in again
+			int numSwaps = 0; ///< the amount of swaps since the loading mode was set
+		};
+
+		UserPresetHandler(MainController* mc_);
+
+		/** Sets the way the user presets are loaded.
+		*
+		*	In KillVoices mode, all voices are killed immediately and the preset is restored on the sample loading thread.
+		*	
+		*	In FadeOutIn mode, the preset is prepared on the sample loading thread while the old preset keeps playing. 
+		*	The output is then faded out over the given time, so the tails of the old preset fade out instead of being cut.
+		*	The voices are killed and the preset is restored while the output is muted, then the output is faded in again.
+		*
+		*	This is not a seamless preset switch: the old and the new preset never play at the same time, and the output
+		*	stays silent for as long as the restore takes (see SwapReport::mutedMs). It replaces the hard cut with two fades,
+		*	but it doesn't remove the dropout itself.
+		*/
+		void setLoadingMode(LoadingMode newMode, double fadeTimeMilliseconds=30.0);
+
+		LoadingMode getLoadingMode() const { return loadingMode; }
+
+		/** Returns the timings of the last preset swap in fade mode. */
+		SwapReport getLastSwapReport() const;
+
+		/** The states of a preset swap in FadeOutIn mode. */
+		enum SwapState
+		{
+			Idle = 0, ///< no swap is pending, the output is unchanged
+			FadingOut, ///< the new preset is prepared and the output of the old one is faded out
+			Restoring, ///< the output is muted while the voices are killed and the preset is restored
+			FadingIn, ///< the new preset is restored and the output is faded in
+			numSwapStates
+		};
+
+		/** Returns the state of the current preset swap. */
+		SwapState getSwapState() const { return (SwapState)swapState.load(); }
+
+		/** Returns true if a faded preset swap is in progress. */
+		bool isSwapPending() const { return swapState.load() != SwapState::Idle; }
+
+		/** Applies the fade of a pending preset swap to the output. This is called by the audio callback. */
+		void processSwapFade(AudioSampleBuffer& buffer, int numSamples);
 
 		void incPreset(bool next, bool stayInSameDirectory);
 		void loadUserPreset(const ValueTree& v);
@@ -372,6 +447,38 @@ public:
 
 	private:
 
+		/** The state of the preset that is restored to the processors. */
+		struct PreparedPreset
+		{
+			bool isValid() const { return preset.isValid(); }
+
+			ValueTree preset;
+			Array<WeakReference<Processor>> scriptProcessors;
+			Array<int> scriptDataIndexes; ///< the index of the child in the preset that belongs to each script processor
+		};
+
+		/** Prepares the requested presets on the sample loading thread. */
+		struct SwapJob : public SampleThreadPoolJob
+		{
+			SwapJob(UserPresetHandler& parent_) :
+				SampleThreadPoolJob("Preset Swap"),
+				parent(parent_)
+			{};
+
+			JobStatus runJob() override;
+
+			UserPresetHandler& parent;
+		};
+
+		PreparedPreset preparePreset(const ValueTree& v);
+		void restorePreset(const PreparedPreset& p);
+
+		/** Prepares the last requested preset. Returns false if there was no request. */
+		bool prepareNextSwap();
+
+		/** Restores the prepared presets. This is called on the sample loading thread when the voices are killed. */
+		void restorePreparedPreset();
+
 		void loadUserPresetInternal(const ValueTree& v);
 		void saveUserPresetInternal(const String& name=String());
 
@@ -380,6 +487,23 @@ public:
 		File currentlyLoadedFile;
 
 		MainController* mc;
+
+		LoadingMode loadingMode = LoadingMode::KillVoices;
+		double fadeTimeMs = 30.0;
+
+		CriticalSection swapLock;
+		ValueTree requestedPreset;
+		PreparedPreset preparedPreset;
+		bool swapJobIsActive = false;
+		SwapJob swapJob;
+
+		std::atomic<int> swapState;
+		float swapGain = 1.0f;
+
+		int64 requestTime = 0;
+		int64 preparedTime = 0;
+		std::atomic<int64> fadedOutTime;
+		SwapReport lastSwapReport;
 	};
 
 	struct GlobalAsyncModuleHandler: public AsyncUpdater
@@ -780,6 +904,23 @@ public:
 
 	DebugLogger& getDebugLogger() { return debugLogger; }
 	const DebugLogger& getDebugLogger() const { return debugLogger; }
+
+	/** Returns the pool that renders the child synths in parallel or nullptr if HISE_NUM_AUDIO_WORKER_THREADS is 0. */
+	AudioWorkerPool* getAudioWorkerPool() { return audioWorkerPool; }
+	const AudioWorkerPool* getAudioWorkerPool() const { return audioWorkerPool; }
+
+	/** Replaces the AudioWorkerPool with a pool that has the given amount of workers (0 removes the pool).
+	*
+	*	This must not be called while the audio is running. Call prepareToPlay() afterwards so that the synths
+	*	can allocate their render buffers for the new amount of workers.
+	*/
+	void setNumAudioWorkerThreads(int numWorkers);
+
+	/** Call this whenever a processor is added to or removed from the tree. */
+	void processorTreeChanged() noexcept { processorTreeGeneration.fetch_add(1); }
+
+	/** Returns a counter that changes whenever the processor tree changes. Use this to invalidate cached information about the tree. */
+	int getProcessorTreeGeneration() const noexcept { return processorTreeGeneration.load(); }
     
 	void setBufferToPlay(const AudioSampleBuffer& buffer)
 	{
@@ -1027,6 +1168,13 @@ private: // Never call this directly, but wrap it through DelayedRenderer...
 	/** This is the main processing loop that is shared among all subclasses. */
 	void processBlockCommon(AudioSampleBuffer &b, MidiBuffer &mb);
 
+	/** Converts the MIDI input into the master event buffer.
+	*
+	*	If there are more events than MaxNumMidiInputEvents, the rest is kept in midiOverflow and
+	*	played at the start of the next block instead of being dropped.
+	*/
+	void addMidiInputToMasterBuffer(const MidiBuffer& mb);
+
 	/** Sets the sample rate for the cpu meter. */
 	void prepareToPlay(double sampleRate_, int samplesPerBlock);
 
@@ -1050,6 +1198,7 @@ protected:
 		{
 			masterEventBuffer.clear();
 			masterEventBuffer.addEvent(HiseEvent(HiseEvent::Type::AllNotesOff, 0, 0, 1));
+			midiOverflow.clear();
 
 			allNotesOffFlag = false;
 		}
@@ -1132,7 +1281,15 @@ private:
 
 	bool replaceBufferContent = true;
 
+	enum
+	{
+		// Leaves room for the events that are added while the block is processed
+		MaxNumMidiInputEvents = HISE_EVENT_BUFFER_SIZE / 2
+	};
+
 	HiseEventBuffer masterEventBuffer;
+	LargeHiseEventBuffer midiOverflow;
+	LargeHiseEventBuffer midiOverflowScratch;
 	EventIdHandler eventIdHandler;
 	UserPresetHandler userPresetHandler;
 	ProcessorChangeHandler processorChangeHandler;
@@ -1208,6 +1365,9 @@ private:
 
 	DebugLogger debugLogger;
 
+	ScopedPointer<AudioWorkerPool> audioWorkerPool;
+	std::atomic<int> processorTreeGeneration = { 0 };
+
 #if USE_BACKEND
     
 	
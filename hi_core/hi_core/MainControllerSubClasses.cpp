@@ -290,7 +290,8 @@ MainController::EventIdHandler::EventIdHandler(HiseEventBuffer& masterBuffer_) :
 	//for (int i = 0; i < 128; i++)
 		//realNoteOnEvents[i] = HiseEvent();
 
-	memset(realNoteOnEvents, 0, sizeof(HiseEvent) * 128);
+	memset(realNoteOnEvents, 0, sizeof(realNoteOnEvents));
+	memset(lastArtificialEventIds, 0, sizeof(lastArtificialEventIds));
 
 	artificialEvents.calloc(HISE_EVENT_ID_ARRAY_SIZE, sizeof(HiseEvent));
 }
@@ -340,7 +341,7 @@ void MainController::EventIdHandler::handleEventIds()
 			{
 				m->setEventId(currentEventId);
 				realNoteOnEvents[channel][m->getNoteNumber()] = HiseEvent(*m);
-				currentEventId++;
+				incEventId();
 			}
 			else
 			{
@@ -420,7 +421,7 @@ void MainController::EventIdHandler::pushArtificialNoteOn(HiseEvent& noteOnEvent
 	artificialEvents[currentEventId % HISE_EVENT_ID_ARRAY_SIZE] = noteOnEvent;
 	lastArtificialEventIds[noteOnEvent.getNoteNumber()] = currentEventId;
 
-	currentEventId++;
+	incEventId();
 }
 
 
@@ -430,7 +431,10 @@ HiseEvent MainController::EventIdHandler::peekNoteOn(const HiseEvent& noteOffEve
 	{
 		if (noteOffEvent.getEventId() != 0)
 		{
-			return artificialEvents[noteOffEvent.getEventId() % HISE_EVENT_ID_ARRAY_SIZE];
+			const HiseEvent& e = artificialEvents[noteOffEvent.getEventId() % HISE_EVENT_ID_ARRAY_SIZE];
+
+			// The slot might be used by a newer event already
+			return e.getEventId() == noteOffEvent.getEventId() ? e : HiseEvent();
 		}
 		else
 		{
@@ -449,8 +453,14 @@ HiseEvent MainController::EventIdHandler::peekNoteOn(const HiseEvent& noteOffEve
 
 HiseEvent MainController::EventIdHandler::popNoteOnFromEventId(uint16 eventId)
 {
+	HiseEvent& slot = artificialEvents[eventId % HISE_EVENT_ID_ARRAY_SIZE];
+
+	// The slot might be used by a newer event already
+	if (slot.getEventId() != eventId)
+		return HiseEvent();
+
 	HiseEvent e;
-	e.swapWith(artificialEvents[eventId % HISE_EVENT_ID_ARRAY_SIZE]);
+	e.swapWith(slot);
 
 	return e;
 }
@@ -32,12 +32,44 @@
 
 namespace hise { using namespace juce;
 
-void MainController::UserPresetHandler::loadUserPreset(const ValueTree& v)
+MainController::UserPresetHandler::UserPresetHandler(MainController* mc_) :
+	mc(mc_),
+	swapJob(*this),
+	swapState(SwapState::Idle),
+	fadedOutTime(0)
 {
-	auto f = [this, v](Processor*) {loadUserPresetInternal(v); return true; };
 
+}
+
+void MainController::UserPresetHandler::loadUserPreset(const ValueTree& v)
+{
 	auto synthChain = mc->getMainSynthChain();
 
+	// The fade needs a running audio callback
+	if (loadingMode == LoadingMode::FadeOutIn && synthChain->getSampleRate() > 0.0)
+	{
+		bool addJob = false;
+
+		{
+			ScopedLock sl(swapLock);
+
+			if (!requestedPreset.isValid() && !preparedPreset.isValid() && swapState.load() == SwapState::Idle)
+				requestTime = Time::getHighResolutionTicks();
+
+			requestedPreset = v;
+
+			addJob = !swapJobIsActive;
+			swapJobIsActive = true;
+		}
+
+		if (addJob)
+			mc->getSampleManager().getGlobalSampleThreadPool()->addJob(&swapJob, false);
+
+		return;
+	}
+
+	auto f = [this, v](Processor*) {loadUserPresetInternal(v); return true; };
+
 	mc->getKillStateHandler().killVoicesAndCall(synthChain, f, KillStateHandler::TargetThread::SampleLoadingThread);
 }
 
@@ -102,37 +134,58 @@ void MainController::UserPresetHandler::saveUserPresetInternal(const String& nam
 
 void MainController::UserPresetHandler::loadUserPresetInternal(const ValueTree& userPresetToLoad)
 {
+	restorePreset(preparePreset(userPresetToLoad));
+}
 
-#if USE_BACKEND
-	if (!GET_PROJECT_HANDLER(mc->getMainSynthChain()).isActive()) return;
-#endif
 
+MainController::UserPresetHandler::PreparedPreset MainController::UserPresetHandler::preparePreset(const ValueTree& userPresetToLoad)
+{
 	jassert(userPresetToLoad.isValid());
 
-	jassert(!mc->getMainSynthChain()->areVoicesActive());
+	PreparedPreset p;
+	p.preset = userPresetToLoad;
 
 	Processor::Iterator<JavascriptMidiProcessor> iter(mc->getMainSynthChain());
 
-	mc->getSampleManager().setShouldSkipPreloading(true);
-
 	while (JavascriptMidiProcessor *sp = iter.getNextProcessor())
 	{
 		if (!sp->isFront()) continue;
 
-		ValueTree v;
-
 		for (int i = 0; i < userPresetToLoad.getNumChildren(); i++)
 		{
 			if (userPresetToLoad.getChild(i).getProperty("Processor") == sp->getId())
 			{
-				v = userPresetToLoad.getChild(i);
+				p.scriptProcessors.add(sp);
+				p.scriptDataIndexes.add(i);
 				break;
 			}
 		}
+	}
 
-		if (v.isValid())
+	return p;
+}
+
+
+void MainController::UserPresetHandler::restorePreset(const PreparedPreset& p)
+{
+
+#if USE_BACKEND
+	if (!GET_PROJECT_HANDLER(mc->getMainSynthChain()).isActive()) return;
+#endif
+
+	const ValueTree& userPresetToLoad = p.preset;
+
+	jassert(userPresetToLoad.isValid());
+
+	jassert(!mc->getMainSynthChain()->areVoicesActive());
+
+	mc->getSampleManager().setShouldSkipPreloading(true);
+
+	for (int i = 0; i < p.scriptProcessors.size(); i++)
+	{
+		if (auto sp = dynamic_cast<JavascriptMidiProcessor*>(p.scriptProcessors[i].get()))
 		{
-			sp->getScriptingContent()->restoreAllControlsFromPreset(v);
+			sp->getScriptingContent()->restoreAllControlsFromPreset(userPresetToLoad.getChild(p.scriptDataIndexes[i]));
 		}
 	}
 
@@ -182,6 +235,176 @@ void MainController::UserPresetHandler::loadUserPresetInternal(const ValueTree&
 }
 
 
+void MainController::UserPresetHandler::setLoadingMode(LoadingMode newMode, double fadeTimeMilliseconds/*=30.0*/)
+{
+	jassert(fadeTimeMilliseconds > 0.0);
+
+	ScopedLock sl(swapLock);
+
+	loadingMode = newMode;
+	fadeTimeMs = jmax<double>(1.0, fadeTimeMilliseconds);
+	lastSwapReport = SwapReport();
+}
+
+
+MainController::UserPresetHandler::SwapReport MainController::UserPresetHandler::getLastSwapReport() const
+{
+	ScopedLock sl(swapLock);
+	return lastSwapReport;
+}
+
+
+void MainController::UserPresetHandler::processSwapFade(AudioSampleBuffer& buffer, int numSamples)
+{
+	const int state = swapState.load();
+
+	if (state == SwapState::Idle)
+		return;
+
+	const double sampleRate = mc->getMainSynthChain()->getSampleRate();
+	const float delta = (float)((double)numSamples / jmax<double>(1.0, fadeTimeMs * 0.001 * sampleRate));
+
+	switch (state)
+	{
+	case SwapState::FadingOut:
+	{
+		const float nextGain = jmax<float>(0.0f, swapGain - delta);
+		buffer.applyGainRamp(0, numSamples, swapGain, nextGain);
+		swapGain = nextGain;
+
+		if (swapGain == 0.0f)
+		{
+			// The output is silent now, so killing the voices can't be heard. 
+			fadedOutTime.store(Time::getHighResolutionTicks());
+			swapState.store(SwapState::Restoring);
+
+			auto f = [this](Processor*) { restorePreparedPreset(); return true; };
+
+			mc->getKillStateHandler().killVoicesAndCall(mc->getMainSynthChain(), f, KillStateHandler::TargetThread::SampleLoadingThread);
+		}
+
+		break;
+	}
+	case SwapState::Restoring:
+	{
+		buffer.clear(0, numSamples);
+		break;
+	}
+	case SwapState::FadingIn:
+	{
+		const float nextGain = jmin<float>(1.0f, swapGain + delta);
+		buffer.applyGainRamp(0, numSamples, swapGain, nextGain);
+		swapGain = nextGain;
+
+		int expected = SwapState::FadingIn;
+
+		// The compare will fail if a new preset was prepared in the meantime
+		if (swapGain == 1.0f)
+			swapState.compare_exchange_strong(expected, SwapState::Idle);
+
+		break;
+	}
+	default:
+		break;
+	}
+}
+
+
+SampleThreadPool::Job::JobStatus MainController::UserPresetHandler::SwapJob::runJob()
+{
+	while (parent.prepareNextSwap())
+	{
+		if (shouldExit())
+			break;
+	}
+
+	return SampleThreadPool::Job::jobHasFinished;
+}
+
+
+bool MainController::UserPresetHandler::prepareNextSwap()
+{
+	ValueTree v;
+
+	{
+		ScopedLock sl(swapLock);
+
+		if (!requestedPreset.isValid())
+		{
+			swapJobIsActive = false;
+			return false;
+		}
+
+		v = requestedPreset;
+		requestedPreset = ValueTree();
+	}
+
+	// This is the shadow copy of the new state, the old preset keeps playing until it's swapped in.
+	PreparedPreset p = preparePreset(v.createCopy());
+
+	ScopedLock sl(swapLock);
+
+	preparedPreset = p;
+	preparedTime = Time::getHighResolutionTicks();
+
+	int state = swapState.load();
+
+	// The audio thread only changes FadingOut -> Restoring and FadingIn -> Idle.
+	while (state == SwapState::Idle || state == SwapState::FadingIn)
+	{
+		if (swapState.compare_exchange_strong(state, SwapState::FadingOut))
+			break;
+	}
+
+	return true;
+}
+
+
+void MainController::UserPresetHandler::restorePreparedPreset()
+{
+	const int64 restoreStart = Time::getHighResolutionTicks();
+
+	SwapReport r;
+
+	for (;;)
+	{
+		PreparedPreset p;
+
+		{
+			ScopedLock sl(swapLock);
+
+			p = preparedPreset;
+			preparedPreset = PreparedPreset();
+
+			if (!p.isValid())
+			{
+				const int64 restoreEnd = Time::getHighResolutionTicks();
+
+				r.mutedMs = Time::highResolutionTicksToSeconds(restoreEnd - fadedOutTime.load()) * 1000.0;
+				r.preparationMs = Time::highResolutionTicksToSeconds(preparedTime - requestTime) * 1000.0;
+				r.fadeOutMs = Time::highResolutionTicksToSeconds(fadedOutTime.load() - preparedTime) * 1000.0;
+				r.restoreMs = Time::highResolutionTicksToSeconds(restoreEnd - restoreStart) * 1000.0;
+				r.totalMs = Time::highResolutionTicksToSeconds(restoreEnd - requestTime) * 1000.0 + fadeTimeMs;
+				r.numSwaps = lastSwapReport.numSwaps + 1;
+
+				lastSwapReport = r;
+
+				swapState.store(SwapState::FadingIn);
+				break;
+			}
+		}
+
+		restorePreset(p);
+	}
+
+	debugToConsole(mc->getMainSynthChain(), "Preset swap: output muted for " + String(r.mutedMs, 1) + " ms (" +
+															   String(r.preparationMs, 1) + " ms preparation, " +
+															   String(r.fadeOutMs, 1) + " ms fade out, " +
+															   String(r.restoreMs, 1) + " ms muted restore, " +
+															   String(r.totalMs, 1) + " ms total)");
+}
+
+
 void MainController::UserPresetHandler::incPreset(bool next, bool stayInSameDirectory)
 {
 	Array<File> allPresets;
@@ -52,20 +52,19 @@ struct FileLimitInitialiser
 static FileLimitInitialiser fileLimitInitialiser;
 #endif
 
-double ScopedGlitchDetector::locationTimeSum[30] = { .0,.0,.0,.0,.0,.0,.0,.0,.0,.0, .0,.0,.0,.0,.0,.0,.0,.0,.0,.0, .0,.0,.0,.0,.0,.0,.0,.0,.0,.0};
-int ScopedGlitchDetector::locationIndex[30] = { 0,0,0,0,0,0,0,0,0,0, 0,0,0,0,0,0,0,0,0,0, 0,0,0,0,0,0,0,0,0,0, };
-int ScopedGlitchDetector::lastPositiveId = 0;
+// Static atomics are zero initialised
+std::atomic<double> ScopedGlitchDetector::locationTimeSum[30];
+std::atomic<int> ScopedGlitchDetector::locationIndex[30];
+std::atomic<int> ScopedGlitchDetector::lastPositiveId;
 
 ScopedGlitchDetector::ScopedGlitchDetector(Processor* const processor, int location_) :
 	location(location_),
 	startTime(processor->getMainController()->getDebugLogger().isLogging() ? Time::getMillisecondCounterHiRes() : 0.0),
 	p(processor)
 {
-	if (lastPositiveId == location)
-	{
-		// Resets the identifier if a GlitchDetector is recreated...
-		lastPositiveId = 0;
-	}
+	// Resets the identifier if a GlitchDetector is recreated...
+	int expected = location;
+	lastPositiveId.compare_exchange_strong(expected, 0);
 }
 
 ScopedGlitchDetector::~ScopedGlitchDetector() 
@@ -82,23 +81,28 @@ ScopedGlitchDetector::~ScopedGlitchDetector()
 
 		const double bufferMs = 1000.0 * (double)p->getLargestBlockSize() / p->getSampleRate();
 
-		locationTimeSum[location] += interval;
-		locationIndex[location]++;
+		auto sum = locationTimeSum[location].load();
+
+		while (!locationTimeSum[location].compare_exchange_weak(sum, sum + interval))
+			;
+
+		const int numCalls = ++locationIndex[location];
 
 		const double allowedPercentage = getAllowedPercentageForLocation(location) * logger.getScaleFactorForWarningLevel();
 		
 		double maxTime = allowedPercentage * bufferMs;
 		
-		if (lastPositiveId == 0 && interval > maxTime)
-		{
-			lastPositiveId = location;
+		int noPositiveId = 0;
 
-			const double average = locationTimeSum[location] / (double)locationIndex[location];
+		if (interval > maxTime && lastPositiveId.compare_exchange_strong(noPositiveId, location))
+		{
+			const double average = (sum + interval) / (double)numCalls;
 			const double thisTime = average / bufferMs;
 
 			DebugLogger::PerformanceData  l(location, (float)(100.0 * interval / bufferMs), (float)(100.0 * thisTime), p);
 
 			l.limit = (float)allowedPercentage;
+			l.duration = interval * 0.001;
 
 			logger.logPerformanceWarning(l);
 		}
@@ -370,12 +370,13 @@ private:
     
 	int location = 0;
 
-	static double locationTimeSum[30];
-	static int locationIndex[30];
+	// The voices of a synth might be rendered on the workers of the AudioWorkerPool, so the statistics must be atomic
+	static std::atomic<double> locationTimeSum[30];
+	static std::atomic<int> locationIndex[30];
 
     const double startTime;
     
-    static int lastPositiveId;
+    static std::atomic<int> lastPositiveId;
 
 	WeakReference<Processor> p;
 
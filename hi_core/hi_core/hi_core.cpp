@@ -67,6 +67,7 @@
 #include "AES.cpp"
 #include "UtilityClasses.cpp"
 #include "DebugLogger.cpp"
+#include "AudioWorkerPool.cpp"
 #include "ThreadWithQuasiModalProgressWindow.cpp"
 #include "HI_LookAndFeels.cpp"
 #include "Tables.cpp"
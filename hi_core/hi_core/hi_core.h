@@ -76,6 +76,7 @@ struct TestGlobalNamespace
 #include "HI_LookAndFeels.h"
 #include "HiseEventBuffer.h"
 #include "DebugLogger.h"
+#include "AudioWorkerPool.h"
 
 
 #include "ThreadWithQuasiModalProgressWindow.h"
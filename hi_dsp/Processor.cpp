@@ -127,6 +127,9 @@ void Processor::setIsOnAir(bool isBeingProcessedInAudioThread)
 {
 	onAir = isBeingProcessedInAudioThread;
 
+	// Every processor that is added to a chain passes here
+	getMainController()->processorTreeChanged();
+
 	for (int i = 0; i < getNumChildProcessors(); i++)
 	{
 		getChildProcessor(i)->setIsOnAir(isBeingProcessedInAudioThread);
@@ -213,6 +213,7 @@ public:
 	virtual ~Processor()
 	{
 		getMainController()->getMacroManager().removeMacroControlsFor(this);
+		getMainController()->processorTreeChanged();
 		masterReference.clear();
 		removeAllChangeListeners();	
 	};
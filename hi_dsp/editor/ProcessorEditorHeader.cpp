@@ -1150,8 +1150,19 @@ void ProcessorEditorHeader::timerCallback()
 				valueMeter->setPeak(outputValue, -1.0f);
 			}
 
-			
-			
+			if (auto chain = dynamic_cast<ModulatorChain*>(getProcessor()))
+			{
+				String typeText = getProcessor()->getName();
+
+				if (chain->getControlRateDivider() > 1)
+				{
+					typeText << " (1/" << String(chain->getControlRateDivider()) << " rate, ";
+					typeText << String(roundToInt(chain->getSkippedValueRatio() * 100.0f)) << "% values skipped)";
+				}
+
+				if (typeLabel->getText() != typeText)
+					typeLabel->setText(typeText, dontSendNotification);
+			}
 		}
 		else
 		{
@@ -1210,6 +1221,10 @@ void ProcessorEditorHeader::mouseDown(const MouseEvent &e)
 			ReloadFromExternalScript,
 			DisconnectFromScriptFile,
 			SaveCurrentInterfaceState,
+			ControlRateAudio,
+			ControlRate8,
+			ControlRate16,
+			ControlRate32,
 			numMenuItems
 		};
 
@@ -1242,6 +1257,20 @@ void ProcessorEditorHeader::mouseDown(const MouseEvent &e)
 		m.addItem(CreateScriptVariable, "Create script variable declaration");
 
 
+		ModulatorChain* modChain = dynamic_cast<ModulatorChain*>(getProcessor());
+
+		if (modChain != nullptr && !modChain->getIsVoiceStartChain())
+		{
+			const int divider = modChain->getControlRateDivider();
+
+			m.addSeparator();
+			m.addSectionHeader("Control Rate");
+			m.addItem(ControlRateAudio, "Audio rate", true, divider == 1);
+			m.addItem(ControlRate8, "Every 8 samples", true, divider == 8);
+			m.addItem(ControlRate16, "Every 16 samples", true, divider == 16);
+			m.addItem(ControlRate32, "Every 32 samples", true, divider == 32);
+		}
+
 		if (isMainSynthChain)
 		{
 			m.addSeparator();
@@ -1283,6 +1312,12 @@ void ProcessorEditorHeader::mouseDown(const MouseEvent &e)
 			PresetHandler::checkProcessorIdsForDuplicates(getEditor()->getProcessor(), false);
 
 		}
+		else if (result >= ControlRateAudio && result <= ControlRate32)
+		{
+			const int dividers[] = { 1, 8, 16, 32 };
+
+			modChain->setControlRateDivider(dividers[result - ControlRateAudio]);
+		}
 		else if (result == CreateScriptVariable)
 		{
 			ProcessorHelpers::getScriptVariableDeclaration(getEditor()->getProcessor());
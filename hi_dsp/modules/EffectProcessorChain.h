@@ -119,6 +119,19 @@ public:
 
 	};
 
+	/** Returns true if there are voice effects that are not bypassed. */
+	bool hasActiveVoiceEffects() const
+	{
+		if (isBypassed()) return false;
+
+		for (int i = 0; i < voiceEffects.size(); i++)
+		{
+			if (!voiceEffects[i]->isBypassed()) return true;
+		}
+
+		return false;
+	};
+
 	bool hasTail() const override
 	{
 		for(int i = 0; i < allEffects.size(); i++)
@@ -193,6 +193,9 @@ public:
 
 	void renderNextHiseEventBuffer(HiseEventBuffer &buffer, int numSamples);
 
+	/** Returns the events that are scheduled after the current block. The timestamps are relative to the start of the next block. */
+	const HiseEventBuffer& getFutureEvents() const noexcept { return artificialEvents; }
+
 	/** Sequentially processes all processors. */
 	void processHiseEvent(HiseEvent &m) override
 	{
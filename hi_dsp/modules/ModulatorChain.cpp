@@ -32,6 +32,49 @@
 
 namespace hise { using namespace juce;
 
+void ModulationShape::applyTo(float* data, const float* modulationValues, int numSamples) const noexcept
+{
+	switch (type)
+	{
+	case Constant:
+		if (firstValue != 1.0f)
+			FloatVectorOperations::multiply(data, firstValue, numSamples);
+		break;
+	case Ramp:
+	{
+		const float delta = numSamples > 1 ? (lastValue - firstValue) / (float)(numSamples - 1) : 0.0f;
+
+		for (int i = 0; i < numSamples; i++)
+			data[i] *= firstValue + delta * (float)i;
+
+		break;
+	}
+	case Dynamic:
+	case numTypes:
+		FloatVectorOperations::multiply(data, modulationValues, numSamples);
+		break;
+	}
+}
+
+ModulationShape ModulationShape::operator*(const ModulationShape& other) const noexcept
+{
+	if (isConstant())
+		return other * firstValue;
+
+	if (other.isConstant())
+		return *this * other.firstValue;
+
+	return ModulationShape();
+}
+
+ModulationShape ModulationShape::operator*(float factor) const noexcept
+{
+	if (isDynamic())
+		return *this;
+
+	return ModulationShape(type, firstValue * factor, lastValue * factor);
+}
+
 ModulatorChain::ModulatorChain(MainController *mc, const String &uid, int numVoices, Mode m, Processor *p): 
 	EnvelopeModulator(mc, uid, numVoices, m),
 	Modulation(m),
@@ -192,6 +235,7 @@ void ModulatorChain::startVoice(int voiceIndex)
 	const float startValue = getConstantVoiceValue(voiceIndex);
 
 	lastVoiceValues[voiceIndex] = startValue;
+	voiceRamps[voiceIndex].reset();
 
 	setOutputValue(startValue);
 }
@@ -257,6 +301,119 @@ void ModulatorChain::setIsVoiceStartChain(bool isVoiceStartChain_)
 	}
 }
 
+ValueTree ModulatorChain::exportAsValueTree() const
+{
+	ValueTree v = EnvelopeModulator::exportAsValueTree();
+
+	if (controlRateDivider != 1)
+		v.setProperty("ControlRate", controlRateDivider, nullptr);
+
+	return v;
+}
+
+void ModulatorChain::restoreFromValueTree(const ValueTree &v)
+{
+	EnvelopeModulator::restoreFromValueTree(v);
+
+	setControlRateDivider(v.getProperty("ControlRate", 1));
+}
+
+void ModulatorChain::setControlRateDivider(int newDivider)
+{
+	newDivider = jlimit<int>(1, 128, newDivider);
+
+	if (newDivider == controlRateDivider)
+		return;
+
+	ScopedLock sl(getMainController()->getLock());
+
+	controlRateDivider = newDivider;
+
+	for (int i = 0; i < NUM_POLYPHONIC_VOICES; i++)
+		voiceRamps[i].reset();
+
+	monophonicRamp.reset();
+
+	for (auto m : envelopeModulators)
+		updateControlRate(m);
+
+	for (auto v : variantModulators)
+		updateControlRate(v);
+
+	numCalculatedValues = 0;
+	numAudioRateValues = 0;
+	skippedValueRatio = 0.0f;
+}
+
+bool ModulatorChain::hasActiveTimeModulators() const
+{
+	for (auto m : envelopeModulators)
+		if (!m->isBypassed())
+			return true;
+
+	for (auto v : variantModulators)
+		if (!v->isBypassed())
+			return true;
+
+	return false;
+}
+
+int ModulatorChain::updateControlRate(TimeModulation* m) const
+{
+	const int divider = (controlRateDivider > 1 && m->supportsControlRate()) ? controlRateDivider : 1;
+
+	m->setControlRateDivider(divider);
+
+	return divider;
+}
+
+int ModulatorChain::getNumControlRateValues(const ControlRateRamp& r, int numSamples) const noexcept
+{
+	const int numRemaining = numSamples - r.samplesLeft;
+
+	if (numRemaining <= 0)
+		return 0;
+
+	return (numRemaining + controlRateDivider - 1) / controlRateDivider;
+}
+
+void ModulatorChain::applyControlRateRamp(ControlRateRamp& r, const float* controlValues, float* destination, int numSamples) const noexcept
+{
+	while (numSamples > 0)
+	{
+		if (r.samplesLeft == 0)
+		{
+			r.target = *controlValues++;
+
+			if (!r.initialised)
+			{
+				r.value = r.target;
+				r.initialised = true;
+			}
+
+			r.delta = (r.target - r.value) / (float)controlRateDivider;
+			r.samplesLeft = controlRateDivider;
+		}
+
+		const int numThisTime = jmin<int>(r.samplesLeft, numSamples);
+
+		float value = r.value;
+		const float delta = r.delta;
+
+		for (int i = 0; i < numThisTime; i++)
+		{
+			value += delta;
+			destination[i] *= value;
+		}
+
+		r.samplesLeft -= numThisTime;
+		r.value = r.samplesLeft == 0 ? r.target : value;
+
+		destination += numThisTime;
+		numSamples -= numThisTime;
+	}
+}
+
 void ModulatorChain::ModulatorChainHandler::addModulator(Modulator *newModulator, Processor *siblingToInsertBefore)
 {
 	newModulator->setColour(chain->getColour());
@@ -287,11 +444,13 @@ void ModulatorChain::ModulatorChainHandler::addModulator(Modulator *newModulator
 		{
 			EnvelopeModulator *m = static_cast<EnvelopeModulator*>(newModulator);
 			chain->envelopeModulators.add(m);
+			chain->updateControlRate(m);
 		}
 		else if (dynamic_cast<TimeVariantModulator*>(newModulator) != nullptr)
 		{
 			TimeVariantModulator *m = static_cast<TimeVariantModulator*>(newModulator);
 			chain->variantModulators.add(m);
+			chain->updateControlRate(m);
 		}
 		else jassertfalse;
 
@@ -438,11 +597,18 @@ void ModulatorChain::renderVoice(int voiceIndex, int startSample, int numSamples
 	const int startIndex = startSample;
 	const int sampleAmount = numSamples;
 
+	ModulationShape& shape = voiceShapes[voiceIndex];
+
+	shape = ModulationShape();
+
 	if( shouldBeProcessed(true))
 	{
 		const float constantVoiceValue = getConstantVoiceValue(voiceIndex);
 		const float lastVoiceValue = lastVoiceValues[voiceIndex];
 
+		// The actual values are read back from the buffer when the envelopes are rendered
+		bool isLinear = true;
+
 		if (std::abs(constantVoiceValue - lastVoiceValue) > 0.001f)
 		{
 			const float stepSize = (constantVoiceValue - lastVoiceValue) / (float)numSamples;
@@ -462,6 +628,13 @@ void ModulatorChain::renderVoice(int voiceIndex, int startSample, int numSamples
 
 		lastVoiceValues[voiceIndex] = constantVoiceValue;
 
+		ControlRateRamp& ramp = voiceRamps[voiceIndex];
+		const int numControlValues = getNumControlRateValues(ramp, numSamples);
+		bool hasControlRateModulators = false;
+
+		if (controlRateDivider > 1)
+			FloatVectorOperations::fill(envelopeTempBuffer.getWritePointer(0, 0), 1.0f, numControlValues);
+
 		for(int i = 0; i < envelopeModulators.size(); i++)
 		{
 			EnvelopeModulator *m = envelopeModulators[i];
@@ -473,19 +646,57 @@ void ModulatorChain::renderVoice(int voiceIndex, int startSample, int numSamples
 			
 			m->polyManager.setCurrentVoice(voiceIndex);
 
-			FloatVectorOperations::fill(envelopeTempBuffer.getWritePointer(0, startSample), 1.0f, numSamples);
+			numAudioRateValues += numSamples;
+
+			if (updateControlRate(m) > 1)
+			{
+				hasControlRateModulators = true;
+
+				if (numControlValues > 0)
+					m->renderNextBlock(envelopeTempBuffer, 0, numControlValues);
+
+				numCalculatedValues += numControlValues;
+			}
+			else
+			{
+				float* bufferPointer = internalBuffer.getWritePointer(0, 0);
+
+				AudioSampleBuffer b1(&bufferPointer, 1, startSample + numSamples);
 
-			float* bufferPointer = internalBuffer.getWritePointer(0, 0);
+				m->renderNextBlock(b1, startSample, numSamples);
 
-			AudioSampleBuffer b1(&bufferPointer, 1, startSample + numSamples);
+				isLinear &= m->isLastBlockConstant();
 
-			m->renderNextBlock(b1, startSample, numSamples);
+				numCalculatedValues += numSamples;
+			}
 
 			m->polyManager.clearCurrentVoice();
 		}
 
+		if (hasControlRateModulators)
+		{
+			applyControlRateRamp(ramp, envelopeTempBuffer.getReadPointer(0), internalBuffer.getWritePointer(0, startSample), numSamples);
+			isLinear = false;
+		}
+
+		const float* values = internalBuffer.getReadPointer(0, startIndex);
+
 		if (getMode() != Modulation::PitchMode)
-			FloatVectorOperations::clip(internalBuffer.getWritePointer(0, startIndex), internalBuffer.getReadPointer(0, startIndex), (getMode() == Modulation::GainMode ? 0.0f : -1.0f), 1.0f, sampleAmount);
+		{
+			const float minValue = getMode() == Modulation::GainMode ? 0.0f : -1.0f;
+
+			// A ramp that exceeds the range is not linear anymore after the clipping
+			if (isLinear && sampleAmount > 0)
+			{
+				isLinear = jlimit(minValue, 1.0f, values[0]) == values[0] &&
+						   jlimit(minValue, 1.0f, values[sampleAmount - 1]) == values[sampleAmount - 1];
+			}
+
+			FloatVectorOperations::clip(internalBuffer.getWritePointer(0, startIndex), values, minValue, 1.0f, sampleAmount);
+		}
+
+		if (isLinear && sampleAmount > 0)
+			shape = ModulationShape::ramp(values[0], values[sampleAmount - 1]);
 
 		if (voiceIndex == polyManager.getLastStartedVoice())
 			pushPlotterValues(internalBuffer, startSample, sampleAmount);
@@ -515,12 +726,49 @@ void ModulatorChain::renderNextBlock(AudioSampleBuffer& buffer, int startSample,
 
 		jassert(getSampleRate() > 0);
 
+		if (numAudioRateValues > 0)
+		{
+			skippedValueRatio = 1.0f - (float)numCalculatedValues / (float)numAudioRateValues;
+			numCalculatedValues = 0;
+			numAudioRateValues = 0;
+		}
+
 		initializeBuffer(internalBuffer, startSample, numSamples);
 
+		const int numControlValues = getNumControlRateValues(monophonicRamp, numSamples);
+		bool hasControlRateModulators = false;
+		bool isConstant = true;
+
+		if (controlRateDivider > 1)
+			FloatVectorOperations::fill(envelopeTempBuffer.getWritePointer(0, 0), 1.0f, numControlValues);
+
+		auto renderMonophonic = [&](TimeModulation* m)
+		{
+			numAudioRateValues += numSamples;
+
+			if (updateControlRate(m) > 1)
+			{
+				hasControlRateModulators = true;
+
+				if (numControlValues > 0)
+					m->renderNextBlock(envelopeTempBuffer, 0, numControlValues);
+
+				numCalculatedValues += numControlValues;
+			}
+			else
+			{
+				m->renderNextBlock(internalBuffer, startSample, numSamples);
+
+				isConstant &= m->isLastBlockConstant();
+
+				numCalculatedValues += numSamples;
+			}
+		};
+
 		for (auto v : variantModulators)
 		{
 			if (v->isBypassed()) continue;
-			v->renderNextBlock(internalBuffer, startSample, numSamples);
+			renderMonophonic(v);
 		}
 
 		for (auto m : envelopeModulators)
@@ -528,9 +776,17 @@ void ModulatorChain::renderNextBlock(AudioSampleBuffer& buffer, int startSample,
 			if (m->isBypassed()) continue;
 			if (!m->isInMonophonicMode()) continue;
 
-			m->renderNextBlock(internalBuffer, startSample, numSamples);
+			renderMonophonic(m);
 		}
 
+		if (hasControlRateModulators)
+		{
+			applyControlRateRamp(monophonicRamp, envelopeTempBuffer.getReadPointer(0), internalBuffer.getWritePointer(0, startSample), numSamples);
+			isConstant = false;
+		}
+
+		timeVariantShape = (isConstant && numSamples > 0) ? ModulationShape::constant(internalBuffer.getSample(0, startSample)) : ModulationShape();
+
 #if ENABLE_ALL_PEAK_METERS
 		if (!isVoiceStartChain)
 			setOutputValue(internalBuffer.getSample(0, startSample) * envelopeOutputValue1);
@@ -35,6 +35,75 @@
 
 namespace hise { using namespace juce;
 
+/** A compact description of a block of modulation values.
+*
+*	The ModulatorChain keeps one of these for every voice and one for the time variant values. If the values of a block
+*	are constant or a linear ramp, the consumers can use a scalar multiplication or a ramp instead of the per sample
+*	multiplication with the modulation buffer. The modulation buffer is always calculated too, so you can ignore this
+*	if you need the values anyway.
+*/
+struct ModulationShape
+{
+	enum Type
+	{
+		Constant = 0,
+		Ramp,
+		Dynamic,
+		numTypes
+	};
+
+	/** Creates a dynamic shape (the values must be read from the buffer). */
+	ModulationShape() {};
+
+	static ModulationShape constant(float value) noexcept
+	{
+		return ModulationShape(Constant, value, value);
+	}
+
+	/** Creates a linear ramp from the first to the last sample of the block. */
+	static ModulationShape ramp(float firstValue, float lastValue) noexcept
+	{
+		return firstValue == lastValue ? constant(firstValue) : ModulationShape(Ramp, firstValue, lastValue);
+	}
+
+	bool isConstant() const noexcept { return type == Constant; }
+
+	bool isRamp() const noexcept { return type == Ramp; }
+
+	bool isDynamic() const noexcept { return type == Dynamic; }
+
+	/** Returns true if the values are all 1.0f, so the modulation has no effect. */
+	bool isUnity() const noexcept { return type == Constant && firstValue == 1.0f; }
+
+	/** Returns the constant value. Only call this if isConstant() returns true. */
+	float getConstantValue() const noexcept { jassert(isConstant()); return firstValue; }
+
+	/** Multiplies the data with the modulation. The modulationValues are only read if the shape is dynamic.
+	*
+	*	@param data the data that will be modulated (already offset to the start sample).
+	*	@param modulationValues the modulation buffer with the same offset.
+	*/
+	void applyTo(float* data, const float* modulationValues, int numSamples) const noexcept;
+
+	/** Returns the shape of the product of both values. Two ramps result in a dynamic shape. */
+	ModulationShape operator*(const ModulationShape& other) const noexcept;
+
+	/** Returns the shape scaled by a constant factor. */
+	ModulationShape operator*(float factor) const noexcept;
+
+	Type type = Dynamic;
+	float firstValue = 1.0f;
+	float lastValue = 1.0f;
+
+private:
+
+	ModulationShape(Type t, float first, float last) noexcept :
+		type(t),
+		firstValue(first),
+		lastValue(last)
+	{};
+};
+
 /** A chain of Modulators that can be processed serially.
 *
 *	@ingroup modulatorTypes
@@ -162,6 +231,10 @@ public:
 
 	float getAttribute(int) const override { jassertfalse; return -1.0; }; // nothing to do here!
 
+	ValueTree exportAsValueTree() const override;
+
+	void restoreFromValueTree(const ValueTree &v) override;
+
 	/** Iterates all VoiceStartModulators and EnvelopeModulators and stores their values in the internal voice buffer.
 	*
 	*	You can use getVoiceValues() to retrieve these values at a later time.
@@ -176,6 +249,12 @@ public:
 	const float *getVoiceValues(int voiceIndex) const noexcept
 	{ return internalVoiceBuffer.getReadPointer(voiceIndex); }
 
+	/** Returns the shape of the voice values that were calculated in the last renderVoice() call for the given voice. */
+	const ModulationShape& getVoiceShape(int voiceIndex) const noexcept { return voiceShapes[voiceIndex]; }
+
+	/** Returns the shape of the time variant values that were calculated in the last renderNextBlock() call. */
+	const ModulationShape& getTimeVariantShape() const noexcept { return timeVariantShape; }
+
 	/** This ocverrides the TimeVariant::renderNextBlock method and only calculates the TimeVariant modulators.
 	*
 	*	It assumes that the other modulators are calculated before with renderVoice().
@@ -200,6 +279,32 @@ public:
 	/** If you want the chain to only process voice start modulators, set this to true. */
 	void setIsVoiceStartChain(bool isVoiceStartChain_);
 
+	bool getIsVoiceStartChain() const noexcept { return isVoiceStartChain; }
+
+	/** Sets the control rate for all modulators that support it.
+	*
+	*	If the divider is bigger than 1, modulators that return true in TimeModulation::supportsControlRate() only calculate
+	*	one value every `newDivider` samples and the chain reconstructs the signal with linear ramps. All other modulators
+	*	are still rendered at audio rate.
+	*
+	*	The ramp moves from the previous control value to the current one, so the reconstructed signal lags `newDivider - 1`
+	*	samples behind the audio rate signal.
+	*/
+	void setControlRateDivider(int newDivider);
+
+	/** Returns the control rate divider of this chain (1 = audio rate). */
+	int getControlRateDivider() const noexcept { return controlRateDivider; }
+
+	/** Returns the ratio of modulator values that were skipped by the control rate mode in the last block.
+	*
+	*	This only counts the values and is not a measurement of the CPU usage: the ramp that reconstructs the
+	*	signal has a cost too and the modulators don't spend the same time for every value.
+	*/
+	float getSkippedValueRatio() const noexcept { return skippedValueRatio; }
+
+	/** Checks if the chain contains any non bypassed envelopes or time variant modulators. */
+	bool hasActiveTimeModulators() const;
+
 	/** This renders all modulators as they were monophonic. This is useful for ModulatorChains that are not interested in polyphony (eg internal chains of non-polyphonic Modulators, but want to process polyphonic modulators.
 	*
 	*	The best thing is to use this method after / or before all voices are rendered.
@@ -279,6 +384,31 @@ public:
 
 private:
 
+	/** The state of the linear ramp that reconstructs the control rate values. */
+	struct ControlRateRamp
+	{
+		void reset() noexcept
+		{
+			samplesLeft = 0;
+			initialised = false;
+		}
+
+		float value = 1.0f;
+		float target = 1.0f;
+		float delta = 0.0f;
+		int samplesLeft = 0;
+		bool initialised = false;
+	};
+
+	// Returns the divider that should be used for the given modulator and updates the modulator if it has changed.
+	int updateControlRate(TimeModulation* m) const;
+
+	// Returns the amount of control rate values that are needed for the next numSamples.
+	int getNumControlRateValues(const ControlRateRamp& r, int numSamples) const noexcept;
+
+	// Multiplies the destination with the linear ramp between the control rate values.
+	void applyControlRateRamp(ControlRateRamp& r, const float* controlValues, float* destination, int numSamples) const noexcept;
+
 	// Checks if the Modulators are initialized correctly and are set to the right voices */
 	bool checkModulatorStructure();
 
@@ -321,6 +451,18 @@ private:
 
 	float lastVoiceValues[NUM_POLYPHONIC_VOICES];
 
+	ControlRateRamp voiceRamps[NUM_POLYPHONIC_VOICES];
+	ControlRateRamp monophonicRamp;
+
+	ModulationShape voiceShapes[NUM_POLYPHONIC_VOICES];
+	ModulationShape timeVariantShape;
+
+	int controlRateDivider = 1;
+
+	int numCalculatedValues = 0;
+	int numAudioRateValues = 0;
+	float skippedValueRatio = 0.0f;
+
 	bool isVoiceStartChain;
 
 	JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(ModulatorChain)
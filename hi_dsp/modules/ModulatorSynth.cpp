@@ -71,10 +71,13 @@ clockSpeed(ClockSpeed::Inactive),
 lastClockCounter(0),
 wasPlayingInLastBuffer(false),
 pitchModulationActive(false),
-bypassState(false)
+bypassState(false),
+voiceRenderJob(*this)
 {
 	setVoiceLimit(numVoices);
 
+	voicesForNoteOn.ensureStorageAllocated(NUM_POLYPHONIC_VOICES);
+
 	
 
 	for (int i = 0; i < 4; i++)
@@ -368,6 +371,7 @@ void ModulatorSynth::renderNextBlockWithModulators(AudioSampleBuffer& outputBuff
 
 	processHiseEventBuffer(inputMidiBuffer, numSamplesFixed);
 
+	prepareForUpcomingEvents(midiProcessorChain->getFutureEvents(), numSamplesFixed);
 	
 	midiInputFlag = !eventBuffer.isEmpty();
 
@@ -477,6 +481,9 @@ void ModulatorSynth::renderVoice(int startSample, int numThisTime)
 {
     ADD_GLITCH_DETECTOR(this, DebugLogger::Location::SynthVoiceRendering);
     
+	if (renderVoicesInParallel(startSample, numThisTime))
+		return;
+
 	for (int i = 0; i < activeVoices.size(); i++)
 	{
 		//jassert(!activeVoices[i]->isInactive());
@@ -485,11 +492,90 @@ void ModulatorSynth::renderVoice(int startSample, int numThisTime)
 
 		if (activeVoices[i]->isInactive())
 		{
+			eventIdVoices.removeVoice(activeVoices[i]->getVoiceIndex());
 			activeVoices.removeElement(i--);
 		}
 	}
 };
 
+int ModulatorSynth::getMaxNumVoicePartitions() const
+{
+	if (auto pool = getMainController()->getAudioWorkerPool())
+		return pool->getNumWorkers() + 1;
+
+	return 1;
+}
+
+bool ModulatorSynth::renderVoicesInParallel(int startSample, int numThisTime)
+{
+	// Below this amount the synchronisation of the workers costs more than it saves
+	static const int minNumVoicesPerPartition = 8;
+
+	auto pool = getMainController()->getAudioWorkerPool();
+
+	if (pool == nullptr || pool->isBusy() || !canRenderVoicesInParallel())
+		return false;
+
+	if (!isChainDisabled(EffectChain) && effectChain->hasActiveVoiceEffects())
+		return false;
+
+	const int numPartitions = jmin<int>(activeVoices.size() / minNumVoicesPerPartition, getMaxNumVoicePartitions(), voicePartitionBuffers.size() + 1);
+
+	if (numPartitions < 2)
+		return false;
+
+	// The first partition is rendered directly into the internal buffer
+	for (int i = 0; i < numPartitions - 1; i++)
+	{
+		auto b = voicePartitionBuffers[i];
+
+		b->setSize(internalBuffer.getNumChannels(), internalBuffer.getNumSamples(), false, false, true);
+
+		for (int c = 0; c < b->getNumChannels(); c++)
+			FloatVectorOperations::clear(b->getWritePointer(c, startSample), numThisTime);
+	}
+
+	for (int i = 0; i < activeVoices.size(); i++)
+		activeVoices[i]->prepareForParallelRendering(i % numPartitions, startSample, numThisTime);
+
+	voiceRenderJob.numPartitions = numPartitions;
+	voiceRenderJob.startSample = startSample;
+	voiceRenderJob.numSamples = numThisTime;
+
+	if (!pool->renderParallel(voiceRenderJob, numPartitions))
+	{
+		for (int i = 0; i < numPartitions; i++)
+			voiceRenderJob.renderPart(i);
+	}
+
+	// Add the partitions in a fixed order so that the result doesn't depend on the scheduling
+	for (int i = 0; i < numPartitions - 1; i++)
+	{
+		for (int c = 0; c < internalBuffer.getNumChannels(); c++)
+			FloatVectorOperations::add(internalBuffer.getWritePointer(c, startSample), voicePartitionBuffers[i]->getReadPointer(c, startSample), numThisTime);
+	}
+
+	for (int i = 0; i < activeVoices.size(); i++)
+	{
+		activeVoices[i]->finishParallelRendering();
+
+		if (activeVoices[i]->isInactive())
+		{
+			eventIdVoices.removeVoice(activeVoices[i]->getVoiceIndex());
+			activeVoices.removeElement(i--);
+		}
+	}
+
+	return true;
+}
+
+void ModulatorSynth::VoiceRenderJob::renderPart(int partIndex)
+{
+	AudioSampleBuffer& b = partIndex == 0 ? parent.internalBuffer : *parent.voicePartitionBuffers[partIndex - 1];
+
+	for (int i = partIndex; i < parent.activeVoices.size(); i += numPartitions)
+		parent.activeVoices[i]->renderNextBlock(b, startSample, numSamples);
+}
 	
 void ModulatorSynth::postVoiceRendering(int startSample, int numThisTime)
 {
@@ -498,10 +584,12 @@ void ModulatorSynth::postVoiceRendering(int startSample, int numThisTime)
 
 	CHECK_AND_LOG_BUFFER_DATA_WITH_ID(this, getIDAsIdentifier(), DebugLogger::Location::SynthPostVoiceRenderingGainMod, gainBuffer.getReadPointer(0, startSample), true, numThisTime);
 
+	const ModulationShape& gainShape = gainChain->getTimeVariantShape();
+
 	// Apply all gain modulators to the rendered voices
 	for (int i = 0; i < internalBuffer.getNumChannels(); i++)
 	{
-		FloatVectorOperations::multiply(internalBuffer.getWritePointer(i, startSample), gainBuffer.getReadPointer(0, startSample), numThisTime);
+		gainShape.applyTo(internalBuffer.getWritePointer(i, startSample), gainBuffer.getReadPointer(0, startSample), numThisTime);
 
 		CHECK_AND_LOG_BUFFER_DATA_WITH_ID(this, getIDAsIdentifier(), DebugLogger::Location::SynthPostVoiceRendering, internalBuffer.getReadPointer(i, startSample), i % 2 != 0, numThisTime);
 	}
@@ -640,30 +728,30 @@ void ModulatorSynth::handleVolumeFade(int eventId, int fadeTimeMilliseconds, flo
 {
 	const double fadeTimeSeconds = (double)fadeTimeMilliseconds / 1000.0;
 
-	for (int i = voices.size(); --i >= 0;)
+	eventIdVoices.forEachVoice((uint16)eventId, [&](int voiceIndex)
 	{
-		ModulatorSynthVoice *v = static_cast<ModulatorSynthVoice*>(voices[i]);
+		ModulatorSynthVoice *v = static_cast<ModulatorSynthVoice*>(voices[voiceIndex]);
 
 		if (!v->isInactive() && v->getCurrentHiseEvent().getEventId() == eventId)
 		{
 			v->setVolumeFade(fadeTimeSeconds, targetGain);
 		}
-	}
+	});
 }
 
 void ModulatorSynth::handlePitchFade(uint16 eventId, int fadeTimeMilliseconds, double pitchFactor)
 {
 	const double fadeTimeSeconds = (double)fadeTimeMilliseconds / 1000.0;
 
-	for (int i = voices.size(); --i >= 0;)
+	eventIdVoices.forEachVoice(eventId, [&](int voiceIndex)
 	{
-		ModulatorSynthVoice *v = static_cast<ModulatorSynthVoice*>(voices[i]);
+		ModulatorSynthVoice *v = static_cast<ModulatorSynthVoice*>(voices[voiceIndex]);
 
 		if (!v->isInactive() && v->getCurrentHiseEvent().getEventId() == eventId)
 		{
 			v->setPitchFade(fadeTimeSeconds, pitchFactor);
 		}
-	}
+	});
 }
 
 void ModulatorSynth::preHiseEventCallback(const HiseEvent &e)
@@ -697,6 +785,7 @@ void ModulatorSynth::startVoiceWithHiseEvent(ModulatorSynthVoice* voice, Synthes
 	//jassert(!activeVoices.contains(voice));
 
 	activeVoices.insert(voice);
+	eventIdVoices.addVoice(voice->getVoiceIndex(), e.getEventId());
 
 	Synthesiser::startVoice(static_cast<SynthesiserVoice*>(voice), sound, e.getChannel(), e.getNoteNumber(), e.getFloatVelocity());
 }
@@ -732,6 +821,12 @@ void ModulatorSynth::prepareToPlay(double newSampleRate, int samplesPerBlock)
  			static_cast<ModulatorSynthVoice*>(getVoice(i))->prepareToPlay(newSampleRate, samplesPerBlock);
 		}
 
+		while (voicePartitionBuffers.size() < getMaxNumVoicePartitions() - 1)
+			voicePartitionBuffers.add(new AudioSampleBuffer());
+
+		for (auto b : voicePartitionBuffers)
+			b->setSize(internalBuffer.getNumChannels(), samplesPerBlock, false, false, true);
+
 		vuMerger.limitFromBlockSizeToFrameRate(newSampleRate, samplesPerBlock);
 
 		Synthesiser::setCurrentPlaybackSampleRate(newSampleRate);
@@ -839,61 +934,100 @@ void ModulatorSynth::noteOn(const HiseEvent &m)
 	const bool retriggerWithDifferentChannels = getMainController()->getMacroManager().getMidiControlAutomationHandler()->getMPEData().isMpeEnabled();
 
 	const int midiChannel = m.getChannel();
-	const int midiNoteNumber = m.getNoteNumber();
-	const int transposedMidiNoteNumber = midiNoteNumber + m.getTransposeAmount();
+	const int transposedMidiNoteNumber = m.getNoteNumber() + m.getTransposeAmount();
 	const float velocity = m.getFloatVelocity();
 
+	if (auto candidates = getSoundsForNoteOn(transposedMidiNoteNumber))
+	{
+		for (int i = candidates->size(); --i >= 0;)
+		{
+			ModulatorSynthSound *sound = candidates->getUnchecked(i);
+
+			if (soundCanBePlayed(sound, midiChannel, transposedMidiNoteNumber, velocity))
+				startNoteForSound(sound, m, retriggerWithDifferentChannels);
+		}
+
+		return;
+	}
+
     for (int i = sounds.size(); --i >= 0;)
     {
 		SynthesiserSound *s = sounds.getUnchecked(i);
         ModulatorSynthSound *sound = static_cast<ModulatorSynthSound*>(s);
 
 		if (soundCanBePlayed(sound, midiChannel, transposedMidiNoteNumber, velocity))
-        {
-            // If hitting a note that's still ringing, stop it first (it could be
-            // still playing because of the sustain or sostenuto pedal).
-            for (int j = voices.size(); --j >= 0;)
-            {
-                ModulatorSynthVoice* const voice = static_cast<ModulatorSynthVoice*>(voices.getUnchecked (j));
+			startNoteForSound(sound, m, retriggerWithDifferentChannels);
+	}
+}
 
-				const bool voiceIsActive = voice->isPlayingChannel(midiChannel) && !voice->isBeingKilled();
+void ModulatorSynth::collectVoicesForNoteOn(int midiNoteNumber)
+{
+	voicesForNoteOn.clearQuick();
 
-				// if the voiceLimit is reached, kill the voice!
+	for (int i = 0; i < activeVoices.size(); i++)
+	{
+		ModulatorSynthVoice* voice = activeVoices[i];
 
-				if(voiceIsActive && j >= (internalVoiceLimit - 1)) 
-				{
-					killLastVoice();
-				}
+		if (voice->getVoiceIndex() >= (internalVoiceLimit - 1) || voice->getCurrentlyPlayingNote() == midiNoteNumber)
+			voicesForNoteOn.add(voice);
+	}
 
-                else if (voice->getCurrentlyPlayingNote() == midiNoteNumber // Use the untransposed number for detecting repeated notes
-                     && (retriggerWithDifferentChannels || voice->isPlayingChannel (midiChannel)) 
-					 && !(voice->getCurrentHiseEvent() == m))
-				{
-					handleRetriggeredNote(voice);
-				}
-            }
+	std::sort(voicesForNoteOn.begin(), voicesForNoteOn.end(), [](ModulatorSynthVoice* a, ModulatorSynthVoice* b)
+	{
+		return a->getVoiceIndex() > b->getVoiceIndex();
+	});
+}
 
-			ModulatorSynthVoice *v = static_cast<ModulatorSynthVoice*>(findFreeVoice (sound, midiChannel, midiNoteNumber, isNoteStealingEnabled()));
+void ModulatorSynth::startNoteForSound(ModulatorSynthSound* sound, const HiseEvent& m, bool retriggerWithDifferentChannels)
+{
+	const int midiChannel = m.getChannel();
+	const int midiNoteNumber = m.getNoteNumber();
+	const int transposedMidiNoteNumber = midiNoteNumber + m.getTransposeAmount();
 
-			if( v != nullptr)
-			{
-				const int voiceIndex = v->getVoiceIndex();
+	// If hitting a note that's still ringing, stop it first (it could be
+	// still playing because of the sustain or sostenuto pedal).
+	collectVoicesForNoteOn(midiNoteNumber);
+
+	for (auto voice : voicesForNoteOn)
+	{
+		const int j = voice->getVoiceIndex();
 
-				jassert(voiceIndex != -1);
+		const bool voiceIsActive = voice->isPlayingChannel(midiChannel) && !voice->isBeingKilled();
 
-				v->setStartUptime(getMainController()->getUptime());
+		// if the voiceLimit is reached, kill the voice!
 
-				v->setCurrentHiseEvent(m);
+		if(voiceIsActive && j >= (internalVoiceLimit - 1)) 
+		{
+			killLastVoice();
+		}
 
-				preStartVoice(voiceIndex, transposedMidiNoteNumber);
+		else if (voice->getCurrentlyPlayingNote() == midiNoteNumber // Use the untransposed number for detecting repeated notes
+				&& (retriggerWithDifferentChannels || voice->isPlayingChannel (midiChannel)) 
+				&& !(voice->getCurrentHiseEvent() == m))
+		{
+			handleRetriggeredNote(voice);
+		}
+	}
 
-				startVoiceWithHiseEvent (v, sound, m);
-			}
+	ModulatorSynthVoice *v = static_cast<ModulatorSynthVoice*>(findFreeVoice (sound, midiChannel, midiNoteNumber, isNoteStealingEnabled()));
 
-			// Deactivates starting of more than one voice per synth
-			//break;
-        }
+	if( v != nullptr)
+	{
+		const int voiceIndex = v->getVoiceIndex();
+
+		jassert(voiceIndex != -1);
+
+		v->setStartUptime(getMainController()->getUptime());
+
+		v->setCurrentHiseEvent(m);
+
+		preStartVoice(voiceIndex, transposedMidiNoteNumber);
+
+		startVoiceWithHiseEvent (v, sound, m);
 	}
+
+	// Deactivates starting of more than one voice per synth
+	//break;
 }
 
 void ModulatorSynth::noteOn(int midiChannel, int midiNoteNumber, float velocity)
@@ -914,11 +1048,12 @@ void ModulatorSynth::noteOff(const HiseEvent &m)
 
 	jassert(eventId != 0);
 
-	for (int i = voices.size(); --i >= 0;)
+	// Only the voices that were started with this event ID are checked
+	eventIdVoices.forEachVoice(eventId, [&](int voiceIndex)
 	{
-		SynthesiserVoice* const voice = voices.getUnchecked(i);
+		SynthesiserVoice* const voice = voices.getUnchecked(voiceIndex);
 
-		ModulatorSynthVoice* const mvoice = static_cast<ModulatorSynthVoice*>(voices.getUnchecked(i));
+		ModulatorSynthVoice* const mvoice = static_cast<ModulatorSynthVoice*>(voice);
 
 		if (mvoice->getCurrentHiseEvent().getEventId() == eventId
 			&& voice->isPlayingChannel(midiChannel))
@@ -934,7 +1069,7 @@ void ModulatorSynth::noteOff(const HiseEvent &m)
 				}
 			}
 		}
-	}
+	});
 }
 
 int ModulatorSynth::getVoiceIndex(const SynthesiserVoice *v) const
@@ -1042,6 +1177,34 @@ void ModulatorSynthVoice::resetVoice()
 	currentHiseEvent = HiseEvent();
 }
 
+void ModulatorSynthVoice::prepareForParallelRendering(int /*partitionIndex*/, int startSample, int numSamples)
+{
+	if (isActive)
+	{
+		if (isPitchModulationActive()) calculateVoicePitchValues(startSample, numSamples);
+
+		getOwnerSynth()->calculateGainValuesForVoice(voiceIndex, scriptGainValue, startSample, numSamples);
+	}
+
+	resetIsPending = false;
+	renderedInParallel = true;
+}
+
+void ModulatorSynthVoice::finishParallelRendering()
+{
+	renderedInParallel = false;
+
+	if (resetIsPending)
+	{
+		resetIsPending = false;
+		resetVoice();
+	}
+	else if (isActive)
+	{
+		checkRelease();
+	}
+}
+
 void ModulatorSynthVoice::checkRelease()
 {
 	ModulatorSynth *os = getOwnerSynth();
@@ -1188,6 +1351,7 @@ void ModulatorSynth::deleteAllVoices()
 {
 	ScopedLock sl(lock);
 	activeVoices.clear();
+	eventIdVoices.clear();
 	lastStartedVoice = nullptr;
 	clearVoices();
 }
@@ -1203,6 +1367,7 @@ void ModulatorSynth::resetAllVoices()
 
 	lastStartedVoice = nullptr;
 	activeVoices.clear();
+	eventIdVoices.clear();
 }
 
 void ModulatorSynth::killAllVoices()
@@ -1255,7 +1420,8 @@ void ModulatorSynthVoice::renderNextBlock (AudioSampleBuffer& outputBuffer, int
 {
 	if (isActive)
     { 
-		if(isPitchModulationActive()) calculateVoicePitchValues(startSample, numSamples);
+		// In parallel mode the modulation is calculated in prepareForParallelRendering()
+		if(isPitchModulationActive() && !renderedInParallel) calculateVoicePitchValues(startSample, numSamples);
 
 		calculateBlock(startSample, numSamples);
 
@@ -1283,7 +1449,7 @@ void ModulatorSynthVoice::renderNextBlock (AudioSampleBuffer& outputBuffer, int
 
 
 		// checks if any envelopes are active and in their release state and calls stopNote until they are finished.
-		checkRelease();
+		if (!renderedInParallel) checkRelease();
     }
 }
 
@@ -158,9 +158,22 @@ public:
 	/** This method is called to handle all modulatorchains just before the voice rendering. */
 	virtual void preVoiceRendering(int startSample, int numThisTime);;
 
-	/** This method is called to actually render all voices. It operates on the internal buffer of the ModulatorSynth. */
+	/** This method is called to actually render all voices. It operates on the internal buffer of the ModulatorSynth. 
+	*
+	*	If the synth supports it and there is an AudioWorkerPool, the active voices are split into partitions and rendered in parallel.
+	*/
 	void renderVoice(int startSample, int numThisTime);
 
+	/** Overwrite this and return true if the calculateBlock() method of the voices can be called from different threads at the same time.
+	*
+	*	The voice modulation is calculated before the parallel rendering, so the voices must only use getVoiceGainValues() and
+	*	getVoicePitchValues() and must not access any other state of the synth that is shared between the voices.
+	*/
+	virtual bool canRenderVoicesInParallel() const { return false; }
+
+	/** Returns the maximum number of voice partitions that are rendered in parallel (1 if there is no AudioWorkerPool). */
+	int getMaxNumVoicePartitions() const;
+
 	/** This method is called to handle all modulatorchains after the voice rendering and handles the GUI metering. It assumes stereo mode.
 	*
 	*	The rendered buffer is supplied as reference to be able to apply changes here after all voices are rendered (eg. gain).
@@ -194,6 +207,14 @@ public:
 	void handlePitchFade(uint16 eventId, int fadeTimeMilliseconds, double pitchFactor);
 
 	virtual void preHiseEventCallback(const HiseEvent &e);
+
+	/** This will be called with the events that are scheduled after the current block.
+	*
+	*	The timestamps are relative to the start of the next block, so the events below numSamples will be processed in
+	*	the next block. Override this if you need to prepare something for the voices that are about to be started
+	*	(the ModulatorSampler uses this to prefetch the streaming regions of the sounds).
+	*/
+	virtual void prepareForUpcomingEvents(const HiseEventBuffer &/*futureEvents*/, int /*numSamples*/) {};
 	virtual void preStartVoice(int voiceIndex, int noteNumber);
 
 	/** This sets up the synth and the ModulatorChains. 
@@ -258,6 +279,13 @@ public:
 		/** Checks if the message fits the sound, but can be overriden to implement other group start logic. */
 	virtual bool soundCanBePlayed(ModulatorSynthSound *sound, int midiChannel, int midiNoteNumber, float velocity);
 
+	/** Returns the sounds that need to be checked with soundCanBePlayed() for the given note number.
+	*
+	*	The list must contain every sound that can be played for this note in the order of the sound array.
+	*	The default implementation returns nullptr, which means that every sound is checked.
+	*/
+	virtual const Array<ModulatorSynthSound*>* getSoundsForNoteOn(int /*midiNoteNumber*/) const { return nullptr; }
+
 	void startVoiceWithHiseEvent(ModulatorSynthVoice* voice, SynthesiserSound *sound, const HiseEvent &e);
 
 	/** Same functionality as Synthesiser::noteOn(), but calls calculateVoiceStartValue() if a new voice is started. */
@@ -378,14 +406,30 @@ public:
 		return gainData;
 	};
 
-	/** calculates the voice pitch values. You can get the values with getPitchValues for voice. */
-	void calculatePitchValuesForVoice(int voiceIndex, float scriptPitchValue, int startSample, int numSamples)
+	/** calculates the voice pitch values. You can get the values with getPitchValues for voice.
+	*
+	*	@returns the shape of the calculated pitch values.
+	*/
+	ModulationShape calculatePitchValuesForVoice(int voiceIndex, float scriptPitchValue, int startSample, int numSamples)
 	{
         pitchChain->renderVoice(voiceIndex, startSample, numSamples);
 		float *voicePitchValues = pitchChain->getVoiceValues(voiceIndex);
-		const float *timeVariantPitchValues = getConstantPitchValues();
-		FloatVectorOperations::multiply(voicePitchValues, timeVariantPitchValues, startSample + numSamples);
-		if (scriptPitchValue != 1.0f) FloatVectorOperations::multiply(voicePitchValues, scriptPitchValue, startSample + numSamples);
+		const ModulationShape& timeVariantShape = pitchChain->getTimeVariantShape();
+
+		if (timeVariantShape.isConstant())
+		{
+			// Merge the constant time variant pitch with the script pitch to save one multiplication
+			const float factor = timeVariantShape.getConstantValue() * scriptPitchValue;
+			if (factor != 1.0f) FloatVectorOperations::multiply(voicePitchValues, factor, startSample + numSamples);
+		}
+		else
+		{
+			const float *timeVariantPitchValues = getConstantPitchValues();
+			FloatVectorOperations::multiply(voicePitchValues, timeVariantPitchValues, startSample + numSamples);
+			if (scriptPitchValue != 1.0f) FloatVectorOperations::multiply(voicePitchValues, scriptPitchValue, startSample + numSamples);
+		}
+
+		return pitchChain->getVoiceShape(voiceIndex) * timeVariantShape * scriptPitchValue;
 	}
 
 	/** Returns a read pointer to the calculated pitch values. */
@@ -436,6 +480,9 @@ protected:
 
 	VoiceStack activeVoices;
 
+	/** The voices of each event ID. This is used to find the voices for note offs and fade events. */
+	EventIdVoiceTable eventIdVoices;
+
 private:
 
 	
@@ -482,6 +529,44 @@ private:
 
 	// ===================================================================================================================
 
+	/** Renders every n-th active voice into the buffer of its partition on a worker of the AudioWorkerPool. */
+	struct VoiceRenderJob : public AudioWorkerPool::Job
+	{
+		VoiceRenderJob(ModulatorSynth& parent_) :
+			parent(parent_)
+		{}
+
+		void renderPart(int partIndex) override;
+
+		ModulatorSynth& parent;
+		int numPartitions = 0;
+		int startSample = 0;
+		int numSamples = 0;
+	};
+
+	/** Renders the active voices in parallel and adds the partition buffers to the internal buffer.
+	*
+	*	Returns false if the voices should be rendered serially (no pool, not enough voices or voice effects that can't run in parallel).
+	*/
+	bool renderVoicesInParallel(int startSample, int numThisTime);
+
+	VoiceRenderJob voiceRenderJob;
+	OwnedArray<AudioSampleBuffer> voicePartitionBuffers;
+
+	/** Collects the voices that need to be checked for a new note on in descending voice index order.
+	*
+	*	These are the active voices that play the same note or that exceed the voice limit. Voices that are not in
+	*	activeVoices can't be playing anything, so this is much faster than checking every voice.
+	*/
+	void collectVoicesForNoteOn(int midiNoteNumber);
+
+	/** Starts a voice for the sound and takes care of retriggered notes and the voice limit. */
+	void startNoteForSound(ModulatorSynthSound* sound, const HiseEvent& m, bool retriggerWithDifferentChannels);
+
+	Array<ModulatorSynthVoice*> voicesForNoteOn;
+
+	// ===================================================================================================================
+
 	JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(ModulatorSynth)
 	
 };
@@ -528,10 +613,12 @@ public:
 	
 	void calculateVoicePitchValues(int startSample, int numSamples)
 	{
-		getOwnerSynth()->calculatePitchValuesForVoice(voiceIndex, (float)scriptPitchValue, startSample, numSamples);
+		pitchShape = getOwnerSynth()->calculatePitchValuesForVoice(voiceIndex, (float)scriptPitchValue, startSample, numSamples);
 
 		if (pitchFader.isSmoothing())
 		{
+			pitchShape = ModulationShape();
+
 			float* pitchValues = getVoicePitchValues() + startSample;
 
 			float eventPitchFactorFloat = (float)eventPitchFactor;
@@ -547,9 +634,23 @@ public:
 			float* pitchValues = getVoicePitchValues() + startSample;
 
 			FloatVectorOperations::multiply(pitchValues, (float)eventPitchFactor, numSamples);
+
+			pitchShape = pitchShape * (float)eventPitchFactor;
 		}
 	}
 
+	/** Returns the shape of the pitch values that were calculated in calculateVoicePitchValues(). */
+	const ModulationShape& getVoicePitchShape() const noexcept { return pitchShape; }
+
+	/** Call this if you change the pitch values of this voice after calculateVoicePitchValues(). */
+	void setVoicePitchShape(const ModulationShape& newShape) noexcept { pitchShape = newShape; }
+
+	/** Returns the shape of the gain values. Call this after getVoiceGainValues(). */
+	ModulationShape getVoiceGainShape() const noexcept
+	{
+		return getOwnerSynth()->gainChain->getVoiceShape(voiceIndex) * scriptGainValue;
+	}
+
 	
 
 	float *getVoicePitchValues() 
@@ -559,9 +660,22 @@ public:
 
 	const float *getVoiceGainValues(int startSample, int numSamples)
 	{
+		// The values were already calculated in prepareForParallelRendering()
+		if (renderedInParallel)
+			return getOwnerSynth()->gainChain->getVoiceValues(voiceIndex);
+
 		return getOwnerSynth()->calculateGainValuesForVoice(voiceIndex, scriptGainValue, startSample, numSamples);
 	}
 
+	/** Use this instead of resetVoice() in the calculateBlock() method. It defers the reset until the parallel rendering is finished. */
+	void resetVoiceFromRenderCallback()
+	{
+		if (renderedInParallel)
+			resetIsPending = true;
+		else
+			resetVoice();
+	}
+
 	/** This only checks if the sound is valid, but you can override this with the desired behaviour. */
 	virtual bool canPlaySound(SynthesiserSound *s) override
 	{
@@ -621,6 +735,16 @@ public:
 
 	virtual void resetVoice();
 
+	/** Calculates the voice modulation before the voice is rendered on another thread.
+	*
+	*	The ModulatorChains use shared buffers, so this is called serially for every voice before the parallel rendering starts.
+	*	Overwrite this if the voice needs to prepare its own state for the partition (but call the base class method).
+	*/
+	virtual void prepareForParallelRendering(int partitionIndex, int startSample, int numSamples);
+
+	/** Finishes the parallel rendering and resets the voice or checks for its release on the audio thread. */
+	void finishParallelRendering();
+
 	bool isInactive() const noexcept
 	{
         return !isActive; //uptimeDelta == 0.0;
@@ -791,6 +915,8 @@ protected:
 	float scriptGainValue = 1.0f;
 	double scriptPitchValue = 1.0;
 
+	ModulationShape pitchShape;
+
 	double eventPitchFactor = 1.0;
 	float eventGainFactor = 1.0f;
 
@@ -806,6 +932,9 @@ private:
 	bool pitchModulationActive = false;
 	bool scriptPitchActive = false;
 
+	bool renderedInParallel = false;
+	bool resetIsPending = false;
+
 	friend class ModulatorSynthGroupVoice;
 
 	bool killThisVoice;
@@ -40,7 +40,8 @@ ModulatorSynthChain::ModulatorSynthChain(MainController *mc, const String &id, i
 #endif
 	numVoices(numVoices_),
 	handler(this),
-	vuValue(0.0f)
+	vuValue(0.0f),
+	childSynthRenderJob(*this)
 {
 #if USE_BACKEND == 0
 	ignoreUnused(viewUndoManager);
@@ -121,6 +122,41 @@ void ModulatorSynthChain::prepareToPlay(double newSampleRate, int samplesPerBloc
 	ModulatorSynth::prepareToPlay(newSampleRate, samplesPerBlock);
 
 	for (int i = 0; i < synths.size(); i++) synths[i]->prepareToPlay(newSampleRate, samplesPerBlock);
+
+	updateChildSynthBuffers();
+}
+
+void ModulatorSynthChain::updateChildSynthBuffers()
+{
+	if (getMainController()->getAudioWorkerPool() == nullptr)
+		return;
+
+	while (childSynthBuffers.size() < synths.size())
+		childSynthBuffers.add(new AudioSampleBuffer());
+
+	for (auto b : childSynthBuffers)
+		b->setSize(getMatrix().getNumSourceChannels(), getLargestBlockSize(), false, false, true);
+
+	parallelSynthIndexes.ensureStorageAllocated(synths.size());
+	serialSynthIndexes.ensureStorageAllocated(synths.size());
+
+	while (childSynthDependencies.size() < synths.size())
+		childSynthDependencies.add(true);
+
+	dependencyGeneration = -1;
+}
+
+void ModulatorSynthChain::updateChildSynthDependencies()
+{
+	const int currentGeneration = getMainController()->getProcessorTreeGeneration();
+
+	if (currentGeneration == dependencyGeneration)
+		return;
+
+	for (int i = 0; i < synths.size(); i++)
+		childSynthDependencies.setUnchecked(i, hasCrossSynthDependencies(synths[i]));
+
+	dependencyGeneration = currentGeneration;
 }
 
 void ModulatorSynthChain::numSourceChannelsChanged()
@@ -243,7 +279,10 @@ void ModulatorSynthChain::renderNextBlockWithModulators(AudioSampleBuffer &buffe
 	internalBuffer.setSize(getMatrix().getNumSourceChannels(), numSamples, true, false, true);
 
 	// Process the Synths and add store their output in the internal buffer
-	for (int i = 0; i < synths.size(); i++) if (!synths[i]->isSoftBypassed()) synths[i]->renderNextBlockWithModulators(internalBuffer, eventBuffer);
+	if (!renderChildSynthsInParallel(numSamples))
+	{
+		for (int i = 0; i < synths.size(); i++) if (!synths[i]->isSoftBypassed()) synths[i]->renderNextBlockWithModulators(internalBuffer, eventBuffer);
+	}
 
 	HiseEventBuffer::Iterator eventIterator(eventBuffer);
 
@@ -308,6 +347,91 @@ void ModulatorSynthChain::renderNextBlockWithModulators(AudioSampleBuffer &buffe
 }
 
 
+bool ModulatorSynthChain::renderChildSynthsInParallel(int numSamples)
+{
+	auto pool = getMainController()->getAudioWorkerPool();
+
+	if (pool == nullptr || childSynthBuffers.size() < synths.size() || childSynthDependencies.size() < synths.size())
+		return false;
+
+	updateChildSynthDependencies();
+
+	parallelSynthIndexes.clearQuick();
+	serialSynthIndexes.clearQuick();
+
+	for (int i = 0; i < synths.size(); i++)
+	{
+		if (synths[i]->isSoftBypassed())
+			continue;
+
+		if (childSynthDependencies[i])
+			serialSynthIndexes.add(i);
+		else
+			parallelSynthIndexes.add(i);
+	}
+
+	if (parallelSynthIndexes.size() < 2)
+		return false;
+
+	const int numChannels = internalBuffer.getNumChannels();
+
+	for (int i = 0; i < synths.size(); i++)
+	{
+		childSynthBuffers[i]->setSize(numChannels, numSamples, false, false, true);
+		childSynthBuffers[i]->clear();
+	}
+
+	for (auto i : serialSynthIndexes)
+		synths[i]->renderNextBlockWithModulators(*childSynthBuffers[i], eventBuffer);
+
+	if (!pool->renderParallel(childSynthRenderJob, parallelSynthIndexes.size()))
+	{
+		// The pool is busy (this is a nested container that is rendered by a worker)
+		for (auto i : parallelSynthIndexes)
+			synths[i]->renderNextBlockWithModulators(*childSynthBuffers[i], eventBuffer);
+	}
+
+	for (int i = 0; i < synths.size(); i++)
+	{
+		if (synths[i]->isSoftBypassed())
+			continue;
+
+		for (int c = 0; c < numChannels; c++)
+			FloatVectorOperations::add(internalBuffer.getWritePointer(c, 0), childSynthBuffers[i]->getReadPointer(c, 0), numSamples);
+	}
+
+	return true;
+}
+
+bool ModulatorSynthChain::hasCrossSynthDependencies(const Processor* p)
+{
+	// The global modulators are used by other synths and scripts can access any other module
+	if (dynamic_cast<const GlobalModulatorContainer*>(p) != nullptr ||
+		dynamic_cast<const JavascriptProcessor*>(p) != nullptr ||
+		dynamic_cast<const ScriptBaseMidiProcessor*>(p) != nullptr)
+	{
+		return true;
+	}
+
+	for (int i = 0; i < p->getNumChildProcessors(); i++)
+	{
+		if (auto c = p->getChildProcessor(i))
+		{
+			if (hasCrossSynthDependencies(c))
+				return true;
+		}
+	}
+
+	return false;
+}
+
+void ModulatorSynthChain::ChildSynthRenderJob::renderPart(int partIndex)
+{
+	const int synthIndex = parent.parallelSynthIndexes[partIndex];
+
+	parent.synths[synthIndex]->renderNextBlockWithModulators(*parent.childSynthBuffers[synthIndex], parent.eventBuffer);
+}
+
 void ModulatorSynthChain::restoreFromValueTree(const ValueTree &v)
 {
 	packageName = v.getProperty("packageName", "");
@@ -534,6 +658,7 @@ void ModulatorSynthChain::ModulatorSynthChainHandler::add(Processor *newProcesso
 		MainController::ScopedSuspender ss(synth->getMainController());
 		ms->setIsOnAir(true);
 		synth->synths.insert(index, ms);
+		synth->updateChildSynthBuffers();
 	}
 
 	sendChangeMessage();
@@ -544,7 +669,14 @@ void ModulatorSynthChain::ModulatorSynthChainHandler::remove(Processor *processo
 	{
 		auto& tmp = synth;
 
-		auto f = [tmp, removeSynth](Processor* p) { tmp->synths.removeObject(dynamic_cast<ModulatorSynth*>(p), removeSynth); return true; };
+		auto f = [tmp, removeSynth](Processor* p) 
+		{ 
+			tmp->synths.removeObject(dynamic_cast<ModulatorSynth*>(p), removeSynth); 
+
+			// The indexes of the cached dependencies have changed
+			tmp->getMainController()->processorTreeChanged();
+			return true; 
+		};
 
 		synth->getMainController()->getKillStateHandler().killVoicesAndCall(processorToBeRemoved, f, MainController::KillStateHandler::TargetThread::MessageThread);
 		
@@ -169,7 +169,7 @@ public:
     /** This renders the child synths:
 	*
 	*	- processes the MidiBuffer of the ModulatorSynthChain
-	*	- calls the renderNextBlockWithModulators on the child synths
+	*	- calls the renderNextBlockWithModulators on the child synths (in parallel if there is an AudioWorkerPool)
 	*	- applies the time-variant gain modulators (no midi support!)
 	*	- applies the gain of the chain.
 	*/
@@ -231,11 +231,47 @@ public:
 
 private:
 
+	/** Renders one of the independent child synths on a worker of the AudioWorkerPool. */
+	struct ChildSynthRenderJob : public AudioWorkerPool::Job
+	{
+		ChildSynthRenderJob(ModulatorSynthChain& parent_) :
+			parent(parent_)
+		{}
+
+		void renderPart(int partIndex) override;
+
+		ModulatorSynthChain& parent;
+	};
+
+	/** Renders the child synths into their own buffers and adds them to the internal buffer.
+	*
+	*	Synths that interact with other synths are rendered first on the audio thread, then the others are rendered in parallel.
+	*	The buffers are added in the order of the synths, so the result doesn't depend on the scheduling of the workers.
+	*	Returns false if there are not enough independent synths and they should be rendered serially.
+	*/
+	bool renderChildSynthsInParallel(int numSamples);
+
+	/** Checks whether the processor (or one of its children) depends on other synths (eg. global modulators or scripts). */
+	static bool hasCrossSynthDependencies(const Processor* p);
+
+	/** Makes sure that there is a render buffer for every child synth. This must not be called while the audio is running. */
+	void updateChildSynthBuffers();
+
+	/** Checks the child synths for cross synth dependencies if the processor tree has changed since the last call. */
+	void updateChildSynthDependencies();
+
 	HiseEvent::ChannelFilterData activeChannels;
 	ModulatorSynthChainHandler handler;
 	int numVoices;
 	float vuValue;
 	OwnedArray<ModulatorSynth> synths;
+
+	ChildSynthRenderJob childSynthRenderJob;
+	OwnedArray<AudioSampleBuffer> childSynthBuffers;
+	Array<int> parallelSynthIndexes;
+	Array<int> serialSynthIndexes;
+	Array<bool> childSynthDependencies;
+	int dependencyGeneration = -1;
 	ScopedPointer<FactoryType> modulatorSynthFactory;
 	ScopedPointer<FactoryType::Constrainer> constrainer;
 	String packageName;
@@ -190,9 +190,10 @@ void ModulatorSynthGroupVoice::calculateBlock(int startSample, int numSamples)
 	getOwnerSynth()->effectChain->renderVoice(voiceIndex, voiceBuffer, startSample, numSamples);
 
 	const float *modValues = getVoiceGainValues(startSample, numSamples);
+	const ModulationShape gainShape = getVoiceGainShape();
 
-	FloatVectorOperations::multiply(voiceBuffer.getWritePointer(0, startSample), modValues + startSample, numSamples);
-	FloatVectorOperations::multiply(voiceBuffer.getWritePointer(1, startSample), modValues + startSample, numSamples);
+	gainShape.applyTo(voiceBuffer.getWritePointer(0, startSample), modValues + startSample, numSamples);
+	gainShape.applyTo(voiceBuffer.getWritePointer(1, startSample), modValues + startSample, numSamples);
 };
 
 
@@ -247,6 +248,7 @@ void ModulatorSynthGroupVoice::calculateNoFMVoiceInternal(ModulatorSynth* childS
 		if (childPitchValues != nullptr && voicePitchValues != nullptr)
 		{
 			FloatVectorOperations::multiply(childPitchValues + startSample, voicePitchValues + startSample, detuneValues.multiplier, numSamples);
+			childVoice->setVoicePitchShape(childVoice->getVoicePitchShape() * getVoicePitchShape() * detuneValues.multiplier);
 		}
 
 		childVoice->calculateBlock(startSample, numSamples);
@@ -359,6 +361,7 @@ void ModulatorSynthGroupVoice::calculateFMBlock(ModulatorSynthGroup * group, int
 	if (voicePitchValues != nullptr && modPitchValues != nullptr)
 	{
 		FloatVectorOperations::multiply(modPitchValues + startSample, voicePitchValues + startSample, numSamples);
+		modVoice->setVoicePitchShape(modVoice->getVoicePitchShape() * getVoicePitchShape());
 	}
 
 	modVoice->calculateBlock(startSample, numSamples);
@@ -439,6 +442,7 @@ void ModulatorSynthGroupVoice::calculateFMCarrierInternal(ModulatorSynthGroup *
 
 		// This is the magic FM command
 		FloatVectorOperations::multiply(carrierPitchValues + startSample, fmModBuffer, numSamples);
+		carrierVoice->setVoicePitchShape(ModulationShape());
 
 #if JUCE_WINDOWS
 		FloatVectorOperations::clip(carrierPitchValues + startSample, carrierPitchValues + startSample, 0.00000001f, 1000.0f, numSamples);
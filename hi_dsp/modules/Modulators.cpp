@@ -159,6 +159,8 @@ void TimeModulation::renderNextBlock(AudioSampleBuffer &buffer, int startSample,
 	const int startIndex = startSample;
 	const int samplesToCopy = numSamples;
 
+	lastBlockWasConstant = false;
+
 	calculateBlock(startSample, numSamples);
 
 	lastConstantValue = internalBuffer.getSample(0, 0);
@@ -321,8 +321,42 @@ public:
 		return lastConstantValue;
 	}
 
+	/** Overwrite this and return true if the modulator can calculate its values at a reduced control rate.
+	*
+	*	If the ModulatorChain runs in control rate mode (see ModulatorChain::setControlRateDivider()), it will call calculateBlock()
+	*	with one value per control rate step and reconstruct the audio rate signal with linear ramps. Modulators that don't support this
+	*	are still rendered at audio rate.
+	*/
+	virtual bool supportsControlRate() const { return false; }
+
+	/** Sets the amount of audio samples that one calculated value represents. This is set by the ModulatorChain before rendering. */
+	void setControlRateDivider(int newDivider)
+	{
+		if (newDivider != controlRateDivider)
+		{
+			controlRateDivider = newDivider;
+			controlRateDividerChanged();
+		}
+	}
+
+	/** Returns the amount of audio samples that one calculated value represents (1 = audio rate). */
+	int getControlRateDivider() const noexcept { return controlRateDivider; }
+
+	/** Returns true if all values of the last rendered block were the same. */
+	bool isLastBlockConstant() const noexcept { return lastBlockWasConstant; }
+
 protected:
 
+	/** Call this in calculateBlock() if all values of the block are the same.
+	*
+	*	The ModulatorChain uses this information to skip per sample operations (see ModulationShape).
+	*	Don't call it if you override applyTimeModulation() with a varying intensity.
+	*/
+	void setBlockIsConstant() noexcept { lastBlockWasConstant = true; }
+
+	/** Overwrite this and recalculate every coefficient that depends on the sample rate. */
+	virtual void controlRateDividerChanged() {};
+
 	TimeModulation(Modulation::Mode m):
 		Modulation(m),
 		internalBuffer(1, 0)
@@ -367,6 +401,10 @@ private:
 
 	float lastConstantValue = 1.0f;
 
+	int controlRateDivider = 1;
+
+	bool lastBlockWasConstant = false;
+
 };
 
 
@@ -30,6 +30,7 @@
 
 #include "hi_lac.h"
 
+#include "hlac/SimdKernels.cpp"
 #include "hlac/BitCompressors.cpp"
 #include "hlac/CompressionHelpers.cpp"
 #include "hlac/SampleBuffer.cpp"
@@ -101,7 +101,26 @@ If enabled, then the unit test suite will be compiled and added to all unit test
 #define HLAC_INCLUDE_TEST_SUITE 0
 #endif
 
+//=============================================================================
+/** Config: HLAC_USE_SIMD_KERNELS
+
+If enabled, then the decoder uses the SSE4.1 / AVX2 / NEON kernels for the bit unpacking and sample conversion (the instruction set is detected at runtime).
+*/
+#ifndef HLAC_USE_SIMD_KERNELS
+#define HLAC_USE_SIMD_KERNELS 1
+#endif
+
+//=============================================================================
+/** Config: HLAC_NUM_CACHED_BLOCKS
+
+The number of decoded blocks that are cached by a memory mapped reader (one block uses 16KB). The other readers only cache two blocks.
+*/
+#ifndef HLAC_NUM_CACHED_BLOCKS
+#define HLAC_NUM_CACHED_BLOCKS 16
+#endif
+
 
+#include "hlac/SimdKernels.h"
 #include "hlac/BitCompressors.h"
 #include "hlac/CompressionHelpers.h"
 #include "hlac/SampleBuffer.h"
@@ -143,6 +143,16 @@ void unpackArrayOfInt16(int16* d, int /*numValues*/, uint8 bitDepth)
 
 }
 
+/** Lets the vectorized kernel unpack as many values as possible and advances the pointers to the remaining values. */
+void unpackWithSimdKernel(int16*& destination, const uint8*& data, int& numValuesToDecompress, int bitRate)
+{
+	const int numUnpacked = SimdKernels::unpack(destination, data, numValuesToDecompress, bitRate);
+
+	destination += numUnpacked;
+	data += numUnpacked * bitRate / 8;
+	numValuesToDecompress -= numUnpacked;
+}
+
 
 int BitCompressors::ZeroBit::getAllowedBitRange() const
 {
@@ -219,6 +229,8 @@ bool BitCompressors::OneBit::compress(uint8* destination, const int16* data, int
 
 bool BitCompressors::OneBit::decompress(int16* destination, const uint8* data, int numValuesToDecompress)
 {
+	unpackWithSimdKernel(destination, data, numValuesToDecompress, 1);
+
 	const uint8 masks[8] = { 0b00000001, 0b00000010, 0b00000100, 0b00001000,
 		0b00010000, 0b00100000, 0b01000000, 0b10000000 };
 
@@ -314,6 +326,8 @@ bool BitCompressors::TwoBit::compress(uint8* destination, const int16* data, int
 
 bool BitCompressors::TwoBit::decompress(int16* destination, const uint8* data, int numValuesToDecompress)
 {
+	unpackWithSimdKernel(destination, data, numValuesToDecompress, 2);
+
 	const uint8 signMasks[4] =  { 0b00000010, 0b00001000, 0b00100000, 0b10000000 };
 	const uint8 valueMasks[4] = { 0b00000001, 0b00000100, 0b00010000, 0b01000000 };
 
@@ -427,7 +441,7 @@ bool BitCompressors::FourBit::compress(uint8* destination, const int16* data, in
 
 bool BitCompressors::FourBit::decompress(int16* destination, const uint8* data, int numValuesToDecompress)
 {
-	
+	unpackWithSimdKernel(destination, data, numValuesToDecompress, 4);
 
 	const uint8 signMasks[2] =  { 0b00001000, 0b10000000 };
 	const uint8 valueMasks[2] = { 0b00000111, 0b01110000 };
@@ -539,123 +553,7 @@ bool BitCompressors::SixBit::compress(uint8* destination, const int16* data, int
 
 bool BitCompressors::SixBit::decompress(int16* destination, const uint8* data, int numValuesToDecompress)
 {
-#if HLAC_NO_SSE
-	while (numValuesToDecompress >= 8)
-	{
-		decompress6Bit(destination, data);
-
-		destination += 8;
-		data += 6;
-		numValuesToDecompress -= 8;
-	}
-#else
-
-	while (numValuesToDecompress >= 64)
-	{
-		const uint16* dataBlock = reinterpret_cast<const uint16*>(data);
-
-		destination[0] = (dataBlock[0] & 0b1111110000000000) >> 10;
-		destination[1] = (dataBlock[0] & 0b0000001111110000) >> 4;
-		destination[2] = (dataBlock[0] & 0b0000000000001111) << 2;
-		destination[2] |= (dataBlock[1] & 0b1100000000000000) >> 14;
-		destination[3] = (dataBlock[1] & 0b0011111100000000) >> 8;
-		destination[4] = (dataBlock[1] & 0b0000000011111100) >> 2;
-		destination[5] = (dataBlock[1] & 0b0000000000000011) << 4;
-		destination[5] |= (dataBlock[2] & 0b1111000000000000) >> 12;
-		destination[6] = (dataBlock[2] & 0b0000111111000000) >> 6;
-		destination[7] = (dataBlock[2] & 0b0000000000111111);
-
-		destination[8 + 0] =  (dataBlock[3 + 0] & 0b1111110000000000) >> 10;
-		destination[8 + 1] =  (dataBlock[3 + 0] & 0b0000001111110000) >> 4;
-		destination[8 + 2] =  (dataBlock[3 + 0] & 0b0000000000001111) << 2;
-		destination[8 + 2] |= (dataBlock[3 + 1] & 0b1100000000000000) >> 14;
-		destination[8 + 3] =  (dataBlock[3 + 1] & 0b0011111100000000) >> 8;
-		destination[8 + 4] =  (dataBlock[3 + 1] & 0b0000000011111100) >> 2;
-		destination[8 + 5] =  (dataBlock[3 + 1] & 0b0000000000000011) << 4;
-		destination[8 + 5] |= (dataBlock[3 + 2] & 0b1111000000000000) >> 12;
-		destination[8 + 6] =  (dataBlock[3 + 2] & 0b0000111111000000) >> 6;
-		destination[8 + 7] =  (dataBlock[3 + 2] & 0b0000000000111111);
-
-		destination[16 + 0] =  (dataBlock[6 + 0] & 0b1111110000000000) >> 10;
-		destination[16 + 1] =  (dataBlock[6 + 0] & 0b0000001111110000) >> 4;
-		destination[16 + 2] =  (dataBlock[6 + 0] & 0b0000000000001111) << 2;
-		destination[16 + 2] |= (dataBlock[6 + 1] & 0b1100000000000000) >> 14;
-		destination[16 + 3] =  (dataBlock[6 + 1] & 0b0011111100000000) >> 8;
-		destination[16 + 4] =  (dataBlock[6 + 1] & 0b0000000011111100) >> 2;
-		destination[16 + 5] =  (dataBlock[6 + 1] & 0b0000000000000011) << 4;
-		destination[16 + 5] |= (dataBlock[6 + 2] & 0b1111000000000000) >> 12;
-		destination[16 + 6] =  (dataBlock[6 + 2] & 0b0000111111000000) >> 6;
-		destination[16 + 7] =  (dataBlock[6 + 2] & 0b0000000000111111);
-
-		destination[24 + 0] =  (dataBlock[9 + 0] & 0b1111110000000000) >> 10;
-		destination[24 + 1] =  (dataBlock[9 + 0] & 0b0000001111110000) >> 4;
-		destination[24 + 2] =  (dataBlock[9 + 0] & 0b0000000000001111) << 2;
-		destination[24 + 2] |= (dataBlock[9 + 1] & 0b1100000000000000) >> 14;
-		destination[24 + 3] =  (dataBlock[9 + 1] & 0b0011111100000000) >> 8;
-		destination[24 + 4] =  (dataBlock[9 + 1] & 0b0000000011111100) >> 2;
-		destination[24 + 5] =  (dataBlock[9 + 1] & 0b0000000000000011) << 4;
-		destination[24 + 5] |= (dataBlock[9 + 2] & 0b1111000000000000) >> 12;
-		destination[24 + 6] =  (dataBlock[9 + 2] & 0b0000111111000000) >> 6;
-		destination[24 + 7] =  (dataBlock[9 + 2] & 0b0000000000111111);
-
-		destination[32 + 0] =  (dataBlock[12 + 0] & 0b1111110000000000) >> 10;
-		destination[32 + 1] =  (dataBlock[12 + 0] & 0b0000001111110000) >> 4;
-		destination[32 + 2] =  (dataBlock[12 + 0] & 0b0000000000001111) << 2;
-		destination[32 + 2] |= (dataBlock[12 + 1] & 0b1100000000000000) >> 14;
-		destination[32 + 3] =  (dataBlock[12 + 1] & 0b0011111100000000) >> 8;
-		destination[32 + 4] =  (dataBlock[12 + 1] & 0b0000000011111100) >> 2;
-		destination[32 + 5] =  (dataBlock[12 + 1] & 0b0000000000000011) << 4;
-		destination[32 + 5] |= (dataBlock[12 + 2] & 0b1111000000000000) >> 12;
-		destination[32 + 6] =  (dataBlock[12 + 2] & 0b0000111111000000) >> 6;
-		destination[32 + 7] =  (dataBlock[12 + 2] & 0b0000000000111111);
-
-		destination[40 + 0] =  (dataBlock[15 + 0] & 0b1111110000000000) >> 10;
-		destination[40 + 1] =  (dataBlock[15 + 0] & 0b0000001111110000) >> 4;
-		destination[40 + 2] =  (dataBlock[15 + 0] & 0b0000000000001111) << 2;
-		destination[40 + 2] |= (dataBlock[15 + 1] & 0b1100000000000000) >> 14;
-		destination[40 + 3] =  (dataBlock[15 + 1] & 0b0011111100000000) >> 8;
-		destination[40 + 4] =  (dataBlock[15 + 1] & 0b0000000011111100) >> 2;
-		destination[40 + 5] =  (dataBlock[15 + 1] & 0b0000000000000011) << 4;
-		destination[40 + 5] |= (dataBlock[15 + 2] & 0b1111000000000000) >> 12;
-		destination[40 + 6] =  (dataBlock[15 + 2] & 0b0000111111000000) >> 6;
-		destination[40 + 7] =  (dataBlock[15 + 2] & 0b0000000000111111);
-
-		destination[48 + 0] =  (dataBlock[18 + 0] & 0b1111110000000000) >> 10;
-		destination[48 + 1] =  (dataBlock[18 + 0] & 0b0000001111110000) >> 4;
-		destination[48 + 2] =  (dataBlock[18 + 0] & 0b0000000000001111) << 2;
-		destination[48 + 2] |= (dataBlock[18 + 1] & 0b1100000000000000) >> 14;
-		destination[48 + 3] =  (dataBlock[18 + 1] & 0b0011111100000000) >> 8;
-		destination[48 + 4] =  (dataBlock[18 + 1] & 0b0000000011111100) >> 2;
-		destination[48 + 5] =  (dataBlock[18 + 1] & 0b0000000000000011) << 4;
-		destination[48 + 5] |= (dataBlock[18 + 2] & 0b1111000000000000) >> 12;
-		destination[48 + 6] =  (dataBlock[18 + 2] & 0b0000111111000000) >> 6;
-		destination[48 + 7] =  (dataBlock[18 + 2] & 0b0000000000111111);
-
-		destination[56 + 0] =  (dataBlock[21 + 0] & 0b1111110000000000) >> 10;
-		destination[56 + 1] =  (dataBlock[21 + 0] & 0b0000001111110000) >> 4;
-		destination[56 + 2] =  (dataBlock[21 + 0] & 0b0000000000001111) << 2;
-		destination[56 + 2] |= (dataBlock[21 + 1] & 0b1100000000000000) >> 14;
-		destination[56 + 3] =  (dataBlock[21 + 1] & 0b0011111100000000) >> 8;
-		destination[56 + 4] =  (dataBlock[21 + 1] & 0b0000000011111100) >> 2;
-		destination[56 + 5] =  (dataBlock[21 + 1] & 0b0000000000000011) << 4;
-		destination[56 + 5] |= (dataBlock[21 + 2] & 0b1111000000000000) >> 12;
-		destination[56 + 6] =  (dataBlock[21 + 2] & 0b0000111111000000) >> 6;
-		destination[56 + 7] =  (dataBlock[21 + 2] & 0b0000000000111111);
-
-		unpackArrayOfInt16(destination, 8, 6);
-		unpackArrayOfInt16(destination+8, 8, 6);
-		unpackArrayOfInt16(destination+16, 8, 6);
-		unpackArrayOfInt16(destination+24, 8, 6);
-		unpackArrayOfInt16(destination+32, 8, 6);
-		unpackArrayOfInt16(destination+40, 8, 6);
-		unpackArrayOfInt16(destination+48, 8, 6);
-		unpackArrayOfInt16(destination+56, 8, 6);
-		
-		destination += 64;
-		data += 48;
-		numValuesToDecompress -= 64;
-	}
-
+	unpackWithSimdKernel(destination, data, numValuesToDecompress, 6);
 
 	while (numValuesToDecompress >= 8)
 	{
@@ -666,11 +564,6 @@ bool BitCompressors::SixBit::decompress(int16* destination, const uint8* data, i
 		numValuesToDecompress -= 8;
 	}
 
-
-
-
-#endif
-
 	memcpy(destination, data, sizeof(int16) * numValuesToDecompress);
 
 	return true;
@@ -704,6 +597,8 @@ bool BitCompressors::EightBit::compress(uint8* destination, const int16* data, i
 
 bool BitCompressors::EightBit::decompress(int16* destination, const uint8* data, int numValuesToDecompress)
 {
+	unpackWithSimdKernel(destination, data, numValuesToDecompress, 8);
+
     while (--numValuesToDecompress >= 0)
 	{
 		const int8 value = *reinterpret_cast<const int8*>(data++);
@@ -791,6 +686,8 @@ bool BitCompressors::TenBit::compress(uint8* destination, const int16* data, int
 
 bool BitCompressors::TenBit::decompress(int16* destination, const uint8* data, int numValuesToDecompress)
 {
+	unpackWithSimdKernel(destination, data, numValuesToDecompress, 10);
+
 	while (numValuesToDecompress >= 8)
 	{
 		decompress10Bit(reinterpret_cast<uint16*>(destination), (void*)data);
@@ -885,6 +782,8 @@ bool BitCompressors::TwelveBit::decompress(int16* destination, const uint8* data
 
 #else
 
+	unpackWithSimdKernel(destination, data, numValuesToDecompress, 12);
+
 	int16* dst = destination;
 
 	while (numValuesToDecompress >= 4)
@@ -1003,6 +902,8 @@ bool BitCompressors::FourteenBit::compress(uint8* destination, const int16* data
 
 bool BitCompressors::FourteenBit::decompress(int16* destination, const uint8* data, int numValuesToDecompress)
 {
+	unpackWithSimdKernel(destination, data, numValuesToDecompress, 14);
+
 	while (numValuesToDecompress >= 8)
 	{
 		decompress14Bit(destination, data);
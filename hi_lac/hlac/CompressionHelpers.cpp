@@ -490,45 +490,12 @@ void CompressionHelpers::dump(const AudioSampleBuffer& b)
 
 void CompressionHelpers::fastInt16ToFloat(const void* source, float* dest, int numSamples)
 {
-#if HLAC_NO_SSE
-
-	AudioDataConverters::convertInt16LEToFloat(source, dest, numSamples);
-
-#else
-
-	uint64 alignOffsetFloat = reinterpret_cast<uint64>(dest) % 16;
-	uint64 alignOffsetInt = reinterpret_cast<uint64>(source) % 16;
-
-	if (alignOffsetFloat == 0 && alignOffsetInt == 0)
-	{
-		const int16* intData = static_cast<const int16*> (source);
-		const float scale = 1.0f / 0x7fff;
-
-		__m128 s = _mm_set1_ps(scale);
-
-		const int numSingle = (numSamples % 4);
-		const int numSSE = numSamples - numSingle;
-
-		for (int i = 0; i < numSSE; i += 4)
-		{
-			__m128i a = _mm_loadl_epi64((__m128i*)(intData + i));
-			a = _mm_cvtepi16_epi32(a);
-			__m128 a_f = _mm_cvtepi32_ps(a);
-			a_f = _mm_mul_ps(a_f, s);
-			_mm_store_ps(dest + i, a_f);
-		}
+	const int16* intData = static_cast<const int16*> (source);
 
-		for (int i = 0; i < numSingle; i++)
-		{
-			dest[i + numSSE] = scale * intData[i + numSSE];
-		}
-	}
-	else
-	{
-		AudioDataConverters::convertInt16LEToFloat(source, dest, numSamples);
-	}
+	const int numConverted = SimdKernels::int16ToFloat(intData, dest, numSamples);
 
-#endif
+	if (numConverted < numSamples)
+		AudioDataConverters::convertInt16LEToFloat(intData + numConverted, dest + numConverted, numSamples - numConverted);
 }
 
 uint8 CompressionHelpers::checkBuffersEqual(AudioSampleBuffer& workBuffer, AudioSampleBuffer& referenceBuffer)
@@ -643,7 +610,7 @@ void CompressionHelpers::IntVectorOperations::sub(int16* dst, const int16* src,
 
 void CompressionHelpers::IntVectorOperations::add(int16* dst, const int16* src, int numSamples)
 {
-	for (int i = 0; i < numSamples; i++)
+	for (int i = SimdKernels::add(dst, src, numSamples); i < numSamples; i++)
 	{
 		dst[i] += src[i];
 	}
@@ -1038,6 +1005,13 @@ uint32 CompressionHelpers::Misc::createChecksum()
 	r.setSeedRandomly();
 	r.setSeedRandomly();
 
+	return createChecksum(r.nextInt64());
+}
+
+uint32 CompressionHelpers::Misc::createChecksum(int64 seed)
+{
+	Random r(seed);
+
 	uint16 randomNumber = (uint16)r.nextInt(Range<int>(2, UINT16_MAX));
 
 	uint8* d = reinterpret_cast<uint8*>(&randomNumber);
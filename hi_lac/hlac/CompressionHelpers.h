@@ -180,6 +180,9 @@ struct CompressionHelpers
 
 		static uint32 createChecksum();
 
+		/** Creates a valid checksum that only depends on the seed (so that the encoder output is reproducible). */
+		static uint32 createChecksum(int64 seed);
+
 		static bool validateChecksum(uint32 data);
 	};
 
@@ -49,6 +49,8 @@ HiseLosslessAudioFormatReader::HiseLosslessAudioFormatReader(InputStream* input_
 
 bool HiseLosslessAudioFormatReader::readSamples(int** destSamples, int numDestChannels, int startOffsetInDestBuffer, int64 startSampleInFile, int numSamples)
 {
+	const ScopedLock sl(internalReader.getReadLock());
+
 	if (isMonolith)
 	{
 		clearSamplesBeyondAvailableLength(destSamples, numDestChannels, startOffsetInDestBuffer,
@@ -188,13 +190,6 @@ bool HlacReaderCommon::internalHlacRead(int** destSamples, int numDestChannels,
 
 	bool isStereo = destSamples[1] != nullptr;
 
-	if (startSampleInFile != decoder.getCurrentReadPosition())
-	{
-		auto byteOffset = header.getOffsetForReadPosition(startSampleInFile, useHeaderOffsetWhenSeeking);
-
-		decoder.seekToPosition(*input, (uint32)startSampleInFile, byteOffset);
-	}
-
 	if (isStereo)
 	{
 		if (usesFloatingPointData)
@@ -216,7 +211,7 @@ bool HlacReaderCommon::internalHlacRead(int** destSamples, int numDestChannels,
 
 			AudioSampleBuffer b(destinationFloat, 2, numSamples);
 			HiseSampleBuffer hsb(b);
-			decoder.decode(hsb, true, *input, (int)startSampleInFile, numSamples);
+			decodeWithBlockCache(hsb, true, startSampleInFile, numSamples);
 		}
 		else
 		{
@@ -233,7 +228,7 @@ bool HlacReaderCommon::internalHlacRead(int** destSamples, int numDestChannels,
 			}
 
 			HiseSampleBuffer hsb(destinationFixed, 2, numSamples);
-			decoder.decode(hsb, true, *input, (int)startSampleInFile, numSamples);
+			decodeWithBlockCache(hsb, true, startSampleInFile, numSamples);
 		}
 	}
 	else
@@ -245,7 +240,7 @@ bool HlacReaderCommon::internalHlacRead(int** destSamples, int numDestChannels,
 			AudioSampleBuffer b(&destinationFloat, 1, numSamples);
 			HiseSampleBuffer hsb(b);
 
-			decoder.decode(hsb, false, *input, (int)startSampleInFile, numSamples);
+			decodeWithBlockCache(hsb, false, startSampleInFile, numSamples);
 		}
 		else
 		{
@@ -254,7 +249,7 @@ bool HlacReaderCommon::internalHlacRead(int** destSamples, int numDestChannels,
 			HiseSampleBuffer hsb(destinationFixed, 1, numSamples);
 
 
-			decoder.decode(hsb, false, *input, (int)startSampleInFile, numSamples);
+			decodeWithBlockCache(hsb, false, startSampleInFile, numSamples);
 		}
 	}
 
@@ -265,24 +260,153 @@ bool HlacReaderCommon::fixedBufferRead(HiseSampleBuffer& buffer, int numDestChan
 {
 	bool isStereo = numDestChannels == 2;
 
+	if(startOffsetInBuffer == 0)
+		decodeWithBlockCache(buffer, isStereo, startSampleInFile, numSamples);
+	else
+	{
+		HiseSampleBuffer offset(buffer, startOffsetInBuffer);
+
+		decodeWithBlockCache(offset, isStereo, startSampleInFile, numSamples);
+
+	}
+
+	return true;
+}
+
+void HlacReaderCommon::BlockCache::setNumBlocks(int numBlocks)
+{
+	entries.clear();
+
+	for (int i = 0; i < numBlocks; i++)
+		entries.add(new Entry());
+}
+
+HlacReaderCommon::BlockCache::Entry* HlacReaderCommon::BlockCache::getCachedBlock(int64 blockIndex, bool isStereo)
+{
+	for (auto e : entries)
+	{
+		if (e->blockIndex == blockIndex && e->isStereo == isStereo)
+		{
+			e->lastAccess = ++accessCounter;
+			return e;
+		}
+	}
+
+	return nullptr;
+}
+
+HlacReaderCommon::BlockCache::Entry& HlacReaderCommon::BlockCache::getEntryToReplace(int64 blockIndex, bool isStereo)
+{
+	jassert(entries.size() > 0);
+
+	auto oldest = entries.getFirst();
+
+	for (auto e : entries)
+	{
+		if (e->lastAccess < oldest->lastAccess)
+			oldest = e;
+	}
+
+	if (oldest->data.getNumSamples() != COMPRESSION_BLOCK_SIZE)
+		oldest->data = HiseSampleBuffer(false, 2, COMPRESSION_BLOCK_SIZE);
+
+	oldest->blockIndex = blockIndex;
+	oldest->isStereo = isStereo;
+	oldest->lastAccess = ++accessCounter;
+
+	return *oldest;
+}
+
+void HlacReaderCommon::seekIfNecessary(int64 startSampleInFile)
+{
 	if (startSampleInFile != decoder.getCurrentReadPosition())
 	{
 		auto byteOffset = header.getOffsetForReadPosition(startSampleInFile, useHeaderOffsetWhenSeeking);
 
 		decoder.seekToPosition(*input, (uint32)startSampleInFile, byteOffset);
 	}
+}
 
-	if(startOffsetInBuffer == 0)
-		decoder.decode(buffer, isStereo, *input, (int)startSampleInFile, numSamples);
-	else
+const HlacReaderCommon::BlockCache::Entry* HlacReaderCommon::getDecodedBlock(int64 blockIndex, bool isStereo)
+{
+	if (auto cachedBlock = blockCache.getCachedBlock(blockIndex, isStereo))
+		return cachedBlock;
+
+	if (blockIndex >= (int64)header.getBlockAmount() || blockCache.entries.isEmpty())
+		return nullptr;
+
+	auto& e = blockCache.getEntryToReplace(blockIndex, isStereo);
+
+	const int64 blockStart = blockIndex * COMPRESSION_BLOCK_SIZE;
+
+	seekIfNecessary(blockStart);
+
+	decoder.decode(e.data, isStereo, *input, (int)blockStart, COMPRESSION_BLOCK_SIZE);
+
+	return &e;
+}
+
+void HlacReaderCommon::copyFromCachedBlock(HiseSampleBuffer& destination, int startInDestination, const BlockCache::Entry& block, int startInBlock, int numSamples)
+{
+	const int numChannelsToCopy = block.isStereo ? 2 : 1;
+
+	for (int i = 0; i < numChannelsToCopy; i++)
 	{
-		HiseSampleBuffer offset(buffer, startOffsetInBuffer);
+		auto src = static_cast<const int16*>(block.data.getReadPointer(i, startInBlock));
 
-		decoder.decode(offset, isStereo, *input, (int)startSampleInFile, numSamples);
+		if (destination.isFloatingPoint())
+			CompressionHelpers::fastInt16ToFloat(src, static_cast<float*>(destination.getWritePointer(i, startInDestination)), numSamples);
+		else
+			memcpy(destination.getWritePointer(i, startInDestination), src, sizeof(int16) * numSamples);
+	}
+}
 
+void HlacReaderCommon::decodeWithBlockCache(HiseSampleBuffer& destination, bool isStereo, int64 startSampleInFile, int numSamples)
+{
+	const int offsetInBlock = (int)(startSampleInFile % COMPRESSION_BLOCK_SIZE);
+
+	int numDone = 0;
+
+	if (offsetInBlock != 0 || numSamples < COMPRESSION_BLOCK_SIZE)
+	{
+		const int numFromBlock = jmin<int>(numSamples, COMPRESSION_BLOCK_SIZE - offsetInBlock);
+
+		if (auto block = getDecodedBlock(startSampleInFile / COMPRESSION_BLOCK_SIZE, isStereo))
+			copyFromCachedBlock(destination, 0, *block, offsetInBlock, numFromBlock);
+		else
+			destination.clear(0, numFromBlock);
+
+		numDone += numFromBlock;
 	}
 
-	return true;
+	const int numFullBlockSamples = ((numSamples - numDone) / COMPRESSION_BLOCK_SIZE) * COMPRESSION_BLOCK_SIZE;
+
+	if (numFullBlockSamples > 0)
+	{
+		const int64 position = startSampleInFile + numDone;
+
+		seekIfNecessary(position);
+
+		if (numDone == 0)
+			decoder.decode(destination, isStereo, *input, (int)position, numFullBlockSamples);
+		else
+		{
+			HiseSampleBuffer offset(destination, numDone);
+			decoder.decode(offset, isStereo, *input, (int)position, numFullBlockSamples);
+		}
+
+		numDone += numFullBlockSamples;
+	}
+
+	if (numDone < numSamples)
+	{
+		const int numRemaining = numSamples - numDone;
+
+		if (auto block = getDecodedBlock((startSampleInFile + numDone) / COMPRESSION_BLOCK_SIZE, isStereo))
+			copyFromCachedBlock(destination, numDone, *block, 0, numRemaining);
+		else
+			destination.clear(numDone, numRemaining);
+	}
 }
 
 void HiseLosslessAudioFormatReader::copySampleData(int* const* destSamples, int startOffsetInDestBuffer, int numDestChannels, const void* sourceData, int numChannels, int numSamples) noexcept
@@ -304,6 +428,8 @@ bool HiseLosslessAudioFormatReader::copyFromMonolith(HiseSampleBuffer& destinati
 	if (numSamples <= 0)
 		return true;
 
+	const ScopedLock sl(internalReader.getReadLock());
+
 	const int bytesPerFrame = sizeof(int16) * numChannelsToCopy;
 
 	input->setPosition(1 + offsetInFile * bytesPerFrame);
@@ -354,6 +480,8 @@ bool HiseLosslessAudioFormatReader::copyFromMonolith(HiseSampleBuffer& destinati
 
 bool HlacMemoryMappedAudioFormatReader::readSamples(int** destSamples, int numDestChannels, int startOffsetInDestBuffer, int64 startSampleInFile, int numSamples)
 {
+	const ScopedLock sl(internalReader.getReadLock());
+
 	if (isMonolith)
 	{
 		clearSamplesBeyondAvailableLength(destSamples, numDestChannels, startOffsetInDestBuffer,
@@ -385,6 +513,8 @@ bool HlacMemoryMappedAudioFormatReader::readSamples(int** destSamples, int numDe
 
 bool HlacMemoryMappedAudioFormatReader::mapSectionOfFile(Range<int64> samplesToMap)
 {
+	const ScopedLock sl(internalReader.getReadLock());
+
 	if (isMonolith)
 	{
 		dataChunkStart = 1;
@@ -463,6 +593,8 @@ void HlacMemoryMappedAudioFormatReader::copySampleData(int* const* destSamples,
 
 bool HlacMemoryMappedAudioFormatReader::copyFromMonolith(HiseSampleBuffer& destination, int startOffsetInBuffer, int numDestChannels, int64 offsetInFile, int numSrcChannels, int numSamples)
 {
+	const ScopedLock sl(internalReader.getReadLock());
+
 	auto sourceData = sampleToPointer(offsetInFile);
 
 	if (numSrcChannels == 1)
@@ -543,6 +675,9 @@ void HlacSubSectionReader::readMaxLevels(int64 startSampleInFile, int64 numSampl
 
 void HlacSubSectionReader::readIntoFixedBuffer(HiseSampleBuffer& buffer, int startSample, int numSamples, int64 readerStartSample)
 {
+	// The source reader is shared by all samples of the monolith
+	const ScopedLock sl(internalReader->getReadLock());
+
 	if (isMonolith)
 	{
 		if (memoryReader != nullptr)
@@ -83,6 +83,9 @@ public:
 		header(input)
 	{
 		decoder.setupForDecompression();
+
+		// Enough for the blocks at the start and the end of the last read operation
+		blockCache.setNumBlocks(2);
 	}
 
 	HlacReaderCommon(const File& f) :
@@ -90,6 +93,8 @@ public:
 		header(f)
 	{
 		decoder.setupForDecompression();
+
+		blockCache.setNumBlocks(2);
 	}
 
 	/** You can choose what the target data type should be. If you read into integer AudioSampleBuffers, you might want to call this method
@@ -102,10 +107,61 @@ public:
 		useHeaderOffsetWhenSeeking = shouldUseHeaderOffset;
 	};
 
+	/** Sets the amount of decoded blocks that are kept in memory. */
+	void setNumCachedBlocks(int numBlocks)
+	{
+		const ScopedLock sl(readLock);
+		blockCache.setNumBlocks(numBlocks);
+	}
+
+	/** The lock that must be held while the decoder, the input stream or the block cache is used.
+	*
+	*	The reader of a monolith is shared by all its samples, so multiple streaming threads might read from it at the same time.
+	*/
+	const CriticalSection& getReadLock() const noexcept { return readLock; }
+
 private:
 
+	/** A small LRU cache of decoded blocks.
+	*
+	*	Reads that start or end in the middle of a block decode the whole block into this cache. The next read that 
+	*	starts at this position (or any other seek into this block) copies the samples instead of decoding the block
+	*	again, so an arbitrary seek costs at most one block decode. The buffers are allocated when they are used first.
+	*/
+	struct BlockCache
+	{
+		struct Entry
+		{
+			int64 blockIndex = -1;
+			bool isStereo = false;
+			uint32 lastAccess = 0;
+			HiseSampleBuffer data;
+		};
+
+		void setNumBlocks(int numBlocks);
+
+		/** Returns the cached block or nullptr if it isn't in the cache. */
+		Entry* getCachedBlock(int64 blockIndex, bool isStereo);
+
+		/** Returns the least recently used entry that can be overwritten with the given block. */
+		Entry& getEntryToReplace(int64 blockIndex, bool isStereo);
+
+		OwnedArray<Entry> entries;
+		uint32 accessCounter = 0;
+	};
+
 	friend class HlacSubSectionReader;
 
+	/** Decodes the samples into the destination and uses the block cache for the blocks that are not read completely. */
+	void decodeWithBlockCache(HiseSampleBuffer& destination, bool isStereo, int64 startSampleInFile, int numSamples);
+
+	/** Copies the samples from the cached block and converts them to float if necessary. */
+	void copyFromCachedBlock(HiseSampleBuffer& destination, int startInDestination, const BlockCache::Entry& block, int startInBlock, int numSamples);
+
+	const BlockCache::Entry* getDecodedBlock(int64 blockIndex, bool isStereo);
+
+	void seekIfNecessary(int64 startSampleInFile);
+
 	bool internalHlacRead(int** destSamples, int numDestChannels, int startOffsetInDestBuffer, int64 startSampleInFile, int numSamples);
 
 	bool fixedBufferRead(HiseSampleBuffer& buffer, int numDestChannels, int startOffsetInBuffer, int64 startSampleInFile, int numSamples);
@@ -120,6 +176,10 @@ private:
 	HlacDecoder decoder;
 	HiseLosslessHeader header;
 
+	BlockCache blockCache;
+
+	CriticalSection readLock;
+
 	bool usesFloatingPointData;
 
 	bool useHeaderOffsetWhenSeeking = true;
@@ -163,6 +223,9 @@ public:
 	{
 		isMonolith = internalReader.header.getVersion() < 2;
 
+		// This reader is shared by all samples of a monolith
+		internalReader.setNumCachedBlocks(HLAC_NUM_CACHED_BLOCKS);
+
 		if (isMonolith)
 		{
 			bytesPerFrame = internalReader.header.getNumChannels() * sizeof(int16);
@@ -184,6 +247,9 @@ public:
 
 	void setTargetAudioDataType(AudioDataConverters::DataFormat dataType);
 
+	/** Returns true if the file is an uncompressed monolith (the samples are stored as interleaved int16 values after the first byte). */
+	bool isUncompressedMonolith() const noexcept { return isMonolith; }
+
 private:
 	
 	friend class HlacSubSectionReader;
@@ -54,6 +54,9 @@ public:
 
 	void setOptions(HlacEncoder::CompressorOptions& newOptions);
 
+	/** Encodes the blocks of every write call on the given thread pool (see HlacEncoder::setThreadPool()). */
+	void setThreadPool(ThreadPool* pool) { encoder.setThreadPool(pool); }
+
 	bool write(const int** samplesToWrite, int numSamples) override;
 
 	double getCompressionRatioForLastFile() { return encoder.getCompressionRatio(); }
@@ -55,6 +55,16 @@ void HlacEncoder::compress(AudioSampleBuffer& source, OutputStream& output, uint
 	blockOffset = 0;
 	int32 numSamplesRemaining = source.getNumSamples();
 
+	const int numFullBlocks = numSamplesRemaining / COMPRESSION_BLOCK_SIZE;
+
+	if (threadPool != nullptr && numFullBlocks > 1)
+	{
+		compressBlocksParallel(source, output, blockOffsetData, numFullBlocks);
+
+		blockOffset += numFullBlocks * COMPRESSION_BLOCK_SIZE;
+		numSamplesRemaining -= numFullBlocks * COMPRESSION_BLOCK_SIZE;
+	}
+
 	while (numSamplesRemaining >= COMPRESSION_BLOCK_SIZE)
 	{
 		blockOffsetData[blockIndex] = numBytesWritten;
@@ -106,6 +116,119 @@ void HlacEncoder::compress(AudioSampleBuffer& source, OutputStream& output, uint
 	
 }
 
+struct HlacEncoder::ParallelBlockEncoder
+{
+	struct Job : public ThreadPoolJob
+	{
+		Job(ParallelBlockEncoder& parent_) :
+			ThreadPoolJob("HLAC Block Encoder"),
+			parent(parent_)
+		{}
+
+		JobStatus runJob() override
+		{
+			parent.encodeBlocks(encoder);
+			return jobHasFinished;
+		}
+
+		ParallelBlockEncoder& parent;
+		HlacEncoder encoder;
+	};
+
+	ParallelBlockEncoder(HlacEncoder& parent_, AudioSampleBuffer& source_, int numBlocks_) :
+		parent(parent_),
+		source(source_),
+		numBlocks(numBlocks_),
+		nextBlock(0)
+	{
+		for (int i = 0; i < numBlocks; i++)
+			encodedBlocks.add(new MemoryBlock());
+	}
+
+	/** Encodes the next unclaimed block until all blocks are done. Every thread uses its own encoder. */
+	void encodeBlocks(HlacEncoder& e)
+	{
+		e.setOptions(parent.options);
+
+		for (;;)
+		{
+			const int i = nextBlock++;
+
+			if (i >= numBlocks)
+				return;
+
+			// The checksum is created from the block index, so it must match the serial encoder
+			e.blockIndex = parent.blockIndex + (uint32)i + 1;
+			e.blockOffset = parent.blockOffset + (uint32)(i * COMPRESSION_BLOCK_SIZE);
+
+			MemoryOutputStream mos(*encodedBlocks[i], false);
+
+			if (source.getNumChannels() == 2)
+			{
+				auto l = CompressionHelpers::getPart(source, 0, e.blockOffset, COMPRESSION_BLOCK_SIZE);
+				e.encodeBlock(l, mos);
+				auto r = CompressionHelpers::getPart(source, 1, e.blockOffset, COMPRESSION_BLOCK_SIZE);
+				e.encodeBlock(r, mos);
+			}
+			else
+			{
+				auto b = CompressionHelpers::getPart(source, e.blockOffset, COMPRESSION_BLOCK_SIZE);
+				e.encodeBlock(b, mos);
+			}
+		}
+	}
+
+	void addStatistics(const HlacEncoder& e)
+	{
+		parent.numBytesUncompressed += e.numBytesUncompressed;
+		parent.numTemplates += e.numTemplates;
+		parent.numDeltas += e.numDeltas;
+	}
+
+	HlacEncoder& parent;
+	AudioSampleBuffer& source;
+	const int numBlocks;
+
+	std::atomic<int> nextBlock;
+	OwnedArray<MemoryBlock> encodedBlocks;
+};
+
+void HlacEncoder::compressBlocksParallel(AudioSampleBuffer& source, OutputStream& output, uint32* blockOffsetData, int numBlocks)
+{
+	ParallelBlockEncoder pe(*this, source, numBlocks);
+
+	OwnedArray<ParallelBlockEncoder::Job> jobs;
+
+	const int numJobs = jmin<int>(threadPool->getNumThreads(), numBlocks - 1);
+
+	for (int i = 0; i < numJobs; i++)
+		threadPool->addJob(jobs.add(new ParallelBlockEncoder::Job(pe)), false);
+
+	HlacEncoder callingThreadEncoder;
+	pe.encodeBlocks(callingThreadEncoder);
+
+	// All blocks are claimed at this point, so this only waits for the jobs that are still encoding a block
+	// and removes the ones that haven't been started yet.
+	for (auto job : jobs)
+	{
+		threadPool->removeJob(job, false, -1);
+		pe.addStatistics(job->encoder);
+	}
+
+	pe.addStatistics(callingThreadEncoder);
+
+	for (int i = 0; i < numBlocks; i++)
+	{
+		const MemoryBlock& mb = *pe.encodedBlocks[i];
+
+		blockOffsetData[blockIndex] = numBytesWritten;
+		++blockIndex;
+
+		output.write(mb.getData(), mb.getSize());
+		numBytesWritten += (uint32)mb.getSize();
+	}
+}
+
 void HlacEncoder::reset()
 {
 	indexInBlock = 0;
@@ -326,7 +449,7 @@ uint8 HlacEncoder::getBitReductionAmountForMSEncoding(AudioSampleBuffer& block)
 bool HlacEncoder::writeChecksumBytesForBlock(OutputStream& output)
 {
 	
-	auto checkSum = CompressionHelpers::Misc::createChecksum();
+	auto checkSum = CompressionHelpers::Misc::createChecksum(blockIndex);
 
 	if (!output.writeInt((int)checkSum))
 		return false;
@@ -423,7 +546,7 @@ bool HlacEncoder::encodeDiff(CompressionHelpers::AudioBufferInt16& cycle, Output
 	if (numBytesForFull > 0)
 	{
 		MemoryBlock mbFull;
-		mbFull.setSize(numBytesForFull);
+		mbFull.setSize(numBytesForFull, true);
 		compressorFull->compress((uint8*)mbFull.getData(), packedBuffer.getReadPointer(), numFullValues);
 
 		if (!output.write(mbFull.getData(), numBytesForFull))
@@ -435,7 +558,7 @@ bool HlacEncoder::encodeDiff(CompressionHelpers::AudioBufferInt16& cycle, Output
 	if (numBytesForError > 0)
 	{
 		MemoryBlock mbError;
-		mbError.setSize(numBytesForError);
+		mbError.setSize(numBytesForError, true);
 		compressorError->compress((uint8*)mbError.getData(), packedErrorBuffer.getReadPointer(), numErrorValues);
 
 		
@@ -159,8 +159,20 @@ public:
 
 	uint32 getNumBlocksWritten() const { return blockIndex; }
 
+	/** Encodes the full blocks of the buffers passed into compress() on the given thread pool.
+	*
+	*	The blocks are independent, so they can be encoded in any order and are written in the original order afterwards.
+	*	The calling thread works on the blocks too, so it's safe to pass in a pool that is busy with other jobs. 
+	*	The output is identical to the single threaded encoder. Pass in nullptr to encode everything on the calling thread.
+	*/
+	void setThreadPool(ThreadPool* newPool) { threadPool = newPool; }
+
 private:
 
+	struct ParallelBlockEncoder;
+
+	void compressBlocksParallel(AudioSampleBuffer& source, OutputStream& output, uint32* blockOffsetData, int numBlocks);
+
 	bool encodeBlock(AudioSampleBuffer& block, OutputStream& output);
 
 	bool encodeBlock(CompressionHelpers::AudioBufferInt16& block, OutputStream& output);
@@ -222,6 +234,8 @@ private:
 	uint64 readIndex = 0;
 
 	double decompressionSpeed = 0.0;
+
+	ThreadPool* threadPool = nullptr;
 };
 
 } // namespace hlac
@@ -37,7 +37,14 @@ HiseSampleBuffer::HiseSampleBuffer(HiseSampleBuffer& otherBuffer, int offset)
 {
 	if (otherBuffer.isFloatingPoint())
 	{
-		jassertfalse;
+		isFloat = true;
+		size = otherBuffer.size - offset;
+		numChannels = otherBuffer.numChannels;
+
+		float* channels[2] = { otherBuffer.floatBuffer.getWritePointer(0, offset), 
+							   numChannels > 1 ? otherBuffer.floatBuffer.getWritePointer(1, offset) : nullptr };
+
+		floatBuffer.setDataToReferTo(channels, numChannels, size);
 	}
 	else
 	{
@@ -270,4 +277,34 @@ AudioSampleBuffer* HiseSampleBuffer::getFloatBufferForFileReader()
 	return &floatBuffer;
 }
 
+void HiseSampleBuffer::setDataToReferTo(const void* const* channelData, bool isFloat_, int numChannels_, int numSamples)
+{
+	jassert(isPositiveAndBelow(numChannels_, 3));
+
+	isFloat = isFloat_;
+	numChannels = numChannels_;
+	size = numSamples;
+
+	if (isFloat)
+	{
+		float* channels[2] = { (float*)channelData[0], numChannels > 1 ? (float*)channelData[1] : nullptr };
+
+		floatBuffer.setDataToReferTo(channels, numChannels, numSamples);
+
+		leftIntBuffer = FixedSampleBuffer(0);
+		rightIntBuffer = FixedSampleBuffer(0);
+	}
+	else
+	{
+		floatBuffer.setSize(numChannels, 0);
+
+		leftIntBuffer = FixedSampleBuffer(static_cast<const int16*>(channelData[0]), numSamples);
+
+		if (numChannels > 1)
+			rightIntBuffer = FixedSampleBuffer(static_cast<const int16*>(channelData[1]), numSamples);
+		else
+			rightIntBuffer = FixedSampleBuffer(0);
+	}
+}
+
 } // namespace hlac
\ No newline at end of file
@@ -66,7 +66,7 @@ public:
 	}
 
 	HiseSampleBuffer(HiseSampleBuffer&& otherBuffer) :
-		floatBuffer(otherBuffer.floatBuffer),
+		floatBuffer(std::move(otherBuffer.floatBuffer)),
 		isFloat(otherBuffer.isFloat),
 		leftIntBuffer(std::move(otherBuffer.leftIntBuffer)),
 		rightIntBuffer(std::move(otherBuffer.rightIntBuffer)),
@@ -90,7 +90,7 @@ public:
 		isFloat = other.isFloat;
 		leftIntBuffer = std::move(other.leftIntBuffer);
 		rightIntBuffer = std::move(other.rightIntBuffer);
-		floatBuffer = other.floatBuffer;
+		floatBuffer = std::move(other.floatBuffer);
 		numChannels = other.numChannels;
 		size = other.size;
 
@@ -146,6 +146,12 @@ public:
 	/** Returns the internal AudioSampleBuffer for convenient usage with AudioFormatReader classes. */
 	AudioSampleBuffer* getFloatBufferForFileReader();
 
+	/** Lets the buffer use the given data instead of its own memory.
+	*
+	*	The data is not copied, so it must stay valid as long as the buffer uses it. 16 bit data will be read only.
+	*/
+	void setDataToReferTo(const void* const* channelData, bool isFloat_, int numChannels_, int numSamples);
+
 	
 
 private:
@@ -0,0 +1,439 @@
+/*  ===========================================================================
+*
+*   This file is part of HISE.
+*   Copyright 2016 Christoph Hart
+*
+*   HISE is free software: you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation, either version 3 of the License, or
+*   (at your option) any later version.
+*
+*   HISE is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with HISE.  If not, see <http://www.gnu.org/licenses/>.
+*
+*   Commercial licenses for using HISE in an closed source project are
+*   available on request. Please visit the project's website to get more
+*   information about commercial licensing:
+*
+*   http://www.hise.audio/
+*
+*   HISE is based on the JUCE library,
+*   which must be separately licensed for closed source applications:
+*
+*   http://www.juce.com
+*
+*   ===========================================================================
+*/
+
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define HLAC_SIMD_X86 1
+#include <immintrin.h>
+#else
+#define HLAC_SIMD_X86 0
+#endif
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#define HLAC_SIMD_NEON 1
+#include <arm_neon.h>
+#else
+#define HLAC_SIMD_NEON 0
+#endif
+
+// GCC and clang only allow the intrinsics in functions that are compiled for the instruction set
+#if HLAC_SIMD_X86 && (defined(__GNUC__) || defined(__clang__))
+#define HLAC_TARGET_SSE41 __attribute__((target("sse4.1")))
+#define HLAC_TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#define HLAC_TARGET_SSE41
+#define HLAC_TARGET_AVX2
+#endif
+
+namespace hlac { using namespace juce; 
+
+#if HLAC_SIMD_X86
+
+struct SSE41Kernels
+{
+	static HLAC_TARGET_SSE41 int unpack1Bit(int16* destination, const uint8* data, int numValues)
+	{
+		const __m128i bitMasks = _mm_setr_epi16(1, 2, 4, 8, 16, 32, 64, 128);
+		const __m128i one = _mm_set1_epi16(1);
+
+		int i = 0;
+
+		for (; i + 8 <= numValues; i += 8)
+		{
+			__m128i v = _mm_set1_epi16((short)*data++);
+			v = _mm_min_epu16(_mm_and_si128(v, bitMasks), one);
+
+			_mm_storeu_si128((__m128i*)(destination + i), v);
+		}
+
+		return i;
+	}
+
+	static HLAC_TARGET_SSE41 int unpack2Bit(int16* destination, const uint8* data, int numValues)
+	{
+		// Moves the two bits of every lane to the top of the lane (the field of lane j is at bit 2j)
+		const __m128i fieldShift = _mm_setr_epi16(1 << 14, 1 << 12, 1 << 10, 1 << 8, 1 << 6, 1 << 4, 1 << 2, 1);
+		const __m128i one = _mm_set1_epi16(1);
+		const __m128i signMask = _mm_set1_epi16(2);
+
+		int i = 0;
+
+		for (; i + 8 <= numValues; i += 8)
+		{
+			uint16 packed;
+			memcpy(&packed, data, sizeof(uint16));
+			data += 2;
+
+			__m128i v = _mm_srli_epi16(_mm_mullo_epi16(_mm_set1_epi16((short)packed), fieldShift), 14);
+
+			const __m128i value = _mm_and_si128(v, one);
+			const __m128i sign = _mm_sub_epi16(one, _mm_and_si128(v, signMask));
+
+			_mm_storeu_si128((__m128i*)(destination + i), _mm_sign_epi16(value, sign));
+		}
+
+		return i;
+	}
+
+	static HLAC_TARGET_SSE41 int unpack4Bit(int16* destination, const uint8* data, int numValues)
+	{
+		const __m128i fieldShift = _mm_setr_epi16(1 << 12, 1 << 8, 1 << 4, 1, 1 << 12, 1 << 8, 1 << 4, 1);
+		const __m128i one = _mm_set1_epi16(1);
+		const __m128i valueMask = _mm_set1_epi16(7);
+		const __m128i signMask = _mm_set1_epi16(8);
+
+		int i = 0;
+
+		for (; i + 8 <= numValues; i += 8)
+		{
+			uint16 packed[2];
+			memcpy(packed, data, 2 * sizeof(uint16));
+			data += 4;
+
+			__m128i v = _mm_unpacklo_epi64(_mm_set1_epi16((short)packed[0]), _mm_set1_epi16((short)packed[1]));
+			v = _mm_srli_epi16(_mm_mullo_epi16(v, fieldShift), 12);
+
+			const __m128i value = _mm_and_si128(v, valueMask);
+			const __m128i sign = _mm_sub_epi16(one, _mm_srli_epi16(_mm_and_si128(v, signMask), 2));
+
+			_mm_storeu_si128((__m128i*)(destination + i), _mm_sign_epi16(value, sign));
+		}
+
+		return i;
+	}
+
+	static HLAC_TARGET_SSE41 int unpack8Bit(int16* destination, const uint8* data, int numValues)
+	{
+		int i = 0;
+
+		for (; i + 8 <= numValues; i += 8)
+		{
+			const __m128i v = _mm_loadl_epi64((const __m128i*)(data + i));
+			_mm_storeu_si128((__m128i*)(destination + i), _mm_cvtepi8_epi16(v));
+		}
+
+		return i;
+	}
+
+	/** Unpacks groups of eight values that are stored as continuous bit stream in BitRate 16 bit words. 
+	*
+	*	Every lane gets the 32 bit window of the two words that contain its value, then the value is moved to the top 
+	*	(there is no variable shift in SSE4.1, so it uses a multiplication) and shifted down to the bottom.
+	*/
+	template <int BitRate> static HLAC_TARGET_SSE41 int unpackBitStream(int16* destination, const uint8* data, int numValues)
+	{
+		int8 shuffleMasks[2][16];
+		int32 multipliers[2][4];
+
+		for (int j = 0; j < 8; j++)
+		{
+			const int bitPosition = j * BitRate;
+			const int wordIndex = bitPosition / 16;
+
+			int8* s = shuffleMasks[j / 4] + (j % 4) * 4;
+
+			s[0] = (int8)(2 * wordIndex + 2);
+			s[1] = (int8)(2 * wordIndex + 3);
+			s[2] = (int8)(2 * wordIndex);
+			s[3] = (int8)(2 * wordIndex + 1);
+
+			multipliers[j / 4][j % 4] = 1 << (bitPosition % 16);
+		}
+
+		const __m128i shuffleLo = _mm_loadu_si128((const __m128i*)shuffleMasks[0]);
+		const __m128i shuffleHi = _mm_loadu_si128((const __m128i*)shuffleMasks[1]);
+		const __m128i multiplierLo = _mm_loadu_si128((const __m128i*)multipliers[0]);
+		const __m128i multiplierHi = _mm_loadu_si128((const __m128i*)multipliers[1]);
+		const __m128i offset = _mm_set1_epi16((1 << (BitRate - 1)) - 1);
+
+		const int numGroups = numValues / 8;
+
+		int groupIndex = 0;
+
+		// The 16 byte load must not exceed the packed data
+		for (; (numGroups - groupIndex) * BitRate >= 16; groupIndex++)
+		{
+			const __m128i packed = _mm_loadu_si128((const __m128i*)(data + groupIndex * BitRate));
+
+			__m128i lo = _mm_shuffle_epi8(packed, shuffleLo);
+			__m128i hi = _mm_shuffle_epi8(packed, shuffleHi);
+
+			lo = _mm_srli_epi32(_mm_mullo_epi32(lo, multiplierLo), 32 - BitRate);
+			hi = _mm_srli_epi32(_mm_mullo_epi32(hi, multiplierHi), 32 - BitRate);
+
+			const __m128i v = _mm_sub_epi16(_mm_packus_epi32(lo, hi), offset);
+
+			_mm_storeu_si128((__m128i*)(destination + groupIndex * 8), v);
+		}
+
+		return groupIndex * 8;
+	}
+
+	static int unpack(int16* destination, const uint8* data, int numValues, int bitRate)
+	{
+		switch (bitRate)
+		{
+		case 1:		return unpack1Bit(destination, data, numValues);
+		case 2:		return unpack2Bit(destination, data, numValues);
+		case 4:		return unpack4Bit(destination, data, numValues);
+		case 6:		return unpackBitStream<6>(destination, data, numValues);
+		case 8:		return unpack8Bit(destination, data, numValues);
+		case 10:	return unpackBitStream<10>(destination, data, numValues);
+		case 12:	return unpackBitStream<12>(destination, data, numValues);
+		case 14:	return unpackBitStream<14>(destination, data, numValues);
+		default:	return 0;
+		}
+	}
+
+	static HLAC_TARGET_SSE41 int int16ToFloat(const int16* source, float* destination, int numSamples)
+	{
+		const __m128 scale = _mm_set1_ps(1.0f / 0x7fff);
+
+		int i = 0;
+
+		for (; i + 8 <= numSamples; i += 8)
+		{
+			const __m128i v = _mm_loadu_si128((const __m128i*)(source + i));
+
+			const __m128 lo = _mm_cvtepi32_ps(_mm_cvtepi16_epi32(v));
+			const __m128 hi = _mm_cvtepi32_ps(_mm_cvtepi16_epi32(_mm_srli_si128(v, 8)));
+
+			_mm_storeu_ps(destination + i, _mm_mul_ps(lo, scale));
+			_mm_storeu_ps(destination + i + 4, _mm_mul_ps(hi, scale));
+		}
+
+		return i;
+	}
+
+	static HLAC_TARGET_SSE41 int add(int16* dst, const int16* src, int numSamples)
+	{
+		int i = 0;
+
+		for (; i + 8 <= numSamples; i += 8)
+		{
+			const __m128i a = _mm_loadu_si128((const __m128i*)(dst + i));
+			const __m128i b = _mm_loadu_si128((const __m128i*)(src + i));
+
+			_mm_storeu_si128((__m128i*)(dst + i), _mm_add_epi16(a, b));
+		}
+
+		return i;
+	}
+};
+
+struct AVX2Kernels
+{
+	static HLAC_TARGET_AVX2 int int16ToFloat(const int16* source, float* destination, int numSamples)
+	{
+		const __m256 scale = _mm256_set1_ps(1.0f / 0x7fff);
+
+		int i = 0;
+
+		for (; i + 16 <= numSamples; i += 16)
+		{
+			const __m128i a = _mm_loadu_si128((const __m128i*)(source + i));
+			const __m128i b = _mm_loadu_si128((const __m128i*)(source + i + 8));
+
+			_mm256_storeu_ps(destination + i, _mm256_mul_ps(_mm256_cvtepi32_ps(_mm256_cvtepi16_epi32(a)), scale));
+			_mm256_storeu_ps(destination + i + 8, _mm256_mul_ps(_mm256_cvtepi32_ps(_mm256_cvtepi16_epi32(b)), scale));
+		}
+
+		return i + SSE41Kernels::int16ToFloat(source + i, destination + i, numSamples - i);
+	}
+
+	static HLAC_TARGET_AVX2 int add(int16* dst, const int16* src, int numSamples)
+	{
+		int i = 0;
+
+		for (; i + 16 <= numSamples; i += 16)
+		{
+			const __m256i a = _mm256_loadu_si256((const __m256i*)(dst + i));
+			const __m256i b = _mm256_loadu_si256((const __m256i*)(src + i));
+
+			_mm256_storeu_si256((__m256i*)(dst + i), _mm256_add_epi16(a, b));
+		}
+
+		return i + SSE41Kernels::add(dst + i, src + i, numSamples - i);
+	}
+};
+
+#endif
+
+#if HLAC_SIMD_NEON
+
+struct NeonKernels
+{
+	static int unpack(int16* destination, const uint8* data, int numValues, int bitRate)
+	{
+		if (bitRate != 8)
+			return 0;
+
+		int i = 0;
+
+		for (; i + 8 <= numValues; i += 8)
+			vst1q_s16(destination + i, vmovl_s8(vld1_s8(reinterpret_cast<const int8_t*>(data + i))));
+
+		return i;
+	}
+
+	static int int16ToFloat(const int16* source, float* destination, int numSamples)
+	{
+		const float scale = 1.0f / 0x7fff;
+
+		int i = 0;
+
+		for (; i + 8 <= numSamples; i += 8)
+		{
+			const int16x8_t v = vld1q_s16(source + i);
+
+			vst1q_f32(destination + i, vmulq_n_f32(vcvtq_f32_s32(vmovl_s16(vget_low_s16(v))), scale));
+			vst1q_f32(destination + i + 4, vmulq_n_f32(vcvtq_f32_s32(vmovl_s16(vget_high_s16(v))), scale));
+		}
+
+		return i;
+	}
+
+	static int add(int16* dst, const int16* src, int numSamples)
+	{
+		int i = 0;
+
+		for (; i + 8 <= numSamples; i += 8)
+			vst1q_s16(dst + i, vaddq_s16(vld1q_s16(dst + i), vld1q_s16(src + i)));
+
+		return i;
+	}
+};
+
+#endif
+
+static std::atomic<int>& getCurrentInstructionSet()
+{
+	static std::atomic<int> currentInstructionSet((int)SimdKernels::getBestInstructionSet());
+
+	return currentInstructionSet;
+}
+
+SimdKernels::InstructionSet SimdKernels::getInstructionSet() noexcept
+{
+	return (InstructionSet)getCurrentInstructionSet().load();
+}
+
+SimdKernels::InstructionSet SimdKernels::getBestInstructionSet() noexcept
+{
+#if !HLAC_USE_SIMD_KERNELS
+	return InstructionSet::Scalar;
+#elif HLAC_SIMD_X86
+	if (SystemStats::hasAVX2())
+		return InstructionSet::AVX2;
+
+	if (SystemStats::hasSSE41())
+		return InstructionSet::SSE41;
+
+	return InstructionSet::Scalar;
+#elif HLAC_SIMD_NEON
+	return InstructionSet::Neon;
+#else
+	return InstructionSet::Scalar;
+#endif
+}
+
+void SimdKernels::setInstructionSet(InstructionSet newInstructionSet) noexcept
+{
+	const InstructionSet best = getBestInstructionSet();
+
+	bool isSupported = newInstructionSet == InstructionSet::Scalar || newInstructionSet == best;
+
+	// AVX2 implies SSE4.1
+	isSupported |= newInstructionSet == InstructionSet::SSE41 && best == InstructionSet::AVX2;
+
+	getCurrentInstructionSet().store((int)(isSupported ? newInstructionSet : best));
+}
+
+String SimdKernels::getInstructionSetName(InstructionSet s)
+{
+	switch (s)
+	{
+	case InstructionSet::Scalar:	return "Scalar";
+	case InstructionSet::SSE41:		return "SSE4.1";
+	case InstructionSet::AVX2:		return "AVX2";
+	case InstructionSet::Neon:		return "NEON";
+	case InstructionSet::numInstructionSets: 
+	default:						return "";
+	}
+}
+
+int SimdKernels::unpack(int16* destination, const uint8* packedData, int numValues, int bitRate) noexcept
+{
+	switch (getInstructionSet())
+	{
+#if HLAC_SIMD_X86
+	case InstructionSet::AVX2: // The bit unpacking doesn't benefit from the wider registers
+	case InstructionSet::SSE41:	return SSE41Kernels::unpack(destination, packedData, numValues, bitRate);
+#endif
+#if HLAC_SIMD_NEON
+	case InstructionSet::Neon:	return NeonKernels::unpack(destination, packedData, numValues, bitRate);
+#endif
+	default:					return 0;
+	}
+}
+
+int SimdKernels::int16ToFloat(const int16* source, float* destination, int numSamples) noexcept
+{
+	switch (getInstructionSet())
+	{
+#if HLAC_SIMD_X86
+	case InstructionSet::AVX2:	return AVX2Kernels::int16ToFloat(source, destination, numSamples);
+	case InstructionSet::SSE41:	return SSE41Kernels::int16ToFloat(source, destination, numSamples);
+#endif
+#if HLAC_SIMD_NEON
+	case InstructionSet::Neon:	return NeonKernels::int16ToFloat(source, destination, numSamples);
+#endif
+	default:					return 0;
+	}
+}
+
+int SimdKernels::add(int16* dst, const int16* src, int numSamples) noexcept
+{
+	switch (getInstructionSet())
+	{
+#if HLAC_SIMD_X86
+	case InstructionSet::AVX2:	return AVX2Kernels::add(dst, src, numSamples);
+	case InstructionSet::SSE41:	return SSE41Kernels::add(dst, src, numSamples);
+#endif
+#if HLAC_SIMD_NEON
+	case InstructionSet::Neon:	return NeonKernels::add(dst, src, numSamples);
+#endif
+	default:					return 0;
+	}
+}
+
+} // namespace hlac
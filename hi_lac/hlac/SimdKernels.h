@@ -0,0 +1,88 @@
+/*  ===========================================================================
+*
+*   This file is part of HISE.
+*   Copyright 2016 Christoph Hart
+*
+*   HISE is free software: you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation, either version 3 of the License, or
+*   (at your option) any later version.
+*
+*   HISE is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with HISE.  If not, see <http://www.gnu.org/licenses/>.
+*
+*   Commercial licenses for using HISE in an closed source project are
+*   available on request. Please visit the project's website to get more
+*   information about commercial licensing:
+*
+*   http://www.hise.audio/
+*
+*   HISE is based on the JUCE library,
+*   which must be separately licensed for closed source applications:
+*
+*   http://www.juce.com
+*
+*   ===========================================================================
+*/
+
+
+#ifndef SIMDKERNELS_H_INCLUDED
+#define SIMDKERNELS_H_INCLUDED
+
+namespace hlac { using namespace juce; 
+
+/** Vectorized versions of the hot loops of the HLAC decoder.
+*
+*	The kernels are compiled for every supported instruction set (using the target attributes, so no special compiler 
+*	flags are needed) and the fastest one is selected at runtime, so the binary will still run on older CPUs.
+*
+*	All functions process as many values as possible and return the number of processed values. The remaining values
+*	must be processed by the scalar code of the caller.
+*/
+struct SimdKernels
+{
+	enum class InstructionSet
+	{
+		Scalar = 0,
+		SSE41,
+		AVX2,
+		Neon,
+		numInstructionSets
+	};
+
+	/** Returns the instruction set that is currently used. */
+	static InstructionSet getInstructionSet() noexcept;
+
+	/** Returns the best instruction set that is supported by the CPU. */
+	static InstructionSet getBestInstructionSet() noexcept;
+
+	/** Overrides the runtime detection (eg. to compare the kernels in a benchmark). 
+	*
+	*	If the CPU doesn't support the given instruction set, it will use the best supported one.
+	*/
+	static void setInstructionSet(InstructionSet newInstructionSet) noexcept;
+
+	static String getInstructionSetName(InstructionSet s);
+
+	/** Unpacks values that were compressed by the BitCompressors with the given bit rate. 
+	*
+	*	The data must use the layout of the respective BitCompressors class. Values are only processed in full groups 
+	*	and only as long as the vector loads stay within the packed data.
+	*/
+	static int unpack(int16* destination, const uint8* packedData, int numValues, int bitRate) noexcept;
+
+	/** Converts the samples to float (1.0f == 0x7fff). */
+	static int int16ToFloat(const int16* source, float* destination, int numSamples) noexcept;
+
+	/** dst += src */
+	static int add(int16* dst, const int16* src, int numSamples) noexcept;
+};
+
+} // namespace hlac
+
+#endif  // SIMDKERNELS_H_INCLUDED
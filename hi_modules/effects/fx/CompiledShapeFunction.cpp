@@ -0,0 +1,807 @@
+/*  ===========================================================================
+*
+*   This file is part of HISE.
+*   Copyright 2016 Christoph Hart
+*
+*   HISE is free software: you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation, either version 3 of the License, or
+*   (at your option) any later version.
+*
+*   HISE is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with HISE.  If not, see <http://www.gnu.org/licenses/>.
+*
+*   Commercial licenses for using HISE in an closed source project are
+*   available on request. Please visit the project's website to get more
+*   information about commercial licensing:
+*
+*   http://www.hise.audio/
+*
+*   HISE is based on the JUCE library,
+*   which must be separately licensed for closed source applications:
+*
+*   http://www.juce.com
+*
+*   ===========================================================================
+*/
+
+
+namespace hise {
+using namespace juce;
+
+/** A recursive descent parser that emits the operations while it reads the code. 
+*
+*	Every expression returns the index of the register that will contain its value. The registers are never
+*	overwritten, so a variable is just the register index of its last assignment.
+*/
+class CompiledShapeFunction::Parser
+{
+public:
+
+	Parser(CompiledShapeFunction& f_, const String& code) :
+		f(f_),
+		p(code.getCharPointer())
+	{
+		next();
+	}
+
+	void parseFunction()
+	{
+		if (!matchIf("function"))
+			throw String("The code must only contain the shape function");
+
+		readIdentifier();
+		expect("(");
+		variables.set(readIdentifier(), InputRegister);
+		expect(")");
+		expect("{");
+
+		while (!matchIf("}"))
+		{
+			if (currentType == TokenType::EndOfFile)
+				throw String("Missing }");
+
+			parseStatement();
+		}
+
+		if (currentType != TokenType::EndOfFile)
+			throw String("The code must only contain the shape function");
+
+		f.resultRegister = resultRegister;
+	}
+
+private:
+
+	enum class TokenType
+	{
+		EndOfFile,
+		Identifier,
+		Number,
+		Operator
+	};
+
+	// Statements ===========================================================================================
+
+	void parseStatement()
+	{
+		if (matchIf("{"))
+		{
+			while (!matchIf("}"))
+			{
+				if (currentType == TokenType::EndOfFile)
+					throw String("Missing }");
+
+				parseStatement();
+			}
+		}
+		else if (matchIf(";"))
+		{
+		}
+		else if (matchIf("var") || matchIf("local"))
+		{
+			do
+			{
+				const String name = readIdentifier();
+				const int value = matchIf("=") ? parseExpression() : getConstant(0.0f);
+
+				assign(name, value, !variables.contains(name));
+			} 
+			while (matchIf(","));
+
+			expect(";");
+		}
+		else if (matchIf("if"))
+		{
+			parseIf();
+		}
+		else if (matchIf("return"))
+		{
+			parseReturn();
+		}
+		else if (currentType == TokenType::Identifier)
+		{
+			parseAssignment();
+		}
+		else
+		{
+			throw String("Unsupported statement: " + currentToken);
+		}
+	}
+
+	void parseIf()
+	{
+		expect("(");
+		const int condition = toBool(parseExpression());
+		expect(")");
+
+		const int parentMask = currentMask;
+
+		currentMask = combineMasks(parentMask, condition);
+		parseStatement();
+
+		if (matchIf("else"))
+		{
+			currentMask = combineMasks(parentMask, logicalNot(condition));
+			parseStatement();
+		}
+
+		currentMask = parentMask;
+	}
+
+	void parseReturn()
+	{
+		const int value = matchIf(";") ? getConstant(0.0f) : parseExpressionAndSemicolon();
+		const int activeMask = getActiveMask();
+
+		if (activeMask == -1)
+		{
+			resultRegister = value;
+			returnedMask = getConstant(1.0f);
+		}
+		else
+		{
+			resultRegister = select(activeMask, value, resultRegister == -1 ? getConstant(0.0f) : resultRegister);
+
+			// The active mask never overlaps the returned mask
+			returnedMask = returnedMask == -1 ? activeMask : emit(OpType::Add, returnedMask, activeMask);
+		}
+	}
+
+	void parseAssignment()
+	{
+		const String name = readIdentifier();
+		const int oldValue = getVariable(name);
+
+		int value;
+
+		if (matchIf("="))			value = parseExpression();
+		else if (matchIf("+="))		value = emit(OpType::Add, oldValue, parseExpression());
+		else if (matchIf("-="))		value = emit(OpType::Subtract, oldValue, parseExpression());
+		else if (matchIf("*="))		value = emit(OpType::Multiply, oldValue, parseExpression());
+		else if (matchIf("/="))		value = emit(OpType::Divide, oldValue, parseExpression());
+		else if (matchIf("%="))		value = emit(OpType::Modulo, oldValue, parseExpression());
+		else if (matchIf("++"))		value = emit(OpType::Add, oldValue, getConstant(1.0f));
+		else if (matchIf("--"))		value = emit(OpType::Subtract, oldValue, getConstant(1.0f));
+		else						throw String("Unsupported statement: " + name);
+
+		expect(";");
+
+		assign(name, value, false);
+	}
+
+	void assign(const String& name, int value, bool isNewVariable)
+	{
+		const int activeMask = getActiveMask();
+
+		if (activeMask == -1)
+		{
+			variables.set(name, value);
+			return;
+		}
+
+		const int oldValue = isNewVariable ? getConstant(0.0f) : getVariable(name);
+
+		variables.set(name, select(activeMask, value, oldValue));
+	}
+
+	// Expressions ==========================================================================================
+
+	int parseExpressionAndSemicolon()
+	{
+		const int value = parseExpression();
+		expect(";");
+		return value;
+	}
+
+	int parseExpression()
+	{
+		const int condition = parseLogicalOr();
+
+		if (matchIf("?"))
+		{
+			const int trueValue = parseExpression();
+			expect(":");
+			const int falseValue = parseExpression();
+
+			return select(toBool(condition), trueValue, falseValue);
+		}
+
+		return condition;
+	}
+
+	int parseLogicalOr()
+	{
+		int a = parseLogicalAnd();
+
+		// a || b returns a if it's true, otherwise b
+		while (matchIf("||"))
+		{
+			const int b = parseLogicalAnd();
+			a = select(toBool(a), a, b);
+		}
+
+		return a;
+	}
+
+	int parseLogicalAnd()
+	{
+		int a = parseEquality();
+
+		// a && b returns b if a is true, otherwise a
+		while (matchIf("&&"))
+		{
+			const int b = parseEquality();
+			a = select(toBool(a), b, a);
+		}
+
+		return a;
+	}
+
+	int parseEquality()
+	{
+		int a = parseRelational();
+
+		for (;;)
+		{
+			if (matchIf("==") || matchIf("==="))		a = emit(OpType::Equal, a, parseRelational());
+			else if (matchIf("!=") || matchIf("!=="))	a = emit(OpType::NotEqual, a, parseRelational());
+			else										return a;
+		}
+	}
+
+	int parseRelational()
+	{
+		int a = parseAdditive();
+
+		for (;;)
+		{
+			if (matchIf("<"))			a = emit(OpType::Less, a, parseAdditive());
+			else if (matchIf("<="))		a = emit(OpType::LessOrEqual, a, parseAdditive());
+			else if (matchIf(">"))		a = emit(OpType::Greater, a, parseAdditive());
+			else if (matchIf(">="))		a = emit(OpType::GreaterOrEqual, a, parseAdditive());
+			else						return a;
+		}
+	}
+
+	int parseAdditive()
+	{
+		int a = parseMultiplicative();
+
+		for (;;)
+		{
+			if (matchIf("+"))			a = emit(OpType::Add, a, parseMultiplicative());
+			else if (matchIf("-"))		a = emit(OpType::Subtract, a, parseMultiplicative());
+			else						return a;
+		}
+	}
+
+	int parseMultiplicative()
+	{
+		int a = parseUnary();
+
+		for (;;)
+		{
+			if (matchIf("*"))			a = emit(OpType::Multiply, a, parseUnary());
+			else if (matchIf("/"))		a = emit(OpType::Divide, a, parseUnary());
+			else if (matchIf("%"))		a = emit(OpType::Modulo, a, parseUnary());
+			else						return a;
+		}
+	}
+
+	int parseUnary()
+	{
+		if (matchIf("-"))	return emit(OpType::Subtract, getConstant(0.0f), parseUnary());
+		if (matchIf("+"))	return parseUnary();
+		if (matchIf("!"))	return logicalNot(parseUnary());
+
+		return parsePrimary();
+	}
+
+	int parsePrimary()
+	{
+		if (currentType == TokenType::Number)
+		{
+			const float value = (float)currentNumber;
+			next();
+			return getConstant(value);
+		}
+
+		if (matchIf("("))
+		{
+			const int value = parseExpression();
+			expect(")");
+			return value;
+		}
+
+		if (currentType != TokenType::Identifier)
+			throw String("Unexpected token: " + currentToken);
+
+		const String name = readIdentifier();
+
+		if (name == "true")		return getConstant(1.0f);
+		if (name == "false")	return getConstant(0.0f);
+		if (name == "Math")		return parseMathObject();
+
+		if (currentToken == "(" || currentToken == "." || currentToken == "[")
+			throw String("Unsupported function call or property access: " + name);
+
+		return getVariable(name);
+	}
+
+	int parseMathObject()
+	{
+		expect(".");
+
+		const String name = readIdentifier();
+
+		if (name == "PI")		return getConstant((float)double_Pi);
+		if (name == "E")		return getConstant((float)std::exp(1.0));
+		if (name == "SQRT2")	return getConstant((float)std::sqrt(2.0));
+		if (name == "SQRT1_2")	return getConstant((float)std::sqrt(0.5));
+		if (name == "LN2")		return getConstant((float)std::log(2.0));
+		if (name == "LN10")		return getConstant((float)std::log(10.0));
+		if (name == "LOG2E")	return getConstant((float)std::log2(std::exp(1.0)));
+		if (name == "LOG10E")	return getConstant((float)std::log10(std::exp(1.0)));
+
+		int numArguments = 0;
+		const MathFunction function = getMathFunction(name, numArguments);
+
+		if (function == MathFunction::None)
+			throw String("Unsupported Math function: " + name);
+
+		int arguments[3] = { -1, -1, -1 };
+
+		expect("(");
+
+		for (int i = 0; i < numArguments; i++)
+		{
+			if (i != 0)
+				expect(",");
+
+			arguments[i] = parseExpression();
+		}
+
+		expect(")");
+
+		Operation op;
+		op.type = OpType::Function;
+		op.function = function;
+		op.target = allocateRegister();
+		op.a = arguments[0];
+		op.b = arguments[1];
+		op.c = arguments[2];
+
+		f.operations.add(op);
+
+		return op.target;
+	}
+
+	static MathFunction getMathFunction(const String& name, int& numArguments)
+	{
+		static const char* names[] = { "", "abs", "round", "sign", "sin", "asin", "sinh", "asinh", "cos", "acos", "cosh", "acosh", 
+									   "tan", "atan", "tanh", "atanh", "log", "log10", "exp", "sqr", "sqrt", "ceil", "floor", 
+									   "toDegrees", "toRadians", "min", "max", "pow", "range" };
+
+		static_assert(sizeof(names) / sizeof(const char*) == (int)MathFunction::numMathFunctions, "Function name mismatch");
+
+		for (int i = 1; i < (int)MathFunction::numMathFunctions; i++)
+		{
+			if (name == names[i])
+			{
+				const MathFunction function = (MathFunction)i;
+
+				if (function == MathFunction::Range)
+					numArguments = 3;
+				else if (function == MathFunction::Min || function == MathFunction::Max || function == MathFunction::Pow)
+					numArguments = 2;
+				else
+					numArguments = 1;
+
+				return function;
+			}
+		}
+
+		return MathFunction::None;
+	}
+
+	// Registers & masks ====================================================================================
+
+	int allocateRegister()
+	{
+		if (f.numRegisters >= MaxRegisters)
+			throw String("The function is too long");
+
+		return f.numRegisters++;
+	}
+
+	int getConstant(float value)
+	{
+		for (const auto& c : f.constants)
+		{
+			if (c.value == value)
+				return c.registerIndex;
+		}
+
+		const Constant c = { allocateRegister(), value };
+		f.constants.add(c);
+		return c.registerIndex;
+	}
+
+	int getVariable(const String& name) const
+	{
+		if (name == "gain")
+			return GainRegister;
+
+		if (!variables.contains(name))
+			throw String("Unknown variable: " + name);
+
+		return variables[name];
+	}
+
+	int emit(OpType type, int a, int b, int c=-1)
+	{
+		Operation op;
+		op.type = type;
+		op.function = MathFunction::None;
+		op.target = allocateRegister();
+		op.a = a;
+		op.b = b;
+		op.c = c;
+
+		f.operations.add(op);
+
+		return op.target;
+	}
+
+	int select(int mask, int trueValue, int falseValue)
+	{
+		return emit(OpType::Select, mask, trueValue, falseValue);
+	}
+
+	int toBool(int value)
+	{
+		return emit(OpType::NotEqual, value, getConstant(0.0f));
+	}
+
+	int logicalNot(int value)
+	{
+		return emit(OpType::Equal, value, getConstant(0.0f));
+	}
+
+	int combineMasks(int parentMask, int mask)
+	{
+		return parentMask == -1 ? mask : emit(OpType::Multiply, parentMask, mask);
+	}
+
+	/** Returns the mask of the samples that are affected by the current statement (or -1 if all are affected). */
+	int getActiveMask()
+	{
+		if (returnedMask == -1)
+			return currentMask;
+
+		return combineMasks(currentMask, logicalNot(returnedMask));
+	}
+
+	// Tokenizer ============================================================================================
+
+	bool matchIf(const char* token)
+	{
+		if (currentType != TokenType::EndOfFile && currentType != TokenType::Number && currentToken == token)
+		{
+			next();
+			return true;
+		}
+
+		return false;
+	}
+
+	void expect(const char* token)
+	{
+		if (!matchIf(token))
+			throw String("Expected " + String(token) + ", found " + (currentType == TokenType::EndOfFile ? String("end of code") : currentToken));
+	}
+
+	String readIdentifier()
+	{
+		if (currentType != TokenType::Identifier)
+			throw String("Expected identifier, found " + currentToken);
+
+		const String name = currentToken;
+		next();
+		return name;
+	}
+
+	void skipWhitespaceAndComments()
+	{
+		for (;;)
+		{
+			p = p.findEndOfWhitespace();
+
+			if (*p == '/' && p[1] == '/')
+			{
+				while (!p.isEmpty() && *p != '\n')
+					++p;
+			}
+			else if (*p == '/' && p[1] == '*')
+			{
+				p += 2;
+
+				while (!p.isEmpty() && !(*p == '*' && p[1] == '/'))
+					++p;
+
+				if (p.isEmpty())
+					throw String("Unterminated comment");
+
+				p += 2;
+			}
+			else
+			{
+				return;
+			}
+		}
+	}
+
+	void next()
+	{
+		skipWhitespaceAndComments();
+
+		if (p.isEmpty())
+		{
+			currentType = TokenType::EndOfFile;
+			currentToken = String();
+			return;
+		}
+
+		auto start = p;
+		const juce_wchar c = *p;
+
+		if (CharacterFunctions::isLetter(c) || c == '_' || c == '$')
+		{
+			while (CharacterFunctions::isLetterOrDigit(*p) || *p == '_' || *p == '$')
+				++p;
+
+			currentType = TokenType::Identifier;
+			currentToken = String(start, p);
+			return;
+		}
+
+		if (CharacterFunctions::isDigit(c) || (c == '.' && CharacterFunctions::isDigit(p[1])))
+		{
+			if (c == '0' && (p[1] == 'x' || p[1] == 'X'))
+				throw String("Hex numbers are not supported");
+
+			while (CharacterFunctions::isDigit(*p) || *p == '.')
+				++p;
+
+			if (*p == 'e' || *p == 'E')
+			{
+				++p;
+
+				if (*p == '+' || *p == '-')
+					++p;
+
+				while (CharacterFunctions::isDigit(*p))
+					++p;
+			}
+
+			currentType = TokenType::Number;
+			currentToken = String(start, p);
+			currentNumber = currentToken.getDoubleValue();
+			return;
+		}
+
+		static const char* operators[] = { "===", "!==", "==", "!=", "<=", ">=", "&&", "||", "+=", "-=", "*=", "/=", "%=", "++", "--",
+										   "<<", ">>", "(", ")", "{", "}", "[", "]", ";", ",", ".", "?", ":", "=", "<", ">", "+", "-", 
+										   "*", "/", "%", "!", "&", "|", "^", "~" };
+
+		for (auto o : operators)
+		{
+			auto t = p;
+			auto oc = o;
+
+			while (*oc != 0 && *t == (juce_wchar)*oc)
+			{
+				++t;
+				++oc;
+			}
+
+			if (*oc == 0)
+			{
+				p = t;
+				currentType = TokenType::Operator;
+				currentToken = o;
+				return;
+			}
+		}
+
+		throw String("Unsupported character: " + String::charToString(c));
+	}
+
+	CompiledShapeFunction& f;
+
+	String::CharPointerType p;
+
+	TokenType currentType = TokenType::EndOfFile;
+	String currentToken;
+	double currentNumber = 0.0;
+
+	HashMap<String, int> variables;
+
+	int currentMask = -1;
+	int returnedMask = -1;
+	int resultRegister = -1;
+};
+
+CompiledShapeFunction::CompiledShapeFunction()
+{
+}
+
+Result CompiledShapeFunction::compile(const String& code)
+{
+	compiled = false;
+	operations.clear();
+	constants.clear();
+	numRegisters = numFixedRegisters;
+	resultRegister = -1;
+
+	try
+	{
+		Parser parser(*this, code);
+		parser.parseFunction();
+	}
+	catch (String& errorMessage)
+	{
+		operations.clear();
+		constants.clear();
+		return Result::fail(errorMessage);
+	}
+
+	registers.calloc(numRegisters * ChunkSize);
+
+	for (const auto& c : constants)
+		FloatVectorOperations::fill(getRegister(c.registerIndex), c.value, ChunkSize);
+
+	compiled = true;
+
+	return Result::ok();
+}
+
+void CompiledShapeFunction::process(float* data, int numSamples, float gain)
+{
+	jassert(compiled);
+
+	FloatVectorOperations::fill(getRegister(GainRegister), gain, ChunkSize);
+
+	for (int offset = 0; offset < numSamples; offset += ChunkSize)
+	{
+		processChunk(data + offset, jmin<int>(ChunkSize, numSamples - offset));
+	}
+}
+
+float CompiledShapeFunction::getSingleValue(float input, float gain)
+{
+	process(&input, 1, gain);
+	return input;
+}
+
+void CompiledShapeFunction::processChunk(float* data, int numSamples)
+{
+	FloatVectorOperations::copy(getRegister(InputRegister), data, numSamples);
+
+	for (const auto& op : operations)
+	{
+		float* t = getRegister(op.target);
+		const float* a = op.a >= 0 ? getRegister(op.a) : nullptr;
+		const float* b = op.b >= 0 ? getRegister(op.b) : nullptr;
+		const float* c = op.c >= 0 ? getRegister(op.c) : nullptr;
+
+		switch (op.type)
+		{
+		case OpType::Add:				for (int i = 0; i < numSamples; i++) t[i] = a[i] + b[i]; break;
+		case OpType::Subtract:			for (int i = 0; i < numSamples; i++) t[i] = a[i] - b[i]; break;
+		case OpType::Multiply:			for (int i = 0; i < numSamples; i++) t[i] = a[i] * b[i]; break;
+		case OpType::Divide:			for (int i = 0; i < numSamples; i++) t[i] = divide(a[i], b[i]); break;
+		case OpType::Modulo:			for (int i = 0; i < numSamples; i++) t[i] = modulo(a[i], b[i]); break;
+		case OpType::Less:				for (int i = 0; i < numSamples; i++) t[i] = a[i] < b[i] ? 1.0f : 0.0f; break;
+		case OpType::LessOrEqual:		for (int i = 0; i < numSamples; i++) t[i] = a[i] <= b[i] ? 1.0f : 0.0f; break;
+		case OpType::Greater:			for (int i = 0; i < numSamples; i++) t[i] = a[i] > b[i] ? 1.0f : 0.0f; break;
+		case OpType::GreaterOrEqual:	for (int i = 0; i < numSamples; i++) t[i] = a[i] >= b[i] ? 1.0f : 0.0f; break;
+		case OpType::Equal:				for (int i = 0; i < numSamples; i++) t[i] = a[i] == b[i] ? 1.0f : 0.0f; break;
+		case OpType::NotEqual:			for (int i = 0; i < numSamples; i++) t[i] = a[i] != b[i] ? 1.0f : 0.0f; break;
+		case OpType::Select:			for (int i = 0; i < numSamples; i++) t[i] = a[i] != 0.0f ? b[i] : c[i]; break;
+		case OpType::Function:			processFunction(op.function, t, a, b, c, numSamples); break;
+		case OpType::numOpTypes:		jassertfalse; break;
+		}
+	}
+
+	if (resultRegister == -1)
+		FloatVectorOperations::clear(data, numSamples);
+	else
+		FloatVectorOperations::copy(data, getRegister(resultRegister), numSamples);
+
+	for (int i = 0; i < numSamples; i++)
+	{
+		data[i] = jlimit<float>(-1024.0f, 1024.0f, data[i]);
+		data[i] = FloatSanitizers::sanitizeFloatNumber(data[i]);
+	}
+}
+
+float CompiledShapeFunction::divide(float a, float b)
+{
+	return b != 0.0f ? a / b : std::numeric_limits<float>::infinity();
+}
+
+float CompiledShapeFunction::modulo(float a, float b)
+{
+	// The scripting engine rounds both operands to integers
+	const int ia = roundToInt(a);
+	const int ib = roundToInt(b);
+
+	return ib != 0 ? (float)(ia % ib) : std::numeric_limits<float>::infinity();
+}
+
+void CompiledShapeFunction::processFunction(MathFunction f, float* t, const float* a, const float* b, const float* c, int numSamples)
+{
+	switch (f)
+	{
+	case MathFunction::Abs:			for (int i = 0; i < numSamples; i++) t[i] = std::abs(a[i]); break;
+	case MathFunction::Round:		for (int i = 0; i < numSamples; i++) t[i] = (float)roundToInt(a[i]); break;
+	case MathFunction::Sign:		for (int i = 0; i < numSamples; i++) t[i] = a[i] > 0.0f ? 1.0f : (a[i] < 0.0f ? -1.0f : 0.0f); break;
+	case MathFunction::Sin:			for (int i = 0; i < numSamples; i++) t[i] = std::sin(a[i]); break;
+	case MathFunction::Asin:		for (int i = 0; i < numSamples; i++) t[i] = std::asin(a[i]); break;
+	case MathFunction::Sinh:		for (int i = 0; i < numSamples; i++) t[i] = std::sinh(a[i]); break;
+	case MathFunction::Asinh:		for (int i = 0; i < numSamples; i++) t[i] = std::asinh(a[i]); break;
+	case MathFunction::Cos:			for (int i = 0; i < numSamples; i++) t[i] = std::cos(a[i]); break;
+	case MathFunction::Acos:		for (int i = 0; i < numSamples; i++) t[i] = std::acos(a[i]); break;
+	case MathFunction::Cosh:		for (int i = 0; i < numSamples; i++) t[i] = std::cosh(a[i]); break;
+	case MathFunction::Acosh:		for (int i = 0; i < numSamples; i++) t[i] = std::acosh(a[i]); break;
+	case MathFunction::Tan:			for (int i = 0; i < numSamples; i++) t[i] = std::tan(a[i]); break;
+	case MathFunction::Atan:		for (int i = 0; i < numSamples; i++) t[i] = std::atan(a[i]); break;
+	case MathFunction::Tanh:		for (int i = 0; i < numSamples; i++) t[i] = std::tanh(a[i]); break;
+	case MathFunction::Atanh:		for (int i = 0; i < numSamples; i++) t[i] = std::atanh(a[i]); break;
+	case MathFunction::Log:			for (int i = 0; i < numSamples; i++) t[i] = std::log(a[i]); break;
+	case MathFunction::Log10:		for (int i = 0; i < numSamples; i++) t[i] = std::log10(a[i]); break;
+	case MathFunction::Exp:			for (int i = 0; i < numSamples; i++) t[i] = std::exp(a[i]); break;
+	case MathFunction::Sqr:			for (int i = 0; i < numSamples; i++) t[i] = a[i] * a[i]; break;
+	case MathFunction::Sqrt:		for (int i = 0; i < numSamples; i++) t[i] = std::sqrt(a[i]); break;
+	case MathFunction::Ceil:		for (int i = 0; i < numSamples; i++) t[i] = std::ceil(a[i]); break;
+	case MathFunction::Floor:		for (int i = 0; i < numSamples; i++) t[i] = std::floor(a[i]); break;
+	case MathFunction::ToDegrees:	for (int i = 0; i < numSamples; i++) t[i] = radiansToDegrees(a[i]); break;
+	case MathFunction::ToRadians:	for (int i = 0; i < numSamples; i++) t[i] = degreesToRadians(a[i]); break;
+	case MathFunction::Min:			for (int i = 0; i < numSamples; i++) t[i] = jmin(a[i], b[i]); break;
+	case MathFunction::Max:			for (int i = 0; i < numSamples; i++) t[i] = jmax(a[i], b[i]); break;
+	case MathFunction::Pow:			for (int i = 0; i < numSamples; i++) t[i] = std::pow(a[i], b[i]); break;
+
+	// The same as jlimit(), but without the assertion for an invalid range
+	case MathFunction::Range:		for (int i = 0; i < numSamples; i++) t[i] = a[i] < b[i] ? b[i] : (c[i] < a[i] ? c[i] : a[i]); break;
+	case MathFunction::None:
+	case MathFunction::numMathFunctions: jassertfalse; break;
+	}
+}
+
+}
@@ -0,0 +1,181 @@
+/*  ===========================================================================
+*
+*   This file is part of HISE.
+*   Copyright 2016 Christoph Hart
+*
+*   HISE is free software: you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation, either version 3 of the License, or
+*   (at your option) any later version.
+*
+*   HISE is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with HISE.  If not, see <http://www.gnu.org/licenses/>.
+*
+*   Commercial licenses for using HISE in an closed source project are
+*   available on request. Please visit the project's website to get more
+*   information about commercial licensing:
+*
+*   http://www.hise.audio/
+*
+*   HISE is based on the JUCE library,
+*   which must be separately licensed for closed source applications:
+*
+*   http://www.juce.com
+*
+*   ===========================================================================
+*/
+
+
+#ifndef COMPILEDSHAPEFUNCTION_H_INCLUDED
+#define COMPILEDSHAPEFUNCTION_H_INCLUDED
+
+namespace hise {
+using namespace juce;
+
+/** A compiled version of the shape function of the script shaper.
+*
+*	It parses the numeric subset of the scripting language: number literals, local variables, the arithmetic, 
+*	comparison and logical operators, if / else, the ternary operator and the functions of the Math object.
+*	The function is turned into a list of operations that are applied to blocks of samples, so there is no 
+*	interpreter call for every sample. Both branches of a condition are calculated and merged with a mask, 
+*	which keeps the sample loops free of branches.
+*
+*	If the code uses anything else (loops, strings, API calls, variables outside the function), compile() 
+*	returns an error and the script shaper keeps using the interpreter.
+*/
+class CompiledShapeFunction
+{
+public:
+
+	enum
+	{
+		/** The amount of samples that are processed by each operation. */
+		ChunkSize = 64,
+
+		/** The maximum amount of intermediate values of a function. */
+		MaxRegisters = 256
+	};
+
+	CompiledShapeFunction();
+
+	/** Compiles the code of the shape function. The result contains the reason if it can't be compiled. */
+	Result compile(const String& code);
+
+	bool isCompiled() const { return compiled; };
+
+	/** Applies the function to the samples (in place). The result is limited the same way as the interpreted shaper. */
+	void process(float* data, int numSamples, float gain);
+
+	/** Calculates a single value. */
+	float getSingleValue(float input, float gain);
+
+private:
+
+	class Parser;
+
+	enum class OpType : uint8
+	{
+		Add = 0,
+		Subtract,
+		Multiply,
+		Divide,
+		Modulo,
+		Less,
+		LessOrEqual,
+		Greater,
+		GreaterOrEqual,
+		Equal,
+		NotEqual,
+		Select,
+		Function,
+		numOpTypes
+	};
+
+	enum class MathFunction : uint8
+	{
+		None = 0,
+		Abs,
+		Round,
+		Sign,
+		Sin,
+		Asin,
+		Sinh,
+		Asinh,
+		Cos,
+		Acos,
+		Cosh,
+		Acosh,
+		Tan,
+		Atan,
+		Tanh,
+		Atanh,
+		Log,
+		Log10,
+		Exp,
+		Sqr,
+		Sqrt,
+		Ceil,
+		Floor,
+		ToDegrees,
+		ToRadians,
+		Min,
+		Max,
+		Pow,
+		Range,
+		numMathFunctions
+	};
+
+	struct Operation
+	{
+		OpType type;
+		MathFunction function;
+		int target;
+		int a;
+		int b;
+		int c;
+	};
+
+	struct Constant
+	{
+		int registerIndex;
+		float value;
+	};
+
+	/** The registers with a fixed meaning. */
+	enum
+	{
+		InputRegister = 0,
+		GainRegister,
+		numFixedRegisters
+	};
+
+	float* getRegister(int index) { return registers.getData() + index * ChunkSize; }
+
+	void processChunk(float* data, int numSamples);
+
+	/** The division and modulo operators behave like the ones of the scripting engine. */
+	static float divide(float a, float b);
+	static float modulo(float a, float b);
+
+	static void processFunction(MathFunction f, float* target, const float* a, const float* b, const float* c, int numSamples);
+
+	Array<Operation> operations;
+	Array<Constant> constants;
+
+	HeapBlock<float> registers;
+
+	int numRegisters = numFixedRegisters;
+	int resultRegister = -1;
+	bool compiled = false;
+
+	JUCE_DECLARE_NON_COPYABLE(CompiledShapeFunction);
+};
+
+}
+
+#endif
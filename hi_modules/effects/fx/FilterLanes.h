@@ -0,0 +1,204 @@
+/*  ===========================================================================
+*
+*   This file is part of HISE.
+*   Copyright 2016 Christoph Hart
+*
+*   HISE is free software: you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation, either version 3 of the License, or
+*   (at your option) any later version.
+*
+*   HISE is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with HISE.  If not, see <http://www.gnu.org/licenses/>.
+*
+*   Commercial licenses for using HISE in an closed source project are
+*   available on request. Please visit the project's website to get more
+*   information about commercial licensing:
+*
+*   http://www.hise.audio/
+*
+*   HISE is based on the JUCE library,
+*   which must be separately licensed for closed source applications:
+*
+*   http://www.juce.com
+*
+*   ===========================================================================
+*/
+
+
+#ifndef FILTERLANES_H_INCLUDED
+#define FILTERLANES_H_INCLUDED
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define HISE_FILTER_LANES_SSE2 1
+#include <emmintrin.h>
+#else
+#define HISE_FILTER_LANES_SSE2 0
+#endif
+
+namespace hise { using namespace juce;
+
+/** A group of values that are processed with the same operations.
+*
+*	The filters use this type to calculate the recursion of multiple channels at once: every channel lives in one lane.
+*	This generic version is a plain array (which is also used as scalar reference with one lane), the versions with 
+*	four floats and two doubles use SSE2 registers.
+*/
+template <typename FloatType, int N> struct FilterLanes
+{
+	using Scalar = FloatType;
+
+	enum { NumLanes = N };
+
+	FilterLanes() {};
+
+	explicit FilterLanes(FloatType value) { for (int i = 0; i < N; i++) v[i] = value; }
+
+	static forcedinline FilterLanes load(const FloatType* data) { FilterLanes r; for (int i = 0; i < N; i++) r.v[i] = data[i]; return r; }
+
+	forcedinline void store(FloatType* data) const { for (int i = 0; i < N; i++) data[i] = v[i]; }
+
+	forcedinline FilterLanes operator+(const FilterLanes& o) const { FilterLanes r; for (int i = 0; i < N; i++) r.v[i] = v[i] + o.v[i]; return r; }
+	forcedinline FilterLanes operator-(const FilterLanes& o) const { FilterLanes r; for (int i = 0; i < N; i++) r.v[i] = v[i] - o.v[i]; return r; }
+	forcedinline FilterLanes operator*(const FilterLanes& o) const { FilterLanes r; for (int i = 0; i < N; i++) r.v[i] = v[i] * o.v[i]; return r; }
+	forcedinline FilterLanes operator/(const FilterLanes& o) const { FilterLanes r; for (int i = 0; i < N; i++) r.v[i] = v[i] / o.v[i]; return r; }
+
+	FloatType v[N];
+};
+
+#if HISE_FILTER_LANES_SSE2
+
+template <> struct FilterLanes<float, 4>
+{
+	using Scalar = float;
+
+	enum { NumLanes = 4 };
+
+	FilterLanes() {};
+	FilterLanes(__m128 v_) : v(v_) {};
+
+	explicit FilterLanes(float value) : v(_mm_set1_ps(value)) {};
+
+	static forcedinline FilterLanes load(const float* data) { return _mm_loadu_ps(data); }
+
+	forcedinline void store(float* data) const { _mm_storeu_ps(data, v); }
+
+	forcedinline FilterLanes operator+(const FilterLanes& o) const { return _mm_add_ps(v, o.v); }
+	forcedinline FilterLanes operator-(const FilterLanes& o) const { return _mm_sub_ps(v, o.v); }
+	forcedinline FilterLanes operator*(const FilterLanes& o) const { return _mm_mul_ps(v, o.v); }
+	forcedinline FilterLanes operator/(const FilterLanes& o) const { return _mm_div_ps(v, o.v); }
+
+	__m128 v;
+};
+
+template <> struct FilterLanes<double, 2>
+{
+	using Scalar = double;
+
+	enum { NumLanes = 2 };
+
+	FilterLanes() {};
+	FilterLanes(__m128d v_) : v(v_) {};
+
+	explicit FilterLanes(double value) : v(_mm_set1_pd(value)) {};
+
+	static forcedinline FilterLanes load(const double* data) { return _mm_loadu_pd(data); }
+
+	forcedinline void store(double* data) const { _mm_storeu_pd(data, v); }
+
+	forcedinline FilterLanes operator+(const FilterLanes& o) const { return _mm_add_pd(v, o.v); }
+	forcedinline FilterLanes operator-(const FilterLanes& o) const { return _mm_sub_pd(v, o.v); }
+	forcedinline FilterLanes operator*(const FilterLanes& o) const { return _mm_mul_pd(v, o.v); }
+	forcedinline FilterLanes operator/(const FilterLanes& o) const { return _mm_div_pd(v, o.v); }
+
+	__m128d v;
+};
+
+#endif
+
+/** Four float channels in one register. */
+using FloatLanes = FilterLanes<float, 4>;
+
+/** Two double channels in one register. */
+using DoubleLanes = FilterLanes<double, 2>;
+
+/** The number of state slots a filter needs for the given amount of channels. 
+*
+*	The channels are processed in groups, so the last group might use some lanes that don't belong to a channel. 
+*/
+#define NUM_FILTER_STATE_SLOTS(numChannels) ((((numChannels) + 3) / 4) * 4)
+
+/** Processes the channels of a buffer in groups of LaneType::NumLanes channels.
+*
+*	The samples of each group are interleaved into a small buffer (and converted to the scalar type of the lanes), so 
+*	the filter can load one sample of every channel with a single instruction. The unused lanes of the last group process 
+*	silence. The function will be called with the index of the first channel, the interleaved data and the number of samples 
+*	and must process the data in place. A single float lane doesn't need to be interleaved, so it gets the buffer directly.
+*/
+template <class LaneType, class ProcessFunction> static void processChannelsInLanes(AudioSampleBuffer& b, int numChannels, int startSample, int numSamples, const ProcessFunction& f)
+{
+	using Scalar = typename LaneType::Scalar;
+
+	enum
+	{
+		NumLanes = LaneType::NumLanes,
+		ChunkSize = 64
+	};
+
+	Scalar data[ChunkSize * NumLanes];
+
+	numChannels = jmin<int>(numChannels, b.getNumChannels());
+
+	if (NumLanes == 1 && std::is_same<Scalar, float>::value)
+	{
+		for (int c = 0; c < numChannels; c++)
+			f(c, reinterpret_cast<Scalar*>(b.getWritePointer(c, startSample)), numSamples);
+
+		return;
+	}
+
+	for (int c = 0; c < numChannels; c += NumLanes)
+	{
+		const int numChannelsThisTime = jmin<int>(NumLanes, numChannels - c);
+
+		for (int offset = 0; offset < numSamples; offset += ChunkSize)
+		{
+			const int numThisTime = jmin<int>(ChunkSize, numSamples - offset);
+
+			for (int l = 0; l < NumLanes; l++)
+			{
+				if (l < numChannelsThisTime)
+				{
+					const float* src = b.getReadPointer(c + l, startSample + offset);
+
+					for (int i = 0; i < numThisTime; i++)
+						data[i * NumLanes + l] = (Scalar)src[i];
+				}
+				else
+				{
+					for (int i = 0; i < numThisTime; i++)
+						data[i * NumLanes + l] = Scalar(0);
+				}
+			}
+
+			f(c, data, numThisTime);
+
+			for (int l = 0; l < numChannelsThisTime; l++)
+			{
+				float* dst = b.getWritePointer(c + l, startSample + offset);
+
+				for (int i = 0; i < numThisTime; i++)
+					dst[i] = (float)data[i * NumLanes + l];
+			}
+		}
+	}
+}
+
+} // namespace hise
+
+#endif  // FILTERLANES_H_INCLUDED
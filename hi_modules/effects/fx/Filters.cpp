@@ -32,6 +32,54 @@
 
 namespace hise { using namespace juce;
 
+FilterCoefficientTable::FilterCoefficientTable()
+{
+	for (int i = 0; i <= TableSize; i++)
+	{
+		const double normalisedFrequency = MaxNormalisedFrequency * (double)i / (double)TableSize;
+
+		tanTable[i] = (float)std::tan(double_Pi * normalisedFrequency);
+		expTable[i] = (float)std::exp(-2.0 * double_Pi * normalisedFrequency);
+	}
+}
+
+const FilterCoefficientTable& FilterCoefficientTable::getInstance()
+{
+	static const FilterCoefficientTable table;
+	return table;
+}
+
+double FilterCoefficientTable::interpolate(const float* table, double index)
+{
+	const int i = (int)index;
+	const double alpha = index - (double)i;
+
+	if (i >= TableSize)
+		return (double)table[TableSize];
+
+	return (double)table[i] + alpha * ((double)table[i + 1] - (double)table[i]);
+}
+
+double FilterCoefficientTable::getPrewarpedFrequency(double frequency, double sampleRate)
+{
+	const double normalisedFrequency = frequency / sampleRate;
+
+	if (normalisedFrequency < 0.0 || normalisedFrequency > MaxNormalisedFrequency)
+		return std::tan(double_Pi * normalisedFrequency);
+
+	return interpolate(getInstance().tanTable, normalisedFrequency / MaxNormalisedFrequency * (double)TableSize);
+}
+
+double FilterCoefficientTable::getOnePoleDecay(double frequency, double sampleRate)
+{
+	const double normalisedFrequency = frequency / sampleRate;
+
+	if (normalisedFrequency < 0.0 || normalisedFrequency > MaxNormalisedFrequency)
+		return std::exp(-2.0 * double_Pi * normalisedFrequency);
+
+	return interpolate(getInstance().expTable, normalisedFrequency / MaxNormalisedFrequency * (double)TableSize);
+}
+
 MonoFilterEffect::MonoFilterEffect(MainController *mc, const String &id) :
 MonophonicEffectProcessor(mc, id),
 gain(1.0f),
@@ -130,6 +178,8 @@ void MonoFilterEffect::restoreFromValueTree(const ValueTree &v)
 	loadAttribute(Mode, "Mode");
     loadAttribute(Quality, "RenderQuality");
 	loadAttribute(BipolarIntensity, "BipolarIntensity");
+
+	setCoefficientUpdateInterval(v.getProperty("CoefficientUpdateInterval", 0));
 }
 
 ValueTree MonoFilterEffect::exportAsValueTree() const
@@ -142,6 +192,10 @@ ValueTree MonoFilterEffect::exportAsValueTree() const
 	saveAttribute(Mode, "Mode");
     saveAttribute(Quality, "RenderQuality");
 	saveAttribute(BipolarIntensity, "BipolarIntensity");
+
+	if (coefficientUpdateInterval != 0)
+		v.setProperty("CoefficientUpdateInterval", coefficientUpdateInterval, nullptr);
+
 	return v;
 }
 
@@ -150,6 +204,7 @@ void MonoFilterEffect::setMode(int filterMode)
 	mode = (FilterMode)filterMode;
 
 	calculateGainModValue = false;
+	changeFlag = true;
 	
 	switch (mode)
 	{
@@ -230,6 +285,17 @@ void MonoFilterEffect::calcCoefficients()
 	changeFlag = false;
 }
 
+void MonoFilterEffect::calcCoefficientsIfDue(int numSamplesToProcess)
+{
+	if (changeFlag || samplesSinceCoefficientUpdate >= coefficientUpdateInterval)
+	{
+		calcCoefficients();
+		samplesSinceCoefficientUpdate = 0;
+	}
+
+	samplesSinceCoefficientUpdate += numSamplesToProcess;
+}
+
 void MonoFilterEffect::prepareToPlay(double sampleRate, int samplesPerBlock)
 {
 	EffectProcessor::prepareToPlay(sampleRate, samplesPerBlock);
@@ -278,12 +344,12 @@ void MonoFilterEffect::processBlockPartial(AudioSampleBuffer &buffer, int startS
         
         currentGain = 0.3f * Decibels::decibelsToGain(modulatedDecibelValue) + 0.7f * lastCurrentGain;
         
-        calcCoefficients();
+        calcCoefficientsIfDue(numSamples);
     }
     else if (useFixedFrequency)
     {
         currentGain = currentGain * 0.7f + gain * 0.3f;
-        calcCoefficients();
+        calcCoefficientsIfDue(numSamples);
     }
     else
     {
@@ -465,6 +531,8 @@ void PolyFilterEffect::restoreFromValueTree(const ValueTree &v)
 	loadAttribute(MonoFilterEffect::Mode, "Mode");
     loadAttribute(MonoFilterEffect::Quality, "Quality");
 	loadAttribute(MonoFilterEffect::BipolarIntensity, "BipolarIntensity");
+
+	setCoefficientUpdateInterval(v.getProperty("CoefficientUpdateInterval", 0));
 }
 
 ValueTree PolyFilterEffect::exportAsValueTree() const
@@ -478,6 +546,9 @@ ValueTree PolyFilterEffect::exportAsValueTree() const
     saveAttribute(MonoFilterEffect::Quality, "Quality");
 	saveAttribute(MonoFilterEffect::BipolarIntensity, "BipolarIntensity");
 
+	if (coefficientUpdateInterval != 0)
+		v.setProperty("CoefficientUpdateInterval", coefficientUpdateInterval, nullptr);
+
 	return v;
 }
 
@@ -564,6 +635,14 @@ juce::IIRCoefficients PolyFilterEffect::getCurrentCoefficients() const
 	return MonoFilterEffect::getDisplayCoefficients(mode, freq, q, gain, getSampleRate());
 }
 
+void PolyFilterEffect::setCoefficientUpdateInterval(int numSamples)
+{
+	coefficientUpdateInterval = jmax<int>(0, numSamples);
+
+	for (int i = 0; i < voiceFilters.size(); i++)
+		voiceFilters[i]->setCoefficientUpdateInterval(coefficientUpdateInterval);
+}
+
 void PolyFilterEffect::preVoiceRendering(int voiceIndex, int startSample, int numSamples)
 {
 	calculateChain(PolyFilterEffect::FrequencyChain, voiceIndex, startSample, numSamples);
@@ -608,7 +687,7 @@ void PolyFilterEffect::applyEffect(int voiceIndex, AudioSampleBuffer &b, int sta
 	voiceFilters[voiceIndex]->currentFreq = checkFreq;
 	voiceFilters[voiceIndex]->freq = checkFreq;
 
-	voiceFilters[voiceIndex]->calcCoefficients();
+	voiceFilters[voiceIndex]->calcCoefficientsIfDue(numSamples);
 
 	voiceFilters[voiceIndex]->currentFilter->processSamples(b, startSample, numSamples);
 
@@ -619,6 +698,8 @@ void PolyFilterEffect::startVoice(int voiceIndex, int noteNumber)
 {
 	VoiceEffectProcessor::startVoice(voiceIndex, noteNumber);
 
+	// A new voice needs the coefficients for its own modulation values
+	voiceFilters[voiceIndex]->changeFlag = true;
 	voiceFilters[voiceIndex]->currentFilter->reset();
 }
 
@@ -628,19 +709,61 @@ void StaticBiquad::updateCoefficients()
 
 	switch (mode)
 	{
-	case StaticBiquad::LowPass:			currentCoefficients = IIRCoefficients::makeLowPass(sampleRate, frequency); break;
-	case StaticBiquad::HighPass:		currentCoefficients = IIRCoefficients::makeHighPass(sampleRate, frequency); break;
+	case StaticBiquad::LowPass:			currentCoefficients = makeLowPass(FilterCoefficientTable::getPrewarpedFrequency(frequency, sampleRate), 1.0 / std::sqrt(2.0)); break;
+	case StaticBiquad::HighPass:		currentCoefficients = makeHighPass(FilterCoefficientTable::getPrewarpedFrequency(frequency, sampleRate), 1.0 / std::sqrt(2.0)); break;
 	case StaticBiquad::LowShelf:		currentCoefficients = IIRCoefficients::makeLowShelf(sampleRate, frequency, q, (float)gain); break;
 	case StaticBiquad::HighShelf:		currentCoefficients = IIRCoefficients::makeHighShelf(sampleRate, frequency, q, (float)gain); break;
 	case StaticBiquad::Peak:			currentCoefficients = IIRCoefficients::makePeakFilter(sampleRate, frequency, q, (float)gain); break;
-	case StaticBiquad::ResoLow:			currentCoefficients = MonoFilterEffect::makeResoLowPass(sampleRate, frequency, q); break;
-	default:							jassertfalse; break;
+	case StaticBiquad::ResoLow:			currentCoefficients = makeResoLowPass(FilterCoefficientTable::getPrewarpedFrequency(frequency, sampleRate), q); break;
+	default:							jassertfalse; return;
 	}
 
-	for (int i = 0; i < numChannels; i++)
-	{
-		filters[i].setCoefficients(currentCoefficients);
-	}
+	hasCoefficients = true;
+}
+
+IIRCoefficients StaticBiquad::makeLowPass(double prewarpedFrequency, double q)
+{
+	const double n = 1.0 / prewarpedFrequency;
+	const double nSquared = n * n;
+	const double c1 = 1.0 / (1.0 + 1.0 / q * n + nSquared);
+
+	return IIRCoefficients(c1,
+		c1 * 2.0,
+		c1,
+		1.0,
+		c1 * 2.0 * (1.0 - nSquared),
+		c1 * (1.0 - 1.0 / q * n + nSquared));
+}
+
+IIRCoefficients StaticBiquad::makeHighPass(double prewarpedFrequency, double q)
+{
+	const double n = prewarpedFrequency;
+	const double nSquared = n * n;
+	const double c1 = 1.0 / (1.0 + 1.0 / q * n + nSquared);
+
+	return IIRCoefficients(c1,
+		c1 * -2.0,
+		c1,
+		1.0,
+		c1 * 2.0 * (nSquared - 1.0),
+		c1 * (1.0 - 1.0 / q * n + nSquared));
+}
+
+IIRCoefficients StaticBiquad::makeResoLowPass(double prewarpedFrequency, double q)
+{
+	const double c = 1.0 / prewarpedFrequency;
+	const double csq = c * c;
+
+	q = 1 / (3 * q);
+
+	double c1 = 1.0 / (1.0 + (q * c) + (csq));
+
+	return IIRCoefficients(c1,
+		2.0 * c1,
+		c1,
+		1.0,
+		(2.0 * c1) * (1.0 - csq),
+		c1 * (1.0 - (q * c) + csq));
 }
 
 } // namespace hise
@@ -42,6 +42,42 @@ namespace hise { using namespace juce;
 #define MIN_FILTER_FREQ 20.0
 #endif
 
+/** A lookup table for the functions that are needed to calculate the filter coefficients.
+*
+*	A modulated filter recalculates its coefficients for every block, which means lots of tan() and exp() calls 
+*	on the audio thread. This table stores these functions for the normalised frequency (frequency / samplerate)
+*	and interpolates linearly between the table points. Frequencies outside the table range are calculated directly.
+*/
+class FilterCoefficientTable
+{
+public:
+
+	enum
+	{
+		TableSize = 4096
+	};
+
+	/** Returns tan(pi * frequency / sampleRate) (the prewarped frequency of a bilinear-transform filter). */
+	static double getPrewarpedFrequency(double frequency, double sampleRate);
+
+	/** Returns exp(-2 * pi * frequency / sampleRate) (the feedback of a one pole filter). */
+	static double getOnePoleDecay(double frequency, double sampleRate);
+
+private:
+
+	FilterCoefficientTable();
+
+	static const FilterCoefficientTable& getInstance();
+
+	static double interpolate(const float* table, double index);
+
+	/** The highest normalised frequency in the table (tan goes to infinity at 0.5). */
+	static constexpr double MaxNormalisedFrequency = 0.49;
+
+	float tanTable[TableSize + 1];
+	float expTable[TableSize + 1];
+};
+
 /** A base class for filters with multiple channels. 
 *
 *   It exposes an interface for different filter types which have common methods for
@@ -81,6 +117,9 @@ public:
 
 	void setFreqAndQ(double newFrequency, double newQ)
 	{
+		if (frequency == newFrequency && q == newQ)
+			return;
+
 		frequency = newFrequency;
 		q = newQ;
 		updateCoefficients();
@@ -131,8 +170,23 @@ public:
     /** Implement the filter algorithm here. */
 	virtual void processSamples(AudioSampleBuffer& buffer, int startSample, int numSamples) = 0;
 
+	/** Processes the channels one after another without SIMD instructions.
+	*
+	*	The vectorized filters override this with the scalar version of their algorithm, so the results can be compared.
+	*/
+	virtual void processSamplesScalar(AudioSampleBuffer& buffer, int startSample, int numSamples)
+	{
+		processSamples(buffer, startSample, numSamples);
+	}
+
 protected:
 
+	/** The size of the state arrays (the unused lanes of the last channel group need a slot too). */
+	enum
+	{
+		NumStateSlots = NUM_FILTER_STATE_SLOTS(NUM_MAX_CHANNELS)
+	};
+
 	double sampleRate = 44100.0;
 	double frequency = 10000.0;
 	double q = 1.0;
@@ -158,13 +212,13 @@ public:
 	MoogFilter()
 	{
 		in1 = data;
-		in2 = in1 + NUM_MAX_CHANNELS;
-		in3 = in2 + NUM_MAX_CHANNELS;
-		in4 = in3 + NUM_MAX_CHANNELS;
-		out1 = in4 + NUM_MAX_CHANNELS;
-		out2 = out1 + NUM_MAX_CHANNELS;
-		out3 = out2 + NUM_MAX_CHANNELS;
-		out4 = out3 + NUM_MAX_CHANNELS;
+		in2 = in1 + NumStateSlots;
+		in3 = in2 + NumStateSlots;
+		in4 = in3 + NumStateSlots;
+		out1 = in4 + NumStateSlots;
+		out2 = out1 + NumStateSlots;
+		out3 = out2 + NumStateSlots;
+		out4 = out3 + NumStateSlots;
 
 
 		reset();
@@ -174,7 +228,7 @@ public:
 
 	void reset()
 	{
-		memset(data, 0, sizeof(double)*NUM_MAX_CHANNELS * 8);
+		memset(data, 0, sizeof(double)*NumStateSlots * 8);
 	}
 
 	void setMode(int newMode)
@@ -205,31 +259,59 @@ public:
 			setNumChannels(buffer.getNumChannels());
 		}
 
-		for (int c = 0; c < numChannels; c++)
-		{
-			float* d = buffer.getWritePointer(c, startSample);
+		// A single channel would leave the other lanes empty
+		if (numChannels == 1)
+			processLanes<FilterLanes<double, 1>>(buffer, startSample, numSamples);
+		else
+			processLanes<DoubleLanes>(buffer, startSample, numSamples);
+	}
 
-			for (int i = 0; i < numSamples; i++)
-			{
-				double input = (double)d[i];
-
-				input -= out4[c] * fb;
-				input *= 0.35013 * fss;
-				out1[c] = input + 0.3 * in1[c] + invF * out1[c]; 
-				in1[c] = input;
-				out2[c] = out1[c] + 0.3 * in2[c] + invF * out2[c]; 
-				in2[c] = out1[c];
-				out3[c] = out2[c] + 0.3 * in3[c] + invF * out3[c]; 
-				in3[c] = out2[c];
-				out4[c] = out3[c] + 0.3 * in4[c] + invF * out4[c]; 
-				in4[c] = out3[c];
-				d[i] = 2.0f * (float)out4[c];
-			}
+	void processSamplesScalar(AudioSampleBuffer& buffer, int startSample, int numSamples) override
+	{
+		if (numChannels != buffer.getNumChannels())
+		{
+			setNumChannels(buffer.getNumChannels());
 		}
+
+		processLanes<FilterLanes<double, 1>>(buffer, startSample, numSamples);
 	}
 
 private:
 
+	template <class LaneType> void processLanes(AudioSampleBuffer& buffer, int startSample, int numSamples)
+	{
+		processChannelsInLanes<LaneType>(buffer, numChannels, startSample, numSamples, [this](int c, double* d, int n)
+		{
+			const LaneType feedback(fb), inputGain(0.35013 * fss), feedForward(0.3), invFLanes(invF), outputGain(2.0);
+
+			LaneType i1 = LaneType::load(in1 + c), i2 = LaneType::load(in2 + c), i3 = LaneType::load(in3 + c), i4 = LaneType::load(in4 + c);
+			LaneType o1 = LaneType::load(out1 + c), o2 = LaneType::load(out2 + c), o3 = LaneType::load(out3 + c), o4 = LaneType::load(out4 + c);
+
+			for (int i = 0; i < n; i++)
+			{
+				double* sample = d + i * LaneType::NumLanes;
+
+				LaneType input = LaneType::load(sample);
+
+				input = input - o4 * feedback;
+				input = input * inputGain;
+				o1 = input + feedForward * i1 + invFLanes * o1;
+				i1 = input;
+				o2 = o1 + feedForward * i2 + invFLanes * o2;
+				i2 = o1;
+				o3 = o2 + feedForward * i3 + invFLanes * o3;
+				i3 = o2;
+				o4 = o3 + feedForward * i4 + invFLanes * o4;
+				i4 = o3;
+
+				(outputGain * o4).store(sample);
+			}
+
+			i1.store(in1 + c); i2.store(in2 + c); i3.store(in3 + c); i4.store(in4 + c);
+			o1.store(out1 + c); o2.store(out2 + c); o3.store(out3 + c); o4.store(out4 + c);
+		});
+	}
+
 	enum Index
 	{
 		In1 = 0,
@@ -244,7 +326,7 @@ private:
 
 	Mode mode;
 
-	double data[NUM_MAX_CHANNELS * 8];
+	double data[NumStateSlots * 8];
 
 	double* in1;
 	double* in2;
@@ -279,7 +361,7 @@ public:
 
 	SimpleOnePole()
 	{
-		memset(lastValues, 0, sizeof(float)*NUM_MAX_CHANNELS);
+		memset(lastValues, 0, sizeof(float)*NumStateSlots);
 	}
 
 	void reset() override
@@ -289,7 +371,7 @@ public:
 
 	void updateCoefficients() override
 	{
-		const double x = exp(-2.0*double_Pi*frequency / sampleRate);
+		const double x = FilterCoefficientTable::getOnePoleDecay(frequency, sampleRate);
 
 		a0 = (float)(1.0 - x);
 		b1 = (float)-x;
@@ -302,49 +384,63 @@ public:
 			setNumChannels(buffer.getNumChannels());
 		}
 		
-		switch (type)
+		if (numChannels == 1)
+			processLanes<FilterLanes<float, 1>>(buffer, startSample, numSamples);
+		else
+			processLanes<FloatLanes>(buffer, startSample, numSamples);
+	}
+
+	void processSamplesScalar(AudioSampleBuffer& buffer, int startSample, int numSamples) override
+	{
+		if (buffer.getNumSamples() != numChannels)
 		{
-		case FilterType::HP:
+			setNumChannels(buffer.getNumChannels());
+		}
+
+		processLanes<FilterLanes<float, 1>>(buffer, startSample, numSamples);
+	}
+
+private:
+
+	template <class LaneType> void processLanes(AudioSampleBuffer& buffer, int startSample, int numSamples)
+	{
+		if (type != FilterType::HP && type != FilterType::LP)
+			return;
+
+		processChannelsInLanes<LaneType>(buffer, numChannels, startSample, numSamples, [this](int c, float* d, int n)
 		{
-			for (int c = 0; c < numChannels; c++)
-			{
-				float *d = buffer.getWritePointer(c, startSample);
+			const LaneType a0Lanes(a0), b1Lanes(b1);
+
+			LaneType last = LaneType::load(lastValues + c);
 
-				for (int i = 0; i < numSamples; i++)
+			if (type == FilterType::HP)
+			{
+				for (int i = 0; i < n; i++)
 				{
-					const float tmp = a0*d[i] - b1*lastValues[c];
-					lastValues[c] = tmp;
-					d[i] = d[i] - tmp;
+					float* sample = d + i * LaneType::NumLanes;
 
+					const LaneType input = LaneType::load(sample);
+					const LaneType tmp = a0Lanes * input - b1Lanes * last;
+					last = tmp;
+					(input - tmp).store(sample);
 				}
 			}
-
-			break;
-		}
-		case FilterType::LP:
-		{
-			for (int c = 0; c < numChannels; c++)
+			else
 			{
-				float *d = buffer.getWritePointer(c, startSample);
-
-				for (int i = 0; i < numSamples; i++)
+				for (int i = 0; i < n; i++)
 				{
-					d[i] = a0*d[i] - b1*lastValues[c];
-					lastValues[c] = d[i];
+					float* sample = d + i * LaneType::NumLanes;
+
+					last = a0Lanes * LaneType::load(sample) - b1Lanes * last;
+					last.store(sample);
 				}
 			}
 
-			break;
-		}
-
-		}
-
-		
+			last.store(lastValues + c);
+		});
 	}
 
-private:
-
-	float lastValues[NUM_MAX_CHANNELS];
+	float lastValues[NumStateSlots];
 
 	float a0;
 	float b1;
@@ -415,12 +511,16 @@ public:
 	};
 
 
+	StaticBiquad()
+	{
+		memset(v1, 0, sizeof(float) * NumStateSlots);
+		memset(v2, 0, sizeof(float) * NumStateSlots);
+	}
+
 	void reset() override
 	{
-		for (int i = 0; i < numChannels; i++)
-		{
-			filters[i].reset();
-		}
+		memset(v1, 0, sizeof(float) * NumStateSlots);
+		memset(v2, 0, sizeof(float) * NumStateSlots);
 	}
 
 	void processSamples(AudioSampleBuffer& b, int startSample, int numSamples)
@@ -430,18 +530,80 @@ public:
 			setNumChannels(b.getNumChannels());
 		}
 
-		for (int i = 0; i < numChannels; i++)
+		if (numChannels == 1)
+			processLanes<FilterLanes<float, 1>>(b, startSample, numSamples);
+		else
+			processLanes<FloatLanes>(b, startSample, numSamples);
+	}
+
+	void processSamplesScalar(AudioSampleBuffer& b, int startSample, int numSamples) override
+	{
+		if (numChannels != b.getNumChannels())
 		{
-			float* d = b.getWritePointer(i, startSample);
-			filters[i].processSamples(d, numSamples);
+			setNumChannels(b.getNumChannels());
 		}
+
+		processLanes<FilterLanes<float, 1>>(b, startSample, numSamples);
 	}
 
 	void updateCoefficients() override;
 
 	IIRCoefficients currentCoefficients;
 
-	IIRFilter filters[NUM_MAX_CHANNELS];
+private:
+
+	/** The same as IIRCoefficients::makeLowPass(), but with the already prewarped frequency. */
+	static IIRCoefficients makeLowPass(double prewarpedFrequency, double q);
+
+	/** The same as IIRCoefficients::makeHighPass(), but with the already prewarped frequency. */
+	static IIRCoefficients makeHighPass(double prewarpedFrequency, double q);
+
+	/** The same as MonoFilterEffect::makeResoLowPass(), but with the already prewarped frequency. */
+	static IIRCoefficients makeResoLowPass(double prewarpedFrequency, double q);
+
+	/** The same transposed direct form II as JUCE's IIRFilter with the state of each channel in one lane. */
+	template <class LaneType> void processLanes(AudioSampleBuffer& b, int startSample, int numSamples)
+	{
+		// Like an IIRFilter without coefficients, it doesn't change the signal
+		if (!hasCoefficients)
+			return;
+
+		processChannelsInLanes<LaneType>(b, numChannels, startSample, numSamples, [this](int c, float* d, int n)
+		{
+			const float* coefficients = currentCoefficients.coefficients;
+
+			const LaneType c0(coefficients[0]), c1(coefficients[1]), c2(coefficients[2]), c3(coefficients[3]), c4(coefficients[4]);
+
+			LaneType lv1 = LaneType::load(v1 + c);
+			LaneType lv2 = LaneType::load(v2 + c);
+
+			for (int i = 0; i < n; i++)
+			{
+				float* sample = d + i * LaneType::NumLanes;
+
+				const LaneType in = LaneType::load(sample);
+				const LaneType out = c0 * in + lv1;
+				out.store(sample);
+
+				lv1 = c1 * in - c3 * out + lv2;
+				lv2 = c2 * in - c4 * out;
+			}
+
+			lv1.store(v1 + c);
+			lv2.store(v2 + c);
+		});
+
+		for (int i = 0; i < numChannels; i++)
+		{
+			JUCE_SNAP_TO_ZERO(v1[i]);
+			JUCE_SNAP_TO_ZERO(v2[i]);
+		}
+	}
+
+	bool hasCoefficients = false;
+
+	float v1[NumStateSlots];
+	float v2[NumStateSlots];
 };
 
 
@@ -578,20 +740,21 @@ public:
 
 	void reset() override
 	{
-		memset(buf, 0, sizeof(float) * NUM_MAX_CHANNELS * 4);
+		memset(buf, 0, sizeof(float) * NumStateSlots * 4);
 		updateCoefficients();
 	}
 
 	void processSamples(AudioSampleBuffer& b, int startSample, int numSamples)
 	{
-		for (int c = 0; c < b.getNumChannels(); c++)
-		{
-			for (int i = 0; i < numSamples; i++)
-			{
-				float* d = b.getWritePointer(c, i + startSample);
-				*d = processSample(*d, c);
-			}
-		}
+		if (b.getNumChannels() == 1)
+			processLanes<FilterLanes<float, 1>>(b, startSample, numSamples);
+		else
+			processLanes<FloatLanes>(b, startSample, numSamples);
+	}
+
+	void processSamplesScalar(AudioSampleBuffer& b, int startSample, int numSamples) override
+	{
+		processLanes<FilterLanes<float, 1>>(b, startSample, numSamples);
 	}
 
 	void updateCoefficients() override
@@ -606,21 +769,41 @@ public:
 
 private:
 
-	float processSample(float input, int channel)
+	template <class LaneType> void processLanes(AudioSampleBuffer& b, int startSample, int numSamples)
 	{
-		float* buffer = buf[channel];
+		const int numChannelsToProcess = jmin<int>(NUM_MAX_CHANNELS, b.getNumChannels());
 
-		float resoclip = buffer[3];
+		processChannelsInLanes<LaneType>(b, numChannelsToProcess, startSample, numSamples, [this](int c, float* d, int n)
+		{
+			const LaneType cutLanes(cut), resLanes(res), outputGain(2.0f);
 
-		const float in = input - (resoclip * res);
-		buffer[0] = ((in - buffer[0]) * cut) + buffer[0];
-		buffer[1] = ((buffer[0] - buffer[1]) * cut) + buffer[1];
-		buffer[2] = ((buffer[1] - buffer[2]) * cut) + buffer[2];
-		buffer[3] = ((buffer[2] - buffer[3]) * cut) + buffer[3];
-		return 2.0f * buffer[3];
+			LaneType b0 = LaneType::load(buf[0] + c);
+			LaneType b1 = LaneType::load(buf[1] + c);
+			LaneType b2 = LaneType::load(buf[2] + c);
+			LaneType b3 = LaneType::load(buf[3] + c);
+
+			for (int i = 0; i < n; i++)
+			{
+				float* sample = d + i * LaneType::NumLanes;
+
+				const LaneType in = LaneType::load(sample) - (b3 * resLanes);
+				b0 = ((in - b0) * cutLanes) + b0;
+				b1 = ((b0 - b1) * cutLanes) + b1;
+				b2 = ((b1 - b2) * cutLanes) + b2;
+				b3 = ((b2 - b3) * cutLanes) + b3;
+
+				(outputGain * b3).store(sample);
+			}
+
+			b0.store(buf[0] + c);
+			b1.store(buf[1] + c);
+			b2.store(buf[2] + c);
+			b3.store(buf[3] + c);
+		});
 	}
 
-	float buf[NUM_MAX_CHANNELS][4];
+	// The four stages for every channel
+	float buf[4][NumStateSlots];
 
 	float cut;
 	float res;
@@ -932,9 +1115,9 @@ public:
 
 	StateVariableFilter()
 	{
-		memset(v0z, 0, sizeof(float)*NUM_MAX_CHANNELS);
-		memset(z1_A, 0, sizeof(float)*NUM_MAX_CHANNELS);
-		memset(v2, 0, sizeof(float)*NUM_MAX_CHANNELS);
+		memset(v0z, 0, sizeof(float)*NumStateSlots);
+		memset(z1_A, 0, sizeof(float)*NumStateSlots);
+		memset(v2, 0, sizeof(float)*NumStateSlots);
 	}
 
 	void reset() 
@@ -950,13 +1133,8 @@ public:
 
 		if (type == FilterType::ALLPASS)
 		{
-			// prewarp the cutoff (for bilinear-transform filters)
-			float wd = static_cast<float>(frequency * 2.0f * float_Pi);
-			float T = 1.0f / (float)sampleRate;
-			float wa = (2.0f / T) * tan(wd * T / 2.0f);
-
-			// Calculate g (gain element of integrator)
-			gCoeff = wa * T / 2.0f;			// Calculate g (gain element of integrator)
+			// Calculate g (gain element of integrator) from the prewarped cutoff (for bilinear-transform filters)
+			gCoeff = (float)FilterCoefficientTable::getPrewarpedFrequency(frequency, sampleRate);
 
 											// Calculate Zavalishin's R from Q (referred to as damping parameter)
 			RCoeff = 1.0f / (2.0f * (float)q);
@@ -966,7 +1144,7 @@ public:
 		}
 		else
 		{
-			float g = (float)tan(double_Pi * frequency / sampleRate);
+			float g = (float)FilterCoefficientTable::getPrewarpedFrequency(frequency, sampleRate);
 			//float damping = 1.0f / res;
 			//k = damping;
 			k = 1.0f - 0.99f * scaledQ;
@@ -988,128 +1166,99 @@ public:
 			setNumChannels(buffer.getNumChannels());
 		}
 
-		switch (type)
-		{
-		case LP:
-		{
-			for (int c = 0; c < numChannels; c++)
-			{
-				float* d = buffer.getWritePointer(c, startSample);
-
-				for (int i = 0; i < numSamples; i++)
-				{
-					float v0 = d[i];
-					float v1z = z1_A[c];
-					float v2z = v2[c];
-					float v3 = v0 + v0z[c] - 2.0f * v2z;
-					z1_A[c] += g1 * v3 - g2 * v1z;
-					v2[c] += g3 * v3 + g4 * v1z;
-					v0z[c] = v0;
-					d[i] = v2[c];
-				}
-			}
+		if (numChannels == 1)
+			processLanes<FilterLanes<float, 1>>(buffer, startSample, numSamples);
+		else
+			processLanes<FloatLanes>(buffer, startSample, numSamples);
+	}
 
-			break;
-		}
-		case BP:
+	void processSamplesScalar(AudioSampleBuffer& buffer, int startSample, int numSamples) override
+	{
+		if (numChannels != buffer.getNumChannels())
 		{
-			for (int c = 0; c < numChannels; c++)
-			{
-				float* d = buffer.getWritePointer(c, startSample);
+			setNumChannels(buffer.getNumChannels());
+		}
 
-				for (int i = 0; i < numSamples; i++)
-				{
-					float v0 = d[i];
-					float v1z = z1_A[c];
-					float v2z = v2[c];
-					float v3 = v0 + v0z[c] - 2.0f * v2z;
-					z1_A[c] += g1 * v3 - g2 * v1z;
-					v2[c] += g3 * v3 + g4 * v1z;
-					v0z[c] = v0;
-					d[i] = z1_A[c];
-				}
-			}
+		processLanes<FilterLanes<float, 1>>(buffer, startSample, numSamples);
+	}
 
-			break;
-		}
+private:
 
-		case HP:
+	template <class LaneType> void processLanes(AudioSampleBuffer& buffer, int startSample, int numSamples)
+	{
+		switch (type)
 		{
-			for (int c = 0; c < numChannels; c++)
-			{
-				float* d = buffer.getWritePointer(c, startSample);
+		case LP:				processChannelsInLanes<LaneType>(buffer, numChannels, startSample, numSamples, [this](int c, float* d, int n) { processStateVariable<LaneType, LP>(c, d, n); }); break;
+		case HP:				processChannelsInLanes<LaneType>(buffer, numChannels, startSample, numSamples, [this](int c, float* d, int n) { processStateVariable<LaneType, HP>(c, d, n); }); break;
+		case BP:				processChannelsInLanes<LaneType>(buffer, numChannels, startSample, numSamples, [this](int c, float* d, int n) { processStateVariable<LaneType, BP>(c, d, n); }); break;
+		case NOTCH:				processChannelsInLanes<LaneType>(buffer, numChannels, startSample, numSamples, [this](int c, float* d, int n) { processStateVariable<LaneType, NOTCH>(c, d, n); }); break;
+		case FilterType::ALLPASS:	processChannelsInLanes<LaneType>(buffer, numChannels, startSample, numSamples, [this](int c, float* d, int n) { processAllpass<LaneType>(c, d, n); }); break;
+		}
+	}
 
-				for (int i = 0; i < numSamples; i++)
-				{
-					float v0 = d[i];
-					float v1z = z1_A[c];
-					float v2z = v2[c];
-					float v3 = v0 + v0z[c] - 2.0f * v2z;
-					z1_A[c] += g1 * v3 - g2 * v1z;
-					v2[c] += g3 * v3 + g4 * v1z;
-					v0z[c] = v0;
-					d[i] = v0 - k * z1_A[c] - v2[c];
-				}
-			}
+	template <class LaneType, int Mode> void processStateVariable(int c, float* d, int numSamples)
+	{
+		const LaneType g1Lanes(g1), g2Lanes(g2), g3Lanes(g3), g4Lanes(g4), kLanes(k), two(2.0f);
 
-			break;
-		}
-		case FilterType::ALLPASS:
-		{
-			for (int c = 0; c < numChannels; c++)
-			{
-				float* d = buffer.getWritePointer(c, startSample);
+		LaneType lastInput = LaneType::load(v0z + c);
+		LaneType z1 = LaneType::load(z1_A + c);
+		LaneType z2 = LaneType::load(v2 + c);
 
-				for (int i = 0; i < numSamples; ++i)
-				{
-					const float input = d[i];
-					const float HP = (input - x1 * z1_A[c] - v2[c]) / x2;
-					const float BP = HP * gCoeff + z1_A[c];
-					const float LP = BP * gCoeff + v2[c];
+		for (int i = 0; i < numSamples; i++)
+		{
+			float* sample = d + i * LaneType::NumLanes;
 
-					z1_A[c] = gCoeff * HP + BP;
-					v2[c] = gCoeff * BP + LP;
+			const LaneType v0 = LaneType::load(sample);
+			const LaneType v1z = z1;
+			const LaneType v2z = z2;
+			const LaneType v3 = v0 + lastInput - two * v2z;
+			z1 = z1 + (g1Lanes * v3 - g2Lanes * v1z);
+			z2 = z2 + (g3Lanes * v3 + g4Lanes * v1z);
+			lastInput = v0;
 
-					const float AP = input - (4.0f * RCoeff * BP);
-					d[i] = AP;
-				}
+			switch (Mode)
+			{
+			case LP:	z2.store(sample); break;
+			case BP:	z1.store(sample); break;
+			case HP:	(v0 - kLanes * z1 - z2).store(sample); break;
+			case NOTCH:	(v0 - kLanes * z1).store(sample); break;
 			}
-			
+		}
 
-			
+		lastInput.store(v0z + c);
+		z1.store(z1_A + c);
+		z2.store(v2 + c);
+	}
 
-			break;
-		}
+	template <class LaneType> void processAllpass(int c, float* d, int numSamples)
+	{
+		const LaneType g(gCoeff), x1Lanes(x1), x2Lanes(x2), apGain(4.0f * RCoeff);
 
-		case NOTCH:
+		LaneType z1 = LaneType::load(z1_A + c);
+		LaneType z2 = LaneType::load(v2 + c);
+
+		for (int i = 0; i < numSamples; i++)
 		{
-			for (int c = 0; c < numChannels; c++)
-			{
-				float* d = buffer.getWritePointer(c, startSample);
+			float* sample = d + i * LaneType::NumLanes;
 
-				for (int i = 0; i < numSamples; i++)
-				{
-					float v0 = d[i];
-					float v1z = z1_A[c];
-					float v2z = v2[c];
-					float v3 = v0 + v0z[c] - 2.0f * v2z;
-					z1_A[c] += g1 * v3 - g2 * v1z;
-					v2[c] += g3 * v3 + g4 * v1z;
-					v0z[c] = v0;
-					d[i] = v0 - k * z1_A[c];
-				}
-			}
+			const LaneType input = LaneType::load(sample);
+			const LaneType HP = (input - x1Lanes * z1 - z2) / x2Lanes;
+			const LaneType BP = HP * g + z1;
+			const LaneType LP = BP * g + z2;
 
-			break;
-		}
+			z1 = g * HP + BP;
+			z2 = g * BP + LP;
+
+			(input - apGain * BP).store(sample);
 		}
-	}
 
-private:
+		z1.store(z1_A + c);
+		z2.store(v2 + c);
+	}
 	
-	float v0z[NUM_MAX_CHANNELS];
-	float z1_A[NUM_MAX_CHANNELS];
-	float v2[NUM_MAX_CHANNELS];
+	float v0z[NumStateSlots];
+	float z1_A[NumStateSlots];
+	float v2[NumStateSlots];
 
 	float k, g1, g2, g3, g4, x1, x2, gCoeff, RCoeff;
 
@@ -1211,6 +1360,15 @@ public:
 	void setUseInternalChains(bool shouldBeUsed) { useInternalChains = shouldBeUsed; };
 	void setUseFixedFrequency(bool shouldUseFixedFrequency) { useFixedFrequency = shouldUseFixedFrequency; }
 
+	/** Sets the amount of samples that the filter keeps its coefficients before it calculates new ones.
+	*
+	*	Heavy cutoff modulation causes a coefficient update for every block. With an interval, the updates 
+	*	are limited to one per interval, so the CPU usage doesn't depend on the modulation. 
+	*	Zero (the default) calculates new coefficients for every block.
+	*/
+	void setCoefficientUpdateInterval(int numSamples) { coefficientUpdateInterval = jmax<int>(0, numSamples); };
+	int getCoefficientUpdateInterval() const { return coefficientUpdateInterval; };
+
 	float getAttribute(int parameterIndex) const override;;
 	void setInternalAttribute(int parameterIndex, float newValue) override;;
 	float getDefaultValue(int parameterIndex) const override;
@@ -1272,6 +1430,9 @@ private:
 
 	void calcCoefficients();
 
+	/** Calculates the coefficients if the update interval has passed (or a parameter was changed) and counts the samples. */
+	void calcCoefficientsIfDue(int numSamplesToProcess);
+
 	bool useInternalChains;
 	bool useFixedFrequency;
 
@@ -1314,6 +1475,9 @@ private:
 
 	double lastSampleRate = 0.0;
 
+	int coefficientUpdateInterval = 0;
+	int samplesSinceCoefficientUpdate = 0;
+
 };
 
 
@@ -1367,10 +1531,16 @@ public:
 
 	IIRCoefficients getCurrentCoefficients() const override;;
 
+	/** Sets the coefficient update interval of every voice filter. @see MonoFilterEffect::setCoefficientUpdateInterval() */
+	void setCoefficientUpdateInterval(int numSamples);
+	int getCoefficientUpdateInterval() const { return coefficientUpdateInterval; };
+
 private:
 
 	friend class HarmonicFilter;
 
+	int coefficientUpdateInterval = 0;
+
 	bool changeFlag;
 
 	double currentFreq;
@@ -248,6 +248,18 @@ hise::ProcessorEditorBody * ShapeFX::createEditor(ProcessorEditor *parentEditor)
 }
 
 
+void ShapeFX::postCompileCallback()
+{
+	auto r = static_cast<ScriptShaper*>(shapers[ShapeMode::Script])->compileFunction(functionCode->getAllContent());
+
+	if (r.wasOk())
+		debugToConsole(this, "Update shape function (compiled to a block function)");
+	else
+		debugToConsole(this, "Update shape function (interpreted: " + r.getErrorMessage() + ")");
+
+	updateMode();
+}
+
 void ShapeFX::registerApiClasses()
 {
 	content = new ScriptingApi::Content(this);
@@ -205,11 +205,7 @@ public:
 		return nullptr;
 	};
 
-	void postCompileCallback() override
-	{
-		debugToConsole(this, "Update shape function");
-		updateMode();
-	}
+	void postCompileCallback() override;
 
 	ProcessorEditorBody *createEditor(ProcessorEditor *parentEditor)  override;
 
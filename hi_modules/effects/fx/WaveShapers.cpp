@@ -233,6 +233,13 @@ public:
 	{
 		SpinLock::ScopedLockType sl(scriptLock);
 
+		if (compiledFunction != nullptr)
+		{
+			compiledFunction->process(l, numSamples, parent->gain);
+			compiledFunction->process(r, numSamples, parent->gain);
+			return;
+		}
+
 		static const Identifier g("gain");
 		parent->scriptEngine->getRootObject()->setProperty(g, parent->gain);
 
@@ -247,18 +254,44 @@ public:
 	{
 		SpinLock::ScopedLockType sl(scriptLock);
 
+		if (compiledFunction != nullptr)
+			return compiledFunction->getSingleValue(input, parent->gain);
+
 		static const Identifier g("gain");
 
 		parent->scriptEngine->getRootObject()->setProperty(g, parent->gain);
 		return calculateSingleValue(input);
 	}
 
+	/** Tries to compile the shape function into a block function. 
+	*
+	*	If the code can't be compiled, the shaper falls back to calling the interpreter for each sample. 
+	*/
+	Result compileFunction(const String& code)
+	{
+		ScopedPointer<CompiledShapeFunction> newFunction = new CompiledShapeFunction();
+
+		auto r = newFunction->compile(code);
+
+		if (!r.wasOk())
+			newFunction = nullptr;
+
+		{
+			SpinLock::ScopedLockType sl(scriptLock);
+			compiledFunction.swapWith(newFunction);
+		}
+
+		return r;
+	}
+
 	ShapeFX* parent = nullptr;
 	Result shapeResult;
 	SpinLock scriptLock;
 
 private:
 
+	ScopedPointer<CompiledShapeFunction> compiledFunction;
+
 	float calculateSingleValue(float input)
 	{
 		float value = 0.0f;
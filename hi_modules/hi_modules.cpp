@@ -124,6 +124,7 @@ namespace wdl
 #include "effects/fx/AudioProcessorWrapper.cpp"
 #include "effects/fx/SlotFX.cpp"
 #include "effects/fx/Analyser.cpp"
+#include "effects/fx/CompiledShapeFunction.cpp"
 #include "effects/fx/WaveShapers.cpp"
 #include "effects/fx/ShapeFX.cpp"
 
@@ -145,6 +145,7 @@ END_JUCE_MODULE_DECLARATION
 #include "effects/MdaEffectWrapper.h"
 
 #include "effects/fx/RouteFX.h"
+#include "effects/fx/FilterLanes.h"
 #include "effects/fx/Filters.h"
 #include "effects/fx/HarmonicFilter.h"
 #include "effects/fx/CurveEq.h"
@@ -163,6 +164,7 @@ END_JUCE_MODULE_DECLARATION
 #include "effects/fx/Saturator.h"
 #include "effects/fx/AudioProcessorWrapper.h"
 #include "effects/fx/Analyser.h"
+#include "effects/fx/CompiledShapeFunction.h"
 #include "effects/fx/ShapeFX.h"
 #include "effects/fx/SlotFX.h"
 
@@ -130,7 +130,7 @@ ValueTree AhdsrEnvelope::exportAsValueTree() const
 
 float AhdsrEnvelope::getSampleRateForCurrentMode() const
 {
-	auto sr = getSampleRate();
+	auto sr = getSampleRate() / (double)getControlRateDivider();
 	if (ecoMode) sr *= (1.0 / (double)downsampleFactor);
 
 	return (float)sr;
@@ -299,6 +299,7 @@ void AhdsrEnvelope::calculateBlock(int startSample, int numSamples)
 		{
 			FloatVectorOperations::fill(internalBuffer.getWritePointer(0, startSample), thisSustainValue, numSamples);
 			startSample += numSamples;
+			setBlockIsConstant();
 		}
 
 		state->lastSustainValue = thisSustainValue;
@@ -465,6 +466,15 @@ void AhdsrEnvelope::prepareToPlay(double sampleRate, int samplesPerBlock)
 
 }
 
+void AhdsrEnvelope::controlRateDividerChanged()
+{
+	setAttackRate(attack);
+	setHoldTime(hold);
+	setDecayRate(decay);
+	setReleaseRate(release);
+	setSustainLevel(sustain);
+}
+
 bool AhdsrEnvelope::isPlaying(int voiceIndex) const
 {
 	if (isMonophonic)
@@ -143,6 +143,9 @@ public:
 
 	void prepareToPlay(double sampleRate, int samplesPerBlock) override;
 
+	/** The envelope calculates its coefficients for the control rate of the chain. */
+	bool supportsControlRate() const override { return true; }
+
 	/** @brief returns \c true, if the envelope is not IDLE and not bypassed. */
 	bool isPlaying(int voiceIndex) const override;;
     
@@ -216,6 +219,8 @@ public:
 
 private:
 
+	void controlRateDividerChanged() override;
+
 	int downsampleFactor = 1;
 
 	float getSampleRateForCurrentMode() const;
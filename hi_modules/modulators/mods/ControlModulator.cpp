@@ -211,6 +211,7 @@ void ControlModulator::calculateBlock(int startSample, int numSamples)
 	{
 		currentValue = targetValue;
 		FloatVectorOperations::fill(internalBuffer.getWritePointer(0, startSample), currentValue, numSamples);
+		setBlockIsConstant();
 	}
 
 	if (useTable && lastInputValue != inputValue)
@@ -388,7 +388,7 @@ void LfoModulator::prepareToPlay(double sampleRate, int samplesPerBlock)
 		setAttackRate(attack);
 
 		calcAngleDelta();
-		smoother.prepareToPlay(sampleRate);
+		smoother.prepareToPlay(sampleRate / (double)getControlRateDivider());
 		
 		smoother.setSmoothingTime(smoothingTime);
 
@@ -457,9 +457,26 @@ void LfoModulator::handleHiseEvent(const HiseEvent &m)
 
 
 
+bool LfoModulator::supportsControlRate() const
+{
+	// The modulation chains are rendered with the same amount of values, so they must not contain time variant modulators.
+	return !intensityChain->hasActiveTimeModulators() && !frequencyChain->hasActiveTimeModulators();
+}
+
+void LfoModulator::controlRateDividerChanged()
+{
+	if (getSampleRate() <= 0.0)
+		return;
+
+	setAttackRate(attack);
+	calcAngleDelta();
+	smoother.prepareToPlay(getSampleRate() / (double)getControlRateDivider());
+	smoother.setSmoothingTime(smoothingTime);
+}
+
 void LfoModulator::calcAngleDelta()
 {
-	const double sr = getSampleRate();
+	const double sr = getSampleRate() / (double)getControlRateDivider();
 
 	const float frequencyToUse = tempoSync ? TempoSyncer::getTempoInHertz(getMainController()->getBpm(), currentTempo) :
 		frequency;
@@ -206,6 +206,9 @@ public:
 	/** sets up the smoothing filter. */
 	void prepareToPlay(double sampleRate, int samplesPerBlock) override;
 
+	/** The LFO can run at control rate as long as its intensity and frequency chains are not time variant. */
+	bool supportsControlRate() const override;
+
 	void calculateBlock(int startSample, int numSamples) override
 	{
 #if ENABLE_ALL_PEAK_METERS
@@ -263,6 +266,8 @@ public:
 	
 private:
 
+	void controlRateDividerChanged() override;
+
 	class WaveformUpdater: public SafeChangeListener
 	{
 	public:
@@ -316,7 +321,7 @@ private:
 
 	float calcCoef(float rate, float targetRatio) const
 	{
-		const float factor = (float)getSampleRate() * 0.001f;
+		const float factor = (float)getSampleRate() / (float)getControlRateDivider() * 0.001f;
 
 		rate *= factor;
 
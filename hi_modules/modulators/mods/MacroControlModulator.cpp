@@ -206,6 +206,7 @@ void MacroModulator::calculateBlock(int startSample, int numSamples)
 		currentValue = targetValue;
 
 		FloatVectorOperations::fill(internalBuffer.getWritePointer(0, startSample), currentValue, numSamples);
+		setBlockIsConstant();
 	}
 
 	setOutputValue(currentValue);
@@ -138,6 +138,9 @@ public:
 		addSound (new SineWaveSound());	
 	};
 
+	/** The voices only read the parameters of the synth. */
+	bool canRenderVoicesInParallel() const override { return true; }
+
 	void restoreFromValueTree(const ValueTree &v) override
 	{
 		ModulatorSynth::restoreFromValueTree(v);
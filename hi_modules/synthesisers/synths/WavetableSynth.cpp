@@ -131,74 +131,91 @@ void WavetableSynthVoice::calculateBlock(int startSample, int numSamples)
 
 	if (hqMode)
 	{
-		while (--numSamples >= 0)
-		{
-			// Get the two indexes for the table position
+		// Use the band-limited tables for the highest pitch in this block
+		const double maxPitchValue = voicePitchValues != nullptr ? (double)FloatVectorOperations::findMaximum(voicePitchValues + startSample, numSamples) : 1.0;
+		const int mipMapLevel = currentSound->getMipMapLevelForPitchRatio(uptimeDelta * maxPitchValue);
 
+		// Fade from the previous level over this block, so the harmonics aren't switched with a click
+		const bool crossfadeMipMaps = lastMipMapLevel != -1 && lastMipMapLevel != mipMapLevel;
 
+		const float gainFactor = 1.0f / currentSound->getUnnormalizedMaximum();
 
-			int index = (int)voiceUptime;
-
-			const int i1 = index % (tableSize);
+		double positions[WavetableSound::MaxChunkSize];
+		int lowerTableIndexes[WavetableSound::MaxChunkSize];
+		float tableDeltas[WavetableSound::MaxChunkSize];
+		float tableGainValues[WavetableSound::MaxChunkSize];
+		float lastLevelOutput[WavetableSound::MaxChunkSize];
 
-			int i2 = i1 + 1;
+		while (numSamples > 0)
+		{
+			const int numThisTime = jmin<int>(numSamples, WavetableSound::MaxChunkSize);
 
-			if (i2 >= tableSize)
+			for (int i = 0; i < numThisTime; i++)
 			{
-				const float tableModValue = tableValues[startSample];
-				currentTableIndex = roundToInt(tableModValue * 63);
+				const int sampleIndex = startSample + i;
 
-				i2 = 0;
-			}
+				// Get the two indexes for the table position
 
-			const float tableModValue = tableValues[startSample];
+				const int index = (int)voiceUptime;
 
-			const float tableValue = jlimit<float>(0.0f, 1.0f, tableModValue) * 63.0f;
+				const float tableModValue = tableValues[sampleIndex];
 
-			const int lowerTableIndex = (int)(tableValue);
-			const int upperTableIndex = jmin(63, lowerTableIndex + 1);
-			const float tableDelta = tableValue - (float)lowerTableIndex;
-			jassert(0.0f <= tableDelta && tableDelta <= 1.0f);
+				if ((index % tableSize) + 1 >= tableSize)
+				{
+					currentTableIndex = roundToInt(tableModValue * 63);
+				}
 
-			lowerTable = currentSound->getWaveTableData(lowerTableIndex);
-			upperTable = currentSound->getWaveTableData(upperTableIndex);
+				const float tableValue = jlimit<float>(0.0f, 1.0f, tableModValue) * 63.0f;
 
-			float tableGainValue = tableGainInterpolator.interpolateLinear(currentSound->getUnnormalizedGainValue(lowerTableIndex), currentSound->getUnnormalizedGainValue(upperTableIndex), tableDelta);
+				const int lowerTableIndex = (int)(tableValue);
+				const int upperTableIndex = jmin(63, lowerTableIndex + 1);
+				const float tableDelta = tableValue - (float)lowerTableIndex;
+				jassert(0.0f <= tableDelta && tableDelta <= 1.0f);
 
-			tableGainValue *= getGainValue(tableModValue);
+				float tableGainValue = tableGainInterpolator.interpolateLinear(currentSound->getUnnormalizedGainValue(lowerTableIndex), currentSound->getUnnormalizedGainValue(upperTableIndex), tableDelta);
 
-			float u1 = upperTable[i1];
-			float u2 = upperTable[i2];
+				tableGainValue *= getGainValue(tableModValue);
 
-			float l1 = lowerTable[i1];
-			float l2 = lowerTable[i2];
+				positions[i] = voiceUptime;
+				lowerTableIndexes[i] = lowerTableIndex;
+				tableDeltas[i] = tableDelta;
+				tableGainValues[i] = tableGainValue * gainFactor;
 
-			const float alpha = float(voiceUptime) - (float)index;
-			//const float invAlpha = 1.0f - alpha;
+				jassert(voicePitchValues == nullptr || voicePitchValues[sampleIndex] > 0.0f);
 
-			const float upperSample = tableGainInterpolator.interpolateLinear(u1, u2, alpha);
+				const double delta = (uptimeDelta * (voicePitchValues == nullptr ? 1.0 : voicePitchValues[sampleIndex]));
 
-			const float lowerSample = tableGainInterpolator.interpolateLinear(l1, l2, alpha);
+				voiceUptime += delta;
+			}
 
-			float sample = lowerTableIndex != upperTableIndex ? tableGainInterpolator.interpolateLinear(lowerSample, upperSample, tableDelta) : lowerSample;
+			float* output = voiceBuffer.getWritePointer(0, startSample);
 
-			sample *= tableGainValue;
+			currentSound->renderTableCrossfade(output, positions, lowerTableIndexes, tableDeltas, numThisTime, mipMapLevel);
 
-			sample *= 1.0f / currentSound->getUnnormalizedMaximum();
+			if (crossfadeMipMaps)
+			{
+				currentSound->renderTableCrossfade(lastLevelOutput, positions, lowerTableIndexes, tableDeltas, numThisTime, lastMipMapLevel);
 
-			// Stereo mode assumed
-			voiceBuffer.setSample(0, startSample, sample);
-			voiceBuffer.setSample(1, startSample, sample);
+				const float fadeDelta = 1.0f / (float)samplesToCopy;
+				float fadeValue = (float)(startSample - startIndex) * fadeDelta;
 
-			jassert(voicePitchValues == nullptr || voicePitchValues[startSample] > 0.0f);
+				for (int i = 0; i < numThisTime; i++)
+				{
+					output[i] = lastLevelOutput[i] + fadeValue * (output[i] - lastLevelOutput[i]);
+					fadeValue += fadeDelta;
+				}
+			}
 
-			const double delta = (uptimeDelta * (voicePitchValues == nullptr ? 1.0 : voicePitchValues[startSample]));
+			FloatVectorOperations::multiply(output, tableGainValues, numThisTime);
 
-			voiceUptime += delta;
+			startSample += numThisTime;
+			numSamples -= numThisTime;
+		}
 
-			++startSample;
+		lastMipMapLevel = mipMapLevel;
 
-		}
+		// Stereo mode assumed
+		FloatVectorOperations::copy(voiceBuffer.getWritePointer(1, startIndex), voiceBuffer.getReadPointer(0, startIndex), samplesToCopy);
 	}
 	else
 	{
@@ -356,6 +373,8 @@ WavetableSound::WavetableSound(const ValueTree &wavetableData)
 
 	normalizeTables();
 
+	createMipMaps();
+
 	pitchRatio = 1.0;
 }
 
@@ -374,6 +393,92 @@ const float * WavetableSound::getWaveTableData(int wavetableIndex) const
 	}
 }
 
+const float * WavetableSound::getWaveTableData(int wavetableIndex, int mipMapLevel) const
+{
+	if (mipMapLevel == 0)
+		return getWaveTableData(wavetableIndex);
+
+	if (wavetableIndex < wavetableAmount && mipMapLevel < numMipMapLevels)
+	{
+		return mipMaps.getReadPointer(0, mipMapOffsets[mipMapLevel] + wavetableIndex * mipMapSizes[mipMapLevel]);
+	}
+	else
+	{
+		return nullptr;
+	}
+}
+
+int WavetableSound::getMipMapLevelForPitchRatio(double ratio) const
+{
+	// Aliases of the highest harmonic are allowed as long as they fold back above 90% of the nyquist frequency.
+	const double maxNormalisedFrequency = 0.55;
+
+	int level = 0;
+
+	while (level < numMipMapLevels - 1 && (double)mipMapNumHarmonics[level] * ratio / (double)wavetableSize > maxNormalisedFrequency)
+		level++;
+
+	return level;
+}
+
+void WavetableSound::renderTableCrossfade(float* output, const double* positions, const int* lowerTableIndexes, const float* tableDeltas, int numSamples, int mipMapLevel) const
+{
+	jassert(numSamples <= MaxChunkSize);
+	jassert(mipMapLevel < numMipMapLevels);
+
+	const int size = mipMapSizes[mipMapLevel];
+	const double positionFactor = (double)size / (double)wavetableSize;
+
+	const float* levelData = mipMapLevel == 0 ? wavetables.getReadPointer(0) : mipMaps.getReadPointer(0, mipMapOffsets[mipMapLevel]);
+	const int maxTableIndex = wavetableAmount - 1;
+
+	float lowerNext[MaxChunkSize];
+	float upper[MaxChunkSize];
+	float upperNext[MaxChunkSize];
+	float alphas[MaxChunkSize];
+
+	// The positions are increasing, so the modulo is only needed once per chunk
+	const int firstIndex = (int)(positions[0] * positionFactor);
+	const int cycleStart = firstIndex - firstIndex % size;
+
+	for (int i = 0; i < numSamples; i++)
+	{
+		const double position = positions[i] * positionFactor;
+		const int index = (int)position;
+
+		int i1 = index - cycleStart;
+
+		while (i1 >= size)
+			i1 -= size;
+
+		const int i2 = (i1 + 1 == size) ? 0 : i1 + 1;
+
+		const int lowerTableIndex = jmin<int>(maxTableIndex, lowerTableIndexes[i]);
+		const int upperTableIndex = jmin<int>(maxTableIndex, lowerTableIndex + 1);
+
+		const float* lowerTable = levelData + lowerTableIndex * size;
+		const float* upperTable = levelData + upperTableIndex * size;
+
+		output[i] = lowerTable[i1];
+		lowerNext[i] = lowerTable[i2];
+		upper[i] = upperTable[i1];
+		upperNext[i] = upperTable[i2];
+		alphas[i] = (float)(position - (double)index);
+	}
+
+	// lowerSample = l1 + alpha * (l2 - l1)
+	FloatVectorOperations::subtract(lowerNext, output, numSamples);
+	FloatVectorOperations::addWithMultiply(output, lowerNext, alphas, numSamples);
+
+	// upperSample = u1 + alpha * (u2 - u1)
+	FloatVectorOperations::subtract(upperNext, upper, numSamples);
+	FloatVectorOperations::addWithMultiply(upper, upperNext, alphas, numSamples);
+
+	// sample = lowerSample + tableDelta * (upperSample - lowerSample)
+	FloatVectorOperations::subtract(upper, output, numSamples);
+	FloatVectorOperations::addWithMultiply(output, upper, tableDeltas, numSamples);
+}
+
 void WavetableSound::calculatePitchRatio(double playBackSampleRate)
 {
 	const double idealCycleLength = playBackSampleRate / MidiMessage::getMidiNoteInHertz(noteNumber);
@@ -405,4 +510,172 @@ void WavetableSound::normalizeTables()
 	maximum = 1.0f;
 }
 
+void WavetableSound::createMipMaps()
+{
+	mipMapSizes[0] = wavetableSize;
+	mipMapOffsets[0] = 0;
+	mipMapNumHarmonics[0] = wavetableSize / 2;
+	numMipMapLevels = 1;
+
+	int totalSize = 0;
+
+	while (numMipMapLevels < MaxMipMapLevels && (wavetableSize >> numMipMapLevels) >= MinMipMapSize)
+	{
+		const int size = wavetableSize >> numMipMapLevels;
+
+		mipMapSizes[numMipMapLevels] = size;
+		mipMapOffsets[numMipMapLevels] = totalSize;
+
+		// Leave out the harmonic at the nyquist frequency of the smaller table
+		mipMapNumHarmonics[numMipMapLevels] = (size - 1) / 2;
+
+		totalSize += size * wavetableAmount;
+		numMipMapLevels++;
+	}
+
+	if (numMipMapLevels == 1)
+		return;
+
+	mipMaps.setSize(1, totalSize);
+
+	// Only the harmonics of the first mip map level are needed
+	const int numHarmonics = mipMapNumHarmonics[1];
+
+	HeapBlock<double> re(numHarmonics + 1);
+	HeapBlock<double> im(numHarmonics + 1);
+
+	if (isPowerOfTwo(wavetableSize))
+	{
+		// The levels of a power of two table are power of two sizes too, so every transform can use the FFT
+		ScopedPointer<dsp::FFT> fft = new dsp::FFT(roundToInt(std::log2((double)wavetableSize)));
+		OwnedArray<dsp::FFT> levelFFTs;
+
+		for (int level = 1; level < numMipMapLevels; level++)
+			levelFFTs.add(new dsp::FFT(roundToInt(std::log2((double)mipMapSizes[level]))));
+
+		HeapBlock<float> fftData(2 * wavetableSize);
+
+		for (int t = 0; t < wavetableAmount; t++)
+		{
+			FloatVectorOperations::copy(fftData, getWaveTableData(t), wavetableSize);
+			FloatVectorOperations::clear(fftData + wavetableSize, wavetableSize);
+
+			fft->performRealOnlyForwardTransform(fftData, true);
+
+			// The FFT uses exp(-i), so the sine part has the opposite sign of the DFT below
+			for (int k = 0; k <= numHarmonics; k++)
+			{
+				re[k] = (double)fftData[2 * k] / (double)wavetableSize;
+				im[k] = -(double)fftData[2 * k + 1] / (double)wavetableSize;
+			}
+
+			for (int level = 1; level < numMipMapLevels; level++)
+			{
+				const int size = mipMapSizes[level];
+				const int levelHarmonics = mipMapNumHarmonics[level];
+
+				// The inverse transform divides by the size of the level
+				FloatVectorOperations::clear(fftData, 2 * size);
+
+				for (int k = 0; k <= levelHarmonics; k++)
+				{
+					fftData[2 * k] = (float)(re[k] * (double)size);
+					fftData[2 * k + 1] = (float)(-im[k] * (double)size);
+				}
+
+				levelFFTs[level - 1]->performRealOnlyInverseTransform(fftData);
+
+				FloatVectorOperations::copy(mipMaps.getWritePointer(0, mipMapOffsets[level] + t * size), fftData, size);
+			}
+		}
+
+		return;
+	}
+
+	HeapBlock<double> sinTable(wavetableSize);
+	HeapBlock<double> cosTable(wavetableSize);
+
+	for (int i = 0; i < wavetableSize; i++)
+	{
+		sinTable[i] = std::sin(2.0 * double_Pi * (double)i / (double)wavetableSize);
+		cosTable[i] = std::cos(2.0 * double_Pi * (double)i / (double)wavetableSize);
+	}
+
+	// The sin / cos values of every level (the table size is not always a multiple of the level size)
+	HeapBlock<double> levelSinTable(wavetableSize);
+	HeapBlock<double> levelCosTable(wavetableSize);
+	int levelTableOffsets[MaxMipMapLevels];
+	int levelTableOffset = 0;
+
+	for (int level = 1; level < numMipMapLevels; level++)
+	{
+		const int size = mipMapSizes[level];
+
+		levelTableOffsets[level] = levelTableOffset;
+
+		for (int i = 0; i < size; i++)
+		{
+			levelSinTable[levelTableOffset + i] = std::sin(2.0 * double_Pi * (double)i / (double)size);
+			levelCosTable[levelTableOffset + i] = std::cos(2.0 * double_Pi * (double)i / (double)size);
+		}
+
+		levelTableOffset += size;
+	}
+
+	for (int t = 0; t < wavetableAmount; t++)
+	{
+		const float* data = getWaveTableData(t);
+
+		// A plain DFT for the other table sizes. The phase index k * n is wrapped while it's advanced.
+		for (int k = 0; k <= numHarmonics; k++)
+		{
+			double sumRe = 0.0;
+			double sumIm = 0.0;
+			int phase = 0;
+
+			for (int n = 0; n < wavetableSize; n++)
+			{
+				sumRe += (double)data[n] * cosTable[phase];
+				sumIm += (double)data[n] * sinTable[phase];
+
+				phase += k;
+
+				if (phase >= wavetableSize)
+					phase -= wavetableSize;
+			}
+
+			re[k] = sumRe / (double)wavetableSize;
+			im[k] = sumIm / (double)wavetableSize;
+		}
+
+		for (int level = 1; level < numMipMapLevels; level++)
+		{
+			const int size = mipMapSizes[level];
+			const int levelHarmonics = mipMapNumHarmonics[level];
+			const double* levelSin = levelSinTable + levelTableOffsets[level];
+			const double* levelCos = levelCosTable + levelTableOffsets[level];
+
+			float* levelData = mipMaps.getWritePointer(0, mipMapOffsets[level] + t * size);
+
+			for (int n = 0; n < size; n++)
+			{
+				double value = re[0];
+				int phase = n;
+
+				for (int k = 1; k <= levelHarmonics; k++)
+				{
+					value += 2.0 * (re[k] * levelCos[phase] + im[k] * levelSin[phase]);
+
+					phase += n;
+
+					if (phase >= size)
+						phase -= size;
+				}
+
+				levelData[n] = (float)value;
+			}
+		}
+	}
+}
+
 } // namespace hise
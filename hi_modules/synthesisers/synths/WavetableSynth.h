@@ -45,6 +45,18 @@ class WavetableSound: public ModulatorSynthSound
 {
 public:
 
+	enum
+	{
+		/** The maximum amount of mip map levels (including the original tables). */
+		MaxMipMapLevels = 8,
+
+		/** The smallest table size of a mip map level. */
+		MinMipMapSize = 8,
+
+		/** The maximum amount of samples for renderTableCrossfade(). */
+		MaxChunkSize = 64
+	};
+
 	/** Creates a new wavetable sound.
 	*
 	*	You have to supply a ValueTree with the following properties:
@@ -67,6 +79,32 @@ public:
 	*/
 	const float *getWaveTableData(int wavetableIndex) const;
 
+	/** Returns a read pointer to the band-limited wavetable of the given mip map level.
+	*
+	*	Each level halves the table size and only contains the harmonics that fit into the smaller table, 
+	*	so it can be played an octave higher than the previous level without aliasing. Level 0 is the original table.
+	*/
+	const float *getWaveTableData(int wavetableIndex, int mipMapLevel) const;
+
+	int getNumMipMapLevels() const { return numMipMapLevels; };
+
+	/** Returns the table size of the given mip map level. */
+	int getMipMapSize(int mipMapLevel) const { return mipMapSizes[mipMapLevel]; };
+
+	/** Returns the first mip map level that can be played with the given pitch ratio without audible aliasing. 
+	*
+	*	The pitch ratio is the amount of samples of the original table that are advanced for every output sample.
+	*/
+	int getMipMapLevelForPitchRatio(double pitchRatio) const;
+
+	/** Renders the crossfade between two neighbouring tables of a mip map level with linear interpolation.
+	*
+	*	This is the inner loop of the HQ mode. The positions are in samples of the original table, the tables
+	*	are crossfaded from the lower table index to the next one with the table deltas. The table lookups are 
+	*	done for every sample, the interpolation is calculated with vector operations.
+	*/
+	void renderTableCrossfade(float* output, const double* positions, const int* lowerTableIndexes, const float* tableDeltas, int numSamples, int mipMapLevel) const;
+
 	float getUnnormalizedMaximum()
 	{
 		return unnormalizedMaximum;
@@ -92,6 +130,9 @@ public:
 
 	void normalizeTables();
 
+	/** Creates the band-limited tables for the mip map levels from the spectrum of the original tables. */
+	void createMipMaps();
+
 	float getUnnormalizedGainValue(int tableIndex)
 	{
 		jassert(tableIndex < 64);
@@ -112,6 +153,14 @@ private:
 	AudioSampleBuffer wavetables;
 	AudioSampleBuffer emptyBuffer;
 
+	/** The tables of the mip map levels above 0 (all tables of one level after each other). */
+	AudioSampleBuffer mipMaps;
+
+	int numMipMapLevels = 1;
+	int mipMapSizes[MaxMipMapLevels];
+	int mipMapOffsets[MaxMipMapLevels];
+	int mipMapNumHarmonics[MaxMipMapLevels];
+
 	double sampleRate;
 	double pitchRatio;
 
@@ -152,6 +201,7 @@ public:
 
 		tableSize = currentSound->getTableSize();
 		smoothSize = tableSize;
+		lastMipMapLevel = -1;
 		uptimeDelta = currentSound->getPitchRatio();
         uptimeDelta *= getOwnerSynth()->getMainController()->getGlobalPitchFactor();
     };
@@ -206,6 +256,9 @@ private:
 
 	bool hqMode;
 
+	/** The mip map level of the last block (-1 if the voice was just started). */
+	int lastMipMapLevel = -1;
+
 	float const *lowerTable;
 	float const *upperTable;
 
@@ -40,8 +40,10 @@
 
 #include "sampler/ModulatorSamplerData.cpp"
 #include "sampler/ModulatorSamplerSound.cpp"
+#include "sampler/SamplePreloader.cpp"
 #include "sampler/ModulatorSamplerVoice.cpp"
 #include "sampler/ModulatorSampler.cpp"
+#include "sampler/LazyPreloadHandler.cpp"
 
 #if USE_BACKEND
 
@@ -63,6 +63,8 @@ END_JUCE_MODULE_DECLARATION
 
 #include "sampler/ModulatorSamplerData.h"
 #include "sampler/ModulatorSamplerSound.h"
+#include "sampler/SamplePreloader.h"
+#include "sampler/LazyPreloadHandler.h"
 #include "sampler/ModulatorSamplerVoice.h"
 #include "sampler/ModulatorSampler.h"
 
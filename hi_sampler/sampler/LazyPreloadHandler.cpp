@@ -0,0 +1,432 @@
+/*  ===========================================================================
+*
+*   This file is part of HISE.
+*   Copyright 2016 Christoph Hart
+*
+*   HISE is free software: you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation, either version 3 of the License, or
+*   (at your option) any later version.
+*
+*   HISE is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with HISE.  If not, see <http://www.gnu.org/licenses/>.
+*
+*   Commercial licenses for using HISE in an closed source project are
+*   available on request. Please visit the project's website to get more
+*   information about commercial licensing:
+*
+*   http://www.hise.audio/
+*
+*   HISE is based on the JUCE library,
+*   which must be separately licensed for closed source applications:
+*
+*   http://www.juce.com
+*
+*   ===========================================================================
+*/
+
+
+namespace hise { using namespace juce;
+
+// The promotion job runs with a lower priority than the streaming jobs that are due in the next buffers
+static int64 getNextPromotionDeadline()
+{
+	return Time::getHighResolutionTicks() + Time::getHighResolutionTicksPerSecond() / 50;
+}
+
+LazyPreloadHandler::LazyPreloadHandler(ModulatorSampler* sampler_) :
+	sampler(sampler_),
+	job(*this),
+	generation(0),
+	budget(0),
+	residentBytes(0),
+	numPromotedSounds(0),
+	active(false)
+{
+
+}
+
+LazyPreloadHandler::~LazyPreloadHandler()
+{
+	stopTimer();
+	cancelPendingUpdate();
+
+	active.store(false);
+	job.signalJobShouldExit();
+
+	while (job.isRunning())
+		Thread::sleep(1);
+}
+
+int LazyPreloadHandler::prepareToLoad(int newFullPreloadSize, bool isReversed)
+{
+	ScopedLock sl(sampler->getMainController()->getSampleManager().getSamplerSoundLock());
+
+	clearInternal();
+
+	fullPreloadSize = newFullPreloadSize;
+	initialPreloadSize = newFullPreloadSize == -1 ? LAZY_PRELOAD_SIZE : jmin(newFullPreloadSize, LAZY_PRELOAD_SIZE);
+
+	const bool shouldBeActive = budget.load() > 0 && !isReversed && fullPreloadSize != 0 && initialPreloadSize != fullPreloadSize;
+
+	active.store(shouldBeActive);
+
+	if (shouldBeActive)
+		startTimer(30);
+	else
+		stopTimer();
+
+	return shouldBeActive ? initialPreloadSize : fullPreloadSize;
+}
+
+void LazyPreloadHandler::clear()
+{
+	ScopedLock sl(sampler->getMainController()->getSampleManager().getSamplerSoundLock());
+
+	clearInternal();
+}
+
+void LazyPreloadHandler::removeSound(ModulatorSamplerSound* sound)
+{
+	ScopedLock sl(sampler->getMainController()->getSampleManager().getSamplerSoundLock());
+
+	// The pending requests might point to the deleted sound
+	++generation;
+
+	Request r;
+
+	while (requests.pop(r))
+		;
+
+	requestedSounds.removeAllInstancesOf(sound);
+
+	const int index = indexOf(promotedSounds, sound);
+
+	if (index != -1)
+	{
+		residentBytes -= promotedSounds[index].numBytes;
+		--numPromotedSounds;
+		promotedSounds.remove(index);
+	}
+
+	const int promotionIndex = indexOf(promotions, sound);
+
+	if (promotionIndex != -1)
+		promotions.remove(promotionIndex);
+
+	const int demotionIndex = indexOf(demotions, sound);
+
+	if (demotionIndex != -1)
+	{
+		residentBytes -= demotions[demotionIndex]->numBytes;
+		--numPromotedSounds;
+		demotions.remove(demotionIndex);
+	}
+}
+
+void LazyPreloadHandler::soundWasStarted(ModulatorSamplerSound* sound)
+{
+	if (!active.load() || sound == nullptr)
+		return;
+
+	// If the queue is full, the sound will be promoted when it's played the next time
+	requests.push(Request{ sound, generation.load() });
+}
+
+void LazyPreloadHandler::handleAsyncUpdate()
+{
+	sampler->refreshMemoryUsage();
+}
+
+void LazyPreloadHandler::timerCallback()
+{
+	if (active.load() && !requests.isEmpty() && !job.isQueued())
+	{
+		job.setDeadline(getNextPromotionDeadline());
+		sampler->getBackgroundThreadPool()->addJob(&job, false);
+	}
+}
+
+SampleThreadPool::Job::JobStatus LazyPreloadHandler::run()
+{
+	if (job.shouldExit())
+		return SampleThreadPool::Job::jobHasFinished;
+
+	auto& soundLock = sampler->getMainController()->getSampleManager().getSamplerSoundLock();
+
+	if (!soundLock.tryEnter())
+	{
+		job.setDeadline(getNextPromotionDeadline());
+		return SampleThreadPool::Job::jobNeedsRunningAgain;
+	}
+
+	addPendingPromotion();
+
+	Request r;
+
+	while (requests.pop(r))
+	{
+		if (r.generation == generation.load())
+			touch(r.sound);
+	}
+
+	int64 numBytesAfterSwaps = residentBytes.load();
+
+	for (auto p : promotions)
+		numBytesAfterSwaps += p->numBytes;
+
+	for (auto d : demotions)
+		numBytesAfterSwaps -= d->numBytes;
+
+	while (numBytesAfterSwaps > budget.load() && !promotedSounds.isEmpty())
+	{
+		auto leastRecentlyUsed = promotedSounds.removeAndReturn(0);
+
+		// The small buffer is copied from the promoted buffer, so this doesn't read from disk
+		auto demotion = createSwap(leastRecentlyUsed.sound, initialPreloadSize);
+		loadBuffers(*demotion);
+		demotion->numBytes = leastRecentlyUsed.numBytes;
+		demotions.add(demotion);
+
+		numBytesAfterSwaps -= leastRecentlyUsed.numBytes;
+	}
+
+	if (applySwaps())
+		triggerAsyncUpdate();
+
+	// Only one sound is read per call, so the streaming jobs are not delayed too much
+	if (!requestedSounds.isEmpty())
+	{
+		pendingPromotion = createSwap(requestedSounds.removeAndReturn(0), fullPreloadSize);
+		pendingGeneration = generation.load();
+	}
+
+	const bool isFinished = pendingPromotion == nullptr && requestedSounds.isEmpty() && 
+							promotions.isEmpty() && demotions.isEmpty() && requests.isEmpty();
+
+	soundLock.exit();
+
+	if (pendingPromotion != nullptr)
+		loadBuffers(*pendingPromotion);
+
+	if (isFinished)
+		return SampleThreadPool::Job::jobHasFinished;
+
+	job.setDeadline(getNextPromotionDeadline());
+	return SampleThreadPool::Job::jobNeedsRunningAgain;
+}
+
+void LazyPreloadHandler::addPendingPromotion()
+{
+	if (pendingPromotion == nullptr)
+		return;
+
+	ScopedPointer<Swap> promotion = pendingPromotion.release();
+
+	// The sound might have been deleted while the buffers were read
+	if (pendingGeneration != generation.load())
+		return;
+
+	// A sound that doesn't fit into the budget stays at the initial preload size
+	if (promotion->numBytes > 0 && promotion->numBytes <= budget.load())
+		promotions.add(promotion.release());
+}
+
+void LazyPreloadHandler::clearInternal()
+{
+	++generation;
+
+	Request r;
+
+	while (requests.pop(r))
+		;
+
+	requestedSounds.clear();
+	promotedSounds.clear();
+	promotions.clear();
+	demotions.clear();
+
+	residentBytes.store(0);
+	numPromotedSounds.store(0);
+}
+
+void LazyPreloadHandler::touch(ModulatorSamplerSound* sound)
+{
+	const int index = indexOf(promotedSounds, sound);
+
+	if (index != -1)
+	{
+		// Move it to the end of the list (the most recently used sound)
+		promotedSounds.add(promotedSounds.removeAndReturn(index));
+		return;
+	}
+
+	const int demotionIndex = indexOf(demotions, sound);
+
+	if (demotionIndex != -1)
+	{
+		// It was played again before it could be demoted
+		Entry e = { sound, demotions[demotionIndex]->numBytes };
+		demotions.remove(demotionIndex);
+		promotedSounds.add(e);
+		return;
+	}
+
+	if (indexOf(promotions, sound) == -1)
+		requestedSounds.addIfNotAlreadyThere(sound);
+}
+
+LazyPreloadHandler::Swap* LazyPreloadHandler::createSwap(ModulatorSamplerSound* sound, int preloadSize)
+{
+	auto s = new Swap();
+
+	s->sound = sound;
+	s->preloadSize = preloadSize;
+	s->numBytes = 0;
+
+	for (int i = 0; i < sampler->getNumMicPositions(); i++)
+	{
+		auto streamingSound = sound->getReferenceToSound(i);
+
+		if (streamingSound == nullptr || streamingSound->isPurged() || !streamingSound->hasActiveState())
+			s->sources.add(nullptr);
+		else
+			s->sources.add(streamingSound);
+	}
+
+	return s;
+}
+
+void LazyPreloadHandler::loadBuffers(Swap& s)
+{
+	s.numBytes = 0;
+	s.buffers.clear();
+
+	for (auto streamingSound : s.sources)
+	{
+		if (streamingSound == nullptr)
+		{
+			s.buffers.add(nullptr);
+			continue;
+		}
+
+		auto b = new hlac::HiseSampleBuffer(streamingSound->createPreloadBuffer(s.preloadSize));
+
+		streamingSound->closeFileHandle();
+
+		s.numBytes += getNumBytes(*b);
+		s.buffers.add(b);
+	}
+}
+
+bool LazyPreloadHandler::isPlaying(ModulatorSamplerSound* sound) const
+{
+	for (int i = 0; i < sampler->getNumVoices(); i++)
+	{
+		auto v = static_cast<ModulatorSamplerVoice*>(sampler->getVoice(i));
+
+		if (v->isVoiceActive() && v->getCurrentlyPlayingSamplerSound() == sound)
+			return true;
+	}
+
+	return false;
+}
+
+bool LazyPreloadHandler::applySwaps()
+{
+	if (promotions.isEmpty() && demotions.isEmpty())
+		return false;
+
+	// The old buffers are deallocated after the audio lock is released
+	OwnedArray<Swap> finishedSwaps;
+
+	auto swapBuffers = [](Swap* s)
+	{
+		for (int i = 0; i < s->buffers.size(); i++)
+		{
+			auto b = s->buffers[i];
+			auto streamingSound = s->sources[i];
+
+			if (b != nullptr && b->getNumSamples() != 0 && streamingSound != nullptr)
+				streamingSound->swapPreloadBuffer(*b, s->preloadSize);
+		}
+	};
+
+	{
+		ScopedTryLock sl(sampler->getMainController()->getLock());
+
+		if (!sl.isLocked())
+			return false;
+
+		for (int i = demotions.size() - 1; i >= 0; i--)
+		{
+			auto d = demotions[i];
+
+			if (isPlaying(d->sound))
+				continue;
+
+			swapBuffers(d);
+
+			residentBytes -= d->numBytes;
+			--numPromotedSounds;
+
+			finishedSwaps.add(demotions.removeAndReturn(i));
+		}
+
+		for (int i = promotions.size() - 1; i >= 0; i--)
+		{
+			auto p = promotions[i];
+
+			if (isPlaying(p->sound))
+				continue;
+
+			swapBuffers(p);
+
+			residentBytes += p->numBytes;
+			++numPromotedSounds;
+
+			Entry e = { p->sound, p->numBytes };
+			promotedSounds.add(e);
+
+			finishedSwaps.add(promotions.removeAndReturn(i));
+		}
+	}
+
+	return !finishedSwaps.isEmpty();
+}
+
+int LazyPreloadHandler::indexOf(const Array<Entry>& list, ModulatorSamplerSound* sound)
+{
+	for (int i = 0; i < list.size(); i++)
+	{
+		if (list.getReference(i).sound == sound)
+			return i;
+	}
+
+	return -1;
+}
+
+int LazyPreloadHandler::indexOf(const OwnedArray<Swap>& list, ModulatorSamplerSound* sound)
+{
+	for (int i = 0; i < list.size(); i++)
+	{
+		if (list[i]->sound == sound)
+			return i;
+	}
+
+	return -1;
+}
+
+int64 LazyPreloadHandler::getNumBytes(const hlac::HiseSampleBuffer& b)
+{
+	const int64 bytesPerSample = b.isFloatingPoint() ? sizeof(float) : sizeof(int16);
+
+	return (int64)b.getNumSamples() * (int64)b.getNumChannels() * bytesPerSample;
+}
+
+} // namespace hise
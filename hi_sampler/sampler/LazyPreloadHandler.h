@@ -0,0 +1,199 @@
+/*  ===========================================================================
+*
+*   This file is part of HISE.
+*   Copyright 2016 Christoph Hart
+*
+*   HISE is free software: you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation, either version 3 of the License, or
+*   (at your option) any later version.
+*
+*   HISE is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with HISE.  If not, see <http://www.gnu.org/licenses/>.
+*
+*   Commercial licenses for using HISE in an closed source project are
+*   available on request. Please visit the project's website to get more
+*   information about commercial licensing:
+*
+*   http://www.hise.audio/
+*
+*   HISE is based on the JUCE library,
+*   which must be separately licensed for closed source applications:
+*
+*   http://www.juce.com
+*
+*   ===========================================================================
+*/
+
+
+#ifndef LAZYPRELOADHANDLER_H_INCLUDED
+#define LAZYPRELOADHANDLER_H_INCLUDED
+
+namespace hise { using namespace juce;
+
+class ModulatorSampler;
+
+/** Keeps only a small preload chunk of every sound and promotes the sounds that are actually played to the full preload size.
+*	@ingroup sampler
+*
+*	If a sampler has a lazy preload budget, all sounds are loaded with LAZY_PRELOAD_SIZE samples. Whenever a voice starts a sound,
+*	the sound is reported to this handler, which reads the full preload buffer on the sample loading thread and swaps it as
+*	soon as no voice plays the sound. If the promoted sounds use more memory than the budget, the least recently played sounds
+*	are demoted to the small chunk again.
+*
+*	The audio thread only pushes the sound into a lock free queue. A timer schedules the loading job, and the job reads the
+*	buffers without holding the sampler sound lock (the reads of monoliths go through the reader that is shared with the 
+*	streaming jobs). The swap needs the audio lock, but it is only tried and never waited for, so neither the audio thread 
+*	nor the loading thread will block each other.
+*/
+class LazyPreloadHandler: public AsyncUpdater,
+						  private Timer
+{
+public:
+
+	LazyPreloadHandler(ModulatorSampler* sampler);
+
+	~LazyPreloadHandler();
+
+	/** Sets the amount of memory the promoted sounds may use in bytes. Zero disables the lazy preloading. */
+	void setBudget(int64 newBudgetInBytes) noexcept { budget.store(newBudgetInBytes); }
+
+	/** Returns the budget in bytes. */
+	int64 getBudget() const noexcept { return budget.load(); }
+
+	/** Returns the amount of memory that is used by the promoted sounds. */
+	int64 getResidentBytes() const noexcept { return residentBytes.load(); }
+
+	/** Returns the number of sounds that use the full preload size at the moment. */
+	int getNumPromotedSounds() const noexcept { return numPromotedSounds.load(); }
+
+	/** Returns true if the sounds are loaded with the small preload chunk. */
+	bool isActive() const noexcept { return active.load(); }
+
+	/** Forgets all sounds and returns the preload size that should be used for loading the sounds.
+	*
+	*	Call this before the sounds are (re)loaded. If lazy preloading is disabled or can't be used, it returns the given preload size.
+	*/
+	int prepareToLoad(int fullPreloadSize, bool isReversed);
+
+	/** Forgets all promoted sounds and pending requests. Call this whenever all sounds are removed. */
+	void clear();
+
+	/** Forgets the given sound. Call this before the sound is deleted. */
+	void removeSound(ModulatorSamplerSound* sound);
+
+	/** Call this from the audio thread whenever a voice starts the given sound. This doesn't lock or allocate. */
+	void soundWasStarted(ModulatorSamplerSound* sound);
+
+	void handleAsyncUpdate() override;
+
+private:
+
+	void timerCallback() override;
+
+	class PromotionJob : public SampleThreadPool::Job
+	{
+	public:
+
+		PromotionJob(LazyPreloadHandler& parent_) :
+			Job("Lazy Preloading"),
+			parent(parent_)
+		{};
+
+		JobStatus runJob() override { return parent.run(); }
+
+	private:
+
+		LazyPreloadHandler& parent;
+	};
+
+	static constexpr int MaxNumRequests = 512;
+
+	struct Request
+	{
+		ModulatorSamplerSound* sound = nullptr;
+		uint32 generation = 0;
+	};
+
+	struct Entry
+	{
+		ModulatorSamplerSound* sound;
+		int64 numBytes;
+	};
+
+	/** The preload buffers of all mic positions of a sound that wait for the next swap. */
+	struct Swap
+	{
+		ModulatorSamplerSound* sound;
+		int preloadSize;
+		int64 numBytes;
+
+		/** Keeps the sounds alive while the buffers are read without the sampler sound lock. */
+		ReferenceCountedArray<StreamingSamplerSound> sources;
+
+		OwnedArray<hlac::HiseSampleBuffer> buffers;
+	};
+
+	SampleThreadPool::Job::JobStatus run();
+
+	void clearInternal();
+
+	void touch(ModulatorSamplerSound* sound);
+
+	/** Creates a swap for the sound without reading its buffers. Call this with the sampler sound lock. */
+	Swap* createSwap(ModulatorSamplerSound* sound, int preloadSize);
+
+	/** Reads the buffers of the swap. This doesn't need the sampler sound lock. */
+	static void loadBuffers(Swap& s);
+
+	/** Adds the promotion that was read in the last call if no sound was removed in the meantime. */
+	void addPendingPromotion();
+
+	bool isPlaying(ModulatorSamplerSound* sound) const;
+
+	bool applySwaps();
+
+	static int indexOf(const Array<Entry>& list, ModulatorSamplerSound* sound);
+
+	static int indexOf(const OwnedArray<Swap>& list, ModulatorSamplerSound* sound);
+
+	static int64 getNumBytes(const hlac::HiseSampleBuffer& b);
+
+	ModulatorSampler* sampler;
+
+	PromotionJob job;
+
+	MultiProducerQueue<Request, MaxNumRequests> requests;
+
+	std::atomic<uint32> generation;
+	std::atomic<int64> budget;
+	std::atomic<int64> residentBytes;
+	std::atomic<int> numPromotedSounds;
+	std::atomic<bool> active;
+
+	int fullPreloadSize = 0;
+	int initialPreloadSize = 0;
+
+	// These are only accessed by the loading thread or with the sound lock
+
+	Array<ModulatorSamplerSound*> requestedSounds;
+	Array<Entry> promotedSounds;
+	OwnedArray<Swap> promotions;
+	OwnedArray<Swap> demotions;
+
+	// The promotion that is read without the lock. This is only accessed by the loading thread.
+
+	ScopedPointer<Swap> pendingPromotion;
+	uint32 pendingGeneration = 0;
+
+	JUCE_DECLARE_NON_COPYABLE(LazyPreloadHandler);
+};
+
+} // namespace hise
+
+#endif  // LAZYPRELOADHANDLER_H_INCLUDED
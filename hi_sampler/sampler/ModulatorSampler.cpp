@@ -84,6 +84,10 @@ SET_DOCUMENTATION(ModulatorSampler)
 
     ADD_PARAMETER_DOC(UseStaticMatrix,
         "If this is true, then the routing matrix will not be resized when you load a sample map with another mic position amount.");
+
+	ADD_PARAMETER_DOC_WITH_NAME(InterpolationMode, "Interpolation",
+		"The interpolation that is used for resampling: `0` = Linear, `1` = Cubic Hermite, `2` = Sinc (8 points). " \
+		"The higher modes sound better if the samples are pitched, but need more CPU.");
     
 	ADD_CHAIN_DOC(SampleStartModulation, "Sample Start", 
 		"Allows modification of the sample start if the sound allows this. The modulation range is depending on the *SampleStartMod* value of each sample.");
@@ -123,7 +127,7 @@ samplePropertyUpdater(this)
 	sampleEditHandler = new SampleEditHandler(this);
 #endif
 
-	
+	lazyPreloadHandler = new LazyPreloadHandler(this);
 	
 
 	setGain(1.0);
@@ -141,6 +145,7 @@ samplePropertyUpdater(this)
 	parameterNames.add("Purged");
 	parameterNames.add("Reversed");
     parameterNames.add("UseStaticMatrix");
+	parameterNames.add("InterpolationMode");
 
 	editorStateIdentifiers.add("SampleStartChainShown");
 	editorStateIdentifiers.add("SettingsShown");
@@ -183,6 +188,7 @@ samplePropertyUpdater(this)
 
 ModulatorSampler::~ModulatorSampler()
 {
+	lazyPreloadHandler = nullptr;
 	sampleMap = nullptr;
 	deleteAllSounds();
 }
@@ -208,6 +214,46 @@ void ModulatorSampler::refreshRRMap()
 		const ModulatorSamplerSound *sound = static_cast<const ModulatorSamplerSound*>(sounds.getUnchecked(i).get());
 		roundRobinMap.addSample(sound);
 	}
+
+	rebuildSoundIndex();
+}
+
+void ModulatorSampler::rebuildSoundIndex()
+{
+	ScopedLock sl(getSynthLock());
+
+	for (int i = 0; i < sounds.size(); i++)
+		static_cast<ModulatorSamplerSound*>(sounds.getUnchecked(i).get())->setOwner(this);
+
+	soundIndex.rebuild(sounds, ++soundGeneration);
+}
+
+void ModulatorSampler::addToSoundIndex(ModulatorSamplerSound* newSound)
+{
+	ScopedLock sl(getSynthLock());
+
+	newSound->setOwner(this);
+
+	if (soundIndex.isValidFor(sounds.size() - 1, soundGeneration))
+		soundIndex.addSound(newSound, ++soundGeneration);
+	else
+		rebuildSoundIndex();
+}
+
+void ModulatorSampler::updateSoundIndex(ModulatorSamplerSound* sound)
+{
+	ScopedLock sl(getSynthLock());
+
+	if (soundIndex.isValidFor(sounds.size(), soundGeneration))
+		soundIndex.updateSound(sound);
+}
+
+void ModulatorSampler::setInterpolationMode(SamplerInterpolator::Mode newMode)
+{
+	interpolationMode = newMode;
+
+	for (int i = 0; i < voices.size(); i++)
+		static_cast<ModulatorSamplerVoice*>(voices[i])->setInterpolationMode(newMode);
 }
 
 void ModulatorSampler::setReversed(bool shouldBeReversed)
@@ -333,10 +379,14 @@ void ModulatorSampler::restoreFromValueTree(const ValueTree &v)
 	setVoiceAmount(v.getProperty("VoiceAmount", voiceAmount));
 	
 	loadAttribute(Reversed, "Reversed");
+	setInternalAttribute(InterpolationMode, v.getProperty("InterpolationMode", (int)SamplerInterpolator::Mode::Linear));
 
 	loadAttribute(SamplerRepeatMode, "SamplerRepeatMode");
 	loadAttribute(Purged, "Purged");
 
+	// Stored in MB, the samples are loaded afterwards, so this doesn't need to reload them
+	lazyPreloadHandler->setBudget((int64)(int)v.getProperty("LazyPreloadBudget", 0) * 1024 * 1024);
+
 	killAllVoicesAndCall([v](Processor* p) { static_cast<ModulatorSampler*>(p)->loadSampleMapSync(v.getChildWithName("samplemap")); return true; });
 
     loadAttribute(CrossfadeGroups, "CrossfadeGroups");
@@ -366,6 +416,10 @@ ValueTree ModulatorSampler::exportAsValueTree() const
 	saveAttribute(Reversed, "Reversed");
 	v.setProperty("NumChannels", numChannels, nullptr);
     saveAttribute(UseStaticMatrix, "UseStaticMatrix");
+	saveAttribute(InterpolationMode, "InterpolationMode");
+
+	if (getLazyPreloadBudget() > 0)
+		v.setProperty("LazyPreloadBudget", (int)(getLazyPreloadBudget() / 1024 / 1024), nullptr);
 
 	ValueTree channels("channels");
 
@@ -407,6 +461,7 @@ float ModulatorSampler::getAttribute(int parameterIndex) const
 	case Purged:			return purged ? 1.0f : 0.0f;
 	case Reversed:			return reversed ? 1.0f : 0.0f;
     case UseStaticMatrix:   return useStaticMatrix ? 1.0f : 0.0f;
+	case InterpolationMode:	return (float)(int)interpolationMode;
 	default:				jassertfalse; return -1.0f;
 	}
 }
@@ -437,6 +492,7 @@ void ModulatorSampler::setInternalAttribute(int parameterIndex, float newValue)
 	case CrossfadeGroups:	crossfadeGroups = newValue > 0.5f; refreshCrossfadeTables(); break;
 	case Purged:			purgeAllSamples(newValue > 0.5f); break;
 	case UseStaticMatrix:   setUseStaticMatrix(newValue > 0.5f); break;
+	case InterpolationMode:	setInterpolationMode((SamplerInterpolator::Mode)jlimit<int>(0, (int)SamplerInterpolator::Mode::numModes - 1, (int)newValue)); break;
 	default:				jassertfalse; break;
 	}
 }
@@ -485,6 +541,12 @@ void ModulatorSampler::prepareToPlay(double newSampleRate, int samplesPerBlock)
 
 		StreamingSamplerVoice::initTemporaryVoiceBuffer(&temporaryVoiceBuffer, samplesPerBlock);
 
+		while (partitionVoiceBuffers.size() < getMaxNumVoicePartitions() - 1)
+			partitionVoiceBuffers.add(new hlac::HiseSampleBuffer(temporaryVoiceBuffer.isFloatingPoint(), 2, 0));
+
+		for (auto b : partitionVoiceBuffers)
+			StreamingSamplerVoice::initTemporaryVoiceBuffer(b, samplesPerBlock);
+
 		sampleStartChain->prepareToPlay(newSampleRate, samplesPerBlock);
 		crossFadeChain->prepareToPlay(newSampleRate, samplesPerBlock);
 	}
@@ -546,7 +608,7 @@ void ModulatorSampler::deleteSound(ModulatorSamplerSound *s)
 
 	checkAndLogIsSoftBypassed(DebugLogger::Location::DeleteOneSample);
 
-	
+	lazyPreloadHandler->removeSound(s);
 
 	for (int i = 0; i < voices.size(); i++)
 	{
@@ -560,6 +622,9 @@ void ModulatorSampler::deleteSound(ModulatorSamplerSound *s)
 
 	const int deletedIndex = s->getProperty(ModulatorSamplerSound::ID);
 
+	// Invalidates the index until it is rebuilt below
+	++soundGeneration;
+
 	sounds.removeObject(s);
 
 	refreshMemoryUsage();
@@ -568,6 +633,8 @@ void ModulatorSampler::deleteSound(ModulatorSamplerSound *s)
     {
         static_cast<ModulatorSamplerSound*>(sounds[i].get())->setNewIndex(i);
     }
+
+	rebuildSoundIndex();
     
 	sendChangeMessage();
 }
@@ -578,17 +645,23 @@ void ModulatorSampler::deleteAllSounds()
 
 	jassert(getMainController()->getKillStateHandler().voicesAreKilled());
 
+	lazyPreloadHandler->clear();
+
 	for (int i = 0; i < voices.size(); i++)
 	{
 		static_cast<ModulatorSamplerVoice*>(getVoice(i))->resetVoice();
 	}
 
+	++soundGeneration;
+
 	if(getNumSounds() != 0)
 	{
 		clearSounds();
 
 		getMainController()->getSampleManager().getModulatorSamplerSoundPool()->clearUnreferencedMonoliths();
 	}
+
+	soundIndex.clear();
 	
 	refreshMemoryUsage();
 	sendChangeMessage();
@@ -644,6 +717,13 @@ void ModulatorSampler::refreshMemoryUsage()
 
 		StreamingSamplerVoice::initTemporaryVoiceBuffer(&temporaryVoiceBuffer, getLargestBlockSize());
 
+		// Replace them in place, the voices keep a pointer to the buffer of their last partition
+		for (auto b : partitionVoiceBuffers)
+		{
+			*b = hlac::HiseSampleBuffer(temporaryBufferShouldBeFloatingPoint, 2, 0);
+			StreamingSamplerVoice::initTemporaryVoiceBuffer(b, getLargestBlockSize());
+		}
+
 		for (auto i = 0; i < getNumVoices(); i++)
 		{
 			static_cast<ModulatorSamplerVoice*>(getVoice(i))->setStreamingBufferDataType(temporaryBufferShouldBeFloatingPoint);
@@ -676,6 +756,9 @@ void ModulatorSampler::refreshMemoryUsage()
 
 	memoryUsage = actualPreloadSize + streamBufferSizePerVoice * getNumVoices();
 
+	// The promoted sounds are already part of the preload size
+	lazyPreloadMemoryUsage = lazyPreloadHandler->isActive() ? lazyPreloadHandler->getResidentBytes() : 0;
+
 	sendChangeMessage();
 	getMainController()->getSampleManager().getModulatorSamplerSoundPool()->sendChangeMessage();
 }
@@ -720,6 +803,7 @@ void ModulatorSampler::setVoiceAmountInternal()
 			}
 
 			dynamic_cast<ModulatorSamplerVoice*>(voices.getLast())->setStreamingBufferDataType(temporaryVoiceBuffer.isFloatingPoint());
+			dynamic_cast<ModulatorSamplerVoice*>(voices.getLast())->setInterpolationMode(interpolationMode);
 
 			if (Processor::getSampleRate() != -1.0)
 			{
@@ -900,6 +984,8 @@ ModulatorSamplerSound* ModulatorSampler::addSamplerSound(const ValueTree &descri
 		newSound->addChangeListener(sampleMap);
 		newSound->setMaxRRGroupIndex(rrGroupAmount);
 
+		addToSoundIndex(newSound);
+
 		sendChangeMessage();
 
 		
@@ -929,6 +1015,8 @@ void ModulatorSampler::addSamplerSounds(OwnedArray<ModulatorSamplerSound>& monol
 		newSound->setMaxRRGroupIndex(rrGroupAmount);
 		newSound->setUndoManager(getMainController()->getControlUndoManager());
 		newSound->addChangeListener(sampleMap);
+
+		addToSoundIndex(newSound);
 	}
 
 	sendChangeMessage();
@@ -948,6 +1036,14 @@ String ModulatorSampler::getMemoryUsage() const
 	memory << String(m, 2);
 	memory << "MB";
 
+	if (lazyPreloadHandler->isActive())
+	{
+		const double resident = ((double)lazyPreloadMemoryUsage / 1024.0 / 1024.0);
+		const double budget = ((double)getLazyPreloadBudget() / 1024.0 / 1024.0);
+
+		memory << " (Lazy: " << String(resident, 2) << " / " << String(budget, 2) << "MB)";
+	}
+
 	return memory;
 }
 
@@ -1006,6 +1102,14 @@ bool ModulatorSampler::soundCanBePlayed(ModulatorSynthSound *sound, int midiChan
 	return true;
 }
 
+const Array<ModulatorSynthSound*>* ModulatorSampler::getSoundsForNoteOn(int midiNoteNumber) const
+{
+	if (!soundIndex.isValidFor(sounds.size(), soundGeneration))
+		return nullptr;
+
+	return soundIndex.getSounds(midiNoteNumber, crossfadeGroups ? -1 : currentRRGroupIndex);
+}
+
 void ModulatorSampler::handleRetriggeredNote(ModulatorSynthVoice *voice)
 {
 	switch (repeatMode)
@@ -1043,6 +1147,63 @@ void ModulatorSampler::noteOff(const HiseEvent &m)
 	}
 }
 
+void ModulatorSampler::prepareForUpcomingEvents(const HiseEventBuffer &futureEvents, int numSamples)
+{
+	if (purged || futureEvents.isEmpty())
+		return;
+
+	auto pool = getBackgroundThreadPool();
+	const int streamingBufferSize = bufferSize * preloadScaleFactor;
+
+	// preHiseEventCallback() advances the round robin group for every note on. The notes of the current block
+	// are not counted, so the prediction might be off, but then the voice will just read the region itself.
+	int predictedGroupIndex = currentRRGroupIndex;
+
+	HiseEventBuffer::Iterator it(futureEvents);
+
+	while (auto e = it.getNextConstEventPointer(true, false))
+	{
+		// The events are sorted, so the rest will be prefetched in one of the next blocks
+		if ((int)e->getTimeStamp() >= numSamples)
+			break;
+
+		if (!e->isNoteOn())
+			continue;
+
+		if (useRoundRobinCycleLogic)
+		{
+			predictedGroupIndex++;
+			if (predictedGroupIndex > rrGroupAmount) predictedGroupIndex = 1;
+		}
+
+		const int noteNumber = e->getNoteNumber() + e->getTransposeAmount();
+
+		const bool useIndex = soundIndex.isValidFor(sounds.size(), soundGeneration);
+		auto candidates = useIndex ? soundIndex.getSounds(noteNumber, crossfadeGroups ? -1 : predictedGroupIndex) : nullptr;
+		const int numCandidates = useIndex ? candidates->size() : sounds.size();
+
+		for (int i = 0; i < numCandidates; i++)
+		{
+			ModulatorSamplerSound *sound = static_cast<ModulatorSamplerSound*>(useIndex ? candidates->getUnchecked(i) : sounds.getUnchecked(i).get());
+
+			if (!ModulatorSynth::soundCanBePlayed(sound, e->getChannel(), noteNumber, e->getFloatVelocity()))
+				continue;
+
+			if (!crossfadeGroups && !sound->appliesToRRGroup(predictedGroupIndex))
+				continue;
+
+			for (int j = 0; j < sound->getNumMultiMicSamples(); j++)
+			{
+				if (sound->isChannelPurged(j))
+					continue;
+
+				if (auto s = sound->getReferenceToSound(j).get())
+					s->prefetchForVoiceStart(pool, streamingBufferSize);
+			}
+		}
+	}
+}
+
 void ModulatorSampler::preHiseEventCallback(const HiseEvent &m)
 {
 	crossFadeChain->handleHiseEvent(m);
@@ -1317,15 +1478,18 @@ bool ModulatorSampler::preloadAllSamples()
 
 	const bool isReversed = getAttribute(ModulatorSampler::Reversed) > 0.5f;
 
-	ModulatorSampler::SoundIterator sIter(this);
-
-	const int numToLoad = jmax<int>(1, sounds.size() * getNumMicPositions());
-	int currentIndex = 0;
-
 	auto& progress = getMainController()->getSampleManager().getPreloadProgress();
 
 	auto threadPool = getMainController()->getSampleManager().getGlobalSampleThreadPool();
 
+	// The sounds are collected first and then loaded by multiple threads.
+	// The iterator keeps the sound lock until everything is loaded.
+	SamplePreloader preloader(threadPool, progress);
+
+	Array<StreamingSamplerSound*> soundsToLoad;
+
+	ModulatorSampler::SoundIterator sIter(this);
+
 	while (auto sound = sIter.getNextSound())
 	{
 		if (threadPool->threadShouldExit())
@@ -1335,39 +1499,75 @@ bool ModulatorSampler::preloadAllSamples()
 
 		if (getNumMicPositions() == 1)
 		{
-			auto s = sound->getReferenceToSound();
-
-			progress = (double)currentIndex++ / (double)numToLoad;
-
-			if (!preloadSample(s, preloadSizeToUse))
-				return false;
+			preloader.addSound(sound->getReferenceToSound(), 0);
+			soundsToLoad.add(sound->getReferenceToSound());
 		}
 		else
 		{
 			for (int j = 0; j < getNumMicPositions(); j++)
 			{
-				const bool isEnabled = getChannelData(j).enabled;
-
 				auto s = sound->getReferenceToSound(j);
 
-				progress = (double)currentIndex++ / (double)numToLoad;
-
 				if (s != nullptr)
 				{
-					if (isEnabled)
+					if (getChannelData(j).enabled)
 					{
-						if (!preloadSample(s, preloadSizeToUse))
-							return false;
+						preloader.addSound(s, j);
+						soundsToLoad.add(s);
 					}
 					else
 						s->setPurged(true);
 				}
 			}
 		}
+	}
 
-		sound->setReversed(isReversed);
+	// With a lazy preload budget, the sounds start with a small chunk and are promoted when they are played
+	const int sizeToLoad = lazyPreloadHandler->prepareToLoad(preloadSizeToUse, isReversed);
+
+	File cacheFile = getPreloadCacheFile(sizeToLoad);
+
+	PreloadCache::Ptr cache = cacheFile != File() ? PreloadCache::open(cacheFile, sizeToLoad) : nullptr;
+
+	std::atomic<int> numNotCached(0);
+
+	// This is called on the preload workers, so the errors are reported after run() returned
+	auto f = [sizeToLoad, cache, &numNotCached](StreamingSamplerSound* s, String& errorMessage)
+	{
+		if (cache != nullptr && cache->restore(s, sizeToLoad))
+		{
+			s->closeFileHandle();
+			return true;
+		}
+
+		++numNotCached;
+
+		return StreamingHelpers::preloadSample(s, sizeToLoad, errorMessage);
+	};
+
+	if (!preloader.run(f))
+	{
+		const String errorMessage = preloader.getErrorMessage();
+
+		if (errorMessage.isNotEmpty())
+			reportPreloadError(errorMessage);
+
+		return false;
 	}
 
+	if (cacheFile != File() && numNotCached.load() > 0)
+	{
+		auto r = PreloadCache::write(cacheFile, sizeToLoad, soundsToLoad);
+
+		if (r.failed())
+			debugToConsole(this, "Preload cache: " + r.getErrorMessage());
+	}
+
+	ModulatorSampler::SoundIterator reverseIter(this, false);
+
+	while (auto sound = reverseIter.getNextSound())
+		sound->setReversed(isReversed);
+
 	refreshMemoryUsage();
 	setShouldUpdateUI(true);
 	setHasPendingSampleLoad(false);
@@ -1377,32 +1577,57 @@ bool ModulatorSampler::preloadAllSamples()
 }
 
 
+File ModulatorSampler::getPreloadCacheFile(int preloadSizeToUse)
+{
+	auto& sm = getMainController()->getSampleManager();
+
+	const bool isReversed = getAttribute(ModulatorSampler::Reversed) > 0.5f;
+
+	if (!sm.shouldUsePreloadCache() || isReversed || preloadSizeToUse <= 0 || sampleMap == nullptr || sampleMap->getId().isNull())
+		return File();
+
+	auto directory = sm.getPreloadCacheDirectory();
+
+	if (directory == File() || !directory.createDirectory())
+		return File();
+
+	return directory.getChildFile(PreloadCache::getFileName(sampleMap->getId().toString(), preloadSizeToUse));
+}
+
+void ModulatorSampler::setLazyPreloadBudget(int64 newBudgetInBytes)
+{
+	const bool wasEnabled = getLazyPreloadBudget() > 0;
+
+	lazyPreloadHandler->setBudget(jmax<int64>(0, newBudgetInBytes));
+
+	if (wasEnabled != (getLazyPreloadBudget() > 0))
+		refreshPreloadSizes();
+	else
+		refreshMemoryUsage();
+}
+
 bool ModulatorSampler::preloadSample(StreamingSamplerSound * s, const int preloadSizeToUse)
 {
 	jassert(s != nullptr);
 
-	String fileName = s->getFileName(false);
+	String errorMessage;
 
-	try
-	{
-		s->setPreloadSize(s->hasActiveState() ? preloadSizeToUse : 0, true);
-		s->closeFileHandle();
+	if (StreamingHelpers::preloadSample(s, preloadSizeToUse, errorMessage))
 		return true;
-	}
-	catch (StreamingSamplerSound::LoadingError l)
-	{
-		String x;
-		x << "Error at preloading sample " << l.fileName << ": " << l.errorDescription;
-		getMainController()->getDebugLogger().logMessage(x);
+
+	reportPreloadError(errorMessage);
+	return false;
+}
+
+void ModulatorSampler::reportPreloadError(const String& errorMessage)
+{
+	getMainController()->getDebugLogger().logMessage(errorMessage);
 
 #if USE_FRONTEND
-		getMainController()->sendOverlayMessage(DeactiveOverlay::State::CustomErrorMessage, x);
+	getMainController()->sendOverlayMessage(DeactiveOverlay::State::CustomErrorMessage, errorMessage);
 #else
-		debugError(this, x);
+	debugError(this, errorMessage);
 #endif
-
-		return false;
-	}
 }
 
 } // namespace hise
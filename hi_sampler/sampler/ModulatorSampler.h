@@ -151,6 +151,7 @@ public:
 		Purged, 
 		Reversed,
         UseStaticMatrix,
+		InterpolationMode,
 		numModulatorSamplerParameters
 	};
 
@@ -308,12 +309,19 @@ public:
 	void preVoiceRendering(int startSample, int numThisTime) override;
 	void soundsChanged() {};
 	bool soundCanBePlayed(ModulatorSynthSound *sound, int midiChannel, int midiNoteNumber, float velocity) override;;
+
+	/** Returns the sounds of the note from the sound index (only the current group if crossfade groups are disabled). */
+	const Array<ModulatorSynthSound*>* getSoundsForNoteOn(int midiNoteNumber) const override;
+
 	void handleRetriggeredNote(ModulatorSynthVoice *voice) override;
 
 	/** Overwrites the base class method and ignores the note off event if Parameters::OneShot is enabled. */
 	void noteOff(const HiseEvent &m) override;;
 	void preHiseEventCallback(const HiseEvent &m) override;
 
+	/** Prefetches the first streaming region of all sounds that will be started in the next block. */
+	void prepareForUpcomingEvents(const HiseEventBuffer &futureEvents, int numSamples) override;
+
 	bool isUsingCrossfadeGroups() const { return crossfadeGroups; }
 	Table *getTable(int tableIndex) const override { return tableIndex < crossfadeTables.size() ? crossfadeTables[tableIndex] : nullptr; }
 
@@ -330,11 +338,34 @@ public:
 	void loadSampleMapFromIdAsync(const String& sampleMapId);
 	void loadSampleMapFromId(const String& sampleMapId);
 
-	/** This function will be called on a background thread and preloads all samples. */
+	/** This function will be called on a background thread and preloads all samples.
+	*
+	*	The sounds are loaded by a SamplePreloader on multiple threads. Errors are reported on the calling thread after
+	*	all threads are finished.
+	*/
 	bool preloadAllSamples();
 
+	/** Preloads a single sound and reports an error to the console. Don't call this from the SamplePreloader workers. */
 	bool preloadSample(StreamingSamplerSound * s, const int preloadSizeToUse);
 
+	/** Writes the error message to the debug logger and the console (or the overlay in a compiled plugin). */
+	void reportPreloadError(const String& errorMessage);
+
+	/** Returns the PreloadCache file for the current sample map or File() if the cache can't be used. */
+	File getPreloadCacheFile(int preloadSizeToUse);
+
+	/** Sets the amount of memory that the played sounds may use for their full preload buffers.
+	*
+	*	If this is not zero, the sounds are loaded with a small preload buffer and promoted to the full preload size when they
+	*	are played (see LazyPreloadHandler). This reloads the samples if the lazy preloading is enabled or disabled.
+	*/
+	void setLazyPreloadBudget(int64 newBudgetInBytes);
+
+	/** Returns the lazy preload budget in bytes. */
+	int64 getLazyPreloadBudget() const noexcept { return lazyPreloadHandler->getBudget(); }
+
+	LazyPreloadHandler* getLazyPreloadHandler() noexcept { return lazyPreloadHandler; }
+
 	void saveSampleMap() const;
 
 	void saveSampleMapAs();
@@ -386,6 +417,16 @@ public:
 	int getRRGroupsForMessage(int noteNumber, int velocity);
 	void refreshRRMap();
 
+	/** Rebuilds the note / group index that is used to find the sounds for a note on message.
+	*
+	*	Call this whenever you change the sound array without using addSamplerSound() or deleteSound().
+	*	It bumps the generation of the sound array, so an index that was built before can't be used anymore.
+	*/
+	void rebuildSoundIndex();
+
+	/** Updates the index entries of the sound after its key range or group was changed. */
+	void updateSoundIndex(ModulatorSamplerSound* sound);
+
     void setReversed(bool shouldBeReversed);
 
 	void purgeAllSamples(bool shouldBePurged)
@@ -540,6 +581,19 @@ public:
 
 	hlac::HiseSampleBuffer* getTemporaryVoiceBuffer() { return &temporaryVoiceBuffer; }
 
+	/** Returns the temporary voice buffer for the voices that are rendered in the given partition. */
+	hlac::HiseSampleBuffer* getTemporaryVoiceBuffer(int partitionIndex)
+	{
+		if (partitionIndex == 0)
+			return &temporaryVoiceBuffer;
+
+		jassert(partitionIndex <= partitionVoiceBuffers.size());
+		return partitionVoiceBuffers[partitionIndex - 1];
+	}
+
+	/** The voices can be rendered in parallel unless they use the shared crossfade chain. */
+	bool canRenderVoicesInParallel() const override { return !isUsingCrossfadeGroups(); }
+
 	bool checkAndLogIsSoftBypassed(DebugLogger::Location location) const;
 
 	void setHasPendingSampleLoad(bool hasSamplesPending)
@@ -562,6 +616,11 @@ public:
     
     bool isUsingStaticMatrix() const noexcept { return useStaticMatrix; };
 
+	/** Sets the interpolation mode of all voices. */
+	void setInterpolationMode(SamplerInterpolator::Mode newMode);
+
+	SamplerInterpolator::Mode getInterpolationMode() const noexcept { return interpolationMode; }
+
 private:
 
 	bool isOnSampleLoadingThread() const
@@ -650,7 +709,14 @@ private:
 
 	void refreshCrossfadeTables();
 
+	/** Adds the sound that was just appended to the sound array to the index. */
+	void addToSoundIndex(ModulatorSamplerSound* newSound);
+
 	RoundRobinMap roundRobinMap;
+	SamplerSoundIndex soundIndex;
+
+	// Bumped whenever the sound array changes. The index is only used if it was built for the current generation.
+	int soundGeneration = 0;
 
 	bool reversed = false;
 
@@ -678,13 +744,17 @@ private:
 
 	bool useStaticMatrix = false;
 
+	SamplerInterpolator::Mode interpolationMode = SamplerInterpolator::Mode::Linear;
+
 	int64 memoryUsage;
+	int64 lazyPreloadMemoryUsage = 0;
 
 	OwnedArray<SampleLookupTable> crossfadeTables;
 
 	AudioSampleBuffer crossfadeBuffer;
 
 	hlac::HiseSampleBuffer temporaryVoiceBuffer;
+	OwnedArray<hlac::HiseSampleBuffer> partitionVoiceBuffers;
 
 	float groupGainValues[8];
 
@@ -695,6 +765,7 @@ private:
 	ScopedPointer<ModulatorChain> sampleStartChain;
 	ScopedPointer<ModulatorChain> crossFadeChain;
 	ScopedPointer<AudioThumbnailCache> soundCache;
+	ScopedPointer<LazyPreloadHandler> lazyPreloadHandler;
 	
 #if USE_BACKEND
 	ScopedPointer<SampleEditHandler> sampleEditHandler;
@@ -763,6 +763,130 @@ int RoundRobinMap::getRRGroupsForMessage(int noteNumber, int velocity)
 	
 }
 
+SamplerSoundIndex::SamplerSoundIndex():
+	numIndexedSounds(0),
+	indexedGeneration(-1)
+{
+
+}
+
+void SamplerSoundIndex::clear()
+{
+	for (int i = 0; i < 128; i++)
+	{
+		notes[i].allSounds.clearQuick();
+
+		for (auto g : notes[i].groups)
+		{
+			if (g != nullptr)
+				g->clearQuick();
+		}
+	}
+
+	numIndexedSounds = 0;
+	indexedGeneration = -1;
+}
+
+void SamplerSoundIndex::rebuild(const ReferenceCountedArray<SynthesiserSound>& sounds, int soundGeneration)
+{
+	clear();
+
+	for (int i = 0; i < sounds.size(); i++)
+		addToNoteLists(static_cast<ModulatorSamplerSound*>(sounds.getUnchecked(i).get()));
+
+	indexedGeneration = soundGeneration;
+}
+
+void SamplerSoundIndex::addSound(ModulatorSamplerSound* sound, int soundGeneration)
+{
+	addToNoteLists(sound);
+
+	indexedGeneration = soundGeneration;
+}
+
+void SamplerSoundIndex::addToNoteLists(ModulatorSamplerSound* sound)
+{
+	const Range<int> noteRange = sound->getNoteRange().getIntersectionWith(Range<int>(0, 128));
+
+	for (int i = noteRange.getStart(); i < noteRange.getEnd(); i++)
+	{
+		notes[i].allSounds.add(sound);
+
+		if (auto g = getGroupList(i, sound->getRRGroup()))
+			g->add(sound);
+	}
+
+	numIndexedSounds++;
+}
+
+void SamplerSoundIndex::updateSound(ModulatorSamplerSound* sound)
+{
+	ModulatorSynthSound* s = sound;
+
+	for (int i = 0; i < 128; i++)
+	{
+		notes[i].allSounds.removeFirstMatchingValue(s);
+
+		for (auto g : notes[i].groups)
+		{
+			if (g != nullptr)
+				g->removeFirstMatchingValue(s);
+		}
+	}
+
+	const Range<int> noteRange = sound->getNoteRange().getIntersectionWith(Range<int>(0, 128));
+
+	for (int i = noteRange.getStart(); i < noteRange.getEnd(); i++)
+	{
+		insertSorted(notes[i].allSounds, sound);
+
+		if (auto g = getGroupList(i, sound->getRRGroup()))
+			insertSorted(*g, sound);
+	}
+}
+
+const Array<ModulatorSynthSound*>* SamplerSoundIndex::getSounds(int noteNumber, int rrGroup) const noexcept
+{
+	if (noteNumber < 0 || noteNumber >= 128)
+		return &emptyList;
+
+	const NoteEntry& entry = notes[noteNumber];
+
+	if (rrGroup == -1)
+		return &entry.allSounds;
+
+	if (auto g = entry.groups[rrGroup])
+		return g;
+
+	return &emptyList;
+}
+
+void SamplerSoundIndex::insertSorted(Array<ModulatorSynthSound*>& list, ModulatorSamplerSound* sound)
+{
+	int insertIndex = list.size();
+
+	while (insertIndex > 0 && static_cast<ModulatorSamplerSound*>(list.getUnchecked(insertIndex - 1))->getId() > sound->getId())
+		insertIndex--;
+
+	list.insert(insertIndex, sound);
+}
+
+Array<ModulatorSynthSound*>* SamplerSoundIndex::getGroupList(int noteNumber, int rrGroup)
+{
+	if (rrGroup < 0)
+		return nullptr;
+
+	OwnedArray<Array<ModulatorSynthSound*>>& groups = notes[noteNumber].groups;
+
+	while (groups.size() <= rrGroup)
+		groups.add(nullptr);
+
+	if (groups[rrGroup] == nullptr)
+		groups.set(rrGroup, new Array<ModulatorSynthSound*>());
+
+	return groups[rrGroup];
+}
+
 MonolithExporter::MonolithExporter(SampleMap* sampleMap_) :
 	DialogWindowWithBackgroundThread("Exporting samples as monolith"),
 	AudioFormatWriter(nullptr, "", 0.0, 0, 1),
@@ -928,6 +1052,48 @@ void MonolithExporter::checkSanity()
 	}
 }
 
+/** Reads a sample file into memory so that the next files can be loaded while the current file is being encoded. */
+struct MonolithSampleReadJob : public ThreadPoolJob
+{
+	MonolithSampleReadJob(AudioFormatManager& afm_, const File& f, int numChannels_) :
+		ThreadPoolJob("Monolith Sample Reader"),
+		afm(afm_),
+		file(f),
+		numChannels(numChannels_)
+	{}
+
+	JobStatus runJob() override
+	{
+		readFile();
+		return jobHasFinished;
+	}
+
+	void readFile()
+	{
+		if (wasRead)
+			return;
+
+		ScopedPointer<AudioFormatReader> reader = afm.createReaderFor(file);
+
+		if (reader != nullptr)
+		{
+			buffer.setSize(numChannels, (int)reader->lengthInSamples);
+			reader->read(&buffer, 0, (int)reader->lengthInSamples, 0, true, true);
+			readSuccessful = true;
+		}
+
+		wasRead = true;
+	}
+
+	AudioFormatManager& afm;
+	const File file;
+	const int numChannels;
+
+	AudioSampleBuffer buffer;
+	bool readSuccessful = false;
+	bool wasRead = false;
+};
+
 void MonolithExporter::writeFiles(int channelIndex, bool overwriteExistingData)
 {
 	AudioFormatManager afm;
@@ -970,21 +1136,50 @@ void MonolithExporter::writeFiles(int channelIndex, bool overwriteExistingData)
 
 		dynamic_cast<hlac::HiseLosslessAudioFormatWriter*>(writer.get())->setOptions(options);
 
+		// The pool reads the next files while the encoder uses it for the blocks of the current file.
+		// This thread does the rest of the work, so it uses one thread less than the CPU count.
+		ThreadPool pool(jmax<int>(1, SystemStats::getNumCpus() - 1));
+
+		dynamic_cast<hlac::HiseLosslessAudioFormatWriter*>(writer.get())->setThreadPool(&pool);
+
+		OwnedArray<MonolithSampleReadJob> readJobs;
+
+		const int numFilesToReadAhead = pool.getNumThreads();
+		const int numChannelsToWrite = isMono ? 1 : 2;
+
 		for (int i = 0; i < channelList->size(); i++)
 		{
 			setProgress((double)i / (double)numSamples);
 
+			while (readJobs.size() < jmin<int>(channelList->size(), i + 1 + numFilesToReadAhead))
+			{
+				auto job = readJobs.add(new MonolithSampleReadJob(afm, channelList->getUnchecked(readJobs.size()), numChannelsToWrite));
+				pool.addJob(job, false);
+			}
+
+			auto job = readJobs[i];
+
+			// Takes the job off the queue if it hasn't been started yet and reads the file on this thread instead
+			pool.removeJob(job, false, -1);
+			job->readFile();
+
             if(threadShouldExit())
+			{
+				pool.removeAllJobs(true, -1);
                 return;
+			}
             
-			ScopedPointer<AudioFormatReader> reader = afm.createReaderFor(channelList->getUnchecked(i));
-
-			if (reader != nullptr)
+			if (job->readSuccessful)
 			{
-				writer->writeFromAudioReader(*reader, 0, -1);
+				writer->writeFromFloatArrays(job->buffer.getArrayOfReadPointers(), numChannelsToWrite, job->buffer.getNumSamples());
+
+				// The buffer isn't needed anymore
+				readJobs.set(i, nullptr);
 			}
 			else
 			{
+				pool.removeAllJobs(true, -1);
+
 				error = "Could not read the source file " + channelList->getUnchecked(i).getFullPathName();
 				writer->flush();
 				writer = nullptr;
@@ -283,6 +283,68 @@ private:
 
 };
 
+/** A lookup table that contains the sounds of a sampler for every note number and round robin group.
+*
+*	The sampler uses this in noteOn() so it only has to check the sounds that are mapped to the note instead of
+*	every sound of the sample map. The velocity range and the purge state are still checked by soundCanBePlayed()
+*	for every candidate, so the index only needs to be updated if the key range or the group of a sound changes.
+*
+*	The lists are sorted by the sound index, so the voices are started in the same order as with a linear search.
+*
+*	The index stores the generation of the sound array it was built for. The sampler bumps its generation whenever
+*	the sound array changes, so the index can't be used if a sound was removed and another one added.
+*/
+class SamplerSoundIndex
+{
+public:
+
+	SamplerSoundIndex();
+
+	/** Clears the index. */
+	void clear();
+
+	/** Clears the index and adds every sound of the array. The index is valid for the given generation afterwards. */
+	void rebuild(const ReferenceCountedArray<SynthesiserSound>& sounds, int soundGeneration);
+
+	/** Adds a sound that was appended to the sound array of the sampler. The index is valid for the given generation afterwards. */
+	void addSound(ModulatorSamplerSound* sound, int soundGeneration);
+
+	/** Removes the sound from every list and adds it again with its current key range and group. */
+	void updateSound(ModulatorSamplerSound* sound);
+
+	/** Checks if the index was built for the given generation of the sound array. If not, it must be rebuilt before it can be used. 
+	*
+	*	The amount of sounds is checked too, in case the sound array was changed without bumping the generation.
+	*/
+	bool isValidFor(int numSounds, int soundGeneration) const noexcept 
+	{ 
+		return indexedGeneration == soundGeneration && numIndexedSounds == numSounds; 
+	}
+
+	/** Returns all sounds that are mapped to the note number and the given group. Use -1 for the group to get the sounds of every group. */
+	const Array<ModulatorSynthSound*>* getSounds(int noteNumber, int rrGroup) const noexcept;
+
+private:
+
+	struct NoteEntry
+	{
+		Array<ModulatorSynthSound*> allSounds;
+		OwnedArray<Array<ModulatorSynthSound*>> groups;
+	};
+
+	static void insertSorted(Array<ModulatorSynthSound*>& list, ModulatorSamplerSound* sound);
+
+	void addToNoteLists(ModulatorSamplerSound* sound);
+
+	Array<ModulatorSynthSound*>* getGroupList(int noteNumber, int rrGroup);
+
+	NoteEntry notes[128];
+	Array<ModulatorSynthSound*> emptyList;
+
+	int numIndexedSounds;
+	int indexedGeneration;
+};
+
 
 class MonolithExporter : public DialogWindowWithBackgroundThread,
 						 public AudioFormatWriter
@@ -428,6 +428,8 @@ void ModulatorSamplerSound::setMappingData(MappingData newData)
 	midiNotes.setRange(newData.loKey, newData.hiKey - newData.loKey + 1, true);
 	rrGroup = newData.rrGroup;
 
+	updateOwnerIndex();
+
 	setProperty(SampleStart, newData.sampleStart, dontSendNotification);
 	setProperty(SampleEnd, newData.sampleEnd, dontSendNotification);
 	setProperty(SampleStartMod, newData.sampleStartMod, dontSendNotification);
@@ -660,6 +662,14 @@ void ModulatorSamplerSound::setPropertyInternal(Property p, int newValue)
 	default:			jassertfalse; break;
 	}
 
+	if (p == KeyHigh || p == KeyLow || p == RRGroup)
+		updateOwnerIndex();
+}
+
+void ModulatorSamplerSound::updateOwnerIndex()
+{
+	if (auto sampler = dynamic_cast<ModulatorSampler*>(owner.get()))
+		sampler->updateSoundIndex(this);
 }
 
 void ModulatorSamplerSound::setPreloadPropertyInternal(Property p, int newValue)
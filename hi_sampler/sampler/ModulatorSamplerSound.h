@@ -258,6 +258,9 @@ public:
 	Range<int> getVelocityRange() const;
 
     void setNewIndex(int newIndex) noexcept { index = newIndex; };
+
+	/** Sets the sampler that owns this sound. It will be notified when the key range or the group of the sound changes. */
+	void setOwner(Processor* ownerSampler) noexcept { owner = ownerSampler; };
     
 	/** Returns the gain value of the sound.
 	*
@@ -365,6 +368,9 @@ private:
 
 	void setPropertyInternal(Property p, int newValue);
 
+	/** Tells the owner sampler that the key range or the group has changed. */
+	void updateOwnerIndex();
+
 	void setPreloadPropertyInternal(Property y, int newValue);
 
 	// ================================================================================================================
@@ -430,6 +436,8 @@ private:
 	BigInteger midiNotes;
 	int index;
 
+	WeakReference<Processor> owner;
+
 	int maxRRGroup;
 	int rrGroup;
 
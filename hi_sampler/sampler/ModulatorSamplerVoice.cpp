@@ -46,6 +46,8 @@ void ModulatorSamplerVoice::startNote(int midiNoteNumber,
 	jassert(s != nullptr);
 
 	currentlyPlayingSamplerSound = static_cast<ModulatorSamplerSound*>(s);
+
+	sampler->getLazyPreloadHandler()->soundWasStarted(currentlyPlayingSamplerSound);
     
 	velocityXFadeValue = currentlyPlayingSamplerSound->getGainValueForVelocityXFade((int)(velocity * 127.0f));
 	const bool samePitch = !static_cast<ModulatorSampler*>(getOwnerSynth())->isPitchTrackingEnabled();
@@ -108,12 +110,13 @@ void ModulatorSamplerVoice::calculateBlock(int startSample, int numSamples)
 	const int startIndex = startSample;
 	const int samplesInBlock = numSamples;
 
-	float *voicePitchValues = isPitchModulationActive() ? getVoicePitchValues() : nullptr;
-	const double propertyPitch = currentlyPlayingSamplerSound->getPropertyPitch();
+	double propertyPitch = currentlyPlayingSamplerSound->getPropertyPitch();
+	float *voicePitchValues = getPitchValuesForBlock(propertyPitch);
 	
 	const double pitchCounter = limitPitchDataToMaxSamplerPitch(voicePitchValues, uptimeDelta * propertyPitch, startSample, numSamples);
 	
 	const float *modValues = getVoiceGainValues(startSample, numSamples);
+	const ModulationShape gainShape = getVoiceGainShape();
 
 	wrappedVoice.setPitchCounterForThisBlock(pitchCounter);
 	wrappedVoice.setPitchValues(voicePitchValues);
@@ -132,20 +135,29 @@ void ModulatorSamplerVoice::calculateBlock(int startSample, int numSamples)
 	
 	if (!wrappedVoice.isActive)
 	{
-		resetVoice();
+		resetVoiceFromRenderCallback();
 	}
 
 	getOwnerSynth()->effectChain->renderVoice(voiceIndex, voiceBuffer, startIndex, samplesInBlock);
 
-	FloatVectorOperations::multiply(voiceBuffer.getWritePointer(0, startIndex), modValues + startIndex, samplesInBlock);
-	FloatVectorOperations::multiply(voiceBuffer.getWritePointer(1, startIndex), modValues + startIndex, samplesInBlock);
-
 	const float propertyGain = currentlyPlayingSamplerSound->getPropertyVolume();
 	const float normalizationGain = currentlyPlayingSamplerSound->getNormalizedPeak();
 	const float lGain = currentlyPlayingSamplerSound->getBalance(false);
 	const float rGain = currentlyPlayingSamplerSound->getBalance(true);
-	const float totalL = propertyGain * normalizationGain * lGain * velocityXFadeValue;
-	const float totalR = propertyGain * normalizationGain * rGain * velocityXFadeValue;
+	float totalL = propertyGain * normalizationGain * lGain * velocityXFadeValue;
+	float totalR = propertyGain * normalizationGain * rGain * velocityXFadeValue;
+
+	// A constant gain modulation is merged with the static gain factors
+	if (gainShape.isConstant())
+	{
+		totalL *= gainShape.getConstantValue();
+		totalR *= gainShape.getConstantValue();
+	}
+	else
+	{
+		gainShape.applyTo(voiceBuffer.getWritePointer(0, startIndex), modValues + startIndex, samplesInBlock);
+		gainShape.applyTo(voiceBuffer.getWritePointer(1, startIndex), modValues + startIndex, samplesInBlock);
+	}
 
 	if (totalL != 1.0f) FloatVectorOperations::multiply(voiceBuffer.getWritePointer(0, startIndex), totalL, samplesInBlock);
 	if (totalR != 1.0f) FloatVectorOperations::multiply(voiceBuffer.getWritePointer(1, startIndex), totalR, samplesInBlock);
@@ -188,6 +200,28 @@ void ModulatorSamplerVoice::handlePlaybackPosition(const StreamingSamplerSound *
 	}
 }
 
+float* ModulatorSamplerVoice::getPitchValuesForBlock(double& pitchFactor)
+{
+	if (!isPitchModulationActive())
+		return nullptr;
+
+	const ModulationShape& shape = getVoicePitchShape();
+
+	if (shape.isConstant())
+	{
+		const double constantPitchFactor = pitchFactor * (double)shape.getConstantValue();
+
+		// The pitch values are limited to the maximum pitch, so use them if the constant pitch exceeds it.
+		if (uptimeDelta * constantPitchFactor <= (double)MAX_SAMPLER_PITCH)
+		{
+			pitchFactor = constantPitchFactor;
+			return nullptr;
+		}
+	}
+
+	return getVoicePitchValues();
+}
+
 double ModulatorSamplerVoice::limitPitchDataToMaxSamplerPitch(float * pitchData, double uptimeDelta, int startSample, int numSamples)
 {
 	double pitchCounter = 0.0;
@@ -252,6 +286,23 @@ void ModulatorSamplerVoice::setStreamingBufferDataType(bool shouldBeFloat)
 	wrappedVoice.loader.setStreamingBufferDataType(shouldBeFloat);
 }
 
+void ModulatorSamplerVoice::setInterpolationMode(SamplerInterpolator::Mode newMode)
+{
+	wrappedVoice.setInterpolationMode(newMode);
+}
+
+void ModulatorSamplerVoice::setTemporaryVoiceBuffer(hlac::HiseSampleBuffer* buffer)
+{
+	wrappedVoice.setTemporaryVoiceBuffer(buffer);
+}
+
+void ModulatorSamplerVoice::prepareForParallelRendering(int partitionIndex, int startSample, int numSamples)
+{
+	setTemporaryVoiceBuffer(sampler->getTemporaryVoiceBuffer(partitionIndex));
+
+	ModulatorSynthVoice::prepareForParallelRendering(partitionIndex, startSample, numSamples);
+}
+
 const float * ModulatorSamplerVoice::getCrossfadeModulationValues(int startSample, int numSamples)
 {
 
@@ -311,6 +362,8 @@ void MultiMicModulatorSamplerVoice::startNote(int midiNoteNumber, float velocity
 
 	currentlyPlayingSamplerSound = static_cast<ModulatorSamplerSound*>(s);
 
+	sampler->getLazyPreloadHandler()->soundWasStarted(currentlyPlayingSamplerSound);
+
 	velocityXFadeValue = currentlyPlayingSamplerSound->getGainValueForVelocityXFade((int)(velocity * 127.0f));
 	const bool samePitch = !sampler->isPitchTrackingEnabled();
 
@@ -350,11 +403,12 @@ void MultiMicModulatorSamplerVoice::calculateBlock(int startSample, int numSampl
 	const int startIndex = startSample;
 	const int samplesInBlock = numSamples;
 
-	float *voicePitchValues = isPitchModulationActive() ? getVoicePitchValues() : nullptr;
-	const double propertyPitch = (float)currentlyPlayingSamplerSound->getPropertyPitch();
+	double propertyPitch = (float)currentlyPlayingSamplerSound->getPropertyPitch();
+	float *voicePitchValues = getPitchValuesForBlock(propertyPitch);
 	const double pitchCounter = limitPitchDataToMaxSamplerPitch(voicePitchValues, uptimeDelta * propertyPitch, startSample, numSamples);
 
 	const float *modValues = getVoiceGainValues(startSample, numSamples);
+	const ModulationShape gainShape = getVoiceGainShape();
 
 	voiceBuffer.clear();
 
@@ -380,7 +434,7 @@ void MultiMicModulatorSamplerVoice::calculateBlock(int startSample, int numSampl
 
 		if (!wrappedVoices[i]->isActive)
 		{
-			resetVoice();
+			resetVoiceFromRenderCallback();
 		}
 	}
 
@@ -402,11 +456,19 @@ void MultiMicModulatorSamplerVoice::calculateBlock(int startSample, int numSampl
 		if (wrappedVoices[i]->getLoadedSound() == nullptr) continue;
 
 		// Apply Modulation
-		FloatVectorOperations::multiply(voiceBuffer.getWritePointer(2*i, startIndex), modValues + startIndex, samplesInBlock);
-		FloatVectorOperations::multiply(voiceBuffer.getWritePointer(2*i + 1, startIndex), modValues + startIndex, samplesInBlock);
+		if (gainShape.isConstant())
+		{
+			FloatVectorOperations::multiply(voiceBuffer.getWritePointer(2*i, startIndex), lSum * gainShape.getConstantValue(), samplesInBlock);
+			FloatVectorOperations::multiply(voiceBuffer.getWritePointer(2*i + 1, startIndex), rSum * gainShape.getConstantValue(), samplesInBlock);
+		}
+		else
+		{
+			gainShape.applyTo(voiceBuffer.getWritePointer(2*i, startIndex), modValues + startIndex, samplesInBlock);
+			gainShape.applyTo(voiceBuffer.getWritePointer(2*i + 1, startIndex), modValues + startIndex, samplesInBlock);
 
-		FloatVectorOperations::multiply(voiceBuffer.getWritePointer(2*i, startIndex), lSum, samplesInBlock);
-		FloatVectorOperations::multiply(voiceBuffer.getWritePointer(2*i + 1, startIndex), rSum, samplesInBlock);
+			FloatVectorOperations::multiply(voiceBuffer.getWritePointer(2*i, startIndex), lSum, samplesInBlock);
+			FloatVectorOperations::multiply(voiceBuffer.getWritePointer(2*i + 1, startIndex), rSum, samplesInBlock);
+		}
 	}
 
 	if (sampler->isUsingCrossfadeGroups())
@@ -483,6 +545,22 @@ void MultiMicModulatorSamplerVoice::setStreamingBufferDataType(bool shouldBeFloa
 	}
 }
 
+void MultiMicModulatorSamplerVoice::setInterpolationMode(SamplerInterpolator::Mode newMode)
+{
+	for (int i = 0; i < wrappedVoices.size(); i++)
+	{
+		wrappedVoices[i]->setInterpolationMode(newMode);
+	}
+}
+
+void MultiMicModulatorSamplerVoice::setTemporaryVoiceBuffer(hlac::HiseSampleBuffer* buffer)
+{
+	for (int i = 0; i < wrappedVoices.size(); i++)
+	{
+		wrappedVoices[i]->setTemporaryVoiceBuffer(buffer);
+	}
+}
+
 void MultiMicModulatorSamplerVoice::resetVoice()
 {
 	sampler->resetNoteDisplay(this->getCurrentlyPlayingNote());
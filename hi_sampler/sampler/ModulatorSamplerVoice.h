@@ -61,10 +61,20 @@ public:
 	void calculateBlock(int startSample, int numSamples) override;
 	void resetVoice() override;
 
+	/** Uses the temporary voice buffer of the partition so that the voices of different partitions can be resampled at the same time. */
+	void prepareForParallelRendering(int partitionIndex, int startSample, int numSamples) override;
+
 	void handlePlaybackPosition(const StreamingSamplerSound * sound);
 
 	static double limitPitchDataToMaxSamplerPitch(float * pitchData, double uptimeDelta, int startSample, int numSamples);
 
+	/** Returns the pitch values for this block or nullptr if the pitch modulation is constant.
+	*
+	*	If the pitch modulation is constant, it is multiplied to the given pitch factor so that the
+	*	streaming voice can use its fixed pitch path.
+	*/
+	float* getPitchValuesForBlock(double& pitchFactor);
+
 	// ================================================================================================================
 
 	virtual void setLoaderBufferSize(int newBufferSize);
@@ -73,6 +83,10 @@ public:
 
 	virtual void setStreamingBufferDataType(bool shouldBeFloat);
 
+	virtual void setInterpolationMode(SamplerInterpolator::Mode newMode);
+
+	virtual void setTemporaryVoiceBuffer(hlac::HiseSampleBuffer* buffer);
+
 	// ================================================================================================================
 
 	const float *getCrossfadeModulationValues(int startSample, int numSamples);
@@ -140,6 +154,10 @@ public:
 
 	void setStreamingBufferDataType(bool shouldBeFloat) override;
 
+	void setInterpolationMode(SamplerInterpolator::Mode newMode) override;
+
+	void setTemporaryVoiceBuffer(hlac::HiseSampleBuffer* buffer) override;
+
 	/** Resets the display value for the current note. */
 	void resetVoice() override;
 
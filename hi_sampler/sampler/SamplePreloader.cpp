@@ -0,0 +1,208 @@
+/*  ===========================================================================
+*
+*   This file is part of HISE.
+*   Copyright 2016 Christoph Hart
+*
+*   HISE is free software: you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation, either version 3 of the License, or
+*   (at your option) any later version.
+*
+*   HISE is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with HISE.  If not, see <http://www.gnu.org/licenses/>.
+*
+*   Commercial licenses for using HISE in an closed source project are
+*   available on request. Please visit the project's website to get more
+*   information about commercial licensing:
+*
+*   http://www.hise.audio/
+*
+*   HISE is based on the JUCE library,
+*   which must be separately licensed for closed source applications:
+*
+*   http://www.juce.com
+*
+*   ===========================================================================
+*/
+
+
+namespace hise { using namespace juce;
+
+class SamplePreloader::Worker : public Thread
+{
+public:
+
+	Worker(SamplePreloader& parent_) :
+		Thread("Sample Preload Worker"),
+		parent(parent_)
+	{};
+
+	void run() override
+	{
+		parent.loadLanes(false);
+
+		--parent.numActiveWorkers;
+		parent.workerFinished.signal();
+	}
+
+private:
+
+	SamplePreloader& parent;
+};
+
+SamplePreloader::SamplePreloader(Thread* threadToWatch_, double& progress_) :
+	threadToWatch(threadToWatch_),
+	progress(progress_)
+{
+}
+
+SamplePreloader::~SamplePreloader()
+{
+	jassert(numActiveWorkers.load() == 0);
+}
+
+void SamplePreloader::addSound(StreamingSamplerSound* s, int micIndex)
+{
+	jassert(s != nullptr);
+
+	const void* monolith = s->getSharedMonolith();
+
+	Lane* lane = nullptr;
+
+	if (monolith != nullptr)
+	{
+		for (auto l : monolithLanes)
+		{
+			if (l->monolith == monolith && l->micIndex == micIndex)
+			{
+				lane = l;
+				break;
+			}
+		}
+	}
+
+	if (lane == nullptr)
+	{
+		lane = lanes.add(new Lane());
+		lane->monolith = monolith;
+		lane->micIndex = micIndex;
+
+		if (monolith != nullptr)
+			monolithLanes.add(lane);
+	}
+
+	lane->sounds.add(s);
+	numSounds++;
+}
+
+bool SamplePreloader::run(const PreloadFunction& f)
+{
+	function = &f;
+	nextLane.store(0);
+	numLoaded.store(0);
+	aborted.store(false);
+
+	{
+		ScopedLock sl(errorLock);
+		errorMessage = String();
+	}
+
+	const int numThreads = getNumThreadsToUse(lanes.size());
+
+	OwnedArray<Worker> workers;
+
+	numActiveWorkers.store(numThreads - 1);
+
+	for (int i = 1; i < numThreads; i++)
+		workers.add(new Worker(*this))->startThread();
+
+	loadLanes(true);
+
+	while (numActiveWorkers.load() > 0)
+	{
+		shouldAbort();
+		updateProgress();
+
+		workerFinished.wait(50);
+	}
+
+	for (auto w : workers)
+		w->waitForThreadToExit(-1);
+
+	updateProgress();
+
+	function = nullptr;
+
+	return !aborted.load();
+}
+
+String SamplePreloader::getErrorMessage() const
+{
+	ScopedLock sl(errorLock);
+	return errorMessage;
+}
+
+int SamplePreloader::getNumThreadsToUse(int numLanes)
+{
+	int numThreads = NUM_PRELOAD_THREADS;
+
+	if (numThreads <= 0)
+		numThreads = jlimit<int>(1, 4, SystemStats::getNumCpus());
+
+	return jlimit<int>(1, jmax<int>(1, numLanes), numThreads);
+}
+
+void SamplePreloader::loadLanes(bool isCallingThread)
+{
+	while (!shouldAbort())
+	{
+		const int laneIndex = nextLane++;
+
+		if (laneIndex >= lanes.size())
+			return;
+
+		for (auto s : lanes.getUnchecked(laneIndex)->sounds)
+		{
+			if (shouldAbort())
+				return;
+
+			String thisError;
+
+			if (!(*function)(s, thisError))
+			{
+				ScopedLock sl(errorLock);
+
+				// Only the first error is reported
+				if (!aborted.exchange(true))
+					errorMessage = thisError;
+
+				return;
+			}
+
+			++numLoaded;
+
+			if (isCallingThread)
+				updateProgress();
+		}
+	}
+}
+
+bool SamplePreloader::shouldAbort() noexcept
+{
+	if (threadToWatch != nullptr && threadToWatch->threadShouldExit())
+		aborted.store(true);
+
+	return aborted.load();
+}
+
+void SamplePreloader::updateProgress()
+{
+	progress = (double)numLoaded.load() / (double)jmax<int>(1, numSounds);
+}
+
+} // namespace hise
@@ -0,0 +1,126 @@
+/*  ===========================================================================
+*
+*   This file is part of HISE.
+*   Copyright 2016 Christoph Hart
+*
+*   HISE is free software: you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation, either version 3 of the License, or
+*   (at your option) any later version.
+*
+*   HISE is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with HISE.  If not, see <http://www.gnu.org/licenses/>.
+*
+*   Commercial licenses for using HISE in an closed source project are
+*   available on request. Please visit the project's website to get more
+*   information about commercial licensing:
+*
+*   http://www.hise.audio/
+*
+*   HISE is based on the JUCE library,
+*   which must be separately licensed for closed source applications:
+*
+*   http://www.juce.com
+*
+*   ===========================================================================
+*/
+
+
+#ifndef SAMPLEPRELOADER_H_INCLUDED
+#define SAMPLEPRELOADER_H_INCLUDED
+
+namespace hise { using namespace juce;
+
+/** Preloads a list of sounds with multiple threads.
+*	@ingroup sampler
+*
+*	The sounds are sorted into lanes that are loaded one after another by the next free thread. Sounds that read from
+*	the same monolith channel end up in the same lane because they share the reader, every other sound gets its own lane.
+*	This means that a sample map with a single monolith and a single mic position is loaded by one thread and doesn't get
+*	any faster. Only multiple mic positions, multiple monoliths or single sample files are loaded in parallel.
+*
+*	The thread that calls run() loads lanes too, so with one thread this is a plain loop. The amount of additional threads
+*	(and therefore the amount of files that are read at the same time) is limited by NUM_PRELOAD_THREADS.
+*
+*	The function is called on the worker threads, so it must not write to the console or the debug logger. Return the error
+*	message instead and report it on the calling thread after run() returned.
+*/
+class SamplePreloader
+{
+public:
+
+	/** The function that loads a single sound. Return false and set the error message to cancel the preloading. */
+	using PreloadFunction = std::function<bool(StreamingSamplerSound*, String& errorMessage)>;
+
+	/** Creates a preloader that checks the given thread for cancellation and writes the progress to the given value. */
+	SamplePreloader(Thread* threadToWatch, double& progress);
+
+	~SamplePreloader();
+
+	/** Adds the sound of the given mic position. */
+	void addSound(StreamingSamplerSound* s, int micIndex);
+
+	/** Returns the number of sounds that were added. */
+	int getNumSounds() const noexcept { return numSounds; }
+
+	/** Loads all sounds and returns false if the function failed or the thread should exit.
+	*
+	*	The progress value is only written by the calling thread.
+	*/
+	bool run(const PreloadFunction& f);
+
+	/** Returns the error message of the first sound that failed to load in the last run(). */
+	String getErrorMessage() const;
+
+	/** Returns the number of threads (including the calling thread) that are used to load the given amount of lanes. */
+	static int getNumThreadsToUse(int numLanes);
+
+private:
+
+	struct Lane
+	{
+		const void* monolith;
+		int micIndex;
+		Array<StreamingSamplerSound*> sounds;
+	};
+
+	class Worker;
+
+	/** Loads lanes until there are no more lanes left or something went wrong. */
+	void loadLanes(bool isCallingThread);
+
+	/** Returns true if a sound failed to load or the watched thread should exit. */
+	bool shouldAbort() noexcept;
+
+	void updateProgress();
+
+	Thread* threadToWatch;
+	double& progress;
+
+	OwnedArray<Lane> lanes;
+	Array<Lane*> monolithLanes;
+	int numSounds = 0;
+
+	const PreloadFunction* function = nullptr;
+
+	std::atomic<int> nextLane { 0 };
+	std::atomic<int> numLoaded { 0 };
+	std::atomic<int> numActiveWorkers { 0 };
+	std::atomic<bool> aborted { false };
+
+	WaitableEvent workerFinished;
+
+	CriticalSection errorLock;
+	String errorMessage;
+
+	JUCE_DECLARE_NON_COPYABLE(SamplePreloader);
+};
+
+} // namespace hise
+
+#endif  // SAMPLEPRELOADER_H_INCLUDED
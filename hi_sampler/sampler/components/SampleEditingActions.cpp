@@ -202,6 +202,7 @@ void SampleEditHandler::SampleEditingActions::checkMicPositionAmountBeforePastin
 		else if (PresetHandler::showYesNoWindow("Different mic amount detected.", "Do you want to replace all existing samples in this sampler?"))
 		{
 			s->clearSounds();
+			s->rebuildSoundIndex();
 
 			s->setNumChannels(numMics);
 
@@ -469,6 +470,8 @@ public:
 			s->addChangeListener(sampler->getSampleMap());
 		}
 
+		sampler->rebuildSoundIndex();
+
 		sampler->setBypassed(false);
 
 
@@ -942,6 +945,8 @@ void SampleEditHandler::SampleEditingActions::extractToSingleMicSamples(SampleEd
 			s->addChangeListener(sampler->getSampleMap());
 		}
 
+		sampler->rebuildSoundIndex();
+
 		sampler->setBypassed(false);
 
 		sampler->sendChangeMessage();
@@ -420,12 +420,17 @@ void JavascriptMidiProcessor::handleAsyncUpdate()
 
 	deferredUpdatePending = true;
 
+	int numDroppedEvents = 0;
+
 	if (!deferredEvents.isEmpty())
 	{
 		ScopedWriteLock sl(defferedMessageLock);
 
-		copyEventBuffer.copyFrom(deferredEvents);
+		copyEventBuffer.clear();
+		copyEventBuffer.addEvents(deferredEvents);
 		
+		numDroppedEvents = deferredEvents.getNumDroppedEvents();
+
 		deferredEvents.clear();
 
 	}
@@ -435,7 +440,10 @@ void JavascriptMidiProcessor::handleAsyncUpdate()
 		return;
 	}
 
-	HiseEventBuffer::Iterator iter(copyEventBuffer);
+	if (numDroppedEvents > 0)
+		debugError(this, String(numDroppedEvents) + " deferred events were dropped because the message thread couldn't keep up");
+
+	LargeHiseEventBuffer::Iterator iter(copyEventBuffer);
 	
 	while (HiseEvent* m = iter.getNextEventPointer(true,true))
 	{
@@ -143,8 +143,9 @@ private:
 	MidiBuffer deferredMidiMessages;
 	MidiBuffer copyBuffer;
 
-	HiseEventBuffer deferredEvents;
-	HiseEventBuffer copyEventBuffer;
+	/** The events are collected until the message thread catches up, so dense MPE streams need more than HISE_EVENT_BUFFER_SIZE events. */
+	LargeHiseEventBuffer deferredEvents;
+	LargeHiseEventBuffer copyEventBuffer;
 
 	ReferenceCountedObjectPtr<ScriptingApi::Message> currentMidiMessage;
 	ReferenceCountedObjectPtr<ScriptingApi::Engine> engineObject;
@@ -653,5 +653,2225 @@ public:
 
 static AESTest aesTest;
 
+class AudioWorkerPoolTest : public UnitTest
+{
+public:
+
+	AudioWorkerPoolTest() :
+		UnitTest("Testing parallel voice rendering", "Benchmark")
+	{
+
+	}
+
+	void runTest() override
+	{
+		testAllPartsAreRendered();
+		testNestedJobs();
+		benchmarkVoiceRendering();
+	}
+
+private:
+
+	struct CountingJob : public AudioWorkerPool::Job
+	{
+		void renderPart(int partIndex) override
+		{
+			counters[partIndex]++;
+		}
+
+		std::atomic<int> counters[64];
+	};
+
+	struct NestedJob : public AudioWorkerPool::Job
+	{
+		NestedJob(AudioWorkerPool& pool_) :
+			pool(pool_)
+		{
+			numRejectedJobs = 0;
+		}
+
+		void renderPart(int /*partIndex*/) override
+		{
+			CountingJob innerJob;
+
+			if (!pool.renderParallel(innerJob, 4))
+				numRejectedJobs++;
+		}
+
+		AudioWorkerPool& pool;
+		std::atomic<int> numRejectedJobs;
+	};
+
+	/** A simple resampling voice that behaves like a sampler voice (the source is copied to a temporary buffer before it is interpolated). */
+	struct TestVoice
+	{
+		void render(AudioSampleBuffer& output, AudioSampleBuffer& temporaryBuffer, const AudioSampleBuffer& source, int numSamples)
+		{
+			const int numSourceSamples = (int)(numSamples * delta) + 3;
+
+			if (position + numSourceSamples >= source.getNumSamples())
+				position = 0.0;
+
+			const int startIndex = (int)position;
+
+			temporaryBuffer.copyFrom(0, 0, source, 0, startIndex, numSourceSamples);
+
+			const float* tmp = temporaryBuffer.getReadPointer(0);
+			float* l = output.getWritePointer(0);
+			float* r = output.getWritePointer(1);
+
+			double uptime = position - (double)startIndex;
+
+			for (int i = 0; i < numSamples; i++)
+			{
+				const int index = (int)uptime;
+				const float alpha = (float)(uptime - (double)index);
+				const float value = tmp[index] + alpha * (tmp[index + 1] - tmp[index]);
+
+				l[i] += value * gainLeft;
+				r[i] += value * gainRight;
+
+				uptime += delta;
+			}
+
+			position += (double)numSamples * delta;
+		}
+
+		double position = 0.0;
+		double delta = 1.0;
+		float gainLeft = 1.0f;
+		float gainRight = 1.0f;
+	};
+
+	struct VoiceJob : public AudioWorkerPool::Job
+	{
+		void renderPart(int partIndex) override
+		{
+			auto& output = *partitionBuffers[partIndex];
+
+			output.clear();
+
+			for (int i = partIndex; i < voices->size(); i += numPartitions)
+				voices->getReference(i).render(output, *temporaryBuffers[partIndex], *source, numSamples);
+		}
+
+		Array<TestVoice>* voices = nullptr;
+		const AudioSampleBuffer* source = nullptr;
+		OwnedArray<AudioSampleBuffer> partitionBuffers;
+		OwnedArray<AudioSampleBuffer> temporaryBuffers;
+		int numPartitions = 0;
+		int numSamples = 0;
+	};
+
+	void testAllPartsAreRendered()
+	{
+		beginTest("Testing that every part is rendered exactly once");
+
+		AudioWorkerPool pool(3);
+
+		Random r;
+
+		for (int i = 0; i < 2000; i++)
+		{
+			CountingJob job;
+
+			for (int j = 0; j < 64; j++)
+				job.counters[j] = 0;
+
+			const int numParts = r.nextInt(Range<int>(1, 64));
+
+			expect(pool.renderParallel(job, numParts), "Job was rejected");
+
+			for (int j = 0; j < 64; j++)
+			{
+				if (job.counters[j] != (j < numParts ? 1 : 0))
+				{
+					expectEquals<int>(job.counters[j], j < numParts ? 1 : 0, "Part " + String(j) + " of " + String(numParts));
+					return;
+				}
+			}
+		}
+	}
+
+	void testNestedJobs()
+	{
+		beginTest("Testing that nested jobs are rejected");
+
+		AudioWorkerPool pool(2);
+
+		NestedJob job(pool);
+
+		expect(pool.renderParallel(job, 8));
+		expectEquals<int>(job.numRejectedJobs.load(), 8);
+		expect(!pool.isBusy());
+	}
+
+	void benchmarkVoiceRendering()
+	{
+		beginTest("Benchmarking the voice rendering with 1 to 8 cores");
+
+		const int numVoices = 256;
+		const int blockSize = 512;
+		const int numBlocks = 200;
+
+		Random r;
+
+		AudioSampleBuffer source(1, 44100 * 4);
+
+		for (int i = 0; i < source.getNumSamples(); i++)
+			source.setSample(0, i, r.nextFloat() * 2.0f - 1.0f);
+
+		Array<TestVoice> initialVoices;
+
+		for (int i = 0; i < numVoices; i++)
+		{
+			TestVoice v;
+			v.position = (double)r.nextInt(source.getNumSamples() / 2);
+			v.delta = 0.5 + r.nextDouble() * 1.5;
+			v.gainLeft = r.nextFloat();
+			v.gainRight = r.nextFloat();
+
+			initialVoices.add(v);
+		}
+
+		AudioSampleBuffer serialOutput;
+		double serialTime = 0.0;
+
+		for (int numCores = 1; numCores <= 8; numCores++)
+		{
+			Array<TestVoice> voices(initialVoices);
+
+			ScopedPointer<AudioWorkerPool> pool(numCores > 1 ? new AudioWorkerPool(numCores - 1) : nullptr);
+
+			VoiceJob job;
+			job.voices = &voices;
+			job.source = &source;
+			job.numPartitions = numCores;
+			job.numSamples = blockSize;
+
+			for (int i = 0; i < numCores; i++)
+			{
+				job.partitionBuffers.add(new AudioSampleBuffer(2, blockSize));
+				job.temporaryBuffers.add(new AudioSampleBuffer(1, blockSize * 4));
+			}
+
+			AudioSampleBuffer output(2, blockSize);
+
+			// Let the workers start before the time is measured
+			Thread::sleep(20);
+
+			const double start = Time::getMillisecondCounterHiRes();
+
+			for (int i = 0; i < numBlocks; i++)
+			{
+				if (pool == nullptr || !pool->renderParallel(job, numCores))
+				{
+					for (int p = 0; p < numCores; p++)
+						job.renderPart(p);
+				}
+
+				// Add the partitions in a fixed order like ModulatorSynth::renderVoice
+				output.clear();
+
+				for (int p = 0; p < numCores; p++)
+				{
+					output.addFrom(0, 0, *job.partitionBuffers[p], 0, 0, blockSize);
+					output.addFrom(1, 0, *job.partitionBuffers[p], 1, 0, blockSize);
+				}
+			}
+
+			const double time = Time::getMillisecondCounterHiRes() - start;
+
+			if (numCores == 1)
+			{
+				serialOutput.makeCopyOf(output);
+				serialTime = time;
+			}
+			else
+			{
+				for (int c = 0; c < 2; c++)
+				{
+					for (int i = 0; i < blockSize; i++)
+					{
+						if (std::abs(output.getSample(c, i) - serialOutput.getSample(c, i)) > 0.001f)
+						{
+							expectEquals<float>(output.getSample(c, i), serialOutput.getSample(c, i), "Sample mismatch at position " + String(i) + " with " + String(numCores) + " cores");
+							return;
+						}
+					}
+				}
+			}
+
+			logMessage(String(numCores) + " core(s): " + String(time, 2) + " ms for " + String(numBlocks) + " blocks with " + String(numVoices) + " voices, speedup: " + String(serialTime / time, 2) + "x");
+		}
+	}
+};
+
+static AudioWorkerPoolTest audioWorkerPoolTest;
+
+/** A minimal MainController that only owns a synth chain. */
+class TestController : public MainController,
+					   public AudioProcessor
+{
+public:
+
+	TestController(int numWorkers=0) :
+		MainController()
+	{
+		setNumAudioWorkerThreads(numWorkers);
+
+		chain = new ModulatorSynthChain(this, "Master Chain", NUM_POLYPHONIC_VOICES);
+		chain->setIsOnAir(true);
+	}
+
+	~TestController()
+	{
+		chain = nullptr;
+	}
+
+	ModulatorSynthChain* getMainSynthChain() override { return chain; }
+	const ModulatorSynthChain* getMainSynthChain() const override { return chain; }
+
+	const String getName() const override { return "Test"; }
+	void prepareToPlay(double, int) override {}
+	void releaseResources() override {}
+	void processBlock(AudioSampleBuffer&, MidiBuffer&) override {}
+	double getTailLengthSeconds() const override { return 0.0; }
+	bool acceptsMidi() const override { return true; }
+	bool producesMidi() const override { return false; }
+	AudioProcessorEditor* createEditor() override { return nullptr; }
+	bool hasEditor() const override { return false; }
+	int getNumPrograms() override { return 1; }
+	int getCurrentProgram() override { return 0; }
+	void setCurrentProgram(int) override {}
+	const String getProgramName(int) override { return String(); }
+	void changeProgramName(int, const String&) override {}
+	void getStateInformation(MemoryBlock&) override {}
+	void setStateInformation(const void*, int) override {}
+
+	ScopedPointer<ModulatorSynthChain> chain;
+};
+
+class ParallelSynthRenderingTest : public UnitTest
+{
+public:
+
+	ParallelSynthRenderingTest() :
+		UnitTest("Testing parallel synth rendering against serial rendering", "AudioWorkerPool")
+	{
+
+	}
+
+	void runTest() override
+	{
+		testChildSynths();
+		testVoicePartitions();
+	}
+
+private:
+
+	static const int blockSize = 256;
+	static const int numBlocks = 64;
+
+	/** Plays the same notes on both controllers and compares the output of every block. */
+	void compareOutput(TestController& serial, TestController& parallel, int numNotes, float maxError)
+	{
+		serial.chain->prepareToPlay(44100.0, blockSize);
+		parallel.chain->prepareToPlay(44100.0, blockSize);
+
+		HiseEventBuffer events;
+		MainController::EventIdHandler idHandler(events);
+
+		AudioSampleBuffer serialOutput(2, blockSize);
+		AudioSampleBuffer parallelOutput(2, blockSize);
+
+		for (int i = 0; i < numBlocks; i++)
+		{
+			events.clear();
+
+			if (i == 0 || i == numBlocks / 2)
+			{
+				const auto type = i == 0 ? HiseEvent::Type::NoteOn : HiseEvent::Type::NoteOff;
+
+				for (int n = 0; n < numNotes; n++)
+				{
+					HiseEvent e(type, (uint8)(30 + n), 100, 1);
+					e.setTimeStamp((n * 7) % blockSize);
+					events.addEvent(e);
+				}
+
+				idHandler.handleEventIds();
+			}
+
+			serialOutput.clear();
+			parallelOutput.clear();
+
+			serial.chain->renderNextBlockWithModulators(serialOutput, events);
+			parallel.chain->renderNextBlockWithModulators(parallelOutput, events);
+
+			for (int c = 0; c < 2; c++)
+			{
+				for (int s = 0; s < blockSize; s++)
+				{
+					const float expected = serialOutput.getSample(c, s);
+					const float actual = parallelOutput.getSample(c, s);
+
+					if (std::abs(expected - actual) > maxError)
+					{
+						expectWithinAbsoluteError<float>(actual, expected, maxError, "Block " + String(i) + ", channel " + String(c) + ", sample " + String(s));
+						return;
+					}
+				}
+			}
+		}
+	}
+
+	void testChildSynths()
+	{
+		beginTest("Testing parallel child synths");
+
+		TestController serial(0);
+		TestController parallel(3);
+
+		for (auto mc : { &serial, &parallel })
+		{
+			for (int i = 0; i < 4; i++)
+			{
+				auto s = new SineSynth(mc, "Sine" + String(i + 1), NUM_POLYPHONIC_VOICES);
+				s->setAttribute(SineSynth::OctaveTranspose, (float)(i - 2), dontSendNotification);
+				mc->chain->getHandler()->add(s, nullptr);
+			}
+		}
+
+		// The child synth buffers are added in the same order as in the serial rendering
+		compareOutput(serial, parallel, 8, 1.0e-6f);
+	}
+
+	void testVoicePartitions()
+	{
+		beginTest("Testing parallel voice partitions");
+
+		TestController serial(0);
+		TestController parallel(3);
+
+		for (auto mc : { &serial, &parallel })
+			mc->chain->getHandler()->add(new SineSynth(mc, "Sine", NUM_POLYPHONIC_VOICES), nullptr);
+
+		// 32 voices are split into 4 partitions which are summed in a different order
+		compareOutput(serial, parallel, 32, 1.0e-4f);
+	}
+};
+
+static ParallelSynthRenderingTest parallelSynthRenderingTest;
+
+class SamplerSoundIndexTest : public UnitTest
+{
+public:
+
+	SamplerSoundIndexTest() :
+		UnitTest("Testing the sampler sound index against a linear scan")
+	{
+
+	}
+
+	void runTest() override
+	{
+		mc = new TestController();
+
+		testRoundRobinGroups();
+		testKeyRangeEdits();
+		testReplacedSound();
+
+		// The sounds need the MainController when they are deleted
+		sounds.clear();
+		index.clear();
+		mc = nullptr;
+	}
+
+private:
+
+	static const int numGroups = 4;
+
+	ModulatorSamplerSound* createSound(int index, int lowKey, int highKey, int group)
+	{
+		// The file doesn't need to exist, the index only uses the mapping data
+		auto s = new ModulatorSamplerSound(mc, new StreamingSamplerSound("Sample" + String(index), nullptr), index);
+
+		setMapping(s, lowKey, highKey, group);
+
+		return s;
+	}
+
+	static void setMapping(ModulatorSamplerSound* s, int lowKey, int highKey, int group)
+	{
+		s->setMaxRRGroupIndex(numGroups);
+		s->setProperty(ModulatorSamplerSound::KeyLow, lowKey, dontSendNotification);
+		s->setProperty(ModulatorSamplerSound::KeyHigh, highKey, dontSendNotification);
+		s->setProperty(ModulatorSamplerSound::RRGroup, group, dontSendNotification);
+	}
+
+	void addRandomSounds(int numSounds)
+	{
+		for (int i = 0; i < numSounds; i++)
+		{
+			const int lowKey = r.nextInt(120);
+			sounds.add(createSound(sounds.size(), lowKey, lowKey + r.nextInt(8), 1 + r.nextInt(numGroups)));
+		}
+	}
+
+	/** This is what ModulatorSynth::noteOn() did before the index: check every sound in the order of the sound array. */
+	Array<ModulatorSynthSound*> getSoundsWithLinearScan(int noteNumber, int group)
+	{
+		Array<ModulatorSynthSound*> list;
+
+		for (int i = 0; i < sounds.size(); i++)
+		{
+			auto s = static_cast<ModulatorSamplerSound*>(sounds.getUnchecked(i).get());
+
+			if (s->getNoteRange().contains(noteNumber) && (group == -1 || s->getRRGroup() == group))
+				list.add(s);
+		}
+
+		return list;
+	}
+
+	void compareWithLinearScan(const String& context)
+	{
+		for (int group = -1; group <= numGroups; group++)
+		{
+			if (group == 0)
+				continue;
+
+			for (int n = 0; n < 128; n++)
+			{
+				const auto expected = getSoundsWithLinearScan(n, group);
+				const auto actual = index.getSounds(n, group);
+
+				if (*actual != expected)
+				{
+					expect(false, context + ": note " + String(n) + ", group " + String(group) + " has " + String(actual->size()) + " sounds instead of " + String(expected.size()));
+					return;
+				}
+			}
+		}
+	}
+
+	void testRoundRobinGroups()
+	{
+		beginTest("Testing round robin groups");
+
+		sounds.clear();
+		addRandomSounds(200);
+
+		index.rebuild(sounds, 1);
+		expect(index.isValidFor(sounds.size(), 1));
+
+		compareWithLinearScan("Rebuild");
+
+		const int numSoundsBefore = sounds.size();
+		addRandomSounds(20);
+
+		for (int i = numSoundsBefore; i < sounds.size(); i++)
+			index.addSound(static_cast<ModulatorSamplerSound*>(sounds.getUnchecked(i).get()), 2);
+
+		expect(index.isValidFor(sounds.size(), 2));
+
+		compareWithLinearScan("Appended sounds");
+	}
+
+	void testKeyRangeEdits()
+	{
+		beginTest("Testing key range and group edits");
+
+		sounds.clear();
+		addRandomSounds(100);
+		index.rebuild(sounds, 1);
+
+		for (int i = 0; i < 50; i++)
+		{
+			auto s = static_cast<ModulatorSamplerSound*>(sounds[r.nextInt(sounds.size())].get());
+
+			const int lowKey = r.nextInt(100);
+			setMapping(s, lowKey, lowKey + r.nextInt(28), 1 + r.nextInt(numGroups));
+
+			index.updateSound(s);
+		}
+
+		compareWithLinearScan("Edited sounds");
+	}
+
+	void testReplacedSound()
+	{
+		beginTest("Testing that a replaced sound invalidates the index");
+
+		sounds.clear();
+		addRandomSounds(50);
+		index.rebuild(sounds, 1);
+
+		// One sound is removed and another one added, so the amount of sounds doesn't change
+		sounds.remove(10);
+		sounds.add(createSound(50, 60, 72, 1));
+
+		expect(index.isValidFor(sounds.size(), 1), "The amount of sounds alone doesn't detect the change");
+		expect(!index.isValidFor(sounds.size(), 2), "The sampler bumps the generation when the sound array changes");
+
+		index.rebuild(sounds, 2);
+		compareWithLinearScan("Replaced sound");
+
+		index.clear();
+		expect(!index.isValidFor(sounds.size(), 2));
+	}
+
+	ScopedPointer<TestController> mc;
+	Random r;
+	ReferenceCountedArray<SynthesiserSound> sounds;
+	SamplerSoundIndex index;
+};
+
+static SamplerSoundIndexTest samplerSoundIndexTest;
+
+class ControlRateModulationTest : public UnitTest
+{
+public:
+
+	ControlRateModulationTest() :
+		UnitTest("Testing control rate modulation against audio rate modulation")
+	{
+
+	}
+
+	void runTest() override
+	{
+		testControlRate(8);
+		testControlRate(16);
+		testControlRate(32);
+	}
+
+private:
+
+	// Not a multiple of the dividers, so the ramps continue across the blocks
+	static const int blockSize = 500;
+	static const int numBlocks = 40;
+
+	ModulatorChain* createLfoChain(TestController& mc, const String& id, int divider)
+	{
+		auto synth = new SineSynth(&mc, id, NUM_POLYPHONIC_VOICES);
+		mc.chain->getHandler()->add(synth, nullptr);
+
+		auto gainChain = dynamic_cast<ModulatorChain*>(synth->getChildProcessor(ModulatorSynth::GainModulation));
+
+		auto lfo = new LfoModulator(&mc, id + "LFO", Modulation::GainMode);
+		gainChain->getHandler()->add(lfo, nullptr);
+
+		lfo->setAttribute(LfoModulator::TempoSync, 0.0f, dontSendNotification);
+		lfo->setAttribute(LfoModulator::Frequency, 5.0f, dontSendNotification);
+
+		synth->prepareToPlay(44100.0, blockSize);
+		gainChain->setControlRateDivider(divider);
+
+		return gainChain;
+	}
+
+	void testControlRate(int divider)
+	{
+		beginTest("Testing a LFO with a control rate divider of " + String(divider));
+
+		TestController mc;
+
+		auto audioRateChain = createLfoChain(mc, "AudioRate", 1);
+		auto controlRateChain = createLfoChain(mc, "ControlRate", divider);
+
+		expectEquals<int>(controlRateChain->getControlRateDivider(), divider);
+
+		AudioSampleBuffer audioRate(1, blockSize * numBlocks);
+		AudioSampleBuffer controlRate(1, blockSize * numBlocks);
+
+		for (int i = 0; i < numBlocks; i++)
+		{
+			AudioSampleBuffer a(audioRate.getArrayOfWritePointers(), 1, i * blockSize, blockSize);
+			AudioSampleBuffer c(controlRate.getArrayOfWritePointers(), 1, i * blockSize, blockSize);
+
+			audioRateChain->renderNextBlock(a, 0, blockSize);
+			controlRateChain->renderNextBlock(c, 0, blockSize);
+		}
+
+		// The ramp moves from the previous control value to the current one, so it lags divider - 1 samples behind
+		const int latency = divider - 1;
+
+		float maxErrorWithLatency = 0.0f;
+		float maxErrorWithoutLatency = 0.0f;
+
+		for (int i = divider; i < audioRate.getNumSamples(); i++)
+		{
+			const float value = controlRate.getSample(0, i);
+
+			maxErrorWithLatency = jmax(maxErrorWithLatency, std::abs(value - audioRate.getSample(0, i - latency)));
+			maxErrorWithoutLatency = jmax(maxErrorWithoutLatency, std::abs(value - audioRate.getSample(0, i)));
+		}
+
+		logMessage("Max error: " + String(maxErrorWithLatency, 6) + " (with latency compensation), " + String(maxErrorWithoutLatency, 6) + " (without)");
+
+		// A 5Hz sine is almost linear between two control values
+		expect(maxErrorWithLatency < 0.001f, "Control rate signal deviates by " + String(maxErrorWithLatency));
+		expect(maxErrorWithoutLatency > maxErrorWithLatency, "The latency of the ramp wasn't detected");
+
+		expect(controlRateChain->getSkippedValueRatio() > 0.8f, "Skipped value ratio: " + String(controlRateChain->getSkippedValueRatio()));
+		expectEquals<float>(audioRateChain->getSkippedValueRatio(), 0.0f);
+	}
+};
+
+static ControlRateModulationTest controlRateModulationTest;
+
+class SamplePreloaderTest : public UnitTest
+{
+public:
+
+	SamplePreloaderTest() :
+		UnitTest("Testing the multithreaded sample preloader")
+	{
+
+	}
+
+	void runTest() override
+	{
+		testAllSoundsAreLoaded();
+		testErrorIsReported();
+		testNumThreads();
+	}
+
+private:
+
+	static const int numSounds = 64;
+
+	void createSounds()
+	{
+		sounds.clear();
+
+		// The files don't exist, so every sound gets its own lane
+		for (int i = 0; i < numSounds; i++)
+			sounds.add(new StreamingSamplerSound("Sample" + String(i), nullptr));
+	}
+
+	void testAllSoundsAreLoaded()
+	{
+		beginTest("Testing that every sound is loaded once");
+
+		createSounds();
+
+		double progress = 0.0;
+		SamplePreloader preloader(nullptr, progress);
+
+		for (auto s : sounds)
+			preloader.addSound(s, 0);
+
+		expectEquals<int>(preloader.getNumSounds(), numSounds);
+
+		std::atomic<int> counters[numSounds];
+
+		for (auto& c : counters)
+			c.store(0);
+
+		CriticalSection threadLock;
+		Array<void*> threadIds;
+
+		auto f = [&](StreamingSamplerSound* s, String&)
+		{
+			counters[sounds.indexOf(s)]++;
+
+			ScopedLock sl(threadLock);
+			threadIds.addIfNotAlreadyThere(Thread::getCurrentThreadId());
+
+			return true;
+		};
+
+		expect(preloader.run(f), "Preloading failed");
+		expect(preloader.getErrorMessage().isEmpty());
+		expectEquals<double>(progress, 1.0);
+
+		for (int i = 0; i < numSounds; i++)
+			expectEquals<int>(counters[i].load(), 1, "Sound " + String(i));
+
+		logMessage(String(threadIds.size()) + " thread(s) were used");
+
+		expect(threadIds.size() <= SamplePreloader::getNumThreadsToUse(numSounds));
+	}
+
+	void testErrorIsReported()
+	{
+		beginTest("Testing that the first error is reported to the calling thread");
+
+		createSounds();
+
+		double progress = 0.0;
+		SamplePreloader preloader(nullptr, progress);
+
+		for (auto s : sounds)
+			preloader.addSound(s, 0);
+
+		auto failingSound = sounds[numSounds / 2];
+
+		auto f = [failingSound](StreamingSamplerSound* s, String& errorMessage)
+		{
+			if (s != failingSound)
+				return true;
+
+			errorMessage = "Error loading " + s->getFileName();
+			return false;
+		};
+
+		expect(!preloader.run(f), "The error wasn't detected");
+		expectEquals(preloader.getErrorMessage(), "Error loading " + failingSound->getFileName());
+		expect(progress < 1.0, "The progress is complete");
+	}
+
+	void testNumThreads()
+	{
+		beginTest("Testing the number of threads");
+
+		// A single monolith with a single mic position ends up in one lane, so it's loaded by one thread
+		expectEquals<int>(SamplePreloader::getNumThreadsToUse(1), 1);
+		expect(SamplePreloader::getNumThreadsToUse(numSounds) >= 1);
+		expect(SamplePreloader::getNumThreadsToUse(numSounds) <= jmax<int>(4, NUM_PRELOAD_THREADS));
+	}
+
+	ReferenceCountedArray<StreamingSamplerSound> sounds;
+};
+
+static SamplePreloaderTest samplePreloaderTest;
+
+class UserPresetFadeTest : public UnitTest
+{
+public:
+
+	UserPresetFadeTest() : UnitTest("Testing the user preset fade out and in") {}
+
+	typedef MainController::UserPresetHandler UserPresetHandler;
+
+	void runTest() override
+	{
+		beginTest("Running through the swap states");
+
+		TestController mc;
+		mc.chain->prepareToPlay(44100.0, blockSize);
+
+		auto& handler = mc.getUserPresetHandler();
+		handler.setLoadingMode(UserPresetHandler::LoadingMode::FadeOutIn, fadeTimeMs);
+
+		expect(handler.getSwapState() == UserPresetHandler::Idle, "Not idle");
+		expectEquals(processBlock(handler), 1.0f, "Idle output");
+
+		handler.loadUserPreset(ValueTree("Preset"));
+		expect(waitForState(handler, UserPresetHandler::FadingOut), "Preset wasn't prepared");
+
+		float gain = processBlock(handler);
+		expect(gain < 1.0f, "Not fading out");
+
+		// The second request is prepared while the first one fades out and restored in the same swap
+		handler.loadUserPreset(ValueTree("Preset2"));
+		Thread::sleep(100);
+
+		expect(handler.getSwapState() == UserPresetHandler::FadingOut, "A request restarted the fade out");
+
+		fadeOut(handler, gain);
+
+		// The restore might already be finished
+		if (handler.getSwapState() == UserPresetHandler::Restoring)
+			expectEquals(processBlock(handler), 0.0f, "Output while restoring");
+
+		expect(waitForState(handler, UserPresetHandler::FadingIn), "Preset wasn't restored");
+		expectEquals(handler.getLastSwapReport().numSwaps, 1, "Number of swaps with a request during the fade out");
+
+		const auto report = handler.getLastSwapReport();
+		expect(report.mutedMs > 0.0 && report.mutedMs >= report.restoreMs, "The muted gap isn't reported");
+
+		beginTest("Requesting a preset while fading in");
+
+		for (int i = 0; i < 3; i++)
+			gain = processBlock(handler);
+
+		expect(gain > 0.0f && gain < 1.0f, "Not fading in");
+
+		handler.loadUserPreset(ValueTree("Preset3"));
+		expect(waitForState(handler, UserPresetHandler::FadingOut), "The request didn't fade out again");
+
+		// The fade out starts at the current gain instead of jumping back to full volume
+		const float nextGain = processBlock(handler);
+		expect(nextGain < gain, "Fade out doesn't continue from the fade in");
+
+		gain = nextGain;
+		fadeOut(handler, gain);
+
+		expect(waitForState(handler, UserPresetHandler::FadingIn), "Preset wasn't restored");
+		expectEquals(handler.getLastSwapReport().numSwaps, 2, "Number of swaps");
+
+		for (int i = 0; i < numBlocksToWait && handler.getSwapState() == UserPresetHandler::FadingIn; i++)
+		{
+			const float thisGain = processBlock(handler);
+			expect(thisGain > gain, "Fade in isn't rising");
+			gain = thisGain;
+		}
+
+		expect(handler.getSwapState() == UserPresetHandler::Idle, "Not idle after the fade in");
+		expectEquals(processBlock(handler), 1.0f, "Output after the swap");
+	}
+
+private:
+
+	static const int blockSize = 64;
+	static const int numBlocksToWait = 100;
+
+	static constexpr double fadeTimeMs = 10.0;
+
+	/** Processes a block of ones and returns the gain at the end of the block. */
+	float processBlock(UserPresetHandler& handler)
+	{
+		AudioSampleBuffer buffer(1, blockSize);
+
+		for (int i = 0; i < blockSize; i++)
+			buffer.setSample(0, i, 1.0f);
+
+		handler.processSwapFade(buffer, blockSize);
+
+		return buffer.getSample(0, blockSize - 1);
+	}
+
+	/** Processes blocks until the output is silent and checks that the gain is falling. */
+	void fadeOut(UserPresetHandler& handler, float gain)
+	{
+		for (int i = 0; i < numBlocksToWait && handler.getSwapState() == UserPresetHandler::FadingOut; i++)
+		{
+			const float thisGain = processBlock(handler);
+			expect(thisGain < gain || thisGain == 0.0f, "Fade out isn't falling");
+			gain = thisGain;
+		}
+
+		expect(handler.getSwapState() != UserPresetHandler::FadingOut, "The fade out didn't finish");
+	}
+
+	/** Waits for the sample loading thread to change the state. */
+	bool waitForState(const UserPresetHandler& handler, UserPresetHandler::SwapState state)
+	{
+		for (int i = 0; i < 2000; i++)
+		{
+			if (handler.getSwapState() == state)
+				return true;
+
+			Thread::sleep(1);
+		}
+
+		return false;
+	}
+};
+
+static UserPresetFadeTest userPresetFadeTest;
+
+class DebugLoggerTraceTest : public UnitTest
+{
+public:
+
+	DebugLoggerTraceTest() : UnitTest("Testing the debug logger trace") {}
+
+	typedef DebugLogger::TraceBuffer TraceBuffer;
+	typedef DebugLogger::TraceRecord TraceRecord;
+
+	void runTest() override
+	{
+		testTraceBuffer();
+		testBufferOwners();
+		testTraceFile();
+	}
+
+private:
+
+	/** Writes a single streaming failure from its own thread. */
+	class FailureThread : public Thread
+	{
+	public:
+
+		FailureThread(DebugLogger& logger_, double value_) :
+			Thread("Trace Test"),
+			logger(logger_),
+			value(value_)
+		{}
+
+		void run() override
+		{
+			logger.addStreamingFailure(value);
+		}
+
+		DebugLogger& logger;
+		const double value;
+	};
+
+	void testTraceBuffer()
+	{
+		beginTest("Pushing and popping trace records");
+
+		TraceBuffer b;
+		b.allocate();
+
+		TraceRecord r;
+		zerostruct(r);
+
+		// Run through the buffer twice so the indexes wrap around
+		for (int run = 0; run < 2; run++)
+		{
+			for (int i = 0; i < TraceBuffer::NumRecords; i++)
+			{
+				r.intValue = i;
+				expect(b.push(r), "Push failed at " + String(i));
+			}
+
+			expect(!b.push(r), "Push into a full buffer");
+
+			for (int i = 0; i < TraceBuffer::NumRecords; i++)
+			{
+				expect(b.pop(r), "Pop failed at " + String(i));
+				expectEquals<int>(r.intValue, i, "Record order");
+			}
+
+			expect(!b.pop(r), "Pop from an empty buffer");
+		}
+	}
+
+	void testBufferOwners()
+	{
+		beginTest("Claiming and releasing trace buffers");
+
+		TraceBuffer b;
+		b.allocate();
+
+		TraceRecord r;
+		zerostruct(r);
+
+		void* firstThread = (void*)1;
+		void* secondThread = (void*)2;
+
+		expect(b.claim(firstThread), "Claiming a free buffer");
+		expect(!b.claim(secondThread), "Claiming an owned buffer");
+		expect(!b.beginWrite(secondThread), "Writing into a foreign buffer");
+
+		expect(b.beginWrite(firstThread), "Writing into the own buffer");
+		b.push(r);
+		b.endWrite();
+
+		expect(!b.releaseIfIdle(), "Released a buffer with a new record");
+
+		b.pop(r);
+
+		expect(b.releaseIfIdle(), "The idle buffer wasn't released");
+		expect(!b.beginWrite(firstThread), "Writing into a released buffer");
+		expect(b.claim(secondThread), "Claiming a released buffer");
+	}
+
+	void testTraceFile()
+	{
+		beginTest("Writing a trace file and converting it to the Chrome format");
+
+		TestController mc;
+		auto& logger = mc.getDebugLogger();
+
+		logger.startLogging();
+
+		const File logFile = logger.getCurrentLogFile();
+		const File traceFile = logger.getCurrentTraceFile();
+		const File jsonFile = traceFile.withFileExtension("json");
+
+		logger.checkAssertion(mc.chain, DebugLogger::Location::MainRenderCallback, false, 2.0);
+
+		HiseEventBuffer events;
+		events.addEvent(HiseEvent(HiseEvent::Type::NoteOn, 64, 100, 1));
+		logger.logEvents(events);
+
+		// More threads than trace buffers, so the buffers of finished threads must be released
+		const int numThreads = 2 * NUM_TRACE_THREADS;
+
+		for (int i = 0; i < numThreads; i++)
+		{
+			FailureThread t(logger, (double)i);
+			t.startThread();
+			t.waitForThreadToExit(1000);
+
+			// The first drain notes that the thread stopped writing, the second one releases its buffer
+			logger.timerCallback();
+			logger.timerCallback();
+		}
+
+		logger.stopLogging();
+
+		expect(traceFile.existsAsFile(), "No trace file");
+		expect(jsonFile.existsAsFile(), "No JSON file");
+		expect(!logFile.loadFileAsString().contains("trace records were dropped"), "Dropped trace records");
+
+		var json = JSON::parse(jsonFile);
+		var traceEvents = json.getProperty("traceEvents", var());
+
+		expect(traceEvents.isArray(), "No trace events");
+
+		int numStreamingFailures = 0;
+		int numAssertions = 0;
+		int numNoteOns = 0;
+
+		if (auto ar = traceEvents.getArray())
+		{
+			for (const auto& e : *ar)
+			{
+				const String name = e.getProperty("name", var()).toString();
+
+				if (name == DebugLogger::getNameForFailure(DebugLogger::FailureType::StreamingFailure))
+					numStreamingFailures++;
+				else if (name == DebugLogger::getNameForFailure(DebugLogger::FailureType::Assertion))
+				{
+					numAssertions++;
+					expectEquals(e.getProperty("args", var()).getProperty("processor", var()).toString(), mc.chain->getId(), "Processor name");
+				}
+				else if (name == "NoteOn")
+					numNoteOns++;
+			}
+		}
+
+		expectEquals(numStreamingFailures, numThreads, "Streaming failures");
+		expectEquals(numAssertions, 1, "Assertions");
+		expectEquals(numNoteOns, 1, "Events");
+
+		beginTest("Rejecting broken trace files");
+
+		const File brokenFile = traceFile.getSiblingFile("Broken.hisetrace");
+		const File brokenJsonFile = brokenFile.withFileExtension("json");
+
+		MemoryBlock mb;
+		traceFile.loadFileAsData(mb);
+
+		brokenFile.replaceWithData(mb.getData(), mb.getSize() - 10);
+		expect(DebugLogger::convertTraceToChromeFormat(brokenFile, brokenJsonFile).failed(), "Truncated file was converted");
+
+		brokenFile.replaceWithText("Not a trace file");
+		expect(DebugLogger::convertTraceToChromeFormat(brokenFile, brokenJsonFile).failed(), "Text file was converted");
+
+		for (auto f : { logFile, traceFile, jsonFile, brokenFile, brokenJsonFile })
+			f.deleteFile();
+	}
+};
+
+static DebugLoggerTraceTest debugLoggerTraceTest;
+
+class ScriptByteCodeTest : public UnitTest
+{
+public:
+
+	ScriptByteCodeTest() :
+		UnitTest("Testing script bytecode execution", "Benchmark")
+	{
+
+	}
+
+	void runTest() override
+	{
+		beginTest("Comparing bytecode and tree execution: loops and numbers");
+		compareExecutionModes(getLoopScript(), 200);
+
+		beginTest("Comparing bytecode and tree execution: strings, objects and API calls");
+		compareExecutionModes(getMixedScript(), 200);
+
+		beginTest("Benchmarking bytecode execution");
+		benchmark(getLoopScript(), 2000);
+		benchmark(getMixedScript(), 2000);
+	}
+
+private:
+
+	/** These scripts only use the engine (the example scripts need a sampler or an interface). */
+
+	static String getLoopScript()
+	{
+		return "reg i = 0;\n"
+			"reg sum = 0;\n"
+			"reg fsum = 0.0;\n"
+			"reg count = 0;\n"
+			"\n"
+			"function onControl(number, value)\n"
+			"{\n"
+			"	local x = value * 0.5;\n"
+			"	local j = 0;\n"
+			"	sum = 0;\n"
+			"	for (i = 0; i < 200; i++)\n"
+			"	{\n"
+			"		if (i % 3 == 0) continue;\n"
+			"		if (i > 180 + number) break;\n"
+			"		sum += i * 2 - 1;\n"
+			"		fsum = fsum + x * i / 7;\n"
+			"		count = (i >= 100 && i <= 150) || i == 3 ? count + 1 : count - 1;\n"
+			"	}\n"
+			"	do { j++; if (j == 4) continue; j += 1; } while (j < 10);\n"
+			"	while (j > -5) { j -= 3; if (j == 1) break; }\n"
+			"	return [sum + j + -x + (!number) + (number != 2) + (x <= 1.0) + (x >= 3), fsum, count];\n"
+			"}\n";
+	}
+
+	static String getMixedScript()
+	{
+		return "reg i = 0;\n"
+			"reg text = \"\";\n"
+			"reg lastValue;\n"
+			"const var data = [1, 2, 3, 4];\n"
+			"var obj = { \"a\": 1, \"b\": 2.5 };\n"
+			"\n"
+			"function onControl(number, value)\n"
+			"{\n"
+			"	local v = Math.round(value * 2.3) + Math.max(number, 2);\n"
+			"	text = \"n\" + number + \":\" + (v / 0) + (number & 3) + (1 << number) + (lastValue == undefined);\n"
+			"	lastValue = number > 1 ? v : -v;\n"
+			"	for (x in data) lastValue += x;\n"
+			"	for (i = 0; i < data.length; i++) data[i] = data[i] + v % 5;\n"
+			"	obj.a += data[2];\n"
+			"	obj.c = text < \"n2\";\n"
+			"	switch (number) { case 1: lastValue += 100; break; default: lastValue -= 1; }\n"
+			"	return [text, lastValue, obj.a, obj.c, data[0] > 20 ? \"big\" : \"small\"];\n"
+			"}\n";
+	}
+
+	struct TestEngine
+	{
+		TestEngine(const String& code, bool useByteCode) :
+			engine(nullptr)
+		{
+			engine.registerGlobalStorge(new DynamicObject());
+			engine.setUseByteCode(useByteCode);
+			engine.registerCallbackName("onControl", 2, 0.0);
+			compileResult = engine.execute(code);
+		}
+
+		String call(int number, var value)
+		{
+			engine.setCallbackParameter(callbackIndex, 0, number);
+			engine.setCallbackParameter(callbackIndex, 1, value);
+
+			Result r = Result::ok();
+			var returnValue = engine.executeCallback(callbackIndex, &r);
+
+			return r.wasOk() ? JSON::toString(returnValue, true) : r.getErrorMessage();
+		}
+
+		HiseJavascriptEngine engine;
+		const int callbackIndex = 0;
+		Result compileResult = Result::ok();
+	};
+
+	void compareExecutionModes(const String& code, int numCalls)
+	{
+		TestEngine treeEngine(code, false);
+		TestEngine byteCodeEngine(code, true);
+
+		expect(treeEngine.compileResult.wasOk(), treeEngine.compileResult.getErrorMessage());
+		expect(byteCodeEngine.compileResult.wasOk(), byteCodeEngine.compileResult.getErrorMessage());
+
+		for (int i = 0; i < numCalls; i++)
+		{
+			const int number = i % 5;
+			const var value = (i % 2 == 0) ? var(i) : var((double)i * 0.25);
+
+			const String expected = treeEngine.call(number, value);
+			const String actual = byteCodeEngine.call(number, value);
+
+			if (expected != actual)
+			{
+				expectEquals(actual, expected, "Mismatch at call " + String(i));
+				return;
+			}
+		}
+	}
+
+	void benchmark(const String& code, int numCalls)
+	{
+		double times[2];
+
+		for (int useByteCode = 0; useByteCode < 2; useByteCode++)
+		{
+			TestEngine e(code, useByteCode == 1);
+
+			const double start = Time::getMillisecondCounterHiRes();
+
+			for (int i = 0; i < numCalls; i++)
+				e.call(i % 5, (double)i * 0.25);
+
+			times[useByteCode] = Time::getMillisecondCounterHiRes() - start;
+		}
+
+		logMessage("Tree: " + String(times[0], 2) + " ms, Bytecode: " + String(times[1], 2) + " ms for " + String(numCalls) + " calls, speedup: " + String(times[0] / times[1], 2) + "x");
+	}
+};
+
+static ScriptByteCodeTest scriptByteCodeTest;
+
+class ModulationShapeTest : public UnitTest
+{
+public:
+
+	ModulationShapeTest() :
+		UnitTest("Testing modulation shapes")
+	{
+
+	}
+
+	void runTest() override
+	{
+		beginTest("Testing the combination of modulation shapes");
+
+		const auto c = ModulationShape::constant(0.5f);
+		const auto r = ModulationShape::ramp(0.2f, 0.8f);
+
+		expect(c.isConstant(), "Constant");
+		expect(ModulationShape::constant(1.0f).isUnity(), "Unity");
+		expect(ModulationShape::ramp(0.3f, 0.3f).isConstant(), "Flat ramp is constant");
+		expect((c * c).isConstant() && (c * c).getConstantValue() == 0.25f, "Constant * Constant");
+		expect((c * r).isRamp() && (c * r).firstValue == 0.1f && (c * r).lastValue == 0.4f, "Constant * Ramp");
+		expect((r * r).isDynamic(), "Ramp * Ramp");
+		expect((ModulationShape() * c).isDynamic(), "Dynamic * Constant");
+
+		beginTest("Testing the application of modulation shapes");
+
+		const int numSamples = 64;
+
+		HeapBlock<float> values(numSamples);
+		HeapBlock<float> expected(numSamples);
+		HeapBlock<float> data(numSamples);
+
+		for (int i = 0; i < numSamples; i++)
+			values[i] = 0.2f + 0.6f * (float)i / (float)(numSamples - 1);
+
+		testApply(r, values, data, expected, numSamples);
+		testApply(c, values, data, expected, numSamples);
+		testApply(ModulationShape(), values, data, expected, numSamples);
+	}
+
+private:
+
+	void testApply(const ModulationShape& s, const float* values, float* data, float* expected, int numSamples)
+	{
+		for (int i = 0; i < numSamples; i++)
+		{
+			data[i] = 1.0f - (float)i / (float)numSamples;
+
+			const float modValue = s.isConstant() ? s.getConstantValue() : values[i];
+			expected[i] = data[i] * modValue;
+		}
+
+		s.applyTo(data, values, numSamples);
+
+		for (int i = 0; i < numSamples; i++)
+			expectWithinAbsoluteError(data[i], expected[i], 0.0001f);
+	}
+};
+
+static ModulationShapeTest modulationShapeTest;
+
+class FilterLanesTest : public UnitTest
+{
+public:
+
+	FilterLanesTest() : UnitTest("Testing vectorized filters", "Benchmark") {}
+
+	void runTest() override
+	{
+		testFilter<SimpleOnePole, ReferenceOnePole>("One pole", SimpleOnePole::numTypes);
+		testFilter<MoogFilter, ReferenceMoog>("Moog", 1);
+		testFilter<Ladder, ReferenceLadder>("Ladder", Ladder::numTypes);
+		testFilter<StateVariableFilter, ReferenceStateVariable>("State variable", StateVariableFilter::numTypes);
+		testFilter<StaticBiquad, ReferenceBiquad>("Biquad", StaticBiquad::numFilterTypes);
+
+		benchmarkFilter<SimpleOnePole, ReferenceOnePole, FloatLanes>("One pole");
+		benchmarkFilter<MoogFilter, ReferenceMoog, DoubleLanes>("Moog");
+		benchmarkFilter<Ladder, ReferenceLadder, FloatLanes>("Ladder");
+		benchmarkFilter<StateVariableFilter, ReferenceStateVariable, FloatLanes>("State variable");
+		benchmarkFilter<StaticBiquad, ReferenceBiquad, FloatLanes>("Biquad");
+	}
+
+private:
+
+	// The scalar implementations before the filters were vectorized
+
+	class ReferenceMoog : public MultiChannelFilter
+	{
+	public:
+
+		ReferenceMoog()
+		{
+			reset();
+			setFreqAndQ(20000.0, 1.0);
+		}
+
+		void reset() override { memset(data, 0, sizeof(double) * NUM_MAX_CHANNELS * 8); }
+
+		void updateCoefficients() override
+		{
+			auto lFrequency = jlimit<double>(20.0, 20000.0, frequency);
+
+			const double fc = lFrequency / (0.5 * sampleRate);
+			const double res = jmin<double>(4.0, q / 2.0);
+			const double f = fc * 1.16;
+
+			fss = (f * f) * (f * f);
+			invF = 1.0 - f;
+			fb = res * (1.0 - 0.15 * f * f);
+		}
+
+		void processSamples(AudioSampleBuffer& buffer, int startSample, int numSamples) override
+		{
+			setNumChannels(buffer.getNumChannels());
+
+			double* in1 = data;
+			double* in2 = in1 + NUM_MAX_CHANNELS;
+			double* in3 = in2 + NUM_MAX_CHANNELS;
+			double* in4 = in3 + NUM_MAX_CHANNELS;
+			double* out1 = in4 + NUM_MAX_CHANNELS;
+			double* out2 = out1 + NUM_MAX_CHANNELS;
+			double* out3 = out2 + NUM_MAX_CHANNELS;
+			double* out4 = out3 + NUM_MAX_CHANNELS;
+
+			for (int c = 0; c < numChannels; c++)
+			{
+				float* d = buffer.getWritePointer(c, startSample);
+
+				for (int i = 0; i < numSamples; i++)
+				{
+					double input = (double)d[i];
+
+					input -= out4[c] * fb;
+					input *= 0.35013 * fss;
+					out1[c] = input + 0.3 * in1[c] + invF * out1[c];
+					in1[c] = input;
+					out2[c] = out1[c] + 0.3 * in2[c] + invF * out2[c];
+					in2[c] = out1[c];
+					out3[c] = out2[c] + 0.3 * in3[c] + invF * out3[c];
+					in3[c] = out2[c];
+					out4[c] = out3[c] + 0.3 * in4[c] + invF * out4[c];
+					in4[c] = out3[c];
+					d[i] = 2.0f * (float)out4[c];
+				}
+			}
+		}
+
+	private:
+
+		double data[NUM_MAX_CHANNELS * 8];
+		double fss, invF, fb;
+	};
+
+	class ReferenceOnePole : public MultiChannelFilter
+	{
+	public:
+
+		ReferenceOnePole() { reset(); }
+
+		void reset() override { memset(lastValues, 0, sizeof(float) * NUM_MAX_CHANNELS); }
+
+		void updateCoefficients() override
+		{
+			const double x = exp(-2.0*double_Pi*frequency / sampleRate);
+
+			a0 = (float)(1.0 - x);
+			b1 = (float)-x;
+		}
+
+		void processSamples(AudioSampleBuffer& buffer, int startSample, int numSamples) override
+		{
+			setNumChannels(buffer.getNumChannels());
+
+			for (int c = 0; c < numChannels; c++)
+			{
+				float *d = buffer.getWritePointer(c, startSample);
+
+				for (int i = 0; i < numSamples; i++)
+				{
+					if (type == SimpleOnePole::HP)
+					{
+						const float tmp = a0*d[i] - b1*lastValues[c];
+						lastValues[c] = tmp;
+						d[i] = d[i] - tmp;
+					}
+					else
+					{
+						d[i] = a0*d[i] - b1*lastValues[c];
+						lastValues[c] = d[i];
+					}
+				}
+			}
+		}
+
+	private:
+
+		float lastValues[NUM_MAX_CHANNELS];
+		float a0, b1;
+	};
+
+	class ReferenceLadder : public MultiChannelFilter
+	{
+	public:
+
+		ReferenceLadder() { reset(); }
+
+		void reset() override { memset(buf, 0, sizeof(float) * NUM_MAX_CHANNELS * 4); }
+
+		void updateCoefficients() override
+		{
+			float inFreq = jlimit<float>(20.0f, 20000.0f, (float)frequency);
+
+			const float x = 2.0f * float_Pi*inFreq / (float)sampleRate;
+
+			cut = jlimit<float>(0.0f, 0.8f, x);
+			res = jlimit<float>(0.3f, 4.0f, (float)q / 2.0f);
+		}
+
+		void processSamples(AudioSampleBuffer& b, int startSample, int numSamples) override
+		{
+			for (int c = 0; c < b.getNumChannels(); c++)
+			{
+				float* d = b.getWritePointer(c, startSample);
+
+				for (int i = 0; i < numSamples; i++)
+				{
+					float* buffer = buf[c];
+
+					const float in = d[i] - (buffer[3] * res);
+					buffer[0] = ((in - buffer[0]) * cut) + buffer[0];
+					buffer[1] = ((buffer[0] - buffer[1]) * cut) + buffer[1];
+					buffer[2] = ((buffer[1] - buffer[2]) * cut) + buffer[2];
+					buffer[3] = ((buffer[2] - buffer[3]) * cut) + buffer[3];
+					d[i] = 2.0f * buffer[3];
+				}
+			}
+		}
+
+	private:
+
+		float buf[NUM_MAX_CHANNELS][4];
+		float cut, res;
+	};
+
+	class ReferenceStateVariable : public MultiChannelFilter
+	{
+	public:
+
+		ReferenceStateVariable() { reset(); }
+
+		void reset() override
+		{
+			memset(v0z, 0, sizeof(float) * NUM_MAX_CHANNELS);
+			memset(z1_A, 0, sizeof(float) * NUM_MAX_CHANNELS);
+			memset(v2, 0, sizeof(float) * NUM_MAX_CHANNELS);
+		}
+
+		void updateCoefficients() override
+		{
+			const float scaledQ = jlimit<float>(0.0f, 9.999f, (float)q * 0.1f);
+
+			if (type == StateVariableFilter::ALLPASS)
+			{
+				float wd = static_cast<float>(frequency * 2.0f * float_Pi);
+				float T = 1.0f / (float)sampleRate;
+				float wa = (2.0f / T) * tan(wd * T / 2.0f);
+
+				gCoeff = wa * T / 2.0f;
+				RCoeff = 1.0f / (2.0f * (float)q);
+
+				x1 = (2.0f * RCoeff + gCoeff);
+				x2 = 1.0f / (1.0f + (2.0f * RCoeff * gCoeff) + gCoeff * gCoeff);
+			}
+			else
+			{
+				float g = (float)tan(double_Pi * frequency / sampleRate);
+				k = 1.0f - 0.99f * scaledQ;
+				float ginv = g / (1.0f + g * (g + k));
+				g1 = ginv;
+				g2 = 2.0f * (g + k) * ginv;
+				g3 = g * ginv;
+				g4 = 2.0f * ginv;
+			}
+		}
+
+		void processSamples(AudioSampleBuffer& buffer, int startSample, int numSamples) override
+		{
+			setNumChannels(buffer.getNumChannels());
+
+			for (int c = 0; c < numChannels; c++)
+			{
+				float* d = buffer.getWritePointer(c, startSample);
+
+				for (int i = 0; i < numSamples; i++)
+				{
+					if (type == StateVariableFilter::ALLPASS)
+					{
+						const float input = d[i];
+						const float HP = (input - x1 * z1_A[c] - v2[c]) / x2;
+						const float BP = HP * gCoeff + z1_A[c];
+						const float LP = BP * gCoeff + v2[c];
+
+						z1_A[c] = gCoeff * HP + BP;
+						v2[c] = gCoeff * BP + LP;
+
+						d[i] = input - (4.0f * RCoeff * BP);
+						continue;
+					}
+
+					float v0 = d[i];
+					float v1z = z1_A[c];
+					float v2z = v2[c];
+					float v3 = v0 + v0z[c] - 2.0f * v2z;
+					z1_A[c] += g1 * v3 - g2 * v1z;
+					v2[c] += g3 * v3 + g4 * v1z;
+					v0z[c] = v0;
+
+					switch (type)
+					{
+					case StateVariableFilter::LP:		d[i] = v2[c]; break;
+					case StateVariableFilter::BP:		d[i] = z1_A[c]; break;
+					case StateVariableFilter::HP:		d[i] = v0 - k * z1_A[c] - v2[c]; break;
+					case StateVariableFilter::NOTCH:	d[i] = v0 - k * z1_A[c]; break;
+					}
+				}
+			}
+		}
+
+	private:
+
+		float v0z[NUM_MAX_CHANNELS];
+		float z1_A[NUM_MAX_CHANNELS];
+		float v2[NUM_MAX_CHANNELS];
+
+		float k = 0.0f, g1 = 0.0f, g2 = 0.0f, g3 = 0.0f, g4 = 0.0f, x1 = 0.0f, x2 = 1.0f, gCoeff = 0.0f, RCoeff = 0.0f;
+	};
+
+	/** Uses a juce::IIRFilter per channel with the coefficients of a StaticBiquad. */
+	class ReferenceBiquad : public MultiChannelFilter
+	{
+	public:
+
+		void reset() override
+		{
+			for (auto& f : filters)
+				f.reset();
+		}
+
+		void updateCoefficients() override
+		{
+			coefficientSource.setSampleRate(sampleRate);
+			coefficientSource.setType(type);
+			coefficientSource.setFreqAndQ(frequency, q);
+			coefficientSource.setGain(gain);
+
+			for (auto& f : filters)
+				f.setCoefficients(coefficientSource.currentCoefficients);
+		}
+
+		void processSamples(AudioSampleBuffer& b, int startSample, int numSamples) override
+		{
+			setNumChannels(b.getNumChannels());
+
+			for (int i = 0; i < numChannels; i++)
+				filters[i].processSamples(b.getWritePointer(i, startSample), numSamples);
+		}
+
+	private:
+
+		StaticBiquad coefficientSource;
+		IIRFilter filters[NUM_MAX_CHANNELS];
+	};
+
+	template <class FilterType, class ReferenceType> void testFilter(const String& name, int numTypes)
+	{
+		const int numChannelsToTest[4] = { 1, 2, 3, 6 };
+
+		for (int type = 0; type < numTypes; type++)
+		{
+			for (int i = 0; i < 4; i++)
+			{
+				const int numChannels = numChannelsToTest[i];
+
+				beginTest(name + " filter, type " + String(type) + ", " + String(numChannels) + " channels");
+
+				FilterType vectorized;
+				FilterType scalar;
+				ReferenceType reference;
+
+				initFilter(vectorized, type);
+				initFilter(scalar, type);
+				initFilter(reference, type);
+
+				Random r(type * 100 + numChannels);
+
+				AudioSampleBuffer b1(numChannels, 1000);
+
+				fillWithNoise(b1, r);
+
+				AudioSampleBuffer b2(b1);
+				AudioSampleBuffer b3(b1);
+
+				// Use odd block sizes to check the state between the blocks
+				int offset = 0;
+
+				while (offset < b1.getNumSamples())
+				{
+					const int numThisTime = jmin<int>(1 + r.nextInt(200), b1.getNumSamples() - offset);
+
+					vectorized.processSamples(b1, offset, numThisTime);
+					scalar.processSamplesScalar(b2, offset, numThisTime);
+					reference.processSamples(b3, offset, numThisTime);
+
+					offset += numThisTime;
+				}
+
+				const float vectorizedError = getMaxError(b1, b3);
+				const float scalarError = getMaxError(b2, b3);
+
+				expect(vectorizedError < 0.00001f, "Deviation of the vectorized version: " + String(vectorizedError));
+				expect(scalarError < 0.00001f, "Deviation of the scalar version: " + String(scalarError));
+			}
+		}
+	}
+
+	/** Compares the vectorized filter against the reference and shows how much of it is spent with interleaving the channels. */
+	template <class FilterType, class ReferenceType, class LaneType> void benchmarkFilter(const String& name)
+	{
+		beginTest("Benchmarking the " + name + " filter");
+
+		const int numBlocks = 2000;
+		const int blockSize = 512;
+
+		for (int numChannels = 1; numChannels <= 4; numChannels *= 2)
+		{
+			FilterType vectorized;
+			ReferenceType reference;
+
+			initFilter(vectorized, 0);
+			initFilter(reference, 0);
+
+			Random r(numChannels);
+			AudioSampleBuffer noise(numChannels, blockSize);
+			AudioSampleBuffer b(numChannels, blockSize);
+
+			fillWithNoise(noise, r);
+
+			hise::ScopedNoDenormals snd;
+
+			// Every block starts with the same noise, so the filters don't decay to silence
+			auto measure = [&](const std::function<void()>& f)
+			{
+				const double start = Time::getMillisecondCounterHiRes();
+
+				for (int i = 0; i < numBlocks; i++)
+				{
+					for (int c = 0; c < numChannels; c++)
+						b.copyFrom(c, 0, noise, c, 0, blockSize);
+
+					f();
+				}
+
+				return Time::getMillisecondCounterHiRes() - start;
+			};
+
+			const double referenceTime = measure([&]() { reference.processSamples(b, 0, blockSize); });
+			const double vectorizedTime = measure([&]() { vectorized.processSamples(b, 0, blockSize); });
+
+			String s;
+
+			s << name << ", " << String(numChannels) << " channel(s): ";
+			s << "reference: " << String(referenceTime, 2) << " ms, ";
+			s << "lanes: " << String(vectorizedTime, 2) << " ms (speedup: " << String(referenceTime / vectorizedTime, 2) << "x), ";
+
+			// A single channel uses the scalar version
+			if (numChannels > 1)
+			{
+				const double interleaveTime = measure([&]() { processChannelsInLanes<LaneType>(b, numChannels, 0, blockSize, [](int, typename LaneType::Scalar*, int) {}); });
+
+				// The last lane group processes silence in the lanes without a channel
+				const int numLanesUsed = ((numChannels + LaneType::NumLanes - 1) / LaneType::NumLanes) * LaneType::NumLanes;
+
+				s << "interleaving: " << String(interleaveTime, 2) << " ms (" << String(100.0 * interleaveTime / vectorizedTime, 1) << "%), ";
+				s << "used lanes: " << String(numChannels) << "/" << String(numLanesUsed);
+			}
+			else
+				s << "single lane";
+
+			logMessage(s);
+		}
+	}
+
+	static void fillWithNoise(AudioSampleBuffer& b, Random& r)
+	{
+		for (int c = 0; c < b.getNumChannels(); c++)
+		{
+			for (int s = 0; s < b.getNumSamples(); s++)
+				b.setSample(c, s, r.nextFloat() * 2.0f - 1.0f);
+		}
+	}
+
+	static float getMaxError(const AudioSampleBuffer& actual, const AudioSampleBuffer& expected)
+	{
+		float maxError = 0.0f;
+
+		for (int c = 0; c < actual.getNumChannels(); c++)
+		{
+			for (int s = 0; s < actual.getNumSamples(); s++)
+				maxError = jmax<float>(maxError, std::abs(actual.getSample(c, s) - expected.getSample(c, s)));
+		}
+
+		return maxError;
+	}
+
+	void initFilter(MultiChannelFilter& f, int type)
+	{
+		f.setSampleRate(44100.0);
+		f.setType(type);
+		f.setFreqAndQ(1200.0, 2.0);
+		f.setGain(0.5);
+	}
+};
+
+static FilterLanesTest filterLanesTest;
+
+class FilterCoefficientTableTest : public UnitTest
+{
+public:
+
+	FilterCoefficientTableTest() : UnitTest("Testing filter coefficient table") {}
+
+	void runTest() override
+	{
+		testSampleRate(44100.0);
+		testSampleRate(96000.0);
+
+		beginTest("Testing frequencies outside the table");
+
+		expectWithinAbsoluteError(FilterCoefficientTable::getPrewarpedFrequency(23000.0, 44100.0), std::tan(double_Pi * 23000.0 / 44100.0), 0.000001);
+		expectWithinAbsoluteError(FilterCoefficientTable::getOnePoleDecay(23000.0, 44100.0), std::exp(-2.0 * double_Pi * 23000.0 / 44100.0), 0.000001);
+	}
+
+private:
+
+	void testSampleRate(double sampleRate)
+	{
+		beginTest("Testing table at " + String(sampleRate, 0) + " Hz");
+
+		Random r(12);
+
+		double maxTanError = 0.0;
+		double maxExpError = 0.0;
+
+		for (int i = 0; i < 5000; i++)
+		{
+			// Logarithmic distribution between 20Hz and 20kHz
+			const double frequency = 20.0 * std::pow(1000.0, r.nextDouble());
+
+			const double expectedTan = std::tan(double_Pi * frequency / sampleRate);
+			const double expectedExp = std::exp(-2.0 * double_Pi * frequency / sampleRate);
+
+			maxTanError = jmax<double>(maxTanError, std::abs(FilterCoefficientTable::getPrewarpedFrequency(frequency, sampleRate) / expectedTan - 1.0));
+			maxExpError = jmax<double>(maxExpError, std::abs(FilterCoefficientTable::getOnePoleDecay(frequency, sampleRate) - expectedExp));
+		}
+
+		expect(maxTanError < 0.0001, "tan error: " + String(maxTanError));
+		expect(maxExpError < 0.00001, "exp error: " + String(maxExpError));
+	}
+};
+
+static FilterCoefficientTableTest filterCoefficientTableTest;
+
+class WavetableMipMapTest : public UnitTest
+{
+public:
+
+	WavetableMipMapTest() : UnitTest("Testing wavetable mip maps") {}
+
+	void runTest() override
+	{
+		beginTest("Creating mip maps");
+
+		ScopedPointer<WavetableSound> sound = createSawSound();
+
+		expectEquals(sound->getNumMipMapLevels(), 6, "Number of mip map levels");
+		expectEquals(sound->getMipMapSize(2), (int)TableSize / 4, "Table size of level 2");
+		expectEquals(sound->getMipMapLevelForPitchRatio(1.0), 0, "Level for original pitch");
+		expectEquals(sound->getMipMapLevelForPitchRatio(PitchRatio), 2, "Level for two octaves up");
+
+		beginTest("Comparing the aliasing two octaves up");
+
+		HeapBlock<float> reference(NumSamples);
+		HeapBlock<float> original(NumSamples);
+		HeapBlock<float> mipMapped(NumSamples);
+
+		const float gain = 1.0f / sound->getUnnormalizedGainValue(0);
+
+		// The saw with the harmonics below the nyquist frequency of the played pitch
+		for (int i = 0; i < NumSamples; i++)
+		{
+			const double phase = 2.0 * double_Pi * (double)i * PitchRatio / (double)TableSize;
+			double value = 0.0;
+
+			for (int h = 1; (double)h * PitchRatio / (double)TableSize < 0.5; h++)
+				value += std::sin(phase * (double)h) / (double)h;
+
+			reference[i] = (float)value * gain;
+		}
+
+		renderOriginal(*sound, original);
+		renderWithMipMap(*sound, mipMapped, sound->getMipMapLevelForPitchRatio(PitchRatio));
+
+		const double originalError = getRmsError(original, reference);
+		const double mipMapError = getRmsError(mipMapped, reference);
+
+		logMessage("RMS error without mip maps: " + String(originalError));
+		logMessage("RMS error with mip maps: " + String(mipMapError));
+
+		expect(mipMapError < 0.001, "Mip map error: " + String(mipMapError));
+		expect(originalError > 100.0 * mipMapError, "No aliasing in the original tables?");
+
+		beginTest("Benchmarking the table crossfade");
+
+		HeapBlock<float> output(NumSamples);
+
+		const int numRuns = 100;
+
+		double start = Time::getMillisecondCounterHiRes();
+
+		for (int i = 0; i < numRuns; i++)
+			renderOriginal(*sound, output);
+
+		const double originalTime = Time::getMillisecondCounterHiRes() - start;
+
+		start = Time::getMillisecondCounterHiRes();
+
+		for (int i = 0; i < numRuns; i++)
+			renderWithMipMap(*sound, output, 0);
+
+		const double vectorizedTime = Time::getMillisecondCounterHiRes() - start;
+
+		logMessage("Per voice scalar loop: " + String(originalTime / (double)numRuns, 3) + " ms for " + String(NumSamples) + " samples");
+		logMessage("Per voice chunked loop: " + String(vectorizedTime / (double)numRuns, 3) + " ms for " + String(NumSamples) + " samples");
+
+		// A power of two size uses the FFT, the other size the DFT fallback
+		testMipMapHarmonics(TableSize);
+		testMipMapHarmonics(250);
+
+		benchmarkVoices();
+	}
+
+private:
+
+	enum
+	{
+		TableSize = 256,
+		NumTables = 64,
+		NumSamples = 4096
+	};
+
+	static constexpr double PitchRatio = 4.0;
+
+	/** Checks that every mip map level contains exactly the harmonics below its nyquist frequency. */
+	void testMipMapHarmonics(int tableSize)
+	{
+		beginTest("Checking the mip map harmonics with a table size of " + String(tableSize));
+
+		ScopedPointer<WavetableSound> sound = createSawSound(tableSize);
+
+		double maxError = 0.0;
+
+		for (int level = 1; level < sound->getNumMipMapLevels(); level++)
+		{
+			const int size = sound->getMipMapSize(level);
+			const int numHarmonics = jmin((size - 1) / 2, tableSize / 2 - 1);
+			const float* data = sound->getWaveTableData(NumTables / 2, level);
+
+			for (int i = 0; i < size; i++)
+			{
+				double value = 0.0;
+
+				for (int h = 1; h <= numHarmonics; h++)
+					value += std::sin(2.0 * double_Pi * (double)(h * i) / (double)size) / (double)h;
+
+				maxError = jmax(maxError, std::abs(value - (double)data[i]));
+			}
+		}
+
+		expect(maxError < 0.0001, "Mip map error: " + String(maxError));
+	}
+
+	/** Renders the wavetable synth with and without the HQ mode. */
+	void benchmarkVoices()
+	{
+		beginTest("Benchmarking the wavetable voices");
+
+		const int blockSize = 512;
+		const int numBlocks = 200;
+		const int numNotes = 8;
+
+		for (int i = 0; i < 2; i++)
+		{
+			const bool hqMode = i == 1;
+
+			TestController mc;
+
+			auto synth = new WavetableSynth(&mc, "Wavetable", NUM_POLYPHONIC_VOICES);
+			mc.chain->getHandler()->add(synth, nullptr);
+			mc.chain->prepareToPlay(44100.0, blockSize);
+
+			ValueTree v("wavetables");
+
+			for (int n = 0; n < numNotes; n++)
+				v.addChild(createSawTree(TableSize, 60 + 4 * n), -1, nullptr);
+
+			synth->loadWaveTable(v);
+			synth->setAttribute(WavetableSynth::HqMode, hqMode ? 1.0f : 0.0f, dontSendNotification);
+
+			HiseEventBuffer events;
+			MainController::EventIdHandler idHandler(events);
+
+			// The notes are spread over more than two octaves, so the voices use different mip map levels
+			for (int n = 0; n < numNotes; n++)
+				events.addEvent(HiseEvent(HiseEvent::Type::NoteOn, (uint8)(60 + 4 * n), 100, 1));
+
+			idHandler.handleEventIds();
+
+			AudioSampleBuffer output(2, blockSize);
+
+			double time = 0.0;
+
+			for (int b = 0; b < numBlocks; b++)
+			{
+				output.clear();
+
+				const double start = Time::getMillisecondCounterHiRes();
+				mc.chain->renderNextBlockWithModulators(output, events);
+				time += Time::getMillisecondCounterHiRes() - start;
+
+				events.clear();
+			}
+
+			expect(output.getMagnitude(0, 0, blockSize) > 0.0f, "No output");
+
+			logMessage(String(hqMode ? "HQ mode: " : "Normal mode: ") + String(time / (double)(numBlocks * numNotes), 4) + " ms per voice for " + String(blockSize) + " samples");
+		}
+	}
+
+	ValueTree createSawTree(int tableSize, int noteNumber)
+	{
+		AudioSampleBuffer tables(1, tableSize * NumTables);
+
+		for (int i = 0; i < tableSize; i++)
+		{
+			double value = 0.0;
+
+			for (int h = 1; h < tableSize / 2; h++)
+				value += std::sin(2.0 * double_Pi * (double)(h * i) / (double)tableSize) / (double)h;
+
+			tables.setSample(0, i, (float)value);
+		}
+
+		for (int t = 1; t < NumTables; t++)
+			tables.copyFrom(0, t * tableSize, tables, 0, 0, tableSize);
+
+		ValueTree v("wavetable");
+
+		v.setProperty("data", var(tables.getReadPointer(0), sizeof(float) * tableSize * NumTables), nullptr);
+		v.setProperty("amount", NumTables, nullptr);
+		v.setProperty("noteNumber", noteNumber, nullptr);
+		v.setProperty("sampleRate", 44100.0, nullptr);
+
+		return v;
+	}
+
+	WavetableSound* createSawSound(int tableSize=TableSize)
+	{
+		return new WavetableSound(createSawTree(tableSize, 60));
+	}
+
+	/** The scalar loop of the HQ mode before the mip maps. */
+	void renderOriginal(const WavetableSound& sound, float* output)
+	{
+		double uptime = 0.0;
+
+		for (int i = 0; i < NumSamples; i++)
+		{
+			const int index = (int)uptime;
+			const int i1 = index % TableSize;
+			const int i2 = (i1 + 1) % TableSize;
+
+			const float* lowerTable = sound.getWaveTableData(10);
+			const float* upperTable = sound.getWaveTableData(11);
+
+			const float alpha = (float)uptime - (float)index;
+			const float lowerSample = lowerTable[i1] + alpha * (lowerTable[i2] - lowerTable[i1]);
+			const float upperSample = upperTable[i1] + alpha * (upperTable[i2] - upperTable[i1]);
+
+			output[i] = lowerSample + 0.5f * (upperSample - lowerSample);
+
+			uptime += PitchRatio;
+		}
+	}
+
+	void renderWithMipMap(const WavetableSound& sound, float* output, int mipMapLevel)
+	{
+		double positions[WavetableSound::MaxChunkSize];
+		int lowerTableIndexes[WavetableSound::MaxChunkSize];
+		float tableDeltas[WavetableSound::MaxChunkSize];
+
+		double uptime = 0.0;
+
+		for (int offset = 0; offset < NumSamples; offset += WavetableSound::MaxChunkSize)
+		{
+			const int numThisTime = jmin<int>(WavetableSound::MaxChunkSize, NumSamples - offset);
+
+			for (int i = 0; i < numThisTime; i++)
+			{
+				positions[i] = uptime;
+				lowerTableIndexes[i] = 10;
+				tableDeltas[i] = 0.5f;
+
+				uptime += PitchRatio;
+			}
+
+			sound.renderTableCrossfade(output + offset, positions, lowerTableIndexes, tableDeltas, numThisTime, mipMapLevel);
+		}
+	}
+
+	static double getRmsError(const float* data, const float* reference)
+	{
+		double sum = 0.0;
+
+		for (int i = 0; i < NumSamples; i++)
+		{
+			const double delta = (double)data[i] - (double)reference[i];
+			sum += delta * delta;
+		}
+
+		return std::sqrt(sum / (double)NumSamples);
+	}
+};
+
+static WavetableMipMapTest wavetableMipMapTest;
+
+class CompiledShapeFunctionTest : public UnitTest
+{
+public:
+
+	CompiledShapeFunctionTest() : UnitTest("Testing compiled shape functions") {}
+
+	void runTest() override
+	{
+		beginTest("Comparing compiled functions with the interpreter");
+
+		compareWithInterpreter("function shape(input)\n{\n\treturn input;\n}\n");
+
+		compareWithInterpreter("function shape(input)\n"
+			"{\n"
+			"	// A soft clipper with some added harmonics\n"
+			"	var x = input * gain;\n"
+			"	return Math.tanh(x) * 0.8 + Math.sin(x * Math.PI) * 0.1;\n"
+			"}\n");
+
+		compareWithInterpreter("function shape(input)\n"
+			"{\n"
+			"	if (input > 0.5)\n"
+			"		return 0.5 + (input - 0.5) * 0.2;\n"
+			"	else if (input < -0.5)\n"
+			"	{\n"
+			"		return -0.5;\n"
+			"	}\n"
+			"\n"
+			"	var y = input, z = 0;\n"
+			"	y *= 2;\n"
+			"	y -= input;\n"
+			"	z++;\n"
+			"	return y + z * 0.01;\n"
+			"}\n");
+
+		compareWithInterpreter("function shape(input)\n"
+			"{\n"
+			"	var a = input > 0 && input < 0.3;\n"
+			"	var b = input < -0.2 || input > 0.9;\n"
+			"	var c = !a && input !== 0.5;\n"
+			"	if (c == false) return a ? input * 3 : 0.25;\n"
+			"	return b ? -input : (input * 7) % 3 / 3;\n"
+			"}\n");
+
+		compareWithInterpreter("function shape(input)\n"
+			"{\n"
+			"	var s = Math.sign(input) * Math.pow(Math.abs(input), 0.5);\n"
+			"	var r = Math.range(input * 4, -1, 1) + Math.min(Math.max(input, -0.2), 0.2);\n"
+			"	var q = Math.floor(input * 3) / 3 + Math.ceil(input) - Math.round(input * 2);\n"
+			"	return s + r + q + Math.sqr(input) - Math.exp(-Math.abs(input)) + Math.atan(input / gain);\n"
+			"}\n");
+
+		beginTest("Falling back to the interpreter");
+
+		expectFallback("function shape(input)\n{\n\tfor (i = 0; i < 3; i++) input *= 0.5;\n\treturn input;\n}\n");
+		expectFallback("function shape(input)\n{\n\tConsole.print(input);\n\treturn input;\n}\n");
+		expectFallback("function shape(input)\n{\n\treturn input * unknownValue;\n}\n");
+		expectFallback("reg x = 0.5;\nfunction shape(input)\n{\n\treturn input * x;\n}\n");
+		expectFallback("function shape(input)\n{\n\treturn input > 0 ? \"positive\" : 0;\n}\n");
+		expectFallback("function shape(input)\n{\n\treturn input | 1;\n}\n");
+	}
+
+private:
+
+	void compareWithInterpreter(const String& code)
+	{
+		CompiledShapeFunction compiledFunction;
+		const Result r = compiledFunction.compile(code);
+
+		expect(r.wasOk(), r.getErrorMessage());
+
+		if (!r.wasOk())
+			return;
+
+		HiseJavascriptEngine engine(nullptr);
+		engine.registerGlobalStorge(new DynamicObject());
+		engine.registerCallbackName("shape", 1, 0.0);
+
+		const Result compileResult = engine.execute(code);
+		expect(compileResult.wasOk(), compileResult.getErrorMessage());
+
+		const int numSamples = 1000;
+		HeapBlock<float> data(numSamples);
+
+		for (float gain : { 1.0f, 2.5f })
+		{
+			engine.getRootObject()->setProperty("gain", gain);
+
+			for (int i = 0; i < numSamples; i++)
+				data[i] = gain * (2.0f * (float)i / (float)numSamples - 1.0f);
+
+			compiledFunction.process(data, numSamples, gain);
+
+			for (int i = 0; i < numSamples; i++)
+			{
+				const float input = gain * (2.0f * (float)i / (float)numSamples - 1.0f);
+
+				Result callResult = Result::ok();
+				engine.setCallbackParameter(0, 0, input);
+				float expected = (float)engine.executeCallback(0, &callResult);
+				expected = jlimit<float>(-1024.0f, 1024.0f, expected);
+				expected = FloatSanitizers::sanitizeFloatNumber(expected);
+
+				if (std::abs(data[i] - expected) > 1e-4f * jmax(1.0f, std::abs(expected)))
+				{
+					expectEquals(data[i], expected, "Mismatch for input " + String(input));
+					return;
+				}
+			}
+		}
+	}
+
+	void expectFallback(const String& code)
+	{
+		CompiledShapeFunction compiledFunction;
+		expect(compiledFunction.compile(code).failed(), "Should not compile: " + code);
+		expect(!compiledFunction.isCompiled());
+	}
+};
+
+static CompiledShapeFunctionTest compiledShapeFunctionTest;
+
+
+
 
 #endif
\ No newline at end of file
@@ -935,6 +935,7 @@ struct ScriptingApi::Engine::Wrapper
 	API_VOID_METHOD_WRAPPER_1(Engine, loadPreviousUserPreset);
 	API_VOID_METHOD_WRAPPER_1(Engine, loadUserPreset);
 	API_METHOD_WRAPPER_0(Engine, getUserPresetList);
+	API_VOID_METHOD_WRAPPER_1(Engine, setUserPresetFadeTime);
 	API_METHOD_WRAPPER_0(Engine, getCurrentUserPresetName);
 	API_VOID_METHOD_WRAPPER_1(Engine, saveUserPreset);
 	API_METHOD_WRAPPER_0(Engine, isMpeEnabled);
@@ -1001,6 +1002,7 @@ parentMidiProcessor(dynamic_cast<ScriptBaseMidiProcessor*>(p))
 	ADD_API_METHOD_1(saveUserPreset);
 	ADD_API_METHOD_1(loadUserPreset);
 	ADD_API_METHOD_0(getUserPresetList);
+	ADD_API_METHOD_1(setUserPresetFadeTime);
 	ADD_API_METHOD_0(isMpeEnabled);
 	ADD_API_METHOD_0(createMidiList);
 	ADD_API_METHOD_0(getPlayHead);
@@ -1316,6 +1318,18 @@ void ScriptingApi::Engine::loadUserPreset(const String& relativePath)
 	}
 }
 
+void ScriptingApi::Engine::setUserPresetFadeTime(double milliSeconds)
+{
+	typedef MainController::UserPresetHandler::LoadingMode LoadingMode;
+
+	auto& handler = getProcessor()->getMainController()->getUserPresetHandler();
+
+	if (milliSeconds > 0.0)
+		handler.setLoadingMode(LoadingMode::FadeOutIn, milliSeconds);
+	else
+		handler.setLoadingMode(LoadingMode::KillVoices);
+}
+
 var ScriptingApi::Engine::getUserPresetList() const
 {
 #if USE_BACKEND
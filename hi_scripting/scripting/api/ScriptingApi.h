@@ -276,6 +276,9 @@ public:
 		/** Returns a list of all available user presets as relative path. */
 		var getUserPresetList() const;
 
+		/** Fades the output out over the given time (in milliseconds) before a user preset is restored and fades it in afterwards. Use 0 to kill the voices instead. The output is still silent while the preset is restored. */
+		void setUserPresetFadeTime(double milliSeconds);
+
 		/** Returns the Bpm of the host. */
 		double getHostBpm() const;
 		
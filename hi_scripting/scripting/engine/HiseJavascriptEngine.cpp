@@ -690,6 +690,11 @@ void HiseJavascriptEngine::setCallStackEnabled(bool shouldBeEnabled)
 	root->setCallStackEnabled(shouldBeEnabled);
 }
 
+void HiseJavascriptEngine::setUseByteCode(bool shouldUseByteCode)
+{
+	root->setUseByteCode(shouldUseByteCode);
+}
+
 void HiseJavascriptEngine::registerApiClass(ApiClass *apiClass)
 {
 	root->hiseSpecialData.apiClasses.add(apiClass);
@@ -193,6 +193,12 @@ public:
 
 	void setCallStackEnabled(bool shouldBeEnabled);
 
+	/** Executes the callbacks using their compiled bytecode instead of walking the statement tree.
+	*
+	*	This is enabled by default (if HISE_USE_SCRIPT_BYTECODE is set) and only exists for debugging and benchmarking.
+	*/
+	void setUseByteCode(bool shouldUseByteCode);
+
 	CriticalSection& getDebugLock() const;
 
 	void registerApiClass(ApiClass *apiClass);
@@ -489,7 +495,7 @@ public:
 		struct GlobalVarStatement;		struct GlobalReference;		struct LocalVarStatement;
 		struct LocalReference;			struct LockStatement;	    struct CallbackParameterReference;
 		struct CallbackLocalStatement;  struct CallbackLocalReference;  struct ExternalCFunction;
-		struct NativeJIT;				struct IsDefinedTest;
+		struct NativeJIT;				struct IsDefinedTest;			struct ByteCodeProgram;
 
 		// Parser classes
 
@@ -524,6 +530,9 @@ public:
 		String dumpCallStack(const Error& lastError, const Identifier& rootFunctionName);
 		void setCallStackEnabled(bool shouldeBeEnabled) { enableCallstack = shouldeBeEnabled; }
 
+		void setUseByteCode(bool shouldUseByteCode) { useByteCode = shouldUseByteCode; }
+		bool isUsingByteCode() const noexcept { return useByteCode; }
+
 		class Callback:  public DynamicObject,
 					     public DebugableObject
 		{
@@ -613,7 +622,10 @@ public:
 
 		private:
 
+			void performStatements(const Scope& s, RootObject* root, var* returnValue);
+
 			ScopedPointer<BlockStatement> statements;
+			ScopedPointer<ByteCodeProgram> byteCode;
 			double lastExecutionTime;
 			const Identifier callbackName;
 			int numArgs;
@@ -810,6 +822,8 @@ public:
 
 		bool enableCallstack = false;
 
+		bool useByteCode = true;
+
 		bool shouldUseCycleCheck = false;
 	};
 
@@ -756,6 +756,18 @@ void HiseJavascriptEngine::RootObject::Callback::setStatements(BlockStatement *s
 {
 	statements = s;
 	isCallbackDefined = s->statements.size() != 0;
+
+#if HISE_USE_SCRIPT_BYTECODE
+	byteCode = ByteCodeProgram::compile(s);
+#endif
+}
+
+void HiseJavascriptEngine::RootObject::Callback::performStatements(const Scope& s, RootObject* root, var* returnValue)
+{
+	if (byteCode != nullptr && root->isUsingByteCode())
+		byteCode->perform(s, returnValue);
+	else
+		statements->perform(s, returnValue);
 }
 
 
@@ -773,14 +785,14 @@ var HiseJavascriptEngine::RootObject::Callback::perform(RootObject *root)
 
 
 
-	statements->perform(s, &returnValue);
+	performStatements(s, root, &returnValue);
 
 	root->removeFromCallStack(callbackName);
 
 	const double post = Time::getMillisecondCounterHiRes();
 	lastExecutionTime = post - pre;
 #else
-	statements->perform(s, &returnValue);
+	performStatements(s, root, &returnValue);
 #endif
 
 	return returnValue;
@@ -0,0 +1,646 @@
+namespace hise { using namespace juce;
+
+/** A flattened version of the statement tree of a callback.
+*
+*	The program is a linear list of instructions that operate on a small set of registers
+*	and on direct pointers to the storage of callback parameters, callback locals, register
+*	variables and literals. The arithmetic and comparison operators have a fast path for
+*	numeric operands, the control flow is resolved into jumps.
+*
+*	Every node that has no dedicated instruction is executed by calling its tree
+*	implementation, so the result is always identical to walking the statement tree.
+*/
+struct HiseJavascriptEngine::RootObject::ByteCodeProgram
+{
+	enum
+	{
+		maxNumRegisters = 32
+	};
+
+	enum class OpCode
+	{
+		Copy,				// registers[target] = a
+		Evaluate,			// registers[target] = expression->getResult()
+		Store,				// *slot = a
+		AssignExpression,	// expression->assign(a)
+		Perform,			// statement->perform()
+		Add,
+		Subtract,
+		Multiply,
+		LessThan,
+		LessThanOrEqual,
+		GreaterThan,
+		GreaterThanOrEqual,
+		Equals,
+		NotEquals,
+		BinaryOperation,	// registers[target] = expression->getWithVars(a, b)
+		ToBool,				// registers[target] = (bool)a
+		Jump,
+		JumpIfFalse,
+		JumpIfTrue,
+		CheckTimeout,
+		CheckParameter,		// checks the argument a with the index target
+		CallApi,			// registers[target] = expression->callWithArguments(registers + a)
+		Return,
+		Exit				// returns the result code stored in target
+	};
+
+	struct Operand
+	{
+		static Operand fromRegister(int registerIndex)
+		{
+			Operand o;
+			o.registerIndex = registerIndex;
+			return o;
+		}
+
+		static Operand fromPointer(const var* pointer)
+		{
+			Operand o;
+			o.pointer = pointer;
+			return o;
+		}
+
+		int registerIndex = -1;
+		const var* pointer = nullptr;
+	};
+
+	struct Instruction
+	{
+		Instruction() {}
+		Instruction(OpCode op_) : op(op_) {}
+
+		OpCode op = OpCode::Exit;
+		int target = 0;
+		Operand a, b;
+
+		int jumpAddress = -1;
+		int breakAddress = -1;
+		int continueAddress = -1;
+
+		var* slot = nullptr;
+		const Expression* expression = nullptr;
+		const Statement* statement = nullptr;
+	};
+
+	/** Compiles the given block. Returns nullptr if the block can't be compiled. */
+	static ByteCodeProgram* compile(const BlockStatement* block);
+
+	Statement::ResultCode perform(const Scope& s, var* returnValue) const;
+
+	int getNumInstructions() const noexcept { return instructions.size(); }
+
+	int getNumRegisters() const noexcept { return numRegisters; }
+
+private:
+
+	struct Compiler;
+
+	struct Add				{ template <typename T> static var perform(T a, T b) { return a + b; } };
+	struct Subtract			{ template <typename T> static var perform(T a, T b) { return a - b; } };
+	struct Multiply			{ template <typename T> static var perform(T a, T b) { return a * b; } };
+	struct LessThan			{ template <typename T> static var perform(T a, T b) { return a < b; } };
+	struct LessThanOrEqual	{ template <typename T> static var perform(T a, T b) { return a <= b; } };
+	struct GreaterThan		{ template <typename T> static var perform(T a, T b) { return a > b; } };
+	struct GreaterThanOrEqual { template <typename T> static var perform(T a, T b) { return a >= b; } };
+	struct Equals			{ template <typename T> static var perform(T a, T b) { return a == b; } };
+	struct NotEquals		{ template <typename T> static var perform(T a, T b) { return a != b; } };
+
+	/** Mirrors BinaryOperator::getWithVars() for numeric operands and calls it for everything else. */
+	template <class Op> static forcedinline void performBinary(const Instruction& i, const var& a, const var& b, var& result)
+	{
+		if (isNumericOrUndefined(a) && isNumericOrUndefined(b))
+			result = (a.isDouble() || b.isDouble()) ? Op::perform((double)a, (double)b) : Op::perform((int64)a, (int64)b);
+		else
+			result = static_cast<const BinaryOperator*>(i.expression)->getWithVars(a, b);
+	}
+
+	static forcedinline const var& get(const Operand& o, const var* registers) noexcept
+	{
+		return o.pointer != nullptr ? *o.pointer : registers[o.registerIndex];
+	}
+
+	Array<Instruction> instructions;
+	int numRegisters = 0;
+};
+
+
+struct HiseJavascriptEngine::RootObject::ByteCodeProgram::Compiler
+{
+	Compiler(ByteCodeProgram& p) : program(p) {}
+
+	struct LoopTargets
+	{
+		Array<int> breakJumps;
+		Array<int> continueJumps;
+		Array<int> performInstructions;
+	};
+
+	int emit(const Instruction& i)
+	{
+		program.instructions.add(i);
+		return program.instructions.size() - 1;
+	}
+
+	Instruction& getInstruction(int index) { return program.instructions.getReference(index); }
+
+	int getNextAddress() const { return program.instructions.size(); }
+
+	/** Marks the register as used and returns false if there are not enough registers. */
+	bool useRegister(int registerIndex)
+	{
+		if (registerIndex >= maxNumRegisters)
+		{
+			ok = false;
+			return false;
+		}
+
+		program.numRegisters = jmax<int>(program.numRegisters, registerIndex + 1);
+		return true;
+	}
+
+	// Statements ==================================================================================
+
+	void compileStatement(const Statement* st)
+	{
+		if (st == nullptr || !ok)
+			return;
+
+		if (auto block = dynamic_cast<const BlockStatement*>(st))
+			compileBlock(block);
+		else if (auto ifStatement = dynamic_cast<const IfStatement*>(st))
+			compileIf(ifStatement);
+		else if (auto loop = dynamic_cast<const LoopStatement*>(st))
+			compileLoop(loop);
+		else if (auto returnStatement = dynamic_cast<const ReturnStatement*>(st))
+			compileReturn(returnStatement);
+		else if (dynamic_cast<const BreakStatement*>(st) != nullptr)
+			compileJumpOut(true);
+		else if (dynamic_cast<const ContinueStatement*>(st) != nullptr)
+			compileJumpOut(false);
+		else if (auto local = dynamic_cast<const CallbackLocalStatement*>(st))
+			compileCallbackLocal(local);
+		else if (auto postAssignment = dynamic_cast<const PostAssignment*>(st))
+			compilePostAssignmentStatement(postAssignment);
+		else if (auto e = dynamic_cast<const Expression*>(st))
+			compileExpression(e, 0);
+		else if (typeid(*st) != typeid(Statement)) // the empty statement does nothing
+			compilePerform(st);
+	}
+
+	void compileBlock(const BlockStatement* block)
+	{
+		bool needsTree = block->lockStatements.size() != 0;
+
+#if ENABLE_SCRIPTING_BREAKPOINTS
+		for (auto st : block->statements)
+			needsTree |= st->breakpointReference.index != -1;
+#endif
+
+		if (needsTree)
+		{
+			compilePerform(block);
+			return;
+		}
+
+		for (auto st : block->statements)
+			compileStatement(st);
+	}
+
+	void compileIf(const IfStatement* ifStatement)
+	{
+		const int jumpToElse = emitConditionalJump(ifStatement->condition, false, 0);
+
+		compileStatement(ifStatement->trueBranch);
+
+		const int jumpToEnd = emit(Instruction(OpCode::Jump));
+
+		getInstruction(jumpToElse).jumpAddress = getNextAddress();
+
+		compileStatement(ifStatement->falseBranch);
+
+		getInstruction(jumpToEnd).jumpAddress = getNextAddress();
+	}
+
+	void compileLoop(const LoopStatement* loop)
+	{
+		if (loop->isIterator)
+		{
+			compilePerform(loop);
+			return;
+		}
+
+		LoopTargets targets;
+		int continueAddress;
+
+		compileStatement(loop->initialiser);
+
+		const int loopStart = getNextAddress();
+		int jumpToEnd = -1;
+
+		if (!loop->isDoLoop)
+			jumpToEnd = emitConditionalJump(loop->condition, false, 0);
+
+		Instruction timeout(OpCode::CheckTimeout);
+		timeout.statement = loop;
+		emit(timeout);
+
+		loopStack.add(&targets);
+		compileStatement(loop->body);
+		loopStack.removeLast();
+
+		if (loop->isDoLoop)
+		{
+			compileStatement(loop->iterator);
+
+			jumpToEnd = emitConditionalJump(loop->condition, false, 0);
+			emitJump(loopStart);
+
+			// a continue statement skips the condition of a do loop
+			continueAddress = getNextAddress();
+			compileStatement(loop->iterator);
+			emitJump(loopStart);
+		}
+		else
+		{
+			continueAddress = getNextAddress();
+			compileStatement(loop->iterator);
+			emitJump(loopStart);
+		}
+
+		const int endAddress = getNextAddress();
+
+		if (!ok)
+			return;
+
+		getInstruction(jumpToEnd).jumpAddress = endAddress;
+
+		for (auto i : targets.breakJumps)
+			getInstruction(i).jumpAddress = endAddress;
+
+		for (auto i : targets.continueJumps)
+			getInstruction(i).jumpAddress = continueAddress;
+
+		for (auto i : targets.performInstructions)
+		{
+			getInstruction(i).breakAddress = endAddress;
+			getInstruction(i).continueAddress = continueAddress;
+		}
+	}
+
+	void compileReturn(const ReturnStatement* r)
+	{
+		Instruction i(OpCode::Return);
+		i.a = compileOperand(r->returnValue, 0);
+		emit(i);
+	}
+
+	void compileJumpOut(bool isBreak)
+	{
+		if (loopStack.isEmpty())
+		{
+			Instruction i(OpCode::Exit);
+			i.target = isBreak ? Statement::breakWasHit : Statement::continueWasHit;
+			emit(i);
+			return;
+		}
+
+		const int index = emit(Instruction(OpCode::Jump));
+
+		if (isBreak)
+			loopStack.getLast()->breakJumps.add(index);
+		else
+			loopStack.getLast()->continueJumps.add(index);
+	}
+
+	void compileCallbackLocal(const CallbackLocalStatement* local)
+	{
+		var* slot = local->parentCallback->localProperties.getVarPointer(local->name);
+
+		if (slot == nullptr)
+		{
+			compilePerform(local);
+			return;
+		}
+
+		Instruction i(OpCode::Store);
+		i.a = compileOperand(local->initialiser, 0);
+		i.slot = slot;
+		emit(i);
+	}
+
+	/** The old value of a statement like `i++` is not used, so it only needs to be read if this has side effects. */
+	void compilePostAssignmentStatement(const PostAssignment* p)
+	{
+		if (getPureValue(p->target) == nullptr)
+		{
+			compileExpression(p, 0);
+			return;
+		}
+
+		compileExpression(p->newValue, 0);
+		emitAssign(p->target, 0);
+	}
+
+	void compilePerform(const Statement* st)
+	{
+		Instruction i(OpCode::Perform);
+		i.statement = st;
+
+		const int index = emit(i);
+
+		if (!loopStack.isEmpty())
+			loopStack.getLast()->performInstructions.add(index);
+	}
+
+	// Expressions =================================================================================
+
+	/** Returns the storage of the expression if it can be read without evaluating anything. */
+	const var* getPureValue(const Expression* e) const
+	{
+		if (auto l = dynamic_cast<const LiteralValue*>(e))
+			return &l->value;
+		if (auto c = dynamic_cast<const ApiConstant*>(e))
+			return &c->value;
+		if (auto p = dynamic_cast<const CallbackParameterReference*>(e))
+			return p->data;
+		if (auto r = dynamic_cast<const RegisterName*>(e))
+			return r->data;
+		if (auto l = dynamic_cast<const CallbackLocalReference*>(e))
+			return l->parentCallback->localProperties.getVarPointer(l->name);
+
+		return nullptr;
+	}
+
+	static bool isConstant(const Expression* e)
+	{
+		return dynamic_cast<const LiteralValue*>(e) != nullptr || dynamic_cast<const ApiConstant*>(e) != nullptr;
+	}
+
+	/** Returns an operand for the expression. This is either a direct pointer or the given register. */
+	Operand compileOperand(const Expression* e, int freeRegister)
+	{
+		if (auto pure = getPureValue(e))
+			return Operand::fromPointer(pure);
+
+		compileExpression(e, freeRegister);
+		return Operand::fromRegister(freeRegister);
+	}
+
+	void compileExpression(const Expression* e, int dst)
+	{
+		if (!useRegister(dst))
+			return;
+
+		if (auto pure = getPureValue(e))
+		{
+			Instruction i(OpCode::Copy);
+			i.target = dst;
+			i.a = Operand::fromPointer(pure);
+			emit(i);
+		}
+		else if (auto andOp = dynamic_cast<const LogicalAndOp*>(e))
+			compileLogicalOperator(andOp, dst, false);
+		else if (auto orOp = dynamic_cast<const LogicalOrOp*>(e))
+			compileLogicalOperator(orOp, dst, true);
+		else if (auto conditional = dynamic_cast<const ConditionalOp*>(e))
+			compileConditional(conditional, dst);
+		else if (auto postAssignment = dynamic_cast<const PostAssignment*>(e))
+		{
+			compileExpression(postAssignment->target, dst);
+			compileExpression(postAssignment->newValue, dst + 1);
+			emitAssign(postAssignment->target, dst + 1);
+		}
+		else if (auto selfAssignment = dynamic_cast<const SelfAssignment*>(e))
+		{
+			compileExpression(selfAssignment->newValue, dst);
+			emitAssign(selfAssignment->target, dst);
+		}
+		else if (auto assignment = dynamic_cast<const Assignment*>(e))
+		{
+			compileExpression(assignment->newValue, dst);
+			emitAssign(assignment->target, dst);
+		}
+		else if (auto binaryOp = dynamic_cast<const BinaryOperator*>(e))
+			compileBinaryOperator(binaryOp, dst);
+		else if (auto apiCall = dynamic_cast<const ApiCall*>(e))
+			compileApiCall(apiCall, dst);
+		else
+		{
+			Instruction i(OpCode::Evaluate);
+			i.target = dst;
+			i.expression = e;
+			emit(i);
+		}
+	}
+
+	void compileBinaryOperator(const BinaryOperator* op, int dst)
+	{
+		Instruction i(getOpCode(op));
+		i.target = dst;
+		i.expression = op;
+
+		// The left operand may only be read directly if evaluating the right operand can't change it.
+		if (isConstant(op->lhs) || getPureValue(op->rhs) != nullptr)
+			i.a = compileOperand(op->lhs, dst);
+		else
+		{
+			compileExpression(op->lhs, dst);
+			i.a = Operand::fromRegister(dst);
+		}
+
+		i.b = compileOperand(op->rhs, i.a.pointer != nullptr ? dst : dst + 1);
+		emit(i);
+	}
+
+	void compileLogicalOperator(const BinaryOperatorBase* op, int dst, bool isOr)
+	{
+		emitToBool(op->lhs, dst);
+
+		Instruction jump(isOr ? OpCode::JumpIfTrue : OpCode::JumpIfFalse);
+		jump.a = Operand::fromRegister(dst);
+		const int jumpToEnd = emit(jump);
+
+		emitToBool(op->rhs, dst);
+
+		getInstruction(jumpToEnd).jumpAddress = getNextAddress();
+	}
+
+	void compileConditional(const ConditionalOp* op, int dst)
+	{
+		const int jumpToFalse = emitConditionalJump(op->condition, false, dst);
+
+		compileExpression(op->trueBranch, dst);
+		const int jumpToEnd = emit(Instruction(OpCode::Jump));
+
+		getInstruction(jumpToFalse).jumpAddress = getNextAddress();
+		compileExpression(op->falseBranch, dst);
+
+		getInstruction(jumpToEnd).jumpAddress = getNextAddress();
+	}
+
+	void compileApiCall(const ApiCall* call, int dst)
+	{
+		for (int i = 0; i < call->expectedNumArguments; i++)
+		{
+			compileExpression(call->argumentList[i], dst + i);
+
+			Instruction check(OpCode::CheckParameter);
+			check.target = i;
+			check.a = Operand::fromRegister(dst + i);
+			check.expression = call;
+			emit(check);
+		}
+
+		Instruction i(OpCode::CallApi);
+		i.target = dst;
+		i.a = Operand::fromRegister(dst);
+		i.expression = call;
+		emit(i);
+	}
+
+	void emitAssign(const Expression* target, int sourceRegister)
+	{
+		var* slot = nullptr;
+
+		if (auto r = dynamic_cast<const RegisterName*>(target))
+			slot = r->data;
+		else if (auto l = dynamic_cast<const CallbackLocalReference*>(target))
+			slot = l->parentCallback->localProperties.getVarPointer(l->name);
+
+		Instruction i(slot != nullptr ? OpCode::Store : OpCode::AssignExpression);
+		i.a = Operand::fromRegister(sourceRegister);
+		i.slot = slot;
+		i.expression = target;
+		emit(i);
+	}
+
+	void emitToBool(const Expression* e, int dst)
+	{
+		Instruction i(OpCode::ToBool);
+		i.target = dst;
+		i.a = compileOperand(e, dst);
+		emit(i);
+	}
+
+	int emitConditionalJump(const Expression* condition, bool jumpIfTrue, int freeRegister)
+	{
+		Instruction i(jumpIfTrue ? OpCode::JumpIfTrue : OpCode::JumpIfFalse);
+		i.a = compileOperand(condition, freeRegister);
+		return emit(i);
+	}
+
+	void emitJump(int address)
+	{
+		Instruction i(OpCode::Jump);
+		i.jumpAddress = address;
+		emit(i);
+	}
+
+	static OpCode getOpCode(const BinaryOperator* op)
+	{
+		if (dynamic_cast<const AdditionOp*>(op) != nullptr)				return OpCode::Add;
+		if (dynamic_cast<const SubtractionOp*>(op) != nullptr)			return OpCode::Subtract;
+		if (dynamic_cast<const MultiplyOp*>(op) != nullptr)				return OpCode::Multiply;
+		if (dynamic_cast<const LessThanOp*>(op) != nullptr)				return OpCode::LessThan;
+		if (dynamic_cast<const LessThanOrEqualOp*>(op) != nullptr)		return OpCode::LessThanOrEqual;
+		if (dynamic_cast<const GreaterThanOp*>(op) != nullptr)			return OpCode::GreaterThan;
+		if (dynamic_cast<const GreaterThanOrEqualOp*>(op) != nullptr)	return OpCode::GreaterThanOrEqual;
+		if (dynamic_cast<const EqualsOp*>(op) != nullptr)				return OpCode::Equals;
+		if (dynamic_cast<const NotEqualsOp*>(op) != nullptr)			return OpCode::NotEquals;
+
+		return OpCode::BinaryOperation;
+	}
+
+	ByteCodeProgram& program;
+	Array<LoopTargets*> loopStack;
+	bool ok = true;
+};
+
+
+HiseJavascriptEngine::RootObject::ByteCodeProgram* HiseJavascriptEngine::RootObject::ByteCodeProgram::compile(const BlockStatement* block)
+{
+	if (block == nullptr)
+		return nullptr;
+
+	ScopedPointer<ByteCodeProgram> program = new ByteCodeProgram();
+
+	Compiler compiler(*program);
+	compiler.compileBlock(block);
+
+	if (!compiler.ok)
+		return nullptr;
+
+	return program.release();
+}
+
+HiseJavascriptEngine::RootObject::Statement::ResultCode HiseJavascriptEngine::RootObject::ByteCodeProgram::perform(const Scope& s, var* returnValue) const
+{
+	var registers[maxNumRegisters];
+
+	const Instruction* code = instructions.begin();
+	const int numInstructions = instructions.size();
+
+	int pc = 0;
+
+	while (pc < numInstructions)
+	{
+		const Instruction& i = code[pc++];
+
+		switch (i.op)
+		{
+		case OpCode::Copy:					registers[i.target] = get(i.a, registers); break;
+		case OpCode::Evaluate:				registers[i.target] = i.expression->getResult(s); break;
+		case OpCode::Store:					*i.slot = get(i.a, registers); break;
+		case OpCode::AssignExpression:		i.expression->assign(s, get(i.a, registers)); break;
+		case OpCode::Perform:
+		{
+			const Statement::ResultCode r = i.statement->perform(s, returnValue);
+
+			if (r == Statement::ok)
+				break;
+
+			if (r == Statement::breakWasHit && i.breakAddress != -1)
+				pc = i.breakAddress;
+			else if (r == Statement::continueWasHit && i.continueAddress != -1)
+				pc = i.continueAddress;
+			else
+				return r;
+
+			break;
+		}
+		case OpCode::Add:					performBinary<Add>(i, get(i.a, registers), get(i.b, registers), registers[i.target]); break;
+		case OpCode::Subtract:				performBinary<Subtract>(i, get(i.a, registers), get(i.b, registers), registers[i.target]); break;
+		case OpCode::Multiply:				performBinary<Multiply>(i, get(i.a, registers), get(i.b, registers), registers[i.target]); break;
+		case OpCode::LessThan:				performBinary<LessThan>(i, get(i.a, registers), get(i.b, registers), registers[i.target]); break;
+		case OpCode::LessThanOrEqual:		performBinary<LessThanOrEqual>(i, get(i.a, registers), get(i.b, registers), registers[i.target]); break;
+		case OpCode::GreaterThan:			performBinary<GreaterThan>(i, get(i.a, registers), get(i.b, registers), registers[i.target]); break;
+		case OpCode::GreaterThanOrEqual:	performBinary<GreaterThanOrEqual>(i, get(i.a, registers), get(i.b, registers), registers[i.target]); break;
+		case OpCode::Equals:				performBinary<Equals>(i, get(i.a, registers), get(i.b, registers), registers[i.target]); break;
+		case OpCode::NotEquals:				performBinary<NotEquals>(i, get(i.a, registers), get(i.b, registers), registers[i.target]); break;
+		case OpCode::BinaryOperation:
+			registers[i.target] = static_cast<const BinaryOperator*>(i.expression)->getWithVars(get(i.a, registers), get(i.b, registers));
+			break;
+		case OpCode::ToBool:				registers[i.target] = (bool)get(i.a, registers); break;
+		case OpCode::Jump:					pc = i.jumpAddress; break;
+		case OpCode::JumpIfFalse:			if (!(bool)get(i.a, registers)) pc = i.jumpAddress; break;
+		case OpCode::JumpIfTrue:			if ((bool)get(i.a, registers)) pc = i.jumpAddress; break;
+		case OpCode::CheckTimeout:			s.checkTimeOut(i.statement->location); break;
+		case OpCode::CheckParameter:
+			HiseJavascriptEngine::checkValidParameter(i.target, get(i.a, registers), i.expression->location);
+			break;
+		case OpCode::CallApi:
+			registers[i.target] = static_cast<const ApiCall*>(i.expression)->callWithArguments(registers + i.a.registerIndex);
+			break;
+		case OpCode::Return:
+			if (returnValue != nullptr)
+				*returnValue = get(i.a, registers);
+			return Statement::returnWasHit;
+		case OpCode::Exit:					return (Statement::ResultCode)i.target;
+		}
+	}
+
+	return Statement::ok;
+}
+
+} // namespace hise
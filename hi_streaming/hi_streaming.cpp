@@ -2,10 +2,14 @@
 #include "hi_streaming.h"
 
 
+#include "hi_streaming/AsyncIOBackend.cpp"
+#include "hi_streaming/StreamingBlockCache.cpp"
 #include "hi_streaming/SampleThreadPool.cpp"
 #include "hi_streaming/MonolithAudioFormat.cpp"
 #include "hi_streaming/StreamingSampler.cpp"
+#include "hi_streaming/SamplerInterpolator.cpp"
 #include "hi_streaming/StreamingSamplerSound.cpp"
+#include "hi_streaming/PreloadCache.cpp"
 #include "hi_streaming/StreamingSamplerVoice.cpp"
 
 
@@ -78,15 +78,30 @@ Set this to true if you add this module to your existing C++ project and don't e
 #define STANDALONE_STREAMING 1
 #endif
 
+//=============================================================================
+/** Config: HISE_USE_IO_URING
+
+Set this to true to use io_uring for batched disk reads on Linux. This requires the kernel headers of Linux 5.1 or later.
+If the kernel doesn't support it at runtime, it will fall back to the default reading.
+*/
+#ifndef HISE_USE_IO_URING
+#define HISE_USE_IO_URING 0
+#endif
+
 
 #include "hi_streaming/lockfree_fifo/readerwriterqueue.h"
+#include "hi_streaming/MultiProducerQueue.h"
 
 
 
+#include "hi_streaming/AsyncIOBackend.h"
+#include "hi_streaming/StreamingBlockCache.h"
 #include "hi_streaming/SampleThreadPool.h"
 #include "hi_streaming/MonolithAudioFormat.h"
 #include "hi_streaming/StreamingSampler.h"
+#include "hi_streaming/SamplerInterpolator.h"
 #include "hi_streaming/StreamingSamplerSound.h"
+#include "hi_streaming/PreloadCache.h"
 #include "hi_streaming/StreamingSamplerVoice.h"
 
 
@@ -0,0 +1,544 @@
+/*  ===========================================================================
+*
+*   This file is part of HISE.
+*   Copyright 2016 Christoph Hart
+*
+*   HISE is free software: you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation, either version 3 of the License, or
+*   (at your option) any later version.
+*
+*   HISE is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with HISE.  If not, see <http://www.gnu.org/licenses/>.
+*
+*   Commercial licenses for using HISE in an closed source project are
+*   available on request. Please visit the project's website to get more
+*   information about commercial licensing:
+*
+*   http://www.hise.audio/
+*
+*   HISE is based on the JUCE library,
+*   which must be separately licensed for closed source applications:
+*
+*   http://www.juce.com
+*
+*   ===========================================================================
+*/
+
+
+#if HISE_USE_IO_URING
+#include <linux/io_uring.h>
+#include <sys/syscall.h>
+#include <sys/mman.h>
+#include <sys/uio.h>
+#include <cerrno>
+#endif
+
+#if JUCE_LINUX
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace hise { using namespace juce;
+
+#if HISE_USE_IO_URING
+
+/** A minimal io_uring wrapper that uses the raw system calls (so we don't need to link against liburing). */
+struct IoUringRing
+{
+	IoUringRing()
+	{
+		static_assert(NUM_SLOTS <= QUEUE_DEPTH, "Not enough ring entries");
+
+		io_uring_params p;
+		zeromem(&p, sizeof(p));
+
+		ringFd = (int)syscall(__NR_io_uring_setup, (unsigned)QUEUE_DEPTH, &p);
+
+		if (ringFd < 0)
+			return;
+
+		sqRingSize = p.sq_off.array + p.sq_entries * sizeof(unsigned);
+		cqRingSize = p.cq_off.cqes + p.cq_entries * sizeof(io_uring_cqe);
+
+		const bool singleMap = (p.features & IORING_FEAT_SINGLE_MMAP) != 0;
+
+		if (singleMap)
+			sqRingSize = cqRingSize = jmax(sqRingSize, cqRingSize);
+
+		sqRing = mmap(nullptr, sqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ringFd, IORING_OFF_SQ_RING);
+
+		if (sqRing == MAP_FAILED)
+		{
+			sqRing = nullptr;
+			return;
+		}
+
+		cqRing = singleMap ? sqRing : mmap(nullptr, cqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ringFd, IORING_OFF_CQ_RING);
+
+		if (cqRing == MAP_FAILED)
+		{
+			cqRing = nullptr;
+			return;
+		}
+
+		sqeSize = p.sq_entries * sizeof(io_uring_sqe);
+		sqes = (io_uring_sqe*)mmap(nullptr, sqeSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ringFd, IORING_OFF_SQES);
+
+		if (sqes == MAP_FAILED)
+		{
+			sqes = nullptr;
+			return;
+		}
+
+		auto sqBase = static_cast<uint8*>(sqRing);
+		auto cqBase = static_cast<uint8*>(cqRing);
+
+		sqTail = reinterpret_cast<unsigned*>(sqBase + p.sq_off.tail);
+		sqMask = *reinterpret_cast<unsigned*>(sqBase + p.sq_off.ring_mask);
+		sqArray = reinterpret_cast<unsigned*>(sqBase + p.sq_off.array);
+
+		cqHead = reinterpret_cast<unsigned*>(cqBase + p.cq_off.head);
+		cqTail = reinterpret_cast<unsigned*>(cqBase + p.cq_off.tail);
+		cqMask = *reinterpret_cast<unsigned*>(cqBase + p.cq_off.ring_mask);
+		cqes = reinterpret_cast<io_uring_cqe*>(cqBase + p.cq_off.cqes);
+
+		// The reads will land in these buffers (the content is discarded, we only want the pages to be loaded).
+		slotData.allocate(NUM_SLOTS * SLOT_SIZE, true);
+
+		for (int i = 0; i < NUM_SLOTS; i++)
+		{
+			slotVecs[i].iov_base = slotData.get() + i * SLOT_SIZE;
+			slotVecs[i].iov_len = SLOT_SIZE;
+
+			freeSlots[i] = NUM_SLOTS - 1 - i;
+		}
+
+		numFreeSlots = NUM_SLOTS;
+
+		// Registered buffers are locked in memory, so this fails if RLIMIT_MEMLOCK is too small.
+		// In this case we'll use normal vectored reads into the same buffers.
+		useFixedBuffers = syscall(__NR_io_uring_register, ringFd, IORING_REGISTER_BUFFERS, slotVecs, (unsigned)NUM_SLOTS) >= 0;
+
+		ok = true;
+	}
+
+	~IoUringRing()
+	{
+		// The kernel might still write into the slot buffers
+		if (ok)
+			waitForCompletion();
+
+		if (sqes != nullptr)
+			munmap(sqes, sqeSize);
+
+		if (cqRing != nullptr && cqRing != sqRing)
+			munmap(cqRing, cqRingSize);
+
+		if (sqRing != nullptr)
+			munmap(sqRing, sqRingSize);
+
+		if (ringFd >= 0)
+			close(ringFd);
+	}
+
+	bool hasFreeSlots() const noexcept { return numFreeSlots > 0; }
+
+	int getNumReadsInFlight() const noexcept { return NUM_SLOTS - numFreeSlots; }
+
+	/** Submits reads for the given requests without waiting for their completion.
+	*
+	*	Requests that are bigger than a slot are split into multiple reads. If there are not enough free slots, the
+	*	remaining region stays in the array and will be submitted with the next call.
+	*/
+	void submit(Array<AsyncIOBackend::ReadRequest>& requests)
+	{
+		struct QueuedRead
+		{
+			int requestIndex;
+			int slot;
+			int numBytes;
+		};
+
+		QueuedRead queued[NUM_SLOTS];
+		int numQueued = 0;
+
+		const unsigned oldTail = *sqTail;
+		unsigned tail = oldTail;
+
+		int requestIndex = 0;
+		int64 offsetInRequest = 0;
+
+		while (requestIndex < requests.size() && numFreeSlots > 0)
+		{
+			const auto& r = requests.getReference(requestIndex);
+			const int numBytes = (int)jmin<int64>(r.numBytes - offsetInRequest, SLOT_SIZE);
+			const int slot = freeSlots[--numFreeSlots];
+			const unsigned index = tail & sqMask;
+
+			io_uring_sqe* sqe = sqes + index;
+			zeromem(sqe, sizeof(io_uring_sqe));
+
+			sqe->fd = r.fileDescriptor;
+			sqe->off = (uint64)(r.offset + offsetInRequest);
+			sqe->user_data = (uint64)slot;
+
+			if (useFixedBuffers)
+			{
+				sqe->opcode = IORING_OP_READ_FIXED;
+				sqe->addr = (uint64)(pointer_sized_int)slotVecs[slot].iov_base;
+				sqe->len = (uint32)numBytes;
+				sqe->buf_index = (uint16)slot;
+			}
+			else
+			{
+				slotVecs[slot].iov_len = (size_t)numBytes;
+
+				sqe->opcode = IORING_OP_READV;
+				sqe->addr = (uint64)(pointer_sized_int)(slotVecs + slot);
+				sqe->len = 1;
+			}
+
+			sqArray[index] = index;
+			tail++;
+
+			queued[numQueued++] = { requestIndex, slot, numBytes };
+
+			offsetInRequest += numBytes;
+
+			if (offsetInRequest >= r.numBytes)
+			{
+				requestIndex++;
+				offsetInRequest = 0;
+			}
+		}
+
+		if (numQueued == 0)
+			return;
+
+		__atomic_store_n(sqTail, tail, __ATOMIC_RELEASE);
+
+		int numSubmitted = (int)syscall(__NR_io_uring_enter, ringFd, (unsigned)numQueued, 0u, 0u, nullptr, 0);
+
+		if (numSubmitted < 0)
+			numSubmitted = 0;
+
+		if (numSubmitted < numQueued)
+		{
+			// Take back the entries that the kernel didn't consume, they'll be queued again with the next call
+			__atomic_store_n(sqTail, oldTail + (unsigned)numSubmitted, __ATOMIC_RELEASE);
+
+			for (int i = numQueued - 1; i >= numSubmitted; i--)
+				freeSlots[numFreeSlots++] = queued[i].slot;
+		}
+
+		// Remove the submitted regions from the requests
+		int numFinishedRequests = 0;
+
+		for (int i = 0; i < numSubmitted; i++)
+		{
+			auto& r = requests.getReference(queued[i].requestIndex);
+
+			r.offset += queued[i].numBytes;
+			r.numBytes -= queued[i].numBytes;
+
+			if (r.numBytes <= 0)
+				numFinishedRequests = queued[i].requestIndex + 1;
+		}
+
+		requests.removeRange(0, numFinishedRequests);
+	}
+
+	/** Frees the slots of all completed reads without waiting. Returns the number of completed reads. */
+	int reapCompletions()
+	{
+		int numCompleted = 0;
+
+		unsigned head = *cqHead;
+
+		while (head != __atomic_load_n(cqTail, __ATOMIC_ACQUIRE))
+		{
+			// We don't care about the result, a failed read will just be performed again by the memory mapped reader.
+			const auto& cqe = cqes[head & cqMask];
+
+			freeSlots[numFreeSlots++] = (int)cqe.user_data;
+
+			head++;
+			numCompleted++;
+		}
+
+		__atomic_store_n(cqHead, head, __ATOMIC_RELEASE);
+
+		return numCompleted;
+	}
+
+	/** Blocks until all submitted reads are completed. Returns the number of completed reads. */
+	int waitForCompletion()
+	{
+		int numCompleted = reapCompletions();
+
+		while (getNumReadsInFlight() > 0)
+		{
+			if (syscall(__NR_io_uring_enter, ringFd, 0u, (unsigned)getNumReadsInFlight(), IORING_ENTER_GETEVENTS, nullptr, 0) < 0 && errno != EINTR)
+				break;
+
+			numCompleted += reapCompletions();
+		}
+
+		return numCompleted;
+	}
+
+	enum
+	{
+		QUEUE_DEPTH = 256,
+		NUM_SLOTS = 128,
+		SLOT_SIZE = AsyncIOBackend::MaxBytesPerRead
+	};
+
+	bool ok = false;
+
+	bool useFixedBuffers = false;
+
+	int ringFd = -1;
+
+	void* sqRing = nullptr;
+	void* cqRing = nullptr;
+	size_t sqRingSize = 0;
+	size_t cqRingSize = 0;
+	size_t sqeSize = 0;
+
+	io_uring_sqe* sqes = nullptr;
+	io_uring_cqe* cqes = nullptr;
+
+	unsigned* sqTail = nullptr;
+	unsigned* sqArray = nullptr;
+	unsigned sqMask = 0;
+
+	unsigned* cqHead = nullptr;
+	unsigned* cqTail = nullptr;
+	unsigned cqMask = 0;
+
+	HeapBlock<uint8> slotData;
+
+	iovec slotVecs[NUM_SLOTS];
+
+	int freeSlots[NUM_SLOTS];
+	int numFreeSlots = 0;
+};
+
+#endif
+
+struct AsyncIOBackend::Pimpl
+{
+	Pimpl(Type preferredType) :
+		type(Type::Synchronous),
+		numProcessedRequests(0),
+		numPrefetchedRequests(0)
+	{
+		pendingRequests.ensureStorageAllocated(2048);
+
+#if HISE_USE_IO_URING
+		if (preferredType == Type::IoUring)
+		{
+			ring = new IoUringRing();
+
+			if (ring->ok)
+				type = Type::IoUring;
+			else
+				ring = nullptr;
+		}
+#else
+		ignoreUnused(preferredType);
+#endif
+	}
+
+	Type type;
+
+	MultiProducerQueue<ReadRequest, 2048> requestQueue;
+
+	Array<ReadRequest> pendingRequests;
+
+	SpinLock submitLock;
+
+	MultiProducerQueue<ReadRequest, 2048> prefetchQueue;
+
+	SpinLock prefetchLock;
+
+	std::atomic<int64> numProcessedRequests;
+
+	std::atomic<int64> numPrefetchedRequests;
+
+#if HISE_USE_IO_URING
+	ScopedPointer<IoUringRing> ring;
+#endif
+};
+
+AsyncIOBackend::AsyncIOBackend(Type preferredType) :
+	pimpl(new Pimpl(preferredType))
+{
+
+}
+
+AsyncIOBackend::~AsyncIOBackend()
+{
+	pimpl = nullptr;
+}
+
+AsyncIOBackend::Type AsyncIOBackend::getType() const noexcept
+{
+	return pimpl->type;
+}
+
+bool AsyncIOBackend::addReadRequest(const ReadRequest& r) noexcept
+{
+	if (pimpl->type == Type::Synchronous || r.fileDescriptor < 0 || r.numBytes <= 0)
+		return false;
+
+	return pimpl->requestQueue.push(r);
+}
+
+int AsyncIOBackend::submitPendingRequests()
+{
+	if (pimpl->type == Type::Synchronous)
+		return 0;
+
+	const GenericScopedTryLock<SpinLock> sl(pimpl->submitLock);
+
+	// Another worker is already submitting the batch.
+	if (!sl.isLocked())
+		return 0;
+
+	int numSubmitted = 0;
+
+#if HISE_USE_IO_URING
+	auto& ring = *pimpl->ring;
+
+	pimpl->numProcessedRequests += ring.reapCompletions();
+
+	auto& pending = pimpl->pendingRequests;
+
+	ReadRequest r;
+
+	while (pending.size() < 2048 && pimpl->requestQueue.pop(r))
+		pending.add(r);
+
+	const int numBefore = ring.getNumReadsInFlight();
+
+	if (!pending.isEmpty() && ring.hasFreeSlots())
+		ring.submit(pending);
+
+	numSubmitted = ring.getNumReadsInFlight() - numBefore;
+#endif
+
+	return numSubmitted;
+}
+
+int AsyncIOBackend::waitForPendingRequests()
+{
+	if (pimpl->type == Type::Synchronous)
+		return 0;
+
+	const SpinLock::ScopedLockType sl(pimpl->submitLock);
+
+	int numCompleted = 0;
+
+#if HISE_USE_IO_URING
+	auto& ring = *pimpl->ring;
+	auto& pending = pimpl->pendingRequests;
+
+	ReadRequest r;
+
+	while (pimpl->requestQueue.pop(r))
+		pending.add(r);
+
+	numCompleted += ring.waitForCompletion();
+
+	while (!pending.isEmpty())
+	{
+		ring.submit(pending);
+
+		// The kernel doesn't accept any reads at the moment
+		if (ring.getNumReadsInFlight() == 0)
+			break;
+
+		numCompleted += ring.waitForCompletion();
+	}
+#endif
+
+	pimpl->numProcessedRequests += numCompleted;
+
+	return numCompleted;
+}
+
+int64 AsyncIOBackend::getNumProcessedRequests() const noexcept
+{
+	return pimpl->numProcessedRequests.load();
+}
+
+bool AsyncIOBackend::addPrefetchRequest(const ReadRequest& r) noexcept
+{
+	if (r.fileDescriptor < 0 || r.numBytes <= 0)
+		return false;
+
+	return pimpl->prefetchQueue.push(r);
+}
+
+int AsyncIOBackend::processPrefetchRequests()
+{
+	if (pimpl->prefetchQueue.isEmpty())
+		return 0;
+
+	const GenericScopedTryLock<SpinLock> sl(pimpl->prefetchLock);
+
+	if (!sl.isLocked())
+		return 0;
+
+	int numProcessed = 0;
+
+	ReadRequest r;
+
+	while (pimpl->prefetchQueue.pop(r))
+	{
+#if JUCE_LINUX
+		// This just starts the read ahead of the kernel and returns immediately
+		if (posix_fadvise(r.fileDescriptor, (off_t)r.offset, (off_t)r.numBytes, POSIX_FADV_WILLNEED) == 0)
+			numProcessed++;
+#endif
+	}
+
+	pimpl->numPrefetchedRequests += numProcessed;
+
+	return numProcessed;
+}
+
+int64 AsyncIOBackend::getNumPrefetchedRequests() const noexcept
+{
+	return pimpl->numPrefetchedRequests.load();
+}
+
+int AsyncIOBackend::openFileDescriptor(const File& f)
+{
+#if JUCE_LINUX
+	return open(f.getFullPathName().toRawUTF8(), O_RDONLY);
+#else
+	ignoreUnused(f);
+	return -1;
+#endif
+}
+
+void AsyncIOBackend::closeFileDescriptor(int fileDescriptor)
+{
+#if JUCE_LINUX
+	if (fileDescriptor >= 0)
+		close(fileDescriptor);
+#else
+	ignoreUnused(fileDescriptor);
+#endif
+}
+
+} // namespace hise
@@ -0,0 +1,126 @@
+/*  ===========================================================================
+*
+*   This file is part of HISE.
+*   Copyright 2016 Christoph Hart
+*
+*   HISE is free software: you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation, either version 3 of the License, or
+*   (at your option) any later version.
+*
+*   HISE is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with HISE.  If not, see <http://www.gnu.org/licenses/>.
+*
+*   Commercial licenses for using HISE in an closed source project are
+*   available on request. Please visit the project's website to get more
+*   information about commercial licensing:
+*
+*   http://www.hise.audio/
+*
+*   HISE is based on the JUCE library,
+*   which must be separately licensed for closed source applications:
+*
+*   http://www.juce.com
+*
+*   ===========================================================================
+*/
+
+
+#ifndef ASYNCIOBACKEND_H_INCLUDED
+#define ASYNCIOBACKEND_H_INCLUDED
+
+namespace hise { using namespace juce;
+
+/** A backend that loads the file regions of upcoming streaming read operations in one batch.
+*
+*	Whenever a SampleLoader requests new data, it adds the file region that it is about to read to this backend.
+*	Before the SampleThreadPool executes the loader jobs, it submits all pending regions at once, so that the
+*	following read operations don't have to wait for the disk.
+*
+*	On Linux, it uses io_uring with registered buffers, so the whole batch is submitted with a single system call
+*	and the workers don't wait for the completion. If the buffers can't be registered (eg. because of RLIMIT_MEMLOCK),
+*	it uses normal reads. If io_uring is not available (or on other platforms) it falls back to the default behaviour
+*	(the regions will be read when they are accessed by the memory mapped readers).
+*/
+class AsyncIOBackend
+{
+public:
+
+	enum class Type
+	{
+		Synchronous = 0, ///< the default reading (page faults of the memory mapped file)
+		IoUring, ///< batched reading using io_uring
+		numTypes
+	};
+
+	/** A file region that should be loaded. */
+	struct ReadRequest
+	{
+		int fileDescriptor = -1;
+		int64 offset = 0;
+		int64 numBytes = 0;
+	};
+
+	/** Creates a backend. If the preferred type can't be used, it will use the synchronous backend. */
+	AsyncIOBackend(Type preferredType = Type::IoUring);
+
+	~AsyncIOBackend();
+
+	/** Returns the type that is actually used. */
+	Type getType() const noexcept;
+
+	/** Adds a region to the pending requests. This doesn't allocate and can be called from the audio thread (or the audio worker threads). */
+	bool addReadRequest(const ReadRequest& r) noexcept;
+
+	/** The maximum size of a single read. Bigger regions are split into multiple reads. */
+	static constexpr int MaxBytesPerRead = 65536;
+
+	/** Submits the pending requests without waiting for their completion. 
+	*
+	*	It can be called from multiple threads, but only one of them will submit the batch. If there are more reads
+	*	in flight than the backend can handle, the remaining regions will be submitted with the next call.
+	*	Returns the number of reads that were submitted.
+	*/
+	int submitPendingRequests();
+
+	/** Submits all pending requests and waits until they are completed. Returns the number of completed reads. */
+	int waitForPendingRequests();
+
+	/** Returns the number of reads that were completed since the creation. */
+	int64 getNumProcessedRequests() const noexcept;
+
+	/** Adds a region that will be needed soon, but not by the next loader job. 
+	*
+	*	Unlike addReadRequest(), the region will not be read into memory but passed to the operating system as read ahead
+	*	hint (so this also works with the synchronous backend). This doesn't allocate and can be called from the audio thread.
+	*/
+	bool addPrefetchRequest(const ReadRequest& r) noexcept;
+
+	/** Passes all pending prefetch regions to the operating system. Returns the number of regions. */
+	int processPrefetchRequests();
+
+	/** Returns the number of prefetch hints that were passed to the operating system since the creation. */
+	int64 getNumPrefetchedRequests() const noexcept;
+
+	/** Opens a file descriptor that can be used for the read requests. Returns -1 if the platform doesn't support it. */
+	static int openFileDescriptor(const File& f);
+
+	/** Closes the file descriptor that was opened with openFileDescriptor(). */
+	static void closeFileDescriptor(int fileDescriptor);
+
+	struct Pimpl;
+
+private:
+
+	ScopedPointer<Pimpl> pimpl;
+
+	JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(AsyncIOBackend);
+};
+
+} // namespace hise
+#endif  // ASYNCIOBACKEND_H_INCLUDED
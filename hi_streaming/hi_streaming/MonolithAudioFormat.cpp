@@ -205,6 +205,12 @@ void HlacMonolithInfo::fillMetadataInfo(const ValueTree& sampleMap)
 			jassertfalse;
 			throw StreamingSamplerSound::LoadingError(monolithicFiles[i].getFileName(), "Error at memory mapping");
 		}
+
+		// The file regions can only be calculated for uncompressed monoliths
+		if (memoryReaders.getLast()->isUncompressedMonolith())
+			fileDescriptors.add(AsyncIOBackend::openFileDescriptor(monolithicFiles[i]));
+		else
+			fileDescriptors.add(-1);
 #endif
 	}
 }
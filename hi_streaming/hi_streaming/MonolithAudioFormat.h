@@ -298,6 +298,12 @@ public:
 		return nullptr;
 	}
 
+	/** Returns the monolith file of the given channel. */
+	File getFile(int channelIndex) const
+	{
+		return isPositiveAndBelow(channelIndex, (int)monolithicFiles.size()) ? monolithicFiles[channelIndex] : File();
+	}
+
 	String getFileName(int channelIndex, int sampleIndex) const
 	{
 		return multiChannelSampleInformation[channelIndex][sampleIndex].fileName;
@@ -385,8 +391,43 @@ public:
 		dummyReader.bitsPerSample = 16;
 	}
 
+	~HlacMonolithInfo()
+	{
+		for (auto fd : fileDescriptors)
+			AsyncIOBackend::closeFileDescriptor(fd);
+	}
+
 	void fillMetadataInfo(const ValueTree& sampleMap);
 
+	/** Creates a request for the AsyncIOBackend that loads the file region of the given sample range. 
+	*
+	*	Returns false if the file region can't be calculated (eg. if the monolith is compressed).
+	*/
+	bool createReadRequest(int sampleIndex, int channelIndex, int64 startSample, int numSamples, AsyncIOBackend::ReadRequest& r) const
+	{
+		if (!isPositiveAndBelow(channelIndex, fileDescriptors.size()) || !isPositiveAndBelow(sampleIndex, (int)multiChannelSampleInformation[channelIndex].size()))
+			return false;
+
+		const int fd = fileDescriptors.getUnchecked(channelIndex);
+
+		if (fd < 0)
+			return false;
+
+		const int64 bytesPerFrame = (isMonoChannel[channelIndex] ? 1 : 2) * sizeof(int16);
+
+		r.fileDescriptor = fd;
+		r.offset = 1 + (multiChannelSampleInformation[channelIndex][sampleIndex].start + startSample) * bytesPerFrame;
+		r.numBytes = (int64)numSamples * bytesPerFrame;
+
+		return true;
+	}
+
+	/** Returns the monolith file of the given channel. */
+	File getFile(int channelIndex) const
+	{
+		return isPositiveAndBelow(channelIndex, (int)monolithicFiles.size()) ? monolithicFiles[channelIndex] : File();
+	}
+
 	String getFileName(int channelIndex, int sampleIndex) const
 	{
 		return multiChannelSampleInformation[channelIndex][sampleIndex].fileName;
@@ -523,7 +564,7 @@ private:
 
 	OwnedArray<hlac::HlacMemoryMappedAudioFormatReader> memoryReaders;
 
-	
+	Array<int> fileDescriptors;
 
 };
 
@@ -0,0 +1,140 @@
+/*  ===========================================================================
+*
+*   This file is part of HISE.
+*   Copyright 2016 Christoph Hart
+*
+*   HISE is free software: you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation, either version 3 of the License, or
+*   (at your option) any later version.
+*
+*   HISE is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with HISE.  If not, see <http://www.gnu.org/licenses/>.
+*
+*   Commercial licenses for using HISE in an closed source project are
+*   available on request. Please visit the project's website to get more
+*   information about commercial licensing:
+*
+*   http://www.hise.audio/
+*
+*   HISE is based on the JUCE library,
+*   which must be separately licensed for closed source applications:
+*
+*   http://www.juce.com
+*
+*   ===========================================================================
+*/
+
+
+#ifndef MULTIPRODUCERQUEUE_H_INCLUDED
+#define MULTIPRODUCERQUEUE_H_INCLUDED
+
+namespace hise { using namespace juce;
+
+/** A bounded lock free queue that can be written and read by multiple threads.
+*
+*	The moodycamel::ReaderWriterQueue only supports a single producer, but the streaming requests are added by the
+*	audio thread and the threads that render the voices in parallel. Every push just claims a slot with an atomic
+*	increment, so it doesn't lock or allocate. If the queue is full, push() returns false.
+*
+*	The capacity must be a power of two. The cells are stored inside the object, so create it on the heap.
+*/
+template <typename ElementType, size_t Capacity> class MultiProducerQueue
+{
+public:
+
+	MultiProducerQueue() :
+		enqueuePosition(0),
+		dequeuePosition(0)
+	{
+		static_assert((Capacity & (Capacity - 1)) == 0, "Capacity must be a power of two");
+
+		for (size_t i = 0; i < Capacity; i++)
+			cells[i].sequence.store(i, std::memory_order_relaxed);
+	}
+
+	/** Adds the element to the queue. Returns false if the queue is full. */
+	bool push(const ElementType& e) noexcept
+	{
+		size_t pos = enqueuePosition.load(std::memory_order_relaxed);
+
+		for (;;)
+		{
+			auto& c = cells[pos & (Capacity - 1)];
+			const size_t seq = c.sequence.load(std::memory_order_acquire);
+			const intptr_t diff = (intptr_t)seq - (intptr_t)pos;
+
+			if (diff == 0)
+			{
+				if (enqueuePosition.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+				{
+					c.value = e;
+					c.sequence.store(pos + 1, std::memory_order_release);
+					return true;
+				}
+			}
+			else if (diff < 0)
+				return false;
+			else
+				pos = enqueuePosition.load(std::memory_order_relaxed);
+		}
+	}
+
+	/** Removes the oldest element. Returns false if the queue is empty. */
+	bool pop(ElementType& e) noexcept
+	{
+		size_t pos = dequeuePosition.load(std::memory_order_relaxed);
+
+		for (;;)
+		{
+			auto& c = cells[pos & (Capacity - 1)];
+			const size_t seq = c.sequence.load(std::memory_order_acquire);
+			const intptr_t diff = (intptr_t)seq - (intptr_t)(pos + 1);
+
+			if (diff == 0)
+			{
+				if (dequeuePosition.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+				{
+					e = c.value;
+					c.value = ElementType();
+					c.sequence.store(pos + Capacity, std::memory_order_release);
+					return true;
+				}
+			}
+			else if (diff < 0)
+				return false;
+			else
+				pos = dequeuePosition.load(std::memory_order_relaxed);
+		}
+	}
+
+	/** Returns true if there is no element in the queue. The result might be outdated if other threads are using the queue. */
+	bool isEmpty() const noexcept
+	{
+		return enqueuePosition.load() == dequeuePosition.load();
+	}
+
+private:
+
+	struct Cell
+	{
+		std::atomic<size_t> sequence;
+		ElementType value;
+	};
+
+	Cell cells[Capacity];
+
+	std::atomic<size_t> enqueuePosition;
+	std::atomic<size_t> dequeuePosition;
+
+	JUCE_DECLARE_NON_COPYABLE(MultiProducerQueue);
+};
+
+} // namespace hise
+
+#endif  // MULTIPRODUCERQUEUE_H_INCLUDED
@@ -0,0 +1,269 @@
+/*  ===========================================================================
+*
+*   This file is part of HISE.
+*   Copyright 2016 Christoph Hart
+*
+*   HISE is free software: you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation, either version 3 of the License, or
+*   (at your option) any later version.
+*
+*   HISE is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with HISE.  If not, see <http://www.gnu.org/licenses/>.
+*
+*   Commercial licenses for using HISE in an closed source project are
+*   available on request. Please visit the project's website to get more
+*   information about commercial licensing:
+*
+*   http://www.hise.audio/
+*
+*   HISE is based on the JUCE library,
+*   which must be separately licensed for closed source applications:
+*
+*   http://www.juce.com
+*
+*   ===========================================================================
+*/
+
+
+namespace hise { using namespace juce;
+
+PreloadCache::PreloadCache(MemoryMappedFile* map_) :
+	map(map_)
+{
+}
+
+PreloadCache::~PreloadCache()
+{
+	entries.clear();
+	map = nullptr;
+}
+
+PreloadCache::Ptr PreloadCache::open(const File& cacheFile, int preloadSize)
+{
+	if (!cacheFile.existsAsFile())
+		return nullptr;
+
+	ScopedPointer<MemoryMappedFile> newMap = new MemoryMappedFile(cacheFile, MemoryMappedFile::readOnly);
+
+	if (newMap->getData() == nullptr)
+		return nullptr;
+
+	const int64 fileSize = (int64)newMap->getSize();
+
+	MemoryInputStream mis(newMap->getData(), newMap->getSize(), false);
+
+	if (mis.readInt() != magicNumber || mis.readInt() != preloadSize)
+		return nullptr;
+
+	const int numSourceFiles = mis.readInt();
+
+	for (int i = 0; i < numSourceFiles; i++)
+	{
+		const File sourceFile(mis.readString());
+		const int64 size = mis.readInt64();
+		const int64 modificationTime = mis.readInt64();
+
+		if (!sourceFile.existsAsFile() || 
+			sourceFile.getSize() != size || 
+			sourceFile.getLastModificationTime().toMilliseconds() != modificationTime)
+		{
+			return nullptr;
+		}
+	}
+
+	const int numEntries = mis.readInt();
+
+	if (numEntries <= 0 || (int64)numEntries * entryHeaderSize > fileSize)
+		return nullptr;
+
+	Ptr cache = new PreloadCache(newMap.release());
+
+	cache->entries.ensureStorageAllocated(numEntries);
+
+	for (int i = 0; i < numEntries; i++)
+	{
+		Entry e;
+
+		e.key = mis.readInt64();
+		e.offset = mis.readInt64();
+		e.numChannels = mis.readInt();
+		e.numSamples = mis.readInt();
+		e.isFloat = mis.readBool();
+
+		cache->entries.add(e);
+	}
+
+	const int64 dataStart = mis.readInt64();
+
+	for (auto& e : cache->entries)
+	{
+		e.offset += dataStart;
+
+		const bool isValid = isPositiveAndBelow(e.numChannels - 1, 2) && e.numSamples > 0 && e.offset >= dataStart &&
+							 e.offset + e.numChannels * getChannelSize(e) <= fileSize;
+
+		if (!isValid)
+			return nullptr;
+	}
+
+	EntrySorter sorter;
+	cache->entries.sort(sorter);
+
+	return cache;
+}
+
+Result PreloadCache::write(const File& cacheFile, int preloadSize, const Array<StreamingSamplerSound*>& sounds)
+{
+	Array<Entry> newEntries;
+	Array<StreamingSamplerSound*> soundsToWrite;
+	StringArray sourceFiles;
+
+	int64 dataSize = 0;
+
+	for (auto s : sounds)
+	{
+		const auto& b = s->getPreloadBuffer();
+
+		if (b.getNumSamples() == 0)
+			continue;
+
+		Entry e;
+
+		e.key = s->getPreloadCacheKey();
+		e.offset = dataSize;
+		e.numChannels = b.getNumChannels();
+		e.numSamples = b.getNumSamples();
+		e.isFloat = b.isFloatingPoint();
+
+		dataSize += e.numChannels * getChannelSize(e);
+
+		newEntries.add(e);
+		soundsToWrite.add(s);
+		sourceFiles.addIfNotAlreadyThere(s->getSourceFile().getFullPathName());
+	}
+
+	if (newEntries.isEmpty())
+		return Result::fail("No preload buffers to cache");
+
+	MemoryOutputStream header;
+
+	header.writeInt(magicNumber);
+	header.writeInt(preloadSize);
+	header.writeInt(sourceFiles.size());
+
+	for (const auto& path : sourceFiles)
+	{
+		const File sourceFile(path);
+
+		header.writeString(path);
+		header.writeInt64(sourceFile.getSize());
+		header.writeInt64(sourceFile.getLastModificationTime().toMilliseconds());
+	}
+
+	header.writeInt(newEntries.size());
+
+	for (const auto& e : newEntries)
+	{
+		header.writeInt64(e.key);
+		header.writeInt64(e.offset);
+		header.writeInt(e.numChannels);
+		header.writeInt(e.numSamples);
+		header.writeBool(e.isFloat);
+	}
+
+	// The data starts at a 16 byte boundary
+	const int64 dataStart = ((int64)header.getDataSize() + 8 + 15) & ~(int64)15;
+
+	header.writeInt64(dataStart);
+
+	TemporaryFile tempFile(cacheFile);
+
+	{
+		FileOutputStream fos(tempFile.getFile());
+
+		if (fos.failedToOpen())
+			return Result::fail("Can't open " + tempFile.getFile().getFullPathName());
+
+		fos.write(header.getData(), header.getDataSize());
+		fos.writeRepeatedByte(0, (size_t)(dataStart - (int64)header.getDataSize()));
+
+		for (int i = 0; i < newEntries.size(); i++)
+		{
+			const auto& e = newEntries.getReference(i);
+			const auto& b = soundsToWrite[i]->getPreloadBuffer();
+
+			const size_t numBytes = (size_t)e.numSamples * (e.isFloat ? sizeof(float) : sizeof(int16));
+			
+			for (int c = 0; c < e.numChannels; c++)
+			{
+				fos.write(b.getReadPointer(c), numBytes);
+				fos.writeRepeatedByte(0, (size_t)getChannelSize(e) - numBytes);
+			}
+		}
+
+		fos.flush();
+
+		if (fos.getStatus().failed())
+			return fos.getStatus();
+	}
+
+	if (!tempFile.overwriteTargetFileWithTemporary())
+		return Result::fail("Can't write " + cacheFile.getFullPathName());
+
+	return Result::ok();
+}
+
+String PreloadCache::getFileName(const String& sampleMapId, int preloadSize)
+{
+	return sampleMapId.replaceCharacters("/\\:", "___") + "_" + String(preloadSize) + ".hpc";
+}
+
+bool PreloadCache::restore(StreamingSamplerSound* s, int preloadSize)
+{
+	auto e = getEntry(s->getPreloadCacheKey());
+
+	if (e == nullptr || e->isFloat == s->isMonolithic())
+		return false;
+
+	auto data = static_cast<const uint8*>(map->getData()) + e->offset;
+
+	const void* channels[2] = { data, data + getChannelSize(*e) };
+
+	return s->setPreloadBufferFromCache(preloadSize, channels, e->numChannels, e->numSamples, this);
+}
+
+const PreloadCache::Entry* PreloadCache::getEntry(int64 key) const
+{
+	int start = 0;
+	int end = entries.size();
+
+	while (start < end)
+	{
+		const int mid = (start + end) / 2;
+		const auto& e = entries.getReference(mid);
+
+		if (e.key == key)
+			return &e;
+		else if (e.key < key)
+			start = mid + 1;
+		else
+			end = mid;
+	}
+
+	return nullptr;
+}
+
+int64 PreloadCache::getChannelSize(const Entry& e) noexcept
+{
+	const int64 numBytes = (int64)e.numSamples * (e.isFloat ? sizeof(float) : sizeof(int16));
+
+	return (numBytes + 15) & ~(int64)15;
+}
+
+} // namespace hise
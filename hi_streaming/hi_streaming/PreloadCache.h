@@ -0,0 +1,117 @@
+/*  ===========================================================================
+*
+*   This file is part of HISE.
+*   Copyright 2016 Christoph Hart
+*
+*   HISE is free software: you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation, either version 3 of the License, or
+*   (at your option) any later version.
+*
+*   HISE is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with HISE.  If not, see <http://www.gnu.org/licenses/>.
+*
+*   Commercial licenses for using HISE in an closed source project are
+*   available on request. Please visit the project's website to get more
+*   information about commercial licensing:
+*
+*   http://www.hise.audio/
+*
+*   HISE is based on the JUCE library,
+*   which must be separately licensed for closed source applications:
+*
+*   http://www.juce.com
+*
+*   ===========================================================================
+*/
+
+
+#ifndef PRELOADCACHE_H_INCLUDED
+#define PRELOADCACHE_H_INCLUDED
+
+namespace hise { using namespace juce;
+
+/** A file that contains the decoded preload buffers of a list of sounds.
+*
+*	Reading the preload buffers of a sample map means opening and decoding thousands of files, which takes most of the time
+*	when switching patches. This cache stores all preload buffers in a single file in the storage format of the preload 
+*	buffer (16 bit integers for monoliths, floats for everything else), so they can be memory mapped and used directly.
+*
+*	The cache is only valid for one preload size. Every sound is identified by its StreamingSamplerSound::getPreloadCacheKey()
+*	and the file is rejected if one of the source files was changed (the size and modification time are stored for each file).
+*/
+class PreloadCache : public ReferenceCountedObject
+{
+public:
+
+	using Ptr = ReferenceCountedObjectPtr<PreloadCache>;
+
+	~PreloadCache();
+
+	/** Opens the cache file.
+	*
+	*	Returns nullptr if the file doesn't exist, was written for another preload size or if one of the source files was changed.
+	*/
+	static Ptr open(const File& cacheFile, int preloadSize);
+
+	/** Writes the preload buffers of the given sounds into the cache file. Sounds without a preload buffer are skipped. */
+	static Result write(const File& cacheFile, int preloadSize, const Array<StreamingSamplerSound*>& sounds);
+
+	/** Returns the name of the cache file for the given sample map and preload size. */
+	static String getFileName(const String& sampleMapId, int preloadSize);
+
+	/** Sets the preload buffer of the sound to the cached data.
+	*
+	*	Returns false if the cache doesn't contain a matching buffer, so you need to load it from the file. This can be called 
+	*	from multiple threads at once.
+	*/
+	bool restore(StreamingSamplerSound* s, int preloadSize);
+
+	/** Returns the number of cached preload buffers. */
+	int getNumEntries() const noexcept { return entries.size(); }
+
+private:
+
+	struct Entry
+	{
+		int64 key;
+		int64 offset;
+		int numChannels;
+		int numSamples;
+		bool isFloat;
+	};
+
+	struct EntrySorter
+	{
+		static int compareElements(const Entry& first, const Entry& second)
+		{
+			return first.key < second.key ? -1 : (first.key > second.key ? 1 : 0);
+		}
+	};
+
+	PreloadCache(MemoryMappedFile* map_);
+
+	const Entry* getEntry(int64 key) const;
+
+	/** Returns the size of one channel in the file (every channel starts at a 16 byte boundary). */
+	static int64 getChannelSize(const Entry& e) noexcept;
+
+	static const int magicNumber = 0x31435048; // "HPC1"
+
+	/** The number of bytes of one entry in the header (key, offset, channels, samples and the float flag). */
+	static const int entryHeaderSize = 8 + 8 + 4 + 4 + 1;
+
+	ScopedPointer<MemoryMappedFile> map;
+
+	Array<Entry> entries;
+
+	JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(PreloadCache);
+};
+
+} // namespace hise
+#endif  // PRELOADCACHE_H_INCLUDED
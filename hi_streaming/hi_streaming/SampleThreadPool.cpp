@@ -35,58 +35,518 @@ namespace hise { using namespace juce;
 
 struct SampleThreadPool::Pimpl
 {
-	Pimpl() :
-		jobQueue(2048),
-		currentlyExecutedJob(nullptr),
-		diskUsage(0.0),
-		counter(0)
-	{};
+	struct QueueEntry
+	{
+		WeakReference<Job> job;
+		int64 deadline;
+		bool stealable;
+	};
 
-	~Pimpl()
+	/** A list of jobs sorted by their deadline. Every worker owns one list that is protected by its lock. */
+	struct JobList
 	{
-		if (Job* currentJob = currentlyExecutedJob.load())
+		JobList() :
+			numJobs(0),
+			numStealableJobs(0)
 		{
-			currentJob->signalJobShouldExit();
+			entries.reserve(2048);
+		}
+
+		void insert(Job* j, int64 deadline, bool stealable)
+		{
+			for (const auto& e : entries)
+			{
+				// The job was added again before it was executed
+				if (e.job.get() == j)
+					return;
+			}
+
+			QueueEntry e;
+			e.job = j;
+			e.deadline = deadline;
+			e.stealable = stealable;
+
+			auto pos = entries.end();
+
+			// Jobs with the same deadline will be executed in the order they were added
+			while (pos != entries.begin() && (pos - 1)->deadline > deadline)
+				--pos;
+
+			entries.insert(pos, e);
+			updateCounters();
 		}
+
+		/** Removes the most urgent job that isn't executed by another worker and marks it as running.
+		*
+		*	If onlyStealable is true, the jobs that must be executed by the main thread are skipped.
+		*/
+		Job* popNextJob(bool onlyStealable)
+		{
+			Job* result = nullptr;
+
+			for (int i = 0; i < (int)entries.size(); i++)
+			{
+				Job* j = entries[i].job.get();
+
+				if (j == nullptr)
+				{
+					// The job was deleted while it was queued...
+					entries.erase(entries.begin() + i--);
+					continue;
+				}
+
+				if (onlyStealable && !entries[i].stealable)
+					continue;
+
+				bool notRunning = false;
+
+				// The job was added again while it's running, so we'll leave it in the list until it's finished.
+				if (!j->running.compare_exchange_strong(notRunning, true))
+					continue;
+
+				entries.erase(entries.begin() + i);
+				result = j;
+				break;
+			}
+
+			updateCounters();
+			return result;
+		}
+
+		int64 getNextDeadline(bool onlyStealable) const
+		{
+			for (const auto& e : entries)
+			{
+				if (onlyStealable && !e.stealable)
+					continue;
+
+				if (auto j = e.job.get())
+				{
+					if (!j->isRunning())
+						return e.deadline;
+				}
+			}
+
+			return std::numeric_limits<int64>::max();
+		}
+
+		void updateCounters()
+		{
+			int numStealable = 0;
+
+			for (const auto& e : entries)
+				numStealable += e.stealable ? 1 : 0;
+
+			numJobs.store((int)entries.size());
+			numStealableJobs.store(numStealable);
+		}
+
+		// The entries hold weak references, so they need a container that copy constructs them when they are moved
+		std::vector<QueueEntry> entries;
+
+		std::atomic<int> numJobs;
+		std::atomic<int> numStealableJobs;
+	};
+
+	/** The state of each thread of the pool. */
+	struct WorkerState
+	{
+		WorkerState(Thread* t) :
+			thread(t),
+			sleeping(false),
+			diskUsage(0.0),
+			currentlyExecutedJob(nullptr),
+			startTime(0),
+			endTime(0)
+		{};
+
+		Thread* thread;
+
+		std::atomic<bool> sleeping;
+
+		std::atomic<double> diskUsage;
+
+		std::atomic<Job*> currentlyExecutedJob;
+
+		int64 startTime, endTime;
+
+		// The queue of this worker. Other workers only lock it when they steal a job.
+		CriticalSection lock;
+		JobList jobs;
+	};
+
+	/** An additional thread that executes the parallel jobs. */
+	class Worker : public Thread
+	{
+	public:
+
+		Worker(SampleThreadPool& parent_, int workerIndex_) :
+			Thread("Sample Streaming Worker " + String(workerIndex_)),
+			parent(parent_),
+			workerIndex(workerIndex_)
+		{};
+
+		void run() override
+		{
+			while (!threadShouldExit())
+			{
+				if (!parent.pimpl->runNextJob(workerIndex))
+					parent.pimpl->waitForNextJob(workerIndex);
+			}
+		}
+
+	private:
+
+		SampleThreadPool& parent;
+		const int workerIndex;
+	};
+
+	Pimpl(SampleThreadPool& parent, int numWorkers) :
+		counter(0),
+		nextWorker(0),
+		ioBackend(HISE_USE_IO_URING ? AsyncIOBackend::Type::IoUring : AsyncIOBackend::Type::Synchronous),
+		blockCache(NUM_STREAMING_CACHE_BLOCKS)
+	{
+		states.add(new WorkerState(&parent));
+
+		for (int i = 1; i < numWorkers; i++)
+		{
+			auto w = workers.add(new Worker(parent, i));
+			states.add(new WorkerState(w));
+		}
+	};
+
+	static int64 getDeadlineForJob(const Job* j)
+	{
+		const int64 deadline = j->getDeadline();
+
+		return deadline != 0 ? deadline : Time::getHighResolutionTicks();
+	}
+
+	bool isStealable(const Job* j) const
+	{
+		return j->canRunOnAnyWorker() && states.size() > 1;
+	}
+
+	/** Wakes up the given worker if it's waiting for jobs. Returns true if the worker was sleeping. */
+	bool wakeUp(int workerIndex)
+	{
+		auto s = states.getUnchecked(workerIndex);
+
+		if (s->sleeping.load() && s->sleeping.exchange(false))
+		{
+			s->thread->notify();
+			return true;
+		}
+
+		return false;
+	}
+
+	/** Wakes up at most one sleeping worker that can execute the job. */
+	void wakeUpWorkerFor(Job* j)
+	{
+		if (j == nullptr || !j->canRunOnAnyWorker())
+		{
+			wakeUp(0);
+			return;
+		}
+
+		for (int i = 0; i < states.size(); i++)
+		{
+			if (wakeUp(i))
+				return;
+		}
+	}
+
+	bool hasPendingWork(int workerIndex) const
+	{
+		if (!inbox.isEmpty() || states.getUnchecked(workerIndex)->jobs.numJobs.load() > 0)
+			return true;
+
+		for (int i = 0; i < states.size(); i++)
+		{
+			if (i != workerIndex && states.getUnchecked(i)->jobs.numStealableJobs.load() > 0)
+				return true;
+		}
+
+		return false;
+	}
+
+	void waitForNextJob(int workerIndex)
+	{
+		auto s = states.getUnchecked(workerIndex);
+
+		s->sleeping.store(true);
+
+		// Check again after the flag is set so that a job that was added in the meantime isn't missed
+		if (hasPendingWork(workerIndex))
+		{
+			s->sleeping.store(false);
+			return;
+		}
+
+		s->thread->wait(500);
+		s->sleeping.store(false);
+	}
+
+	/** Returns the worker that should execute the job.
+	*
+	*	A job stays on the worker that executed it last, so that a loader keeps using the same thread.
+	*	New parallel jobs are distributed round robin.
+	*/
+	int getWorkerForJob(const Job* j)
+	{
+		if (!isStealable(j))
+			return 0;
+
+		const int lastWorker = j->workerIndex.load();
+
+		if (isPositiveAndBelow(lastWorker, states.size()))
+			return lastWorker;
+
+		return (++nextWorker & 0x7fffffff) % states.size();
+	}
+
+	/** Inserts the job into the queue of the given worker and wakes it up. */
+	void queueJob(Job* j, int workerIndex)
+	{
+		auto s = states.getUnchecked(workerIndex);
+
+		j->workerIndex.store(workerIndex);
+
+		{
+			const ScopedLock sl(s->lock);
+			s->jobs.insert(j, getDeadlineForJob(j), isStealable(j));
+		}
+
+		wakeUp(workerIndex);
+	}
+
+	/** Moves the jobs of the inbox into the worker queues. Any worker can do this, the inbox supports multiple readers. */
+	void drainInbox()
+	{
+		WeakReference<Job> ref;
+
+		while (inbox.pop(ref))
+		{
+			if (auto j = ref.get())
+				queueJob(j, getWorkerForJob(j));
+		}
+	}
+
+	/** Removes the most urgent job from the queue of the worker or steals one from another worker if the queue is empty. */
+	Job* popNextJob(int workerIndex)
+	{
+		drainInbox();
+
+		auto s = states.getUnchecked(workerIndex);
+
+		{
+			const ScopedLock sl(s->lock);
+
+			if (auto j = s->jobs.popNextJob(false))
+				return j;
+		}
+
+		return stealJob(workerIndex);
+	}
+
+	/** Takes the most urgent parallel job from the other workers. It never holds more than one queue lock. */
+	Job* stealJob(int workerIndex)
+	{
+		int victimIndex = -1;
+		int64 nextDeadline = std::numeric_limits<int64>::max();
+
+		for (int i = 0; i < states.size(); i++)
+		{
+			auto victim = states.getUnchecked(i);
+
+			if (i == workerIndex || victim->jobs.numStealableJobs.load() == 0)
+				continue;
+
+			const ScopedLock sl(victim->lock);
+			const int64 deadline = victim->jobs.getNextDeadline(true);
+
+			if (deadline < nextDeadline)
+			{
+				nextDeadline = deadline;
+				victimIndex = i;
+			}
+		}
+
+		if (victimIndex == -1)
+			return nullptr;
+
+		Job* j = nullptr;
+
+		{
+			auto victim = states.getUnchecked(victimIndex);
+			const ScopedLock sl(victim->lock);
+			j = victim->jobs.popNextJob(true);
+		}
+
+		if (j != nullptr)
+			j->workerIndex.store(workerIndex);
+
+		return j;
+	}
+
+	/** Runs the next job for the given worker. Returns false if there was nothing to do. */
+	bool runNextJob(int workerIndex)
+	{
+		auto s = states.getUnchecked(workerIndex);
+
+		// Load the regions of all pending loaders before executing the next job
+		ioBackend.submitPendingRequests();
+		ioBackend.processPrefetchRequests();
+
+		Job* j = popNextJob(workerIndex);
+
+		if (j == nullptr)
+			return false;
+
+#if ENABLE_CPU_MEASUREMENT
+		const int64 lastEndTime = s->endTime;
+		s->startTime = Time::getHighResolutionTicks();
+#endif
+
+		s->currentlyExecutedJob.store(j);
+
+		j->currentThread.store(s->thread);
+
+		Job::JobStatus status = j->runJob();
+
+		if (status == Job::jobHasFinished)
+		{
+			j->queued.store(false);
+			j->running.store(false);
+			--counter;
+		}
+		else
+		{
+			j->running.store(false);
+			queueJob(j, getWorkerForJob(j));
+		}
+
+		s->currentlyExecutedJob.store(nullptr);
+
+#if ENABLE_CPU_MEASUREMENT
+		s->endTime = Time::getHighResolutionTicks();
+
+		const int64 idleTime = s->startTime - lastEndTime;
+		const int64 busyTime = s->endTime - s->startTime;
+
+		s->diskUsage.store((double)busyTime / (double)(idleTime + busyTime));
+#endif
+
+		return true;
 	}
 
 	Atomic<int> counter;
 
-	std::atomic<double> diskUsage;
+	Atomic<int> nextWorker;
+
+	// addJob() is called from the audio thread, the voice rendering workers and the message thread.
+	// The audio thread never touches the worker queues.
+	MultiProducerQueue<WeakReference<Job>, 4096> inbox;
+
+	OwnedArray<WorkerState> states;
 
-	int64 startTime, endTime;
+	OwnedArray<Worker> workers;
 
-	moodycamel::ReaderWriterQueue<WeakReference<Job>> jobQueue;
+	AsyncIOBackend ioBackend;
 
-	std::atomic<Job*> currentlyExecutedJob;
+	StreamingBlockCache blockCache;
 
 	static const String errorMessage;
 };
 
-SampleThreadPool::SampleThreadPool() :
-	Thread("Sample Loading Thread"),
-	pimpl(new Pimpl())
+SampleThreadPool::SampleThreadPool(int numWorkersToUse) :
+	Thread("Sample Loading Thread")
 {
+	if (numWorkersToUse <= 0)
+		numWorkersToUse = NUM_STREAMING_THREADS;
+
+	if (numWorkersToUse <= 0)
+		numWorkersToUse = jlimit<int>(1, 8, SystemStats::getNumCpus() / 2);
+
+	pimpl = new Pimpl(*this, numWorkersToUse);
 
 	startThread(9);
+
+	for (auto w : pimpl->workers)
+		w->startThread(9);
 }
 
 SampleThreadPool::~SampleThreadPool()
 {
-	pimpl = nullptr;
+	signalThreadShouldExit();
+
+	for (auto w : pimpl->workers)
+		w->signalThreadShouldExit();
+
+	for (auto s : pimpl->states)
+	{
+		if (Job* currentJob = s->currentlyExecutedJob.load())
+			currentJob->signalJobShouldExit();
+	}
+
+	for (auto w : pimpl->workers)
+		w->stopThread(300);
 
 	stopThread(300);
+
+	pimpl = nullptr;
 }
 
 double SampleThreadPool::getDiskUsage() const noexcept
 {
-	return pimpl->diskUsage.load();
+	double sum = 0.0;
+
+	for (auto s : pimpl->states)
+		sum += s->diskUsage.load();
+
+	return sum / (double)pimpl->states.size();
 }
 
-void SampleThreadPool::addJob(Job* jobToAdd, bool unused)
+double SampleThreadPool::getDiskUsage(int workerIndex) const noexcept
 {
-	++pimpl->counter;
+	if (auto s = pimpl->states[workerIndex])
+		return s->diskUsage.load();
+
+	return 0.0;
+}
+
+int SampleThreadPool::getNumWorkers() const noexcept
+{
+	return pimpl->states.size();
+}
+
+AsyncIOBackend& SampleThreadPool::getIOBackend() noexcept
+{
+	return pimpl->ioBackend;
+}
+
+StreamingBlockCache& SampleThreadPool::getBlockCache() noexcept
+{
+	return pimpl->blockCache;
+}
+
+void SampleThreadPool::addPrefetchRequest(const AsyncIOBackend::ReadRequest& r)
+{
+	if (!pimpl->ioBackend.addPrefetchRequest(r))
+		return;
 
+	// Any worker can pass the request to the operating system
+	for (int i = pimpl->states.size() - 1; i >= 0; i--)
+	{
+		if (pimpl->wakeUp(i))
+			return;
+	}
+}
+
+void SampleThreadPool::addJob(Job* jobToAdd, bool unused)
+{
 	ignoreUnused(unused);
 
 #if ENABLE_CONSOLE_OUTPUT
@@ -97,74 +557,31 @@ void SampleThreadPool::addJob(Job* jobToAdd, bool unused)
 	}
 #endif
 
+	++pimpl->counter;
 
 	jobToAdd->queued.store(true);
-	pimpl->jobQueue.enqueue(jobToAdd);
 
+	if (!pimpl->inbox.push(jobToAdd))
+	{
+		// There are more jobs waiting than the inbox can hold...
+		jassertfalse;
+		jobToAdd->queued.store(false);
+		--pimpl->counter;
+		return;
+	}
 
-	notify();
+	pimpl->wakeUpWorkerFor(jobToAdd);
 }
 
 void SampleThreadPool::run()
 {
 	while (!threadShouldExit())
 	{
-		if (WeakReference<Job>* next = pimpl->jobQueue.peek())
-		{
-			Job* j = next->get();
-
-#if ENABLE_CPU_MEASUREMENT
-
-			const int64 lastEndTime = pimpl->endTime;
-			pimpl->startTime = Time::getHighResolutionTicks();
-#endif
-
-			if (j != nullptr)
-			{
-				pimpl->currentlyExecutedJob.store(j);
-
-				j->currentThread.store(this);
-
-				j->running.store(true);
-				
-				Job::JobStatus status = j->runJob();
-
-				j->running.store(false);
-
-				if (status == Job::jobHasFinished)
-				{
-					pimpl->jobQueue.pop();
-					j->queued.store(false);
-					--pimpl->counter;
-				}
-
-				pimpl->currentlyExecutedJob.store(nullptr);
-			}
-
-
-#if ENABLE_CPU_MEASUREMENT
-			pimpl->endTime = Time::getHighResolutionTicks();
-
-			const int64 idleTime = pimpl->startTime - lastEndTime;
-			const int64 busyTime = pimpl->endTime - pimpl->startTime;
-
-			pimpl->diskUsage.store((double)busyTime / (double)(idleTime + busyTime));
-#endif
-		}
-
-#if 0 // Set this to true to enable defective threading (for debugging purposes)
-		wait(500);
-#else
-		else
-		{
-			wait(500);
-		}
-#endif
-
-
+		if (!pimpl->runNextJob(0))
+			pimpl->waitForNextJob(0);
 	}
 }
 
 const String SampleThreadPool::Pimpl::errorMessage("HDD overflow");
 
-} // namespace hise
\ No newline at end of file
+} // namespace hise
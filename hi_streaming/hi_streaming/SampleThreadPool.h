@@ -35,11 +35,25 @@
 
 namespace hise { using namespace juce;
 
+/** A thread pool that executes the disk streaming jobs of the sampler.
+*
+*	The pool consists of the main sample loading thread (this object) and a configurable number of additional worker threads.
+*	addJob() pushes the job into a lock free inbox and wakes up at most one sleeping worker. The workers move the jobs from the
+*	inbox into their own queues, which are sorted by the deadline of the job, so that loaders whose read buffers run out soonest
+*	are executed first. A job stays on the worker that executed it last, and a worker that runs out of jobs steals the most
+*	urgent job from the queues of the other workers.
+*
+*	Jobs that can't be executed in parallel (eg. the preloading of samples) are always executed by the main thread.
+*/
 class SampleThreadPool : public Thread
 {
 public:
 
-	SampleThreadPool();
+	/** Creates a pool with the given amount of workers (including the main thread). 
+	*
+	*	If you pass in zero, it will use NUM_STREAMING_THREADS.
+	*/
+	SampleThreadPool(int numWorkersToUse=0);
 
 	~SampleThreadPool();
 	
@@ -52,7 +66,9 @@ public:
 			name(name_),
 			queued(false),
 			running(false),
-			shouldStop(false)
+			shouldStop(false),
+			deadline(0),
+			workerIndex(-1)
 		{};
         
         virtual ~Job() { masterReference.clear(); }
@@ -65,6 +81,12 @@ public:
 
 		virtual JobStatus runJob() = 0;
 
+		/** Override this and return true if the job can be executed by any worker thread of the pool. 
+		*
+		*	By default, the jobs are executed by the main sample loading thread in the order they were added.
+		*/
+		virtual bool canRunOnAnyWorker() const noexcept { return false; }
+
 		bool shouldExit() const noexcept{ return shouldStop.load(); }
 
 		void signalJobShouldExit() { shouldStop.store(true); }
@@ -73,6 +95,17 @@ public:
 
 		bool isQueued() const noexcept{ return queued.load(); };
 
+		/** Sets the time (in high resolution ticks) until which this job must be finished. 
+		*
+		*	Call this before you add the job to the pool. If the deadline is zero, the time of the addJob() call will be used.
+		*/
+		void setDeadline(int64 deadlineInHighResolutionTicks) noexcept { deadline.store(deadlineInHighResolutionTicks); }
+
+		int64 getDeadline() const noexcept { return deadline.load(); }
+
+		/** Returns the index of the worker that executes this job (0 is the main thread) or -1 if it wasn't queued yet. */
+		int getWorkerIndex() const noexcept { return workerIndex.load(); }
+
 	protected:
 
 		Thread* getCurrentThread() { return currentThread.load(); }
@@ -92,11 +125,31 @@ public:
 
 		std::atomic<Thread*> currentThread;
 
+		std::atomic<int64> deadline;
+
+		std::atomic<int> workerIndex;
+
 		const String name;
 	};
 
+	/** Returns the average disk usage of all workers. */
 	double getDiskUsage() const noexcept;
 
+	/** Returns the disk usage of the given worker (0 is the main thread). */
+	double getDiskUsage(int workerIndex) const noexcept;
+
+	/** Returns the number of workers including the main thread. */
+	int getNumWorkers() const noexcept;
+
+	/** Returns the backend that loads the file regions of the pending streaming jobs in one batch. */
+	AsyncIOBackend& getIOBackend() noexcept;
+
+	/** Returns the cache for the streaming buffers that is shared between all loaders. */
+	StreamingBlockCache& getBlockCache() noexcept;
+
+	/** Adds a prefetch request to the AsyncIOBackend and wakes up an idle worker that passes it to the operating system. */
+	void addPrefetchRequest(const AsyncIOBackend::ReadRequest& r);
+
 	void addJob(Job* jobToAdd, bool unused);
 
 	void run() override;
@@ -0,0 +1,470 @@
+/*  ===========================================================================
+*
+*   This file is part of HISE.
+*   Copyright 2016 Christoph Hart
+*
+*   HISE is free software: you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation, either version 3 of the License, or
+*   (at your option) any later version.
+*
+*   HISE is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with HISE.  If not, see <http://www.gnu.org/licenses/>.
+*
+*   Commercial licenses for using HISE in an closed source project are
+*   available on request. Please visit the project's website to get more
+*   information about commercial licensing:
+*
+*   http://www.hise.audio/
+*
+*   HISE is based on the JUCE library,
+*   which must be separately licensed for closed source applications:
+*
+*   http://www.juce.com
+*
+*   ===========================================================================
+*/
+
+
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define HISE_INTERPOLATOR_X86 1
+#include <immintrin.h>
+#else
+#define HISE_INTERPOLATOR_X86 0
+#endif
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#define HISE_INTERPOLATOR_NEON 1
+#include <arm_neon.h>
+#else
+#define HISE_INTERPOLATOR_NEON 0
+#endif
+
+// GCC and clang only allow the intrinsics in functions that are compiled for the instruction set
+#if HISE_INTERPOLATOR_X86 && (defined(__GNUC__) || defined(__clang__))
+#define HISE_TARGET_SSE41 __attribute__((target("sse4.1")))
+#else
+#define HISE_TARGET_SSE41
+#endif
+
+namespace hise { using namespace juce;
+
+/** A table with the coefficients of a Blackman windowed sinc function with 8 taps for 256 fractional positions. */
+struct SincTable
+{
+	enum
+	{
+		NumTaps = 8,
+		NumPhases = 256
+	};
+
+	SincTable()
+	{
+		for (int phase = 0; phase <= NumPhases; phase++)
+		{
+			const double alpha = (double)phase / (double)NumPhases;
+			double sum = 0.0;
+
+			for (int k = 0; k < NumTaps; k++)
+			{
+				// the distance of the tap at (pos - 3 + k) to the read position
+				const double x = (double)(k - 3) - alpha;
+				const double u = x / (double)(NumTaps / 2);
+
+				const double sinc = std::abs(x) < 1e-9 ? 1.0 : std::sin(double_Pi * x) / (double_Pi * x);
+				const double window = std::abs(u) >= 1.0 ? 0.0 : (0.42 + 0.5 * std::cos(double_Pi * u) + 0.08 * std::cos(2.0 * double_Pi * u));
+
+				coefficients[phase][k] = (float)(sinc * window);
+				sum += sinc * window;
+			}
+
+			// Normalise the DC gain so that the interpolation doesn't change the level
+			for (int k = 0; k < NumTaps; k++)
+				coefficients[phase][k] = (float)((double)coefficients[phase][k] / sum);
+		}
+	}
+
+	static const SincTable& get()
+	{
+		static const SincTable table;
+		return table;
+	}
+
+	forcedinline const float* getCoefficients(float alpha) const noexcept
+	{
+		return coefficients[(int)(alpha * (float)NumPhases + 0.5f)];
+	}
+
+	float coefficients[NumPhases + 1][NumTaps];
+};
+
+/** Reads the samples of the voice buffer and applies the gain. */
+template <typename SignalType> struct DataReader
+{
+	forcedinline float getLeft(int index) const noexcept { return (float)inL[index] * gain; }
+	forcedinline float getRight(int index) const noexcept { return (float)inR[index] * gain; }
+
+	const SignalType* inL;
+	const SignalType* inR;
+	float gain;
+};
+
+/** Reads the samples before the start of the voice buffer from the history. */
+template <typename SignalType> struct HistoryReader
+{
+	forcedinline float getLeft(int index) const noexcept 
+	{ 
+		return index < 0 ? history.l[SamplerInterpolator::MaxNumPastSamples + index] : data.getLeft(index); 
+	}
+
+	forcedinline float getRight(int index) const noexcept 
+	{ 
+		return index < 0 ? history.r[SamplerInterpolator::MaxNumPastSamples + index] : data.getRight(index); 
+	}
+
+	DataReader<SignalType> data;
+	const SamplerInterpolator::History& history;
+};
+
+static forcedinline float interpolateHermite(float xm1, float x0, float x1, float x2, float t) noexcept
+{
+	const float c1 = 0.5f * (x1 - xm1);
+	const float c2 = xm1 - 2.5f * x0 + 2.0f * x1 - 0.5f * x2;
+	const float c3 = 0.5f * (x2 - xm1) + 1.5f * (x0 - x1);
+
+	return ((c3 * t + c2) * t + c1) * t + x0;
+}
+
+template <typename ReaderType> static forcedinline void interpolateSample(SamplerInterpolator::Mode m, const ReaderType& reader, float position, float& l, float& r) noexcept
+{
+	const int pos = (int)position;
+	const float alpha = position - (float)pos;
+
+	switch (m)
+	{
+	case SamplerInterpolator::Mode::CubicHermite:
+		l = interpolateHermite(reader.getLeft(pos - 1), reader.getLeft(pos), reader.getLeft(pos + 1), reader.getLeft(pos + 2), alpha);
+		r = interpolateHermite(reader.getRight(pos - 1), reader.getRight(pos), reader.getRight(pos + 1), reader.getRight(pos + 2), alpha);
+		break;
+	case SamplerInterpolator::Mode::Sinc:
+	{
+		const float* c = SincTable::get().getCoefficients(alpha);
+
+		l = 0.0f;
+		r = 0.0f;
+
+		for (int k = 0; k < SincTable::NumTaps; k++)
+		{
+			l += reader.getLeft(pos - 3 + k) * c[k];
+			r += reader.getRight(pos - 3 + k) * c[k];
+		}
+
+		break;
+	}
+	case SamplerInterpolator::Mode::Linear:
+	case SamplerInterpolator::Mode::numModes:
+	default:
+	{
+		const float l0 = reader.getLeft(pos);
+		const float r0 = reader.getRight(pos);
+
+		l = l0 + (reader.getLeft(pos + 1) - l0) * alpha;
+		r = r0 + (reader.getRight(pos + 1) - r0) * alpha;
+		break;
+	}
+	}
+}
+
+#if HISE_INTERPOLATOR_X86
+
+struct SSE41InterpolatorKernels
+{
+	static forcedinline HISE_TARGET_SSE41 __m128 load4(const float* data, const int* index, int offset)
+	{
+		return _mm_setr_ps(data[index[0] + offset], data[index[1] + offset], data[index[2] + offset], data[index[3] + offset]);
+	}
+
+	static forcedinline HISE_TARGET_SSE41 __m128 load4(const int16* data, const int* index, int offset)
+	{
+		return _mm_cvtepi32_ps(_mm_setr_epi32(data[index[0] + offset], data[index[1] + offset], data[index[2] + offset], data[index[3] + offset]));
+	}
+
+	/** Loads 4 consecutive samples. */
+	static forcedinline HISE_TARGET_SSE41 __m128 loadRow(const float* data) { return _mm_loadu_ps(data); }
+
+	static forcedinline HISE_TARGET_SSE41 __m128 loadRow(const int16* data)
+	{
+		return _mm_cvtepi32_ps(_mm_cvtepi16_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(data))));
+	}
+
+	static forcedinline HISE_TARGET_SSE41 __m128 hermite(__m128 xm1, __m128 x0, __m128 x1, __m128 x2, __m128 t)
+	{
+		const __m128 half = _mm_set1_ps(0.5f);
+
+		const __m128 c1 = _mm_mul_ps(half, _mm_sub_ps(x1, xm1));
+		const __m128 c2 = _mm_sub_ps(_mm_add_ps(_mm_sub_ps(xm1, _mm_mul_ps(_mm_set1_ps(2.5f), x0)), _mm_add_ps(x1, x1)), _mm_mul_ps(half, x2));
+		const __m128 c3 = _mm_add_ps(_mm_mul_ps(half, _mm_sub_ps(x2, xm1)), _mm_mul_ps(_mm_set1_ps(1.5f), _mm_sub_ps(x0, x1)));
+
+		return _mm_add_ps(_mm_mul_ps(_mm_add_ps(_mm_mul_ps(_mm_add_ps(_mm_mul_ps(c3, t), c2), t), c1), t), x0);
+	}
+
+	template <typename SignalType> static HISE_TARGET_SSE41 int process(SamplerInterpolator::Mode m, const SignalType* inL, const SignalType* inR, const float* positions, float* outL, float* outR, int numSamples, float gain)
+	{
+		const __m128 g = _mm_set1_ps(gain);
+
+		int i = 0;
+
+		if (m == SamplerInterpolator::Mode::Sinc)
+		{
+			const SincTable& table = SincTable::get();
+
+			for (; i < numSamples; i++)
+			{
+				const int pos = (int)positions[i];
+				const float* c = table.getCoefficients(positions[i] - (float)pos);
+
+				const __m128 c0 = _mm_loadu_ps(c);
+				const __m128 c1 = _mm_loadu_ps(c + 4);
+
+				const __m128 l = _mm_add_ps(_mm_mul_ps(loadRow(inL + pos - 3), c0), _mm_mul_ps(loadRow(inL + pos + 1), c1));
+				const __m128 r = _mm_add_ps(_mm_mul_ps(loadRow(inR + pos - 3), c0), _mm_mul_ps(loadRow(inR + pos + 1), c1));
+
+				// l0 + l1, l2 + l3, r0 + r1, r2 + r3 -> l, r, l, r
+				__m128 sum = _mm_hadd_ps(l, r);
+				sum = _mm_mul_ps(_mm_hadd_ps(sum, sum), g);
+
+				outL[i] = _mm_cvtss_f32(sum);
+				outR[i] = _mm_cvtss_f32(_mm_shuffle_ps(sum, sum, _MM_SHUFFLE(1, 1, 1, 1)));
+			}
+
+			return i;
+		}
+
+		alignas(16) int index[4];
+
+		for (; i + 4 <= numSamples; i += 4)
+		{
+			const __m128 p = _mm_loadu_ps(positions + i);
+			const __m128i idx = _mm_cvttps_epi32(p);
+			const __m128 alpha = _mm_sub_ps(p, _mm_cvtepi32_ps(idx));
+
+			_mm_store_si128(reinterpret_cast<__m128i*>(index), idx);
+
+			__m128 l, r;
+
+			if (m == SamplerInterpolator::Mode::CubicHermite)
+			{
+				l = hermite(load4(inL, index, -1), load4(inL, index, 0), load4(inL, index, 1), load4(inL, index, 2), alpha);
+				r = hermite(load4(inR, index, -1), load4(inR, index, 0), load4(inR, index, 1), load4(inR, index, 2), alpha);
+			}
+			else
+			{
+				const __m128 l0 = load4(inL, index, 0);
+				const __m128 r0 = load4(inR, index, 0);
+
+				l = _mm_add_ps(l0, _mm_mul_ps(_mm_sub_ps(load4(inL, index, 1), l0), alpha));
+				r = _mm_add_ps(r0, _mm_mul_ps(_mm_sub_ps(load4(inR, index, 1), r0), alpha));
+			}
+
+			_mm_storeu_ps(outL + i, _mm_mul_ps(l, g));
+			_mm_storeu_ps(outR + i, _mm_mul_ps(r, g));
+		}
+
+		return i;
+	}
+};
+
+#endif
+
+#if HISE_INTERPOLATOR_NEON
+
+/** Only the sinc kernel is vectorized for NEON, the other modes need gather operations that NEON doesn't have. */
+struct NeonInterpolatorKernels
+{
+	static forcedinline float32x4_t loadRow(const float* data) { return vld1q_f32(data); }
+	static forcedinline float32x4_t loadRow(const int16* data) { return vcvtq_f32_s32(vmovl_s16(vld1_s16(data))); }
+
+	template <typename SignalType> static int process(SamplerInterpolator::Mode m, const SignalType* inL, const SignalType* inR, const float* positions, float* outL, float* outR, int numSamples, float gain)
+	{
+		if (m != SamplerInterpolator::Mode::Sinc)
+			return 0;
+
+		const SincTable& table = SincTable::get();
+
+		for (int i = 0; i < numSamples; i++)
+		{
+			const int pos = (int)positions[i];
+			const float* c = table.getCoefficients(positions[i] - (float)pos);
+
+			const float32x4_t c0 = vld1q_f32(c);
+			const float32x4_t c1 = vld1q_f32(c + 4);
+
+			const float32x4_t l = vmlaq_f32(vmulq_f32(loadRow(inL + pos - 3), c0), loadRow(inL + pos + 1), c1);
+			const float32x4_t r = vmlaq_f32(vmulq_f32(loadRow(inR + pos - 3), c0), loadRow(inR + pos + 1), c1);
+
+			const float32x2_t sum = vpadd_f32(vadd_f32(vget_low_f32(l), vget_high_f32(l)), vadd_f32(vget_low_f32(r), vget_high_f32(r)));
+
+			outL[i] = vget_lane_f32(sum, 0) * gain;
+			outR[i] = vget_lane_f32(sum, 1) * gain;
+		}
+
+		return numSamples;
+	}
+};
+
+#endif
+
+template <typename SignalType> static int processVectorized(SamplerInterpolator::Mode m, const SignalType* inL, const SignalType* inR, const float* positions, float* outL, float* outR, int numSamples, float gain) noexcept
+{
+	using InstructionSet = hlac::SimdKernels::InstructionSet;
+
+	switch (hlac::SimdKernels::getInstructionSet())
+	{
+#if HISE_INTERPOLATOR_X86
+	// The AVX2 gathers are slower than the scalar loads of the SSE4.1 kernels, so AVX2 uses them too
+	case InstructionSet::AVX2:
+	case InstructionSet::SSE41:	return SSE41InterpolatorKernels::process(m, inL, inR, positions, outL, outR, numSamples, gain);
+#endif
+#if HISE_INTERPOLATOR_NEON
+	case InstructionSet::Neon:	return NeonInterpolatorKernels::process(m, inL, inR, positions, outL, outR, numSamples, gain);
+#endif
+	default:					return 0;
+	}
+}
+
+void SamplerInterpolator::History::clear() noexcept
+{
+	for (int i = 0; i < MaxNumPastSamples; i++)
+	{
+		l[i] = 0.0f;
+		r[i] = 0.0f;
+	}
+}
+
+template <typename SignalType> void SamplerInterpolator::History::advance(const SignalType* inL, const SignalType* inR, int numSamplesToAdvance, float gain) noexcept
+{
+	jassert(numSamplesToAdvance >= 0);
+
+	// The entry i contains the sample at (i - MaxNumPastSamples) relative to the read position.
+	// Reading index i + numSamplesToAdvance is safe because it is never smaller than the index that is written
+	for (int i = 0; i < MaxNumPastSamples; i++)
+	{
+		const int index = numSamplesToAdvance - MaxNumPastSamples + i;
+
+		l[i] = index < 0 ? l[i + numSamplesToAdvance] : (float)inL[index] * gain;
+		r[i] = index < 0 ? r[i + numSamplesToAdvance] : (float)inR[index] * gain;
+	}
+}
+
+int SamplerInterpolator::getNumPastSamples(Mode m) noexcept
+{
+	switch (m)
+	{
+	case Mode::CubicHermite:	return 1;
+	case Mode::Sinc:			return 3;
+	case Mode::Linear:
+	case Mode::numModes:
+	default:					return 0;
+	}
+}
+
+int SamplerInterpolator::getNumFutureSamples(Mode m) noexcept
+{
+	switch (m)
+	{
+	case Mode::CubicHermite:	return 2;
+	case Mode::Sinc:			return 4;
+	case Mode::Linear:
+	case Mode::numModes:
+	default:					return 1;
+	}
+}
+
+String SamplerInterpolator::getModeName(Mode m)
+{
+	switch (m)
+	{
+	case Mode::Linear:			return "Linear";
+	case Mode::CubicHermite:	return "Cubic Hermite";
+	case Mode::Sinc:			return "Sinc";
+	case Mode::numModes:
+	default:					return "";
+	}
+}
+
+template <typename SignalType> void SamplerInterpolator::process(Mode m, const SignalType* inL, const SignalType* inR, const History& history,
+																 const float* pitchData, double startIndex, double delta, 
+																 float* outL, float* outR, int numSamples, float gain) noexcept
+{
+	enum { ChunkSize = 64 };
+
+	float positions[ChunkSize];
+
+	const int numPastSamples = getNumPastSamples(m);
+	const HistoryReader<SignalType> historyReader = { { inL, inR, gain }, history };
+
+	float indexInBufferFloat = (float)startIndex;
+	int offset = 0;
+
+	while (offset < numSamples)
+	{
+		const int numThisTime = jmin<int>(ChunkSize, numSamples - offset);
+
+		if (pitchData != nullptr)
+		{
+			for (int i = 0; i < numThisTime; i++)
+			{
+				jassert(pitchData[offset + i] <= (float)MAX_SAMPLER_PITCH);
+
+				positions[i] = indexInBufferFloat;
+				indexInBufferFloat += pitchData[offset + i];
+			}
+		}
+		else
+		{
+			for (int i = 0; i < numThisTime; i++)
+				positions[i] = (float)(startIndex + (double)(offset + i) * delta);
+		}
+
+		// The first samples might need the history
+		int i = 0;
+
+		for (; i < numThisTime && (int)positions[i] < numPastSamples; i++)
+			interpolateSample(m, historyReader, positions[i], outL[offset + i], outR[offset + i]);
+
+		if (i < numThisTime)
+		{
+			const int numVectorized = processVectorized(m, inL, inR, positions + i, outL + offset + i, outR + offset + i, numThisTime - i, gain);
+
+			processScalar(m, inL, inR, positions + i + numVectorized, outL + offset + i + numVectorized, outR + offset + i + numVectorized, numThisTime - i - numVectorized, gain);
+		}
+
+		offset += numThisTime;
+	}
+}
+
+template <typename SignalType> void SamplerInterpolator::processScalar(Mode m, const SignalType* inL, const SignalType* inR, const float* positions,
+																	   float* outL, float* outR, int numSamples, float gain) noexcept
+{
+	const DataReader<SignalType> reader = { inL, inR, gain };
+
+	for (int i = 0; i < numSamples; i++)
+		interpolateSample(m, reader, positions[i], outL[i], outR[i]);
+}
+
+template void SamplerInterpolator::History::advance<float>(const float*, const float*, int, float) noexcept;
+template void SamplerInterpolator::History::advance<int16>(const int16*, const int16*, int, float) noexcept;
+
+template void SamplerInterpolator::process<float>(Mode, const float*, const float*, const History&, const float*, double, double, float*, float*, int, float) noexcept;
+template void SamplerInterpolator::process<int16>(Mode, const int16*, const int16*, const History&, const float*, double, double, float*, float*, int, float) noexcept;
+
+template void SamplerInterpolator::processScalar<float>(Mode, const float*, const float*, const float*, float*, float*, int, float) noexcept;
+template void SamplerInterpolator::processScalar<int16>(Mode, const int16*, const int16*, const float*, float*, float*, int, float) noexcept;
+
+} // namespace hise
@@ -0,0 +1,106 @@
+/*  ===========================================================================
+*
+*   This file is part of HISE.
+*   Copyright 2016 Christoph Hart
+*
+*   HISE is free software: you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation, either version 3 of the License, or
+*   (at your option) any later version.
+*
+*   HISE is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with HISE.  If not, see <http://www.gnu.org/licenses/>.
+*
+*   Commercial licenses for using HISE in an closed source project are
+*   available on request. Please visit the project's website to get more
+*   information about commercial licensing:
+*
+*   http://www.hise.audio/
+*
+*   HISE is based on the JUCE library,
+*   which must be separately licensed for closed source applications:
+*
+*   http://www.juce.com
+*
+*   ===========================================================================
+*/
+
+
+
+#ifndef SAMPLERINTERPOLATOR_H_INCLUDED
+#define SAMPLERINTERPOLATOR_H_INCLUDED
+
+namespace hise { using namespace juce;
+
+/** The resampling kernels of the StreamingSamplerVoice.
+*
+*	There are three interpolation modes: the default linear interpolation, a 4-point cubic hermite interpolation and
+*	an 8-point windowed sinc interpolation which gives the best quality if the samples are pitched.
+*
+*	The kernels are vectorized for SSE4.1 and NEON and use the runtime dispatch of the hlac::SimdKernels, so
+*	hlac::SimdKernels::setInstructionSet() can be used to compare them. AVX2 uses the SSE4.1 kernels, because the
+*	kernels read from random positions and the AVX2 gather instructions are slower than separate loads.
+*/
+struct SamplerInterpolator
+{
+	enum class Mode
+	{
+		Linear = 0,
+		CubicHermite,
+		Sinc,
+		numModes
+	};
+
+	enum
+	{
+		MaxNumPastSamples = 3
+	};
+
+	/** Stores the last samples before the current read position so that the kernels can look behind the start of the voice buffer. */
+	struct History
+	{
+		History() { clear(); }
+
+		void clear() noexcept;
+
+		/** Advances the history by the given amount of samples. The data must contain at least numSamplesToAdvance samples. */
+		template <typename SignalType> void advance(const SignalType* inL, const SignalType* inR, int numSamplesToAdvance, float gain) noexcept;
+
+		float l[MaxNumPastSamples];
+		float r[MaxNumPastSamples];
+	};
+
+	/** Returns the number of samples before the read position that are used by the mode. */
+	static int getNumPastSamples(Mode m) noexcept;
+
+	/** Returns the number of samples after the read position that are used by the mode (1 for linear interpolation). */
+	static int getNumFutureSamples(Mode m) noexcept;
+
+	static String getModeName(Mode m);
+
+	/** Resamples the stereo data. 
+	*
+	*	The read position starts at startIndex and is advanced with either the pitch values (if not nullptr) or the constant delta.
+	*	The samples before the start of the data are taken from the history. The data must contain 
+	*	getNumFutureSamples() samples after the last read position.
+	*/
+	template <typename SignalType> static void process(Mode m, const SignalType* inL, const SignalType* inR, const History& history, 
+													   const float* pitchData, double startIndex, double delta, 
+													   float* outL, float* outR, int numSamples, float gain) noexcept;
+
+	/** Interpolates the data at the given read positions without the history and the vectorized kernels. 
+	*
+	*	This is the reference implementation for all other code paths. All samples that are used by the kernel must be readable.
+	*/
+	template <typename SignalType> static void processScalar(Mode m, const SignalType* inL, const SignalType* inR, const float* positions,
+															 float* outL, float* outR, int numSamples, float gain) noexcept;
+};
+
+} // namespace hise
+
+#endif  // SAMPLERINTERPOLATOR_H_INCLUDED
@@ -0,0 +1,251 @@
+/*  ===========================================================================
+*
+*   This file is part of HISE.
+*   Copyright 2016 Christoph Hart
+*
+*   HISE is free software: you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation, either version 3 of the License, or
+*   (at your option) any later version.
+*
+*   HISE is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with HISE.  If not, see <http://www.gnu.org/licenses/>.
+*
+*   Commercial licenses for using HISE in an closed source project are
+*   available on request. Please visit the project's website to get more
+*   information about commercial licensing:
+*
+*   http://www.hise.audio/
+*
+*   HISE is based on the JUCE library,
+*   which must be separately licensed for closed source applications:
+*
+*   http://www.juce.com
+*
+*   ===========================================================================
+*/
+
+
+namespace hise { using namespace juce;
+
+struct StreamingBlockCache::Pimpl
+{
+	enum
+	{
+		SlotsPerSet = 4
+	};
+
+	struct Slot
+	{
+		Slot() :
+			state(0),
+			lastAccess(0),
+			data(false, 2, 0)
+		{};
+
+		/** Increases the reader count. Returns false if the slot is being written. */
+		bool tryAcquireForReading() noexcept
+		{
+			int s = state.load();
+
+			while (s >= 0)
+			{
+				if (state.compare_exchange_weak(s, s + 1))
+					return true;
+			}
+
+			return false;
+		}
+
+		void releaseAfterReading() noexcept { --state; }
+
+		/** Locks the slot for writing. Returns false if the slot is being read or written. */
+		bool tryAcquireForWriting() noexcept
+		{
+			int expected = 0;
+			return state.compare_exchange_strong(expected, -1);
+		}
+
+		void releaseAfterWriting() noexcept { state.store(0); }
+
+		/** -1 if the slot is being written, otherwise the number of readers. */
+		std::atomic<int> state;
+
+		std::atomic<uint32> lastAccess;
+
+		Key key;
+
+		hlac::HiseSampleBuffer data;
+	};
+
+	Pimpl(int numBlocks) :
+		accessCounter(0),
+		numHits(0),
+		numMisses(0),
+		memoryUsage(0)
+	{
+		const int numSets = (numBlocks + SlotsPerSet - 1) / SlotsPerSet;
+
+		for (int i = 0; i < numSets * SlotsPerSet; i++)
+			slots.add(new Slot());
+	}
+
+	int getFirstSlotIndex(const Key& k) const noexcept
+	{
+		const uint32 blockIndex = (uint32)(k.position / jmax<int>(1, k.numSamples));
+		const uint32 hash = k.soundId * 2654435761u ^ blockIndex * 40503u;
+		const int numSets = slots.size() / SlotsPerSet;
+
+		return (int)(hash % (uint32)numSets) * SlotsPerSet;
+	}
+
+	static int64 getNumBytes(const hlac::HiseSampleBuffer& b)
+	{
+		const int64 bytesPerSample = b.isFloatingPoint() ? sizeof(float) : sizeof(int16);
+		return (int64)b.getNumSamples() * (int64)b.getNumChannels() * bytesPerSample;
+	}
+
+	OwnedArray<Slot> slots;
+
+	std::atomic<uint32> accessCounter;
+
+	std::atomic<int64> numHits;
+	std::atomic<int64> numMisses;
+	std::atomic<int64> memoryUsage;
+};
+
+StreamingBlockCache::StreamingBlockCache(int numBlocks) :
+	pimpl(new Pimpl(numBlocks))
+{
+
+}
+
+StreamingBlockCache::~StreamingBlockCache()
+{
+	pimpl = nullptr;
+}
+
+bool StreamingBlockCache::copyBlock(const Key& k, hlac::HiseSampleBuffer& destination)
+{
+	if (!isEnabled() || k.soundId == 0 || destination.isFloatingPoint() != k.isFloatingPoint)
+		return false;
+
+	const int firstIndex = pimpl->getFirstSlotIndex(k);
+
+	for (int i = firstIndex; i < firstIndex + Pimpl::SlotsPerSet; i++)
+	{
+		auto s = pimpl->slots.getUnchecked(i);
+
+		if (!s->tryAcquireForReading())
+			continue;
+
+		const bool found = s->key == k;
+
+		if (found)
+		{
+			hlac::HiseSampleBuffer::copy(destination, s->data, 0, 0, k.numSamples);
+			s->lastAccess.store(++pimpl->accessCounter);
+		}
+
+		s->releaseAfterReading();
+
+		if (found)
+		{
+			++pimpl->numHits;
+			return true;
+		}
+	}
+
+	++pimpl->numMisses;
+	return false;
+}
+
+void StreamingBlockCache::addBlock(const Key& k, const hlac::HiseSampleBuffer& source)
+{
+	if (!isEnabled() || k.soundId == 0 || source.isFloatingPoint() != k.isFloatingPoint)
+		return;
+
+	const int firstIndex = pimpl->getFirstSlotIndex(k);
+
+	Pimpl::Slot* slotToUse = nullptr;
+
+	for (int i = firstIndex; i < firstIndex + Pimpl::SlotsPerSet; i++)
+	{
+		auto s = pimpl->slots.getUnchecked(i);
+
+		if (!s->tryAcquireForWriting())
+			continue;
+
+		// Already added by another loader
+		if (s->key == k)
+		{
+			s->releaseAfterWriting();
+
+			if (slotToUse != nullptr)
+				slotToUse->releaseAfterWriting();
+
+			return;
+		}
+
+		if (slotToUse == nullptr || s->lastAccess.load() < slotToUse->lastAccess.load())
+		{
+			if (slotToUse != nullptr)
+				slotToUse->releaseAfterWriting();
+
+			slotToUse = s;
+		}
+		else
+			s->releaseAfterWriting();
+	}
+
+	if (slotToUse == nullptr)
+		return;
+
+	auto& data = slotToUse->data;
+
+	if (data.isFloatingPoint() != k.isFloatingPoint || data.getNumChannels() != source.getNumChannels() || data.getNumSamples() < k.numSamples)
+	{
+		pimpl->memoryUsage -= Pimpl::getNumBytes(data);
+		data = hlac::HiseSampleBuffer(k.isFloatingPoint, source.getNumChannels(), k.numSamples);
+		pimpl->memoryUsage += Pimpl::getNumBytes(data);
+	}
+
+	hlac::HiseSampleBuffer::copy(data, source, 0, 0, k.numSamples);
+
+	slotToUse->key = k;
+	slotToUse->lastAccess.store(++pimpl->accessCounter);
+	slotToUse->releaseAfterWriting();
+}
+
+bool StreamingBlockCache::isEnabled() const noexcept
+{
+	return pimpl->slots.size() != 0;
+}
+
+int64 StreamingBlockCache::getNumHits() const noexcept
+{
+	return pimpl->numHits.load();
+}
+
+int64 StreamingBlockCache::getNumMisses() const noexcept
+{
+	return pimpl->numMisses.load();
+}
+
+int64 StreamingBlockCache::getMemoryUsage() const noexcept
+{
+	return pimpl->memoryUsage.load();
+}
+
+void StreamingBlockCache::resetStatistics() noexcept
+{
+	pimpl->numHits.store(0);
+	pimpl->numMisses.store(0);
+}
+
+} // namespace hise
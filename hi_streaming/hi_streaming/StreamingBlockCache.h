@@ -0,0 +1,112 @@
+/*  ===========================================================================
+*
+*   This file is part of HISE.
+*   Copyright 2016 Christoph Hart
+*
+*   HISE is free software: you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation, either version 3 of the License, or
+*   (at your option) any later version.
+*
+*   HISE is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with HISE.  If not, see <http://www.gnu.org/licenses/>.
+*
+*   Commercial licenses for using HISE in an closed source project are
+*   available on request. Please visit the project's website to get more
+*   information about commercial licensing:
+*
+*   http://www.hise.audio/
+*
+*   HISE is based on the JUCE library,
+*   which must be separately licensed for closed source applications:
+*
+*   http://www.juce.com
+*
+*   ===========================================================================
+*/
+
+
+
+#ifndef STREAMINGBLOCKCACHE_H_INCLUDED
+#define STREAMINGBLOCKCACHE_H_INCLUDED
+
+namespace hise { using namespace juce;
+
+/** A fixed size cache for the streaming buffers that were read by the SampleLoaders.
+*
+*	If multiple voices play the same StreamingSamplerSound (eg. repeated notes or unison), their loaders will request
+*	the exact same regions of the file (the streaming positions are aligned to the preload buffer and the buffer size).
+*	Instead of reading and decoding them again, the loaders copy the block from this cache.
+*
+*	The mic positions of a multimic sample are separate sounds with different audio data (and different cache ids),
+*	so they don't share any blocks.
+*
+*	The cache is lock free: every slot has a reference count that is increased while a block is copied out of it, and a
+*	slot can only be overwritten if nobody is reading it. Slots are chosen from a small set per key using the least
+*	recently used strategy.
+*/
+class StreamingBlockCache
+{
+public:
+
+	/** Identifies a block of a sound. */
+	struct Key
+	{
+		bool operator==(const Key& other) const noexcept
+		{
+			return soundId == other.soundId && position == other.position && 
+				   numSamples == other.numSamples && isFloatingPoint == other.isFloatingPoint;
+		}
+
+		/** the cache id of the sound (see StreamingSamplerSound::getCacheId()). Zero means an empty slot. */
+		uint32 soundId = 0;
+
+		/** the position of the block in the sample. */
+		int position = 0;
+
+		int numSamples = 0;
+
+		bool isFloatingPoint = false;
+	};
+
+	/** Creates a cache with the given amount of blocks. If you pass zero, the cache will be disabled. */
+	StreamingBlockCache(int numBlocks);
+
+	~StreamingBlockCache();
+
+	/** Copies the block with the given key into the buffer. Returns false if the block is not in the cache. */
+	bool copyBlock(const Key& k, hlac::HiseSampleBuffer& destination);
+
+	/** Adds the block to the cache. If all slots for the key are currently read, it will not be added. */
+	void addBlock(const Key& k, const hlac::HiseSampleBuffer& source);
+
+	/** Returns true if the cache is enabled. */
+	bool isEnabled() const noexcept;
+
+	/** Returns the number of cache hits since the last call to resetStatistics(). */
+	int64 getNumHits() const noexcept;
+
+	/** Returns the number of cache misses since the last call to resetStatistics(). */
+	int64 getNumMisses() const noexcept;
+
+	/** Returns the amount of memory that is allocated by the cache in bytes. */
+	int64 getMemoryUsage() const noexcept;
+
+	void resetStatistics() noexcept;
+
+	struct Pimpl;
+
+private:
+
+	ScopedPointer<Pimpl> pimpl;
+
+	JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(StreamingBlockCache);
+};
+
+} // namespace hise
+#endif  // STREAMINGBLOCKCACHE_H_INCLUDED
@@ -85,8 +85,11 @@ public:
 
 	virtual void decreaseNumOpenFileHandles()
 	{
-		--numOpenFileHandles;
-		if (numOpenFileHandles < 0) numOpenFileHandles = 0;
+		// The file handles are closed by multiple preload threads, so this must not go below zero in between
+		int current = numOpenFileHandles.load();
+
+		while (current > 0 && !numOpenFileHandles.compare_exchange_weak(current, current - 1))
+			;
 	}
 
 	AudioFormatManager afm;
@@ -95,7 +98,7 @@ public:
 
 private:
 
-	int numOpenFileHandles = 0;
+	std::atomic<int> numOpenFileHandles { 0 };
 
 	JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(StreamingSamplerSoundPool);
 };
@@ -139,6 +142,31 @@ struct StereoChannelData
 // Same as the preload size.
 #define BUFFER_SIZE_FOR_STREAM_BUFFERS 8192
 
+// The number of threads that are used for disk streaming (including the main sample loading thread).
+// If you set this to 0, it will use half of the available CPU cores.
+#ifndef NUM_STREAMING_THREADS
+#define NUM_STREAMING_THREADS 0
+#endif
+
+// The number of streaming buffers that are shared between the voices (see StreamingBlockCache).
+// If you set this to 0, the cache will be disabled.
+#ifndef NUM_STREAMING_CACHE_BLOCKS
+#define NUM_STREAMING_CACHE_BLOCKS 128
+#endif
+
+// The number of threads that preload the samples of a sampler (including the sample loading thread).
+// This also limits the amount of files that are read at the same time. If you set this to 0, it will use up to 4 threads.
+#ifndef NUM_PRELOAD_THREADS
+#define NUM_PRELOAD_THREADS 0
+#endif
+
+// The preload size of sounds that haven't been played yet if a sampler uses a lazy preload budget.
+// The first voice of an unpromoted sound streams from disk after this many samples, so it must cover the
+// time of the first read (about 90ms at 44.1kHz).
+#ifndef LAZY_PRELOAD_SIZE
+#define LAZY_PRELOAD_SIZE 4096
+#endif
+
 // Deactivate this to use one rounded pitch value for one a buffer (crucial for other interpolation methods than linear interpolation)
 #define USE_SAMPLE_ACCURATE_RESAMPLING 0
 
@@ -56,6 +56,8 @@ StreamingSamplerSound::StreamingSamplerSound(const String &fileNameToLoad, Strea
 	crossfadeLength(0),
 	crossfadeArea(Range<int>())
 {
+	updateCacheId();
+
 	fileReader.setFile(fileNameToLoad);
 
 	setPreloadSize(0);
@@ -81,6 +83,8 @@ StreamingSamplerSound::StreamingSamplerSound(MonolithInfoToUse *info, int channe
 	crossfadeLength(0),
 	crossfadeArea(Range<int>())
 {
+	updateCacheId();
+
 	fileReader.setMonolithicInfo(info, channelIndex, sampleIndex);
 
 	setPreloadSize(0);
@@ -133,99 +137,246 @@ void StreamingSamplerSound::setPreloadSize(int newPreloadSize, bool forceReload)
 
 	ScopedLock sl(getSampleLock());
 
-	const bool sampleDeactivated = !hasActiveState() || newPreloadSize == 0;
+	updateCacheId();
 
+	if (!initialisePreloadBuffer(newPreloadSize, true))
+		return;
 
+	preloadBuffer.clear();
 
-	if (sampleDeactivated)
+	if (loopEnabled && (loopEnd - loopStart > 0) && loopEnd < internalPreloadSize)
+		entireSampleLoaded = false;
+
+	fillPreloadBuffer(preloadBuffer, internalPreloadSize);
+}
+
+void StreamingSamplerSound::fillPreloadBuffer(hlac::HiseSampleBuffer& b, int numSamples)
+{
+	if (loopEnabled && (loopEnd - loopStart > 0) && loopEnd < numSamples)
 	{
-		internalPreloadSize = 0;
-		preloadSize = 0;
+		fileReader.readFromDisk(b, 0, loopEnd, sampleStart + monolithOffset, true);
+		const int samplesPerFillOp = (loopEnd - loopStart);
 
-		preloadBuffer = hlac::HiseSampleBuffer(!fileReader.isMonolithic(), fileReader.isStereo() ? 2 : 1, 0);
+		int numTodo = numSamples - loopEnd;
 
-		return;
-	}
+		int pos = loopEnd;
 
-	preloadSize = newPreloadSize;
+		while (numTodo > 0)
+		{
+			int numThisTime = jmin<int>(numTodo, samplesPerFillOp);
 
-	if (newPreloadSize == -1 || (preloadSize + sampleStartMod) > sampleLength)
-	{
-		internalPreloadSize = (int)sampleLength;
-		entireSampleLoaded = true;
+			hlac::HiseSampleBuffer::copy(b, b, pos, loopStart, numThisTime);
+			numTodo -= numThisTime;
+			pos += numThisTime;
+		}
 	}
 	else
 	{
-		internalPreloadSize = preloadSize + (int)sampleStartMod;
-		entireSampleLoaded = false;
+		auto samplesToRead = jmin<int>(sampleLength, numSamples);
+
+		if(samplesToRead > 0)
+			fileReader.readFromDisk(b, 0, samplesToRead, sampleStart + monolithOffset, true);
 	}
+}
 
-	internalPreloadSize = jmax(preloadSize, internalPreloadSize, 2048);
+hlac::HiseSampleBuffer StreamingSamplerSound::createPreloadBuffer(int newPreloadSize)
+{
+	const int numChannelsToUse = fileReader.isStereo() ? 2 : 1;
 
-	fileReader.openFileHandles();
+	hlac::HiseSampleBuffer b(!fileReader.isMonolithic(), numChannelsToUse, 0);
 
-	preloadBuffer = hlac::HiseSampleBuffer(!fileReader.isMonolithic(), fileReader.isStereo() ? 2 : 1, 0);
+	if (reversed || newPreloadSize == 0 || !hasActiveState())
+		return b;
+
+	ScopedLock sl(getSampleLock());
+
+	loadSampleInformation();
+
+	bool unused;
+	const int numSamples = calculateInternalPreloadSize(newPreloadSize, unused);
 
 	try
 	{
-		preloadBuffer.setSize(fileReader.isStereo() ? 2 : 1, internalPreloadSize);
+		b.setSize(numChannelsToUse, numSamples);
 	}
 	catch (std::exception e)
 	{
-		preloadBuffer.setSize(fileReader.isStereo() ? 2 : 1, 0);
-
-		throw StreamingSamplerSound::LoadingError(getFileName(), "Preload error (max memory exceeded).");
+		b.setSize(numChannelsToUse, 0);
+		return b;
 	}
 
-	if (preloadBuffer.getNumSamples() == 0)
+	b.clear();
+
+	// The content at each position doesn't depend on the preload size, so a smaller buffer can be copied
+	if (numSamples <= preloadBuffer.getNumSamples() && preloadBuffer.getNumChannels() == numChannelsToUse)
+		hlac::HiseSampleBuffer::copy(b, preloadBuffer, 0, 0, numSamples);
+	else
+		fillPreloadBuffer(b, numSamples);
+
+	return b;
+}
+
+void StreamingSamplerSound::swapPreloadBuffer(hlac::HiseSampleBuffer& newPreloadBuffer, int newPreloadSize)
+{
+	if (reversed || !hasActiveState())
+		return;
+
+	ScopedLock sl(getSampleLock());
+
+	bool loadsEntireSample;
+	const int newInternalSize = calculateInternalPreloadSize(newPreloadSize, loadsEntireSample);
+
+	if (newPreloadBuffer.getNumSamples() != newInternalSize)
 	{
+		jassertfalse;
 		return;
 	}
 
-	preloadBuffer.clear();
+	std::swap(preloadBuffer, newPreloadBuffer);
 
-	if (sampleRate <= 0.0)
+	// The old buffer might refer to the data of a PreloadCache, which is released here
+	if (preloadBufferOwner != nullptr)
 	{
-		if (AudioFormatReader *reader = fileReader.getReader())
-		{
-			sampleRate = reader->sampleRate;
-			sampleEnd = jmin<int>(sampleEnd, (int)reader->lengthInSamples);
-			sampleLength = jmax<int>(0, sampleEnd - sampleStart);
-			loopEnd = jmin(loopEnd, sampleEnd);
-		}
+		hlac::HiseSampleBuffer copy(newPreloadBuffer.isFloatingPoint(), newPreloadBuffer.getNumChannels(), 0);
+		newPreloadBuffer = std::move(copy);
+		preloadBufferOwner = nullptr;
 	}
 
+	preloadSize = newPreloadSize;
+	internalPreloadSize = newInternalSize;
+	entireSampleLoaded = loadsEntireSample;
+
 	if (loopEnabled && (loopEnd - loopStart > 0) && loopEnd < internalPreloadSize)
-	{
 		entireSampleLoaded = false;
-		int samplesToFill = internalPreloadSize;
-		
-		fileReader.readFromDisk(preloadBuffer, 0, loopEnd, sampleStart + monolithOffset, true);
-		const int samplesPerFillOp = (loopEnd - loopStart);
+}
 
-		int numTodo = internalPreloadSize - loopEnd;
+bool StreamingSamplerSound::setPreloadBufferFromCache(int newPreloadSize, const void* const* channelData, int numChannels, int numSamples, ReferenceCountedObject* dataOwner)
+{
+	if (reversed || newPreloadSize <= 0 || !hasActiveState())
+		return false;
 
-		int pos = loopEnd;
+	ScopedLock sl(getSampleLock());
 
-		while (numTodo > 0)
+	updateCacheId();
+
+	if (!initialisePreloadBuffer(newPreloadSize, false))
+		return false;
+
+	const int numChannelsToUse = fileReader.isStereo() ? 2 : 1;
+
+	// The cached buffer doesn't match anymore, so it must be read from the file
+	if (numSamples != internalPreloadSize || numChannels != numChannelsToUse)
+		return false;
+
+	if (loopEnabled && (loopEnd - loopStart > 0) && loopEnd < internalPreloadSize)
+		entireSampleLoaded = false;
+
+	preloadBuffer.setDataToReferTo(channelData, !fileReader.isMonolithic(), numChannels, numSamples);
+	preloadBufferOwner = dataOwner;
+
+	return true;
+}
+
+File StreamingSamplerSound::getSourceFile() const
+{
+	return fileReader.getSourceFile();
+}
+
+int64 StreamingSamplerSound::getPreloadCacheKey()
+{
+	{
+		ScopedLock sl(getSampleLock());
+		loadSampleInformation();
+	}
+
+	String key;
+
+	key << getSourceFile().getFullPathName() << ":" << fileReader.getFileName(true) << ":"
+		<< sampleStart << ":" << sampleEnd << ":" << sampleStartMod << ":"
+		<< (loopEnabled ? 1 : 0) << ":" << loopStart << ":" << loopEnd;
+
+	return key.hashCode64();
+}
+
+bool StreamingSamplerSound::initialisePreloadBuffer(int newPreloadSize, bool allocateBuffer)
+{
+	const bool sampleDeactivated = !hasActiveState() || newPreloadSize == 0;
+
+	if (sampleDeactivated)
+	{
+		internalPreloadSize = 0;
+		preloadSize = 0;
+
+		preloadBuffer = hlac::HiseSampleBuffer(!fileReader.isMonolithic(), fileReader.isStereo() ? 2 : 1, 0);
+		preloadBufferOwner = nullptr;
+
+		return false;
+	}
+
+	preloadSize = newPreloadSize;
+
+	internalPreloadSize = calculateInternalPreloadSize(newPreloadSize, entireSampleLoaded);
+
+	fileReader.openFileHandles();
+
+	preloadBuffer = hlac::HiseSampleBuffer(!fileReader.isMonolithic(), fileReader.isStereo() ? 2 : 1, 0);
+	preloadBufferOwner = nullptr;
+
+	if (allocateBuffer)
+	{
+		try
 		{
-			int numThisTime = jmin<int>(numTodo, samplesPerFillOp);
+			preloadBuffer.setSize(fileReader.isStereo() ? 2 : 1, internalPreloadSize);
+		}
+		catch (std::exception e)
+		{
+			preloadBuffer.setSize(fileReader.isStereo() ? 2 : 1, 0);
 
-			hlac::HiseSampleBuffer::copy(preloadBuffer, preloadBuffer, pos, loopStart, numThisTime);
-			numTodo -= numThisTime;
-			pos += numThisTime;
+			throw StreamingSamplerSound::LoadingError(getFileName(), "Preload error (max memory exceeded).");
+		}
+
+		if (preloadBuffer.getNumSamples() == 0)
+		{
+			return false;
 		}
 	}
+
+	loadSampleInformation();
+
+	return true;
+}
+
+int StreamingSamplerSound::calculateInternalPreloadSize(int newPreloadSize, bool& loadsEntireSample) const
+{
+	int newInternalSize;
+
+	if (newPreloadSize == -1 || (newPreloadSize + sampleStartMod) > sampleLength)
+	{
+		newInternalSize = (int)sampleLength;
+		loadsEntireSample = true;
+	}
 	else
 	{
-		auto samplesToRead = jmin<int>(sampleLength, internalPreloadSize);
-
-		if(samplesToRead > 0)
-			fileReader.readFromDisk(preloadBuffer, 0, samplesToRead, sampleStart + monolithOffset, true);
+		newInternalSize = newPreloadSize + (int)sampleStartMod;
+		loadsEntireSample = false;
 	}
-}
 
+	return jmax(newPreloadSize, newInternalSize, 2048);
+}
 
+void StreamingSamplerSound::loadSampleInformation()
+{
+	if (sampleRate <= 0.0)
+	{
+		if (AudioFormatReader *reader = fileReader.getReader())
+		{
+			sampleRate = reader->sampleRate;
+			sampleEnd = jmin<int>(sampleEnd, (int)reader->lengthInSamples);
+			sampleLength = jmax<int>(0, sampleEnd - sampleStart);
+			loopEnd = jmin(loopEnd, sampleEnd);
+		}
+	}
+}
 
 size_t StreamingSamplerSound::getActualPreloadSize() const
 {
@@ -507,6 +658,41 @@ bool StreamingSamplerSound::hasEnoughSamplesForBlock(int maxSampleIndexInFile) c
 	return (loopEnabled && loopLength != 0) || maxSampleIndexInFile < sampleLength;
 }
 
+bool StreamingSamplerSound::createReadRequest(int uptime, int numSamples, AsyncIOBackend::ReadRequest& r) const
+{
+	if (!isMonolithic() || entireSampleLoaded)
+		return false;
+
+	const int startSample = uptime + sampleStart;
+
+	// If the loop wraps, the rest of the samples will be read from the (already loaded) loop start.
+	const int endSample = loopEnabled ? jmin(loopEnd, sampleEnd) : sampleEnd;
+
+	numSamples = jmin(numSamples, endSample - startSample);
+
+	if (numSamples <= 0)
+		return false;
+
+	return fileReader.createReadRequest(startSample, numSamples, r);
+}
+
+void StreamingSamplerSound::prefetchForVoiceStart(SampleThreadPool* pool, int streamingBufferSize) const
+{
+	const int numPreloadSamples = preloadBuffer.getNumSamples();
+
+	AsyncIOBackend::ReadRequest r;
+
+	if (pool != nullptr && numPreloadSamples != 0 && createReadRequest(numPreloadSamples, streamingBufferSize, r))
+		pool->addPrefetchRequest(r);
+}
+
+void StreamingSamplerSound::updateCacheId() noexcept
+{
+	static std::atomic<uint32> idCounter(0);
+
+	cacheId.store(++idCounter);
+}
+
 float StreamingSamplerSound::calculatePeakValue()
 {
 	return fileReader.calculatePeakValue();
@@ -915,6 +1101,9 @@ void StreamingSamplerSound::FileReader::readFromDisk(hlac::HiseSampleBuffer &buf
 	{
 		ScopedReadLock sl(fileAccessLock);
 
+		// The workers of the SampleThreadPool might read this sound at the same time, but the reader has a file position
+		ScopedLock rl(readLock2);
+
 		if (buffer.isFloatingPoint())
 			normalReader->read(buffer.getFloatBufferForFileReader(), startSample, numSamples, readerPosition, true, true);
 		else
@@ -950,6 +1139,14 @@ float StreamingSamplerSound::FileReader::calculatePeakValue()
 }
 
 
+bool StreamingSamplerSound::FileReader::createReadRequest(int64 startSample, int numSamples, AsyncIOBackend::ReadRequest& r) const
+{
+	if (monolithicInfo == nullptr)
+		return false;
+
+	return monolithicInfo->createReadRequest(monolithicIndex, monolithicChannelIndex, startSample, numSamples, r);
+}
+
 AudioFormatReader* StreamingSamplerSound::FileReader::createMonolithicReaderForPreview()
 {
 	if (monolithicInfo != nullptr)
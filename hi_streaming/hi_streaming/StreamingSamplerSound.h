@@ -170,6 +170,13 @@ public:
 
 	bool isEntireSampleLoaded() const noexcept { return entireSampleLoaded; };
 
+	/** Returns the id of this sound for the StreamingBlockCache.
+	*
+	*	It is unique across all sounds and changes whenever a property that affects the streamed data is modified, so
+	*	outdated blocks will never be used.
+	*/
+	uint32 getCacheId() const noexcept { return cacheId.load(); }
+
 	// ==============================================================================================================================================
 
 	/** Set the preload size.
@@ -179,6 +186,34 @@ public:
 	*/
 	void setPreloadSize(int newPreloadSizeInSamples, bool forceReload = false);
 
+	/** Sets the preload size and uses the given (already decoded) data as preload buffer instead of reading it from the file.
+	*
+	*	The data is not copied, so the dataOwner will be kept alive until the preload buffer is reloaded. The data must have the
+	*	storage format of the preload buffer (16 bit integers for monoliths and floats otherwise). If the size or channel amount 
+	*	doesn't match the current settings, it returns false and you need to call setPreloadSize() instead.
+	*/
+	bool setPreloadBufferFromCache(int newPreloadSizeInSamples, const void* const* channelData, int numChannels, int numSamples, ReferenceCountedObject* dataOwner);
+
+	/** Creates a preload buffer for the given preload size without changing the sound.
+	*
+	*	The samples are copied from the current preload buffer if it is big enough, otherwise they are read from the file.
+	*	It returns an empty buffer if the sound is reversed or deactivated. Use swapPreloadBuffer() to apply the new buffer.
+	*/
+	hlac::HiseSampleBuffer createPreloadBuffer(int newPreloadSizeInSamples);
+
+	/** Replaces the preload buffer with a buffer that was created by createPreloadBuffer() for the same preload size.
+	*
+	*	The old preload buffer is moved into the given buffer, so you can deallocate it later. This doesn't allocate or read
+	*	anything, but the voices refer to the preload buffer directly, so no voice must play this sound while you call it.
+	*/
+	void swapPreloadBuffer(hlac::HiseSampleBuffer& newPreloadBuffer, int newPreloadSizeInSamples);
+
+	/** Returns a hash of all properties that change the content of the preload buffer.
+	*
+	*	The sample range depends on the file length, so this opens the file if it wasn't loaded before.
+	*/
+	int64 getPreloadCacheKey();
+
 	/** Returns the size of the preload buffer in bytes. You can use this method to check how much memory the sound uses. It also includes the memory used for the crossfade buffer. */
 	size_t getActualPreloadSize() const;
 
@@ -199,6 +234,16 @@ public:
 	bool isOpened();
 
 	bool isMonolithic() const;
+
+	/** Returns the monolith that this sound is read from or nullptr if it has its own file.
+	*
+	*	The sounds of a monolith share the reader of a channel, so they must not be loaded at the same time.
+	*/
+	const void* getSharedMonolith() const noexcept { return fileReader.getSharedMonolith(); }
+
+	/** Returns the file that is read by this sound (for monolithic sounds this is the file of the mic position). */
+	File getSourceFile() const;
+
 	AudioFormatReader* createReaderForPreview();
 
 	AudioFormatReader* createReaderForAnalysis();
@@ -243,6 +288,12 @@ public:
 	*/
 	bool hasEnoughSamplesForBlock(int maxSampleIndexInFile) const;
 
+	/** Creates a request for the AsyncIOBackend that loads the file region which is needed for the given streaming position.
+	*
+	*	Returns false if the region can't be loaded in advance (this is currently only supported for uncompressed monoliths).
+	*/
+	bool createReadRequest(int uptime, int numSamples, AsyncIOBackend::ReadRequest& r) const;
+
 	/** Returns read only access to the preload buffer.
 	*
 	*	This is used by the SampleLoader class to fetch the samples from the preloaded buffer until the disk streaming
@@ -256,6 +307,13 @@ public:
 		return preloadBuffer;
 	}
 
+	/** Passes the first streaming region after the preload buffer to the pool as prefetch request.
+	*
+	*	This is called on the audio thread for the voices that will be started in the next block. The request is pushed
+	*	into a lock free queue, so it doesn't lock or allocate.
+	*/
+	void prefetchForVoiceStart(SampleThreadPool* pool, int streamingBufferSize) const;
+
 	// ==============================================================================================================================================
 
 	/** Scans the file for the max level. */
@@ -324,6 +382,10 @@ private:
 		bool isOpened() const noexcept { return fileHandlesOpen; }
 		bool isMonolithic() const noexcept { return monolithicInfo != nullptr; }
 
+		const void* getSharedMonolith() const noexcept { return monolithicInfo.get(); }
+
+		File getSourceFile() const { return monolithicInfo != nullptr ? monolithicInfo->getFile(monolithicChannelIndex) : loadedFile; }
+
 		bool isStereo() const noexcept;
 
 		bool isMissing() const { return missing; }
@@ -368,6 +430,8 @@ private:
 
 		void wakeSound();
 
+		bool createReadRequest(int64 startSample, int numSamples, AsyncIOBackend::ReadRequest& r) const;
+
 		float calculatePeakValue();
 
 		AudioFormatReader* createMonolithicReaderForPreview();
@@ -420,6 +484,18 @@ private:
 	void loopChanged();
 	void lengthChanged();
 
+	/** Sets the preload size and prepares the preload buffer. Returns false if there is nothing to load. */
+	bool initialisePreloadBuffer(int newPreloadSize, bool allocateBuffer);
+
+	/** Reads the sample rate and length from the file if they are not known yet. */
+	void loadSampleInformation();
+
+	/** Returns the amount of samples the preload buffer needs for the given preload size. */
+	int calculateInternalPreloadSize(int newPreloadSize, bool& loadsEntireSample) const;
+
+	/** Fills the first numSamples of the buffer with the start of the sample (and the loop if it fits into the buffer). */
+	void fillPreloadBuffer(hlac::HiseSampleBuffer& b, int numSamples);
+
 	/** This fills the supplied AudioSampleBuffer with samples.
 	*
 	*	It copies the samples either from the preload buffer or reads it directly from the file, so don't call this method from the
@@ -443,6 +519,10 @@ private:
 	friend class SampleLoader;
 
 	hlac::HiseSampleBuffer preloadBuffer;
+
+	// keeps the data alive if the preload buffer refers to a PreloadCache
+	ReferenceCountedObjectPtr<ReferenceCountedObject> preloadBufferOwner;
+
 	double sampleRate;
 
 	int monolithOffset;
@@ -452,6 +532,10 @@ private:
 
 	bool useSmallLoopBuffer = false;
 
+	void updateCacheId() noexcept;
+
+	std::atomic<uint32> cacheId { 0 };
+
 	int preloadSize;
 	int internalPreloadSize;
 
@@ -118,6 +118,8 @@ void SampleLoader::startNote(StreamingSamplerSound const *s, int startTime)
 
 	voiceCounterWasIncreased = false;
 
+	lastPrefetchPosition = -1;
+
 	entireSampleIsLoaded = s->isEntireSampleLoaded();
 
 	if (!entireSampleIsLoaded)
@@ -163,9 +165,21 @@ void SampleLoader::clearLoader()
 
 double SampleLoader::getDiskUsage() noexcept
 {
-	const double returnValue = (double)diskUsage.get();
+	const double loaderUsage = (double)diskUsage.get();
 	diskUsage = 0.0f;
-	return returnValue;
+
+	const int numWorkers = backgroundPool->getNumWorkers();
+
+	double totalUsage = 0.0;
+
+	for (int i = 0; i < numWorkers; i++)
+		totalUsage += backgroundPool->getDiskUsage(i);
+
+	if (totalUsage <= 0.0)
+		return loaderUsage / (double)numWorkers;
+
+	// A worker that is busier than the others gets a bigger weight, so it isn't hidden by the idle workers
+	return loaderUsage * backgroundPool->getDiskUsage(getWorkerIndex()) / totalUsage;
 }
 
 void SampleLoader::setStreamingBufferDataType(bool shouldBeFloat)
@@ -293,6 +307,33 @@ bool SampleLoader::advanceReadIndex(double uptime)
 	return true;
 }
 
+void SampleLoader::setPredictedReadPosition(double uptimeAfterNextBlock)
+{
+	if (entireSampleIsLoaded)
+		return;
+
+	// The write buffer contains the region at positionInSampleFile, so the next request will be the region after it.
+	const int nextPosition = positionInSampleFile + getNumSamplesForStreamingBuffers();
+
+	if (nextPosition == lastPrefetchPosition)
+		return;
+
+	const double predictedReadIndex = uptimeAfterNextBlock - lastSwapPosition;
+
+	if (predictedReadIndex < (double)readBuffer.get()->getNumSamples() * 0.5)
+		return;
+
+	lastPrefetchPosition = nextPosition;
+
+	if (const StreamingSamplerSound* localSound = sound.get())
+	{
+		AsyncIOBackend::ReadRequest r;
+
+		if (localSound->createReadRequest(nextPosition, getNumSamplesForStreamingBuffers(), r))
+			backgroundPool->addPrefetchRequest(r);
+	}
+}
+
 int SampleLoader::getNumSamplesForStreamingBuffers() const
 {
 	jassert(b1.getNumSamples() == b2.getNumSamples());
@@ -300,8 +341,25 @@ int SampleLoader::getNumSamplesForStreamingBuffers() const
 	return b1.getNumSamples();
 }
 
+void SampleLoader::updateDeadline()
+{
+	int64 deadline = Time::getHighResolutionTicks();
+
+	if (playbackSpeed > 0.0)
+	{
+		const double numSamplesLeft = jmax<double>(0.0, (double)readBuffer.get()->getNumSamples() - readIndexDouble);
+		const double secondsLeft = numSamplesLeft / playbackSpeed;
+
+		deadline += (int64)(secondsLeft * (double)Time::getHighResolutionTicksPerSecond());
+	}
+
+	setDeadline(deadline);
+}
+
 bool SampleLoader::requestNewData()
 {
+	updateDeadline();
+
 #if KILL_VOICES_WHEN_STREAMING_IS_BLOCKED
 	if (this->isQueued())
 	{
@@ -313,15 +371,28 @@ bool SampleLoader::requestNewData()
 	}
 	else
 	{
+		addReadRequest();
 		backgroundPool->addJob(this, false);
 		return true;
 	}
 #else
+	addReadRequest();
 	backgroundPool->addJob(this, false);
 	return true;
 #endif
 };
 
+void SampleLoader::addReadRequest()
+{
+	if (const StreamingSamplerSound* localSound = sound.get())
+	{
+		AsyncIOBackend::ReadRequest r;
+
+		if (localSound->createReadRequest(positionInSampleFile, getNumSamplesForStreamingBuffers(), r))
+			backgroundPool->getIOBackend().addReadRequest(r);
+	}
+}
+
 
 SampleThreadPoolJob::JobStatus SampleLoader::runJob()
 {
@@ -375,9 +446,23 @@ void SampleLoader::fillInactiveBuffer()
 
 	if (localSound != nullptr)
 	{
-		if (localSound->hasEnoughSamplesForBlock(positionInSampleFile + getNumSamplesForStreamingBuffers()))
+		auto& blockCache = backgroundPool->getBlockCache();
+
+		StreamingBlockCache::Key key;
+
+		key.soundId = localSound->getCacheId();
+		key.position = positionInSampleFile;
+		key.numSamples = getNumSamplesForStreamingBuffers();
+		key.isFloatingPoint = writeBuffer.get()->isFloatingPoint();
+
+		if (blockCache.copyBlock(key, *writeBuffer.get()))
+		{
+			// Another voice has already read this block
+		}
+		else if (localSound->hasEnoughSamplesForBlock(positionInSampleFile + getNumSamplesForStreamingBuffers()))
 		{
 			localSound->fillSampleBuffer(*writeBuffer.get(), getNumSamplesForStreamingBuffers(), (int)positionInSampleFile);
+			blockCache.addBlock(key, *writeBuffer.get());
 		}
 		else if (localSound->hasEnoughSamplesForBlock(positionInSampleFile))
 		{
@@ -387,6 +472,7 @@ void SampleLoader::fillInactiveBuffer()
 			localSound->fillSampleBuffer(*writeBuffer.get(), numSamplesToFill, (int)positionInSampleFile);
 
 			writeBuffer.get()->clear(numSamplesToFill, numSamplesToClear);
+			blockCache.addBlock(key, *writeBuffer.get());
 		}
 		else
 		{
@@ -478,13 +564,6 @@ void StreamingSamplerVoice::startNote(int /*midiNoteNumber*/,
 
 	if (sound != nullptr && sound->getSampleLength() > 0)
 	{
-		loader.startNote(sound, sampleStartModValue);
-
-		jassert(sound != nullptr);
-		sound->wakeSound();
-
-		voiceUptime = (double)sampleStartModValue;
-
 		// You have to call setPitchFactor() before startNote().
 		jassert(uptimeDelta != 0.0);
 
@@ -494,6 +573,16 @@ void StreamingSamplerVoice::startNote(int /*midiNoteNumber*/,
 
 		constUptimeDelta = uptimeDelta;
 
+		loader.setPlaybackSpeed(uptimeDelta * getSampleRate());
+		loader.startNote(sound, sampleStartModValue);
+
+		jassert(sound != nullptr);
+		sound->wakeSound();
+
+		voiceUptime = (double)sampleStartModValue;
+
+		history.clear();
+
 		isActive = true;
 
 	}
@@ -525,59 +614,6 @@ void StreamingSamplerVoice::setDebugLogger(DebugLogger* newLogger)
 	loader.setLogger(logger);
 }
 
-template <typename SignalType> void interpolateStereoSamples(const SignalType* inL, const SignalType* inR, const float* pitchData, float* outL, float* outR, int startSample, double indexInBuffer, double uptimeDelta, int numSamples, bool isFloat)
-{
-	const float gainFactor = isFloat ? 1.0f : (1.0f / (float)INT16_MAX);
-
-	if (pitchData != nullptr)
-	{
-		pitchData += startSample;
-
-		float indexInBufferFloat = (float)indexInBuffer;
-
-		for (int i = 0; i < numSamples; i++)
-		{
-			const int pos = int(indexInBufferFloat);
-			const float alpha = indexInBufferFloat - (float)pos;
-			const float invAlpha = 1.0f - alpha;
-
-			float l = ((float)inL[pos] * invAlpha + (float)inL[pos + 1] * alpha);
-			float r = ((float)inR[pos] * invAlpha + (float)inR[pos + 1] * alpha);
-
-			outL[i] = l * gainFactor;
-			outR[i] = r * gainFactor;
-
-			jassert(*pitchData <= (float)MAX_SAMPLER_PITCH);
-
-			indexInBufferFloat += pitchData[i];
-		}
-	}
-	else
-	{
-
-		float indexInBufferFloat = (float)indexInBuffer;
-		const float uptimeDeltaFloat = (float)uptimeDelta;
-
-		while (numSamples > 0)
-		{
-			const int pos = int(indexInBufferFloat);
-			const float alpha = indexInBufferFloat - (float)pos;
-			const float invAlpha = 1.0f - alpha;
-
-			float l = ((float)inL[pos] * invAlpha + (float)inL[pos + 1] * alpha);
-			float r = ((float)inR[pos] * invAlpha + (float)inR[pos + 1] * alpha);
-
-			*outL++ = l * gainFactor;
-			*outR++ = r * gainFactor;
-
-			indexInBufferFloat += uptimeDeltaFloat;
-
-			numSamples--;
-		}
-	}
-}
-
-
 void StreamingSamplerVoice::renderNextBlock(AudioSampleBuffer &outputBuffer, int startSample, int numSamples)
 {
 	const StreamingSamplerSound *sound = loader.getLoadedSound();
@@ -599,8 +635,10 @@ void StreamingSamplerVoice::renderNextBlock(AudioSampleBuffer &outputBuffer, int
 
 		//tempVoiceBuffer->clear();
 
-		// Copy the not resampled values into the voice buffer.
-		StereoChannelData data = loader.fillVoiceBuffer(*tempVoiceBuffer, pitchCounter + startAlpha);
+		const SamplerInterpolator::Mode mode = interpolationMode;
+
+		// Copy the not resampled values into the voice buffer (including the samples after the last read position).
+		StereoChannelData data = loader.fillVoiceBuffer(*tempVoiceBuffer, pitchCounter + startAlpha + (double)(SamplerInterpolator::getNumFutureSamples(mode) - 1));
 
 		float* outL = outputBuffer.getWritePointer(0, startSample);
 		float* outR = outputBuffer.getWritePointer(1, startSample);
@@ -615,20 +653,28 @@ void StreamingSamplerVoice::renderNextBlock(AudioSampleBuffer &outputBuffer, int
 
 		double indexInBuffer = startAlpha;
 
+		const float* pitchDataForBlock = pitchData != nullptr ? pitchData + startSample : nullptr;
+
+		// The history must contain the samples before the read position of the next block
+		const int numSamplesToAdvance = (int)(startAlpha + pitchCounter);
+
 		if (data.isFloatingPoint)
 		{
 			const float* const inL = static_cast<const float*>(data.leftChannel);
 			const float* const inR = static_cast<const float*>(data.rightChannel);
 
-			interpolateStereoSamples(inL, inR, pitchData, outL, outR, startSample, indexInBuffer, uptimeDelta, numSamples, true);
+			SamplerInterpolator::process(mode, inL, inR, history, pitchDataForBlock, indexInBuffer, uptimeDelta, outL, outR, numSamples, 1.0f);
+			history.advance(inL, inR, numSamplesToAdvance, 1.0f);
 		}
 		else
 		{
 			const int16* const inL = static_cast<const int16*>(data.leftChannel);
 			const int16* const inR = static_cast<const int16*>(data.rightChannel);
 
-			interpolateStereoSamples(inL, inR, pitchData, outL, outR, startSample, indexInBuffer, uptimeDelta, numSamples, false);
+			const float gainFactor = 1.0f / (float)INT16_MAX;
 
+			SamplerInterpolator::process(mode, inL, inR, history, pitchDataForBlock, indexInBuffer, uptimeDelta, outL, outR, numSamples, gainFactor);
+			history.advance(inL, inR, numSamplesToAdvance, gainFactor);
 		}
 
 #if USE_SAMPLE_DEBUG_COUNTER 
@@ -650,6 +696,9 @@ void StreamingSamplerVoice::renderNextBlock(AudioSampleBuffer &outputBuffer, int
 		voiceUptime += pitchCounter;
 #endif
 
+		if (numSamplesFixed > 0)
+			loader.setPlaybackSpeed(pitchCounter / (double)numSamplesFixed * getSampleRate());
+
 		if (!loader.advanceReadIndex(voiceUptime))
 		{
 #if LOG_SAMPLE_RENDERING
@@ -662,6 +711,9 @@ void StreamingSamplerVoice::renderNextBlock(AudioSampleBuffer &outputBuffer, int
 			return;
 		}
 
+		// Assume that the next block consumes the same amount of samples
+		loader.setPredictedReadPosition(voiceUptime + pitchCounter);
+
 		const bool enoughSamples = sound->hasEnoughSamplesForBlock((int)(voiceUptime));// +numSamples * MAX_SAMPLER_PITCH));
 
 #if LOG_SAMPLE_RENDERING
@@ -732,9 +784,12 @@ void StreamingSamplerVoice::initTemporaryVoiceBuffer(hlac::HiseSampleBuffer* buf
 	// The channel amount must be set correctly in the constructor
 	jassert(bufferToUse->getNumChannels() > 0);
 
-	if (bufferToUse->getNumSamples() < samplesPerBlock*MAX_SAMPLER_PITCH)
+	// The interpolation kernels need a few samples after the last read position
+	const int numSamplesToAllocate = samplesPerBlock * MAX_SAMPLER_PITCH + 8;
+
+	if (bufferToUse->getNumSamples() < numSamplesToAllocate)
 	{
-		bufferToUse->setSize(bufferToUse->getNumChannels(), samplesPerBlock*MAX_SAMPLER_PITCH);
+		bufferToUse->setSize(bufferToUse->getNumChannels(), numSamplesToAllocate);
 		bufferToUse->clear();
 	}
 }
@@ -759,9 +814,9 @@ SampleThreadPool::Job::JobStatus SampleLoader::Unmapper::runJob()
 {
 	jassert(sound != nullptr);
 
+	// The loader might still be running on another worker thread
 	if (loader->isRunning())
 	{
-		jassertfalse;
 		return SampleThreadPoolJob::jobNeedsRunningAgain;
 	}
 
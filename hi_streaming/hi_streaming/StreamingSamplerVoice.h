@@ -69,6 +69,9 @@ public:
 	*/
 	JobStatus runJob() override;
 
+	/** The loaders can be executed by any worker of the SampleThreadPool. */
+	bool canRunOnAnyWorker() const noexcept override { return true; }
+
 	size_t getActualStreamingBufferSize() const;
 
 	void setStreamingBufferDataType(bool shouldBeFloat);
@@ -87,6 +90,20 @@ public:
 	/** Returns the loaded sound. */
 	inline const StreamingSamplerSound *getLoadedSound() const { return sound.get(); };
 
+	/** Sets the speed in which the voice consumes the samples (in source samples per second).
+	*
+	*	This is used to calculate the deadline of the refill requests so that the SampleThreadPool can prioritise
+	*	loaders that run out of data soonest.
+	*/
+	void setPlaybackSpeed(double sourceSamplesPerSecond) noexcept { playbackSpeed = sourceSamplesPerSecond; }
+
+	/** Publishes the position the voice will have reached after the next block.
+	*
+	*	If this position is beyond the middle of the read buffer, the region after the currently loading buffer will be
+	*	passed to the SampleThreadPool as prefetch request, so that it is already in the page cache when it is requested.
+	*/
+	void setPredictedReadPosition(double uptimeAfterNextBlock);
+
 	class Unmapper : public SampleThreadPoolJob
 	{
 	public:
@@ -103,6 +120,8 @@ public:
 
 		JobStatus runJob() override;
 
+		bool canRunOnAnyWorker() const noexcept override { return true; }
+
 	private:
 
 		StreamingSamplerSound *sound;
@@ -117,7 +136,9 @@ public:
 	/** Calculates and returns the disk usage.
 	*
 	*	It measures the time the background thread needed for the loading operation and divides it with the duration since the last
-	*	call to requestNewData().
+	*	call to requestNewData(). The value is weighted with the load of the pool worker that executed the loader, so
+	*	the sum over all voices is the load of the workers weighted by their own load: an evenly loaded pool reports its
+	*	average load, but a single saturated worker reports 100% even if the other workers are idle.
 	*/
 	double getDiskUsage() noexcept;;
 
@@ -136,6 +157,10 @@ private:
 
 	bool requestNewData();
 
+	void updateDeadline();
+
+	void addReadRequest();
+
 	bool swapBuffers();
 
 	void fillInactiveBuffer();
@@ -159,6 +184,8 @@ private:
 
 	double lastSwapPosition = 0.0;
 
+	double playbackSpeed = 0.0;
+
 	Atomic<StreamingSamplerSound const *> sound;
 
 	int readIndex;
@@ -167,6 +194,8 @@ private:
 
 	int positionInSampleFile;
 
+	int lastPrefetchPosition = -1;
+
 	bool isReadingFromPreloadBuffer;
 
 	bool entireSampleIsLoaded;
@@ -285,6 +314,11 @@ public:
 	/** Set this to false if you're using HLAC compressed monoliths. */
 	void setStreamingBufferDataType(bool shouldBeFloat);
 
+	/** Sets the interpolation that is used for resampling the sound. */
+	void setInterpolationMode(SamplerInterpolator::Mode newMode) noexcept { interpolationMode = newMode; }
+
+	SamplerInterpolator::Mode getInterpolationMode() const noexcept { return interpolationMode; }
+
 private:
 
 	double pitchCounter = 0.0;
@@ -307,6 +341,11 @@ private:
 
 	DebugLogger* logger = nullptr;
 
+	SamplerInterpolator::Mode interpolationMode = SamplerInterpolator::Mode::Linear;
+
+	// the samples before the current read position for the interpolation kernels
+	SamplerInterpolator::History history;
+
 	SampleLoader loader;
 };
 
@@ -0,0 +1,1011 @@
+/*  ===========================================================================
+*
+*   This file is part of HISE.
+*   Copyright 2016 Christoph Hart
+*
+*   HISE is free software: you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation, either version 3 of the License, or
+*   (at your option) any later version.
+*
+*   HISE is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with HISE.  If not, see <http://www.gnu.org/licenses/>.
+*
+*   Commercial licenses for using HISE in an closed source project are
+*   available on request. Please visit the project's website to get more
+*   information about commercial licensing:
+*
+*   http://www.hise.audio/
+*
+*   HISE is based on the JUCE library,
+*   which must be separately licensed for closed source applications:
+*
+*   http://www.juce.com
+*
+*   ===========================================================================
+*/
+
+
+
+#include "AppConfig.h"
+
+#if HI_RUN_UNIT_TESTS
+
+#include  "JuceHeader.h"
+
+#if JUCE_LINUX
+#include <fcntl.h>
+#endif
+
+using namespace hise;
+
+class StreamingUnitTests : public UnitTest
+{
+public:
+
+	StreamingUnitTests() :
+		UnitTest("Testing streaming classes")
+	{
+
+	}
+
+	void runTest() override
+	{
+		testIOBackends(64);
+		testIOBackends(256);
+		testIOBackends(1024);
+		testPrefetchRequests(256);
+		testMultiProducerQueue();
+		testWorkerQueues();
+		testOpenFileHandleCounter();
+		testBlockCache(false);
+		testBlockCache(true);
+		testPreloadCache();
+		testPreloadBufferSwap(false);
+		testPreloadBufferSwap(true);
+	}
+
+private:
+
+	struct QueueProducer : public Thread
+	{
+		QueueProducer(MultiProducerQueue<int, 256>& q_, int offset_) :
+			Thread("Queue Producer"),
+			q(q_),
+			offset(offset_)
+		{};
+
+		void run() override
+		{
+			for (int i = 0; i < NumValues; i++)
+			{
+				// Don't spin if the queue is full, the consumer might run on the same core
+				while (!q.push(offset + i))
+				{
+					if (threadShouldExit())
+						return;
+
+					wait(1);
+				}
+			}
+		}
+
+		enum
+		{
+			NumValues = 20000
+		};
+
+		MultiProducerQueue<int, 256>& q;
+		const int offset;
+	};
+
+	struct PoolTestJob : public SampleThreadPool::Job
+	{
+		PoolTestJob(bool parallel_) :
+			Job("Test Job"),
+			parallel(parallel_)
+		{};
+
+		JobStatus runJob() override
+		{
+			executingThread = getCurrentThread();
+
+			// Keep the worker busy so that the other workers have to take over the queued jobs
+			Thread::sleep(1);
+
+			return --numRunsLeft > 0 ? jobNeedsRunningAgain : jobHasFinished;
+		}
+
+		bool canRunOnAnyWorker() const noexcept override { return parallel; }
+
+		const bool parallel;
+		std::atomic<int> numRunsLeft{ 3 };
+		Thread* executingThread = nullptr;
+	};
+
+	/** Opens and closes file handles like the preload threads. */
+	struct FileHandleThread : public Thread
+	{
+		FileHandleThread(StreamingSamplerSoundPool& pool_, bool onlyClose_) :
+			Thread("File Handle Thread"),
+			pool(pool_),
+			onlyClose(onlyClose_)
+		{};
+
+		void run() override
+		{
+			for (int i = 0; i < 20000; i++)
+			{
+				if (!onlyClose)
+					pool.increaseNumOpenFileHandles();
+
+				pool.decreaseNumOpenFileHandles();
+
+				if (pool.getNumOpenFileHandles() < 0)
+					wentNegative = true;
+			}
+		}
+
+		StreamingSamplerSoundPool& pool;
+		const bool onlyClose;
+		bool wentNegative = false;
+	};
+
+	void testOpenFileHandleCounter()
+	{
+		beginTest("Testing the open file handle counter with multiple threads");
+
+		for (int i = 0; i < 2; i++)
+		{
+			const bool onlyClose = i == 0;
+
+			StreamingSamplerSoundPool pool;
+			OwnedArray<FileHandleThread> threads;
+
+			for (int t = 0; t < 4; t++)
+				threads.add(new FileHandleThread(pool, onlyClose))->startThread();
+
+			for (auto t : threads)
+				t->waitForThreadToExit(-1);
+
+			for (auto t : threads)
+				expect(!t->wentNegative, "The counter went below zero");
+
+			expectEquals<int>(pool.getNumOpenFileHandles(), 0, onlyClose ? "Closing only" : "Opening and closing");
+		}
+	}
+
+	void testWorkerQueues()
+	{
+		beginTest("Testing worker queues");
+
+		SampleThreadPool pool(4);
+
+		expectEquals<int>(pool.getNumWorkers(), 4);
+
+		OwnedArray<PoolTestJob> jobs;
+
+		for (int i = 0; i < 64; i++)
+			pool.addJob(jobs.add(new PoolTestJob(i % 8 != 0)), false);
+
+		const double timeout = Time::getMillisecondCounterHiRes() + 10000.0;
+
+		auto isDone = [&jobs]()
+		{
+			for (auto j : jobs)
+			{
+				if (j->isQueued())
+					return false;
+			}
+
+			return true;
+		};
+
+		while (!isDone() && Time::getMillisecondCounterHiRes() < timeout)
+			Thread::sleep(5);
+
+		expect(isDone(), "Not all jobs were executed");
+
+		Array<Thread*> parallelThreads;
+
+		for (auto j : jobs)
+		{
+			expectEquals<int>(j->numRunsLeft.load(), 0, "The job wasn't executed again");
+
+			if (j->parallel)
+				parallelThreads.addIfNotAlreadyThere(j->executingThread);
+			else
+				expect(j->executingThread == &pool, "A main thread job was executed by a worker");
+		}
+
+		expect(parallelThreads.size() > 1, "The parallel jobs weren't distributed");
+	}
+
+	void testMultiProducerQueue()
+	{
+		beginTest("Testing multi producer queue");
+
+		ScopedPointer<MultiProducerQueue<int, 256>> q = new MultiProducerQueue<int, 256>();
+
+		int value = 0;
+
+		expect(q->isEmpty());
+		expect(!q->pop(value), "Empty queue returned a value");
+
+		for (int i = 0; i < 256; i++)
+			expect(q->push(i), "Queue is full too early");
+
+		expect(!q->push(256), "Full queue accepted a value");
+
+		for (int i = 0; i < 256; i++)
+		{
+			q->pop(value);
+			expectEquals<int>(value, i, "Wrong order");
+		}
+
+		expect(q->isEmpty());
+
+		const int numProducers = 4;
+
+		OwnedArray<QueueProducer> producers;
+
+		for (int i = 0; i < numProducers; i++)
+			producers.add(new QueueProducer(*q, i * QueueProducer::NumValues));
+
+		for (auto p : producers)
+			p->startThread();
+
+		// Every producer must deliver its values in order
+		Array<int> lastValues;
+		lastValues.insertMultiple(0, -1, numProducers);
+
+		int numReceived = 0;
+		bool orderIsCorrect = true;
+		const double timeout = Time::getMillisecondCounterHiRes() + 10000.0;
+
+		while (numReceived < numProducers * QueueProducer::NumValues && Time::getMillisecondCounterHiRes() < timeout)
+		{
+			if (!q->pop(value))
+			{
+				Thread::yield();
+				continue;
+			}
+
+			const int producerIndex = value / QueueProducer::NumValues;
+
+			orderIsCorrect &= value > lastValues[producerIndex];
+			lastValues.set(producerIndex, value);
+			numReceived++;
+		}
+
+		for (auto p : producers)
+			p->stopThread(1000);
+
+		expectEquals<int>(numReceived, numProducers * QueueProducer::NumValues, "Values were lost");
+		expect(orderIsCorrect, "Values of one producer were reordered");
+		expect(q->isEmpty());
+	}
+
+	/** Creates a file that looks like an uncompressed stereo monolith with one region per stream. */
+	void createTestFile(const File& f, int numStreams)
+	{
+		FileOutputStream fos(f);
+
+		fos.writeByte(0);
+
+		HeapBlock<int16> data(STREAM_BUFFER_SIZE * 2);
+
+		for (int i = 0; i < numStreams; i++)
+		{
+			for (int j = 0; j < STREAM_BUFFER_SIZE * 2; j++)
+				data[j] = (int16)r.nextInt(Range<int>(INT16_MIN, INT16_MAX));
+
+			fos.write(data, STREAM_BUFFER_SIZE * 2 * sizeof(int16));
+		}
+
+		fos.flush();
+	}
+
+	/** Removes the file from the page cache so that both backends have to read from the disk. */
+	void evictFromCache(const File& f)
+	{
+#if JUCE_LINUX
+		const int fd = AsyncIOBackend::openFileDescriptor(f);
+		posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+		AsyncIOBackend::closeFileDescriptor(fd);
+#else
+		ignoreUnused(f);
+#endif
+	}
+
+	/** Copies the region of every stream out of the memory mapped file (this is what the monolith readers do). */
+	int64 readStreams(const File& f, int numStreams)
+	{
+		MemoryMappedFile mf(f, MemoryMappedFile::readOnly);
+
+		expect(mf.getData() != nullptr, "Memory mapping failed");
+
+		if (mf.getData() == nullptr)
+			return 0;
+
+		HeapBlock<int16> buffer(STREAM_BUFFER_SIZE * 2);
+
+		int64 checksum = 0;
+
+		for (int i = 0; i < numStreams; i++)
+		{
+			auto source = static_cast<const uint8*>(mf.getData()) + getOffsetForStream(i);
+
+			memcpy(buffer, source, STREAM_BUFFER_SIZE * 2 * sizeof(int16));
+
+			checksum += buffer[0] + buffer[STREAM_BUFFER_SIZE * 2 - 1];
+		}
+
+		return checksum;
+	}
+
+	void testIOBackends(int numStreams)
+	{
+		beginTest("Testing IO backends with " + String(numStreams) + " streams");
+
+		TemporaryFile tempFile;
+		File f = tempFile.getFile();
+
+		createTestFile(f, numStreams);
+
+		evictFromCache(f);
+
+		const double start1 = Time::getMillisecondCounterHiRes();
+		const int64 checksum1 = readStreams(f, numStreams);
+		const double end1 = Time::getMillisecondCounterHiRes();
+
+		AsyncIOBackend backend;
+
+		if (backend.getType() == AsyncIOBackend::Type::Synchronous)
+		{
+			logMessage("io_uring is not available, skipping comparison");
+			return;
+		}
+
+		evictFromCache(f);
+
+		const double start2 = Time::getMillisecondCounterHiRes();
+
+		const int fd = AsyncIOBackend::openFileDescriptor(f);
+
+		for (int i = 0; i < numStreams; i++)
+		{
+			AsyncIOBackend::ReadRequest request;
+
+			request.fileDescriptor = fd;
+			request.offset = getOffsetForStream(i);
+			request.numBytes = STREAM_BUFFER_SIZE * 2 * sizeof(int16);
+
+			expect(backend.addReadRequest(request), "Request queue is full");
+		}
+
+		backend.submitPendingRequests();
+		backend.waitForPendingRequests();
+
+		const int numProcessed = (int)backend.getNumProcessedRequests();
+		const int64 checksum2 = readStreams(f, numStreams);
+		const double end2 = Time::getMillisecondCounterHiRes();
+
+		// A region that is bigger than a single read must be split instead of being truncated
+		AsyncIOBackend::ReadRequest bigRequest;
+
+		bigRequest.fileDescriptor = fd;
+		bigRequest.offset = 1;
+		bigRequest.numBytes = jmin<int64>(f.getSize() - 1, 3 * AsyncIOBackend::MaxBytesPerRead + 1);
+
+		expect(backend.addReadRequest(bigRequest), "Request queue is full");
+
+		const int numBigReads = backend.waitForPendingRequests();
+
+		AsyncIOBackend::closeFileDescriptor(fd);
+
+		expectEquals<int>(numBigReads, (int)((bigRequest.numBytes + AsyncIOBackend::MaxBytesPerRead - 1) / AsyncIOBackend::MaxBytesPerRead), "Big region wasn't split");
+		expectEquals<int>(numProcessed, numStreams, "Not all requests were processed");
+		expectEquals<int64>(checksum1, checksum2, "Data mismatch");
+
+		logMessage("Synchronous backend: " + String(end1 - start1, 2) + "ms");
+		logMessage("io_uring backend: " + String(end2 - start2, 2) + "ms");
+	}
+
+	void testPrefetchRequests(int numStreams)
+	{
+		beginTest("Testing prefetch requests with " + String(numStreams) + " streams");
+
+		TemporaryFile tempFile;
+		File f = tempFile.getFile();
+
+		createTestFile(f, numStreams);
+
+		const int64 checksum1 = readStreams(f, numStreams);
+
+		evictFromCache(f);
+
+		AsyncIOBackend backend(AsyncIOBackend::Type::Synchronous);
+
+		AsyncIOBackend::ReadRequest invalidRequest;
+		expect(!backend.addPrefetchRequest(invalidRequest), "Invalid request was accepted");
+
+		const int fd = AsyncIOBackend::openFileDescriptor(f);
+
+		if (fd < 0)
+		{
+			logMessage("File descriptors are not supported, skipping test");
+			return;
+		}
+
+		for (int i = 0; i < numStreams; i++)
+		{
+			AsyncIOBackend::ReadRequest request;
+
+			request.fileDescriptor = fd;
+			request.offset = getOffsetForStream(i);
+			request.numBytes = STREAM_BUFFER_SIZE * 2 * sizeof(int16);
+
+			expect(backend.addPrefetchRequest(request), "Prefetch queue is full");
+		}
+
+		const int numProcessed = backend.processPrefetchRequests();
+
+		expectEquals<int>(numProcessed, numStreams, "Not all prefetch hints were processed");
+		expectEquals<int64>(backend.getNumPrefetchedRequests(), numStreams);
+		expectEquals<int>(backend.processPrefetchRequests(), 0, "Queue was not drained");
+
+		const double start = Time::getMillisecondCounterHiRes();
+		const int64 checksum2 = readStreams(f, numStreams);
+		const double end = Time::getMillisecondCounterHiRes();
+
+		AsyncIOBackend::closeFileDescriptor(fd);
+
+		expectEquals<int64>(checksum1, checksum2, "Data mismatch");
+
+		logMessage("Reading after prefetch: " + String(end - start, 2) + "ms");
+	}
+
+	void fillBlock(hlac::HiseSampleBuffer& b, int value)
+	{
+		for (int c = 0; c < b.getNumChannels(); c++)
+		{
+			for (int i = 0; i < b.getNumSamples(); i++)
+			{
+				if (b.isFloatingPoint())
+					static_cast<float*>(b.getWritePointer(c, 0))[i] = (float)(value + i);
+				else
+					static_cast<int16*>(b.getWritePointer(c, 0))[i] = (int16)(value + i);
+			}
+		}
+	}
+
+	bool blockHasValue(const hlac::HiseSampleBuffer& b, int value)
+	{
+		for (int c = 0; c < b.getNumChannels(); c++)
+		{
+			for (int i = 0; i < b.getNumSamples(); i++)
+			{
+				const int thisValue = b.isFloatingPoint() ? (int)static_cast<const float*>(b.getReadPointer(c))[i] :
+															(int)static_cast<const int16*>(b.getReadPointer(c))[i];
+
+				if (thisValue != (int16)(value + i))
+					return false;
+			}
+		}
+
+		return true;
+	}
+
+	void testBlockCache(bool isFloat)
+	{
+		beginTest(String("Testing streaming block cache with ") + (isFloat ? "float" : "int16") + " buffers");
+
+		const int numSamples = 512;
+
+		StreamingBlockCache disabledCache(0);
+		StreamingBlockCache cache(16);
+
+		hlac::HiseSampleBuffer source(isFloat, 2, numSamples);
+		hlac::HiseSampleBuffer destination(isFloat, 2, numSamples);
+
+		StreamingBlockCache::Key k;
+		k.soundId = 1;
+		k.position = 1024;
+		k.numSamples = numSamples;
+		k.isFloatingPoint = isFloat;
+
+		fillBlock(source, 12);
+
+		disabledCache.addBlock(k, source);
+		expect(!disabledCache.copyBlock(k, destination), "Disabled cache returned a block");
+
+		expect(!cache.copyBlock(k, destination), "Empty cache returned a block");
+		expectEquals<int64>(cache.getNumMisses(), 1);
+
+		cache.addBlock(k, source);
+
+		expect(cache.copyBlock(k, destination), "Block wasn't found");
+		expect(blockHasValue(destination, 12), "Data mismatch");
+		expectEquals<int64>(cache.getNumHits(), 1);
+
+		auto otherSound = k;
+		otherSound.soundId = 2;
+
+		auto otherPosition = k;
+		otherPosition.position += numSamples;
+
+		auto otherType = k;
+		otherType.isFloatingPoint = !isFloat;
+
+		expect(!cache.copyBlock(otherSound, destination), "Block of other sound was returned");
+		expect(!cache.copyBlock(otherPosition, destination), "Block at other position was returned");
+		expect(!cache.copyBlock(otherType, destination), "Block with other data type was returned");
+
+		// Fill the cache with more blocks than it can hold and check that the most recent ones survive
+		for (int i = 0; i < 64; i++)
+		{
+			auto thisKey = k;
+			thisKey.soundId = 100 + i;
+
+			fillBlock(source, i);
+			cache.addBlock(thisKey, source);
+
+			expect(cache.copyBlock(thisKey, destination), "Newest block was evicted");
+			expect(blockHasValue(destination, i), "Data mismatch after eviction");
+		}
+
+		expect(cache.getMemoryUsage() > 0, "Memory usage is not reported");
+		expect(cache.getMemoryUsage() <= 16 * numSamples * 2 * (int64)(isFloat ? sizeof(float) : sizeof(int16)), "Cache exceeds its size");
+
+		cache.resetStatistics();
+
+		expectEquals<int64>(cache.getNumHits(), 0);
+		expectEquals<int64>(cache.getNumMisses(), 0);
+	}
+
+	void testPreloadCache()
+	{
+		beginTest("Testing preload cache");
+
+		const int preloadSize = 4096;
+
+		TemporaryFile sampleFile(".wav");
+		TemporaryFile cacheFile(".hpc");
+
+		writeNoiseFile(sampleFile.getFile());
+
+		StreamingSamplerSoundPool pool;
+
+		const String fileName = sampleFile.getFile().getFullPathName();
+
+		StreamingSamplerSound::Ptr original = new StreamingSamplerSound(fileName, &pool);
+		original->checkFileReference();
+		original->setPreloadSize(preloadSize, true);
+
+		Array<StreamingSamplerSound*> sounds;
+		sounds.add(original);
+
+		auto result = PreloadCache::write(cacheFile.getFile(), preloadSize, sounds);
+
+		expect(result.wasOk(), result.getErrorMessage());
+		expect(PreloadCache::open(cacheFile.getFile(), preloadSize * 2) == nullptr, "Cache with other preload size was opened");
+
+		auto cache = PreloadCache::open(cacheFile.getFile(), preloadSize);
+
+		expect(cache != nullptr, "Cache can't be opened");
+
+		if (cache == nullptr)
+			return;
+
+		expectEquals(cache->getNumEntries(), 1);
+
+		StreamingSamplerSound::Ptr restored = new StreamingSamplerSound(fileName, &pool);
+		restored->checkFileReference();
+
+		expect(cache->restore(restored, preloadSize), "Preload buffer wasn't restored");
+
+		StreamingSamplerSound::Ptr otherStart = new StreamingSamplerSound(fileName, &pool);
+		otherStart->checkFileReference();
+		otherStart->setSampleStart(1000);
+
+		expect(!cache->restore(otherStart, preloadSize), "Preload buffer of other sample start was restored");
+
+		// The sound must keep the mapped data alive
+		cache = nullptr;
+
+		expect(preloadBuffersAreEqual(original->getPreloadBuffer(), restored->getPreloadBuffer()), "Data mismatch");
+
+		const Time modificationTime = sampleFile.getFile().getLastModificationTime();
+
+		sampleFile.getFile().setLastModificationTime(modificationTime + RelativeTime::hours(1.0));
+
+		expect(PreloadCache::open(cacheFile.getFile(), preloadSize) == nullptr, "Cache of modified file was opened");
+
+		sampleFile.getFile().setLastModificationTime(modificationTime);
+
+		expect(PreloadCache::open(cacheFile.getFile(), preloadSize) != nullptr, "Cache was rejected after restoring the modification time");
+
+		// Change the file size, but keep the modification time
+		{
+			FileOutputStream fos(sampleFile.getFile());
+			fos.writeRepeatedByte(0, 16);
+		}
+
+		sampleFile.getFile().setLastModificationTime(modificationTime);
+
+		expect(PreloadCache::open(cacheFile.getFile(), preloadSize) == nullptr, "Cache of file with other size was opened");
+	}
+
+	void testPreloadBufferSwap(bool useLoop)
+	{
+		beginTest(String("Testing preload buffer swap") + (useLoop ? " with loop" : ""));
+
+		const int smallPreloadSize = 2048;
+		const int fullPreloadSize = 16384;
+
+		TemporaryFile sampleFile(".wav");
+
+		writeNoiseFile(sampleFile.getFile());
+
+		StreamingSamplerSoundPool pool;
+
+		const String fileName = sampleFile.getFile().getFullPathName();
+
+		auto createSound = [&](int preloadSize)
+		{
+			StreamingSamplerSound::Ptr s = new StreamingSamplerSound(fileName, &pool);
+			s->checkFileReference();
+
+			if (useLoop)
+			{
+				s->setLoopEnabled(true);
+				s->setLoopStart(1000);
+				s->setLoopEnd(3000);
+			}
+
+			s->setPreloadSize(preloadSize, true);
+			return s;
+		};
+
+		auto small = createSound(smallPreloadSize);
+		auto full = createSound(fullPreloadSize);
+		auto lazy = createSound(smallPreloadSize);
+
+		auto promoted = lazy->createPreloadBuffer(fullPreloadSize);
+
+		expect(preloadBuffersAreEqual(promoted, full->getPreloadBuffer()), "Promoted buffer mismatch");
+
+		lazy->swapPreloadBuffer(promoted, fullPreloadSize);
+
+		expect(preloadBuffersAreEqual(promoted, small->getPreloadBuffer()), "The old buffer wasn't returned");
+		expect(preloadBuffersAreEqual(lazy->getPreloadBuffer(), full->getPreloadBuffer()), "Swapped buffer mismatch");
+		expectEquals(lazy->getActualPreloadSize(), full->getActualPreloadSize());
+		expect(lazy->isEntireSampleLoaded() == full->isEntireSampleLoaded(), "Wrong streaming state");
+
+		// The smaller buffer is copied from the current preload buffer
+		auto demoted = lazy->createPreloadBuffer(smallPreloadSize);
+
+		expect(preloadBuffersAreEqual(demoted, small->getPreloadBuffer()), "Demoted buffer mismatch");
+
+		lazy->swapPreloadBuffer(demoted, smallPreloadSize);
+
+		expectEquals(lazy->getActualPreloadSize(), small->getActualPreloadSize());
+	}
+
+	void writeNoiseFile(const File& f)
+	{
+		AudioSampleBuffer b(2, 44100);
+
+		for (int c = 0; c < 2; c++)
+			for (int i = 0; i < b.getNumSamples(); i++)
+				b.setSample(c, i, r.nextFloat() * 2.0f - 1.0f);
+
+		WavAudioFormat wav;
+		ScopedPointer<AudioFormatWriter> writer = wav.createWriterFor(new FileOutputStream(f), 44100.0, 2, 16, StringPairArray(), 0);
+
+		writer->writeFromAudioSampleBuffer(b, 0, b.getNumSamples());
+	}
+
+	static bool preloadBuffersAreEqual(const hlac::HiseSampleBuffer& a, const hlac::HiseSampleBuffer& b)
+	{
+		if (a.getNumSamples() != b.getNumSamples() || a.getNumChannels() != b.getNumChannels() || a.getNumSamples() == 0)
+			return false;
+
+		const size_t numBytes = (size_t)a.getNumSamples() * (a.isFloatingPoint() ? sizeof(float) : sizeof(int16));
+
+		for (int c = 0; c < a.getNumChannels(); c++)
+		{
+			if (memcmp(a.getReadPointer(c), b.getReadPointer(c), numBytes) != 0)
+				return false;
+		}
+
+		return true;
+	}
+
+	static int64 getOffsetForStream(int streamIndex)
+	{
+		return 1 + (int64)streamIndex * STREAM_BUFFER_SIZE * 2 * sizeof(int16);
+	}
+
+	enum
+	{
+		STREAM_BUFFER_SIZE = BUFFER_SIZE_FOR_STREAM_BUFFERS
+	};
+
+	Random r;
+};
+
+static StreamingUnitTests streamingUnitTests;
+
+class SamplerInterpolatorTests : public UnitTest
+{
+public:
+
+	typedef SamplerInterpolator::Mode Mode;
+	typedef hlac::SimdKernels::InstructionSet InstructionSet;
+
+	SamplerInterpolatorTests() :
+		UnitTest("Testing sampler interpolation", "Benchmark")
+	{
+
+	}
+
+	void runTest() override
+	{
+		for (int i = 0; i < (int)Mode::numModes; i++)
+		{
+			testKernels<float>((Mode)i);
+			testKernels<int16>((Mode)i);
+		}
+
+		testQuality();
+
+		benchmarkModes();
+	}
+
+private:
+
+	enum
+	{
+		NumPastSamples = SamplerInterpolator::MaxNumPastSamples,
+		BlockSize = 512,
+		NumSourceSamples = BlockSize * 4
+	};
+
+	template <typename SignalType> struct TestData
+	{
+		TestData(Random& r)
+		{
+			// a few more samples for the kernels that read after the last position
+			for (int i = 0; i < NumPastSamples + NumSourceSamples + 16; i++)
+			{
+				left.add(createValue(r));
+				right.add(createValue(r));
+			}
+		}
+
+		static SignalType createValue(Random& r)
+		{
+			return std::is_same<SignalType, float>::value ? (SignalType)(r.nextFloat() * 2.0f - 1.0f) :
+															(SignalType)(r.nextInt(60000) - 30000);
+		}
+
+		/** The data after the samples that are stored in the history. */
+		const SignalType* getLeft() const { return left.begin() + NumPastSamples; }
+		const SignalType* getRight() const { return right.begin() + NumPastSamples; }
+
+		SamplerInterpolator::History createHistory(float gain) const
+		{
+			SamplerInterpolator::History h;
+			h.advance(left.begin(), right.begin(), NumPastSamples, gain);
+			return h;
+		}
+
+		Array<SignalType> left, right;
+	};
+
+	static Array<InstructionSet> getAvailableInstructionSets()
+	{
+		Array<InstructionSet> sets;
+
+		sets.add(InstructionSet::Scalar);
+
+		switch (hlac::SimdKernels::getBestInstructionSet())
+		{
+		// AVX2 uses the SSE4.1 kernels
+		case InstructionSet::AVX2:
+		case InstructionSet::SSE41: sets.add(InstructionSet::SSE41); break;
+		case InstructionSet::Neon:	sets.add(InstructionSet::Neon); break;
+		case InstructionSet::Scalar:
+		case InstructionSet::numInstructionSets:
+		default:					break;
+		}
+
+		return sets;
+	}
+
+	template <typename SignalType> void testKernels(Mode m)
+	{
+		const bool isFloat = std::is_same<SignalType, float>::value;
+
+		beginTest("Testing " + SamplerInterpolator::getModeName(m) + " kernels with " + (isFloat ? "float" : "int16") + " data");
+
+		const float gain = isFloat ? 1.0f : 1.0f / (float)INT16_MAX;
+
+		TestData<SignalType> data(r);
+		const SamplerInterpolator::History history = data.createHistory(gain);
+
+		HeapBlock<float> pitchData(BlockSize);
+
+		// Use exact binary fractions so that every code path ends up with the same read positions
+		for (int i = 0; i < BlockSize; i++)
+			pitchData[i] = 0.25f + (float)r.nextInt(180) / 64.0f;
+
+		const double startIndex = 0.375;
+		const double delta = 1.375;
+
+		// The reference reads the samples before the data directly, so it doesn't need the history
+		HeapBlock<float> positions(BlockSize);
+		AudioSampleBuffer expectedPitched(2, BlockSize);
+		AudioSampleBuffer expectedConstant(2, BlockSize);
+
+		float index = (float)startIndex;
+
+		for (int i = 0; i < BlockSize; i++)
+		{
+			positions[i] = index;
+			index += pitchData[i];
+		}
+
+		SamplerInterpolator::processScalar(m, data.getLeft(), data.getRight(), positions, expectedPitched.getWritePointer(0), expectedPitched.getWritePointer(1), BlockSize, gain);
+
+		for (int i = 0; i < BlockSize; i++)
+			positions[i] = (float)(startIndex + (double)i * delta);
+
+		SamplerInterpolator::processScalar(m, data.getLeft(), data.getRight(), positions, expectedConstant.getWritePointer(0), expectedConstant.getWritePointer(1), BlockSize, gain);
+
+		AudioSampleBuffer output(2, BlockSize);
+
+		for (auto set : getAvailableInstructionSets())
+		{
+			hlac::SimdKernels::setInstructionSet(set);
+
+			const String setName = hlac::SimdKernels::getInstructionSetName(set);
+
+			output.clear();
+			SamplerInterpolator::process(m, data.getLeft(), data.getRight(), history, pitchData, startIndex, 0.0, output.getWritePointer(0), output.getWritePointer(1), BlockSize, gain);
+			expectBuffersAreEqual(expectedPitched, output, setName + ": pitch modulation");
+
+			output.clear();
+			SamplerInterpolator::process(m, data.getLeft(), data.getRight(), history, nullptr, startIndex, delta, output.getWritePointer(0), output.getWritePointer(1), BlockSize, gain);
+			expectBuffersAreEqual(expectedConstant, output, setName + ": constant pitch");
+
+			// Render the same signal in two blocks like the voice does
+			const int numFirst = 200;
+			const double nextStart = startIndex + (double)numFirst * delta;
+			const int numToAdvance = (int)nextStart;
+
+			SamplerInterpolator::History h = history;
+
+			output.clear();
+			SamplerInterpolator::process(m, data.getLeft(), data.getRight(), h, nullptr, startIndex, delta, output.getWritePointer(0), output.getWritePointer(1), numFirst, gain);
+			h.advance(data.getLeft(), data.getRight(), numToAdvance, gain);
+			SamplerInterpolator::process(m, data.getLeft() + numToAdvance, data.getRight() + numToAdvance, h, nullptr, nextStart - (double)numToAdvance, delta, 
+										 output.getWritePointer(0, numFirst), output.getWritePointer(1, numFirst), BlockSize - numFirst, gain);
+
+			expectBuffersAreEqual(expectedConstant, output, setName + ": splitted blocks");
+		}
+
+		hlac::SimdKernels::setInstructionSet(hlac::SimdKernels::getBestInstructionSet());
+	}
+
+	void expectBuffersAreEqual(const AudioSampleBuffer& expected, const AudioSampleBuffer& actual, const String& message)
+	{
+		float maxError = 0.0f;
+
+		for (int c = 0; c < 2; c++)
+		{
+			for (int i = 0; i < expected.getNumSamples(); i++)
+				maxError = jmax<float>(maxError, std::abs(expected.getSample(c, i) - actual.getSample(c, i)));
+		}
+
+		expect(maxError < 0.0001f, message + ": Max error " + String(maxError));
+	}
+
+	void testQuality()
+	{
+		beginTest("Testing interpolation quality");
+
+		const double frequency = 0.07;
+		const double delta = 0.773;
+
+		HeapBlock<float> sine(NumSourceSamples);
+
+		for (int i = 0; i < NumSourceSamples; i++)
+			sine[i] = (float)std::sin(2.0 * double_Pi * frequency * (double)i);
+
+		AudioSampleBuffer output(2, BlockSize);
+
+		float errors[(int)Mode::numModes];
+
+		for (int m = 0; m < (int)Mode::numModes; m++)
+		{
+			SamplerInterpolator::History history;
+
+			// start at a position where the kernels don't need the (silent) history
+			const double startIndex = 10.0;
+
+			SamplerInterpolator::process((Mode)m, sine.getData(), sine.getData(), history, nullptr, startIndex, delta, output.getWritePointer(0), output.getWritePointer(1), BlockSize, 1.0f);
+
+			errors[m] = 0.0f;
+
+			for (int i = 0; i < BlockSize; i++)
+			{
+				const float expected = (float)std::sin(2.0 * double_Pi * frequency * (startIndex + (double)i * delta));
+				errors[m] = jmax<float>(errors[m], std::abs(output.getSample(0, i) - expected));
+			}
+
+			logMessage(SamplerInterpolator::getModeName((Mode)m) + " max error: " + String(errors[m], 6));
+		}
+
+		expect(errors[(int)Mode::CubicHermite] < errors[(int)Mode::Linear], "Cubic interpolation is not better than linear interpolation");
+		expect(errors[(int)Mode::Sinc] < errors[(int)Mode::CubicHermite], "Sinc interpolation is not better than cubic interpolation");
+	}
+
+	void benchmarkModes()
+	{
+		beginTest("Benchmarking interpolation modes");
+
+		const int numVoices = 64;
+		const int numIterations = 100;
+		const double sampleRate = 44100.0;
+
+		TestData<int16> data(r);
+		const SamplerInterpolator::History history = data.createHistory(1.0f / (float)INT16_MAX);
+
+		AudioSampleBuffer output(2, BlockSize);
+
+		for (auto set : getAvailableInstructionSets())
+		{
+			hlac::SimdKernels::setInstructionSet(set);
+
+			for (int m = 0; m < (int)Mode::numModes; m++)
+			{
+				const double start = Time::getMillisecondCounterHiRes();
+
+				for (int i = 0; i < numIterations; i++)
+				{
+					for (int v = 0; v < numVoices; v++)
+					{
+						const double delta = 0.5 + 0.02 * (double)v;
+
+						SamplerInterpolator::process((Mode)m, data.getLeft(), data.getRight(), history, nullptr, 0.25, delta,
+													 output.getWritePointer(0), output.getWritePointer(1), BlockSize, 1.0f / (float)INT16_MAX);
+					}
+				}
+
+				const double end = Time::getMillisecondCounterHiRes();
+
+				const double msPerVoiceBlock = (end - start) / (double)(numIterations * numVoices);
+				const double msPerBlock = 1000.0 * (double)BlockSize / sampleRate;
+
+				logMessage(hlac::SimdKernels::getInstructionSetName(set) + " " + SamplerInterpolator::getModeName((Mode)m) + ": " + 
+						   String(roundToInt(msPerBlock / msPerVoiceBlock)) + " voices per core");
+			}
+		}
+
+		hlac::SimdKernels::setInstructionSet(hlac::SimdKernels::getBestInstructionSet());
+	}
+
+	Random r;
+};
+
+static SamplerInterpolatorTests samplerInterpolatorTests;
+
+#endif
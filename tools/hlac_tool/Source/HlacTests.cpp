@@ -663,6 +663,9 @@ public:
 			testSeeking(1);
 			testSeeking(2);
 		}
+
+		testBlockCache(1);
+		testBlockCache(2);
 	}
 
 	void testHeader()
@@ -957,6 +960,67 @@ public:
 		expectEquals<int>(error, 0, "Seeking");
 	}
 
+	int getNumDifferentSamples(const AudioSampleBuffer& buffer, const AudioSampleBuffer& reference, int startInReference, int numSamples)
+	{
+		int numDifferent = 0;
+
+		for (int c = 0; c < buffer.getNumChannels(); c++)
+		{
+			auto b = buffer.getReadPointer(c);
+			auto r = reference.getReadPointer(c, startInReference);
+
+			for (int i = 0; i < numSamples; i++)
+				numDifferent += (b[i] != r[i]) ? 1 : 0;
+		}
+
+		return numDifferent;
+	}
+
+	void testBlockCache(int numChannels)
+	{
+		beginTest("Test block cache with " + String(numChannels) + " channels");
+
+		Array<AudioSampleBuffer> buffers;
+		buffers.add(createTestBuffer(numChannels, 200000));
+
+		auto mb = writeIntoMemory(buffers);
+		auto reference = readIntoAudioBuffer(mb, true);
+
+		const int length = reference.getNumSamples();
+
+		ScopedPointer<HiseLosslessAudioFormatReader> reader = createReader(mb, true);
+
+		Random r;
+
+		int numErrors = 0;
+
+		for (int i = 0; i < 200; i++)
+		{
+			const int start = r.nextInt(length - 1);
+			const int numSamples = jmin(length - start, 1 + r.nextInt(3 * COMPRESSION_BLOCK_SIZE));
+
+			AudioSampleBuffer b(numChannels, numSamples);
+			reader->read(&b, 0, numSamples, start, true, true);
+
+			numErrors += getNumDifferentSamples(b, reference, start, numSamples);
+		}
+
+		expectEquals<int>(numErrors, 0, "Random access reads");
+
+		numErrors = 0;
+
+		const int chunkSize = 333;
+		AudioSampleBuffer chunk(numChannels, chunkSize);
+
+		for (int start = 0; start + chunkSize <= length; start += chunkSize)
+		{
+			reader->read(&chunk, 0, chunkSize, start, true, true);
+			numErrors += getNumDifferentSamples(chunk, reference, start, chunkSize);
+		}
+
+		expectEquals<int>(numErrors, 0, "Sequential reads with odd chunk size");
+	}
+
 	void testFlacReadPerformance(int numChannels, int length)
 	{
 		FlacAudioFormat flac;
@@ -1619,3 +1683,273 @@ public:
 };
 
 static FormatTest formatTest;
+
+#if HLAC_INCLUDE_TEST_SUITE
+
+SimdKernelTest::SimdKernelTest() :
+	UnitTest("Testing HLAC SIMD kernels", "Benchmark")
+{
+
+}
+
+void SimdKernelTest::runTest()
+{
+	for (auto s : getSupportedInstructionSets())
+		logMessage("Supported instruction set: " + SimdKernels::getInstructionSetName(s));
+
+	ScopedPointer<BitCompressors::Base> compressor;
+
+	testUnpacking(compressor = new BitCompressors::OneBit());
+	testUnpacking(compressor = new BitCompressors::TwoBit());
+	testUnpacking(compressor = new BitCompressors::FourBit());
+	testUnpacking(compressor = new BitCompressors::SixBit());
+	testUnpacking(compressor = new BitCompressors::EightBit());
+	testUnpacking(compressor = new BitCompressors::TenBit());
+	testUnpacking(compressor = new BitCompressors::TwelveBit());
+	testUnpacking(compressor = new BitCompressors::FourteenBit());
+
+	testConversion();
+
+	SimdKernels::setInstructionSet(SimdKernels::getBestInstructionSet());
+}
+
+void SimdKernelTest::testUnpacking(BitCompressors::Base* compressor)
+{
+	const int bitRate = compressor->getAllowedBitRange();
+
+	beginTest("Testing unpacking with bit rate " + String(bitRate));
+
+	Random r;
+
+	// Use an odd size so that the scalar tail is tested too
+	const int numValues = COMPRESSION_BLOCK_SIZE + r.nextInt(Range<int>(1, 8));
+	const int numIterations = 2000;
+
+	const Range<int> valueRange = bitRate == 1 ? Range<int>(0, 2) : Range<int>(-(1 << (bitRate - 1)) + 1, 1 << (bitRate - 1));
+
+	HeapBlock<int16> uncompressedData(numValues);
+	HeapBlock<int16> decompressedData(numValues);
+	HeapBlock<uint8> compressedData(compressor->getByteAmount(numValues));
+
+	for (int i = 0; i < numValues; i++)
+		uncompressedData[i] = (int16)r.nextInt(valueRange);
+
+	compressor->compress(compressedData, uncompressedData, numValues);
+
+	double scalarTime = 0.0;
+
+	for (auto s : getSupportedInstructionSets())
+	{
+		SimdKernels::setInstructionSet(s);
+
+		decompressedData.clear(numValues);
+		compressor->decompress(decompressedData, compressedData, numValues);
+
+		for (int i = 0; i < numValues; i++)
+		{
+			if (decompressedData[i] != uncompressedData[i])
+			{
+				expectEquals<int16>(decompressedData[i], uncompressedData[i], SimdKernels::getInstructionSetName(s) + ": Sample mismatch at position " + String(i));
+				break;
+			}
+		}
+
+		const double start = Time::getMillisecondCounterHiRes();
+
+		for (int i = 0; i < numIterations; i++)
+			compressor->decompress(decompressedData, compressedData, numValues);
+
+		const double delta = Time::getMillisecondCounterHiRes() - start;
+
+		if (s == SimdKernels::InstructionSet::Scalar)
+			scalarTime = delta;
+
+		logMessage(String(bitRate) + " bit, " + SimdKernels::getInstructionSetName(s) + ": " + 
+				   getSpeedString(numValues * sizeof(int16), numIterations, delta) + 
+				   ", speedup: " + String(scalarTime / jmax(delta, 0.001), 2) + "x");
+	}
+}
+
+void SimdKernelTest::testConversion()
+{
+	beginTest("Testing int16 conversion");
+
+	Random r;
+
+	const int numSamples = COMPRESSION_BLOCK_SIZE + 5;
+	const int numIterations = 2000;
+
+	HeapBlock<int16> source(numSamples);
+	HeapBlock<int16> expectedSum(numSamples);
+	HeapBlock<int16> sum(numSamples);
+	HeapBlock<float> expectedFloat(numSamples);
+	HeapBlock<float> convertedFloat(numSamples);
+
+	for (int i = 0; i < numSamples; i++)
+	{
+		source[i] = (int16)r.nextInt(Range<int>(INT16_MIN, INT16_MAX + 1));
+		expectedSum[i] = (int16)(source[i] + source[i]);
+	}
+
+	AudioDataConverters::convertInt16LEToFloat(source, expectedFloat, numSamples);
+
+	for (auto s : getSupportedInstructionSets())
+	{
+		SimdKernels::setInstructionSet(s);
+
+		const String name = SimdKernels::getInstructionSetName(s);
+
+		CompressionHelpers::fastInt16ToFloat(source, convertedFloat, numSamples);
+
+		expect(memcmp(convertedFloat, expectedFloat, sizeof(float) * numSamples) == 0, name + ": float conversion mismatch");
+
+		memcpy(sum, source, sizeof(int16) * numSamples);
+		CompressionHelpers::IntVectorOperations::add(sum, source, numSamples);
+
+		expect(memcmp(sum, expectedSum, sizeof(int16) * numSamples) == 0, name + ": add mismatch");
+
+		double start = Time::getMillisecondCounterHiRes();
+
+		for (int i = 0; i < numIterations; i++)
+			CompressionHelpers::fastInt16ToFloat(source, convertedFloat, numSamples);
+
+		logMessage("fastInt16ToFloat, " + name + ": " + getSpeedString(numSamples * sizeof(int16), numIterations, Time::getMillisecondCounterHiRes() - start));
+
+		start = Time::getMillisecondCounterHiRes();
+
+		for (int i = 0; i < numIterations; i++)
+			CompressionHelpers::IntVectorOperations::add(sum, source, numSamples);
+
+		logMessage("IntVectorOperations::add, " + name + ": " + getSpeedString(numSamples * sizeof(int16), numIterations, Time::getMillisecondCounterHiRes() - start));
+	}
+}
+
+Array<SimdKernels::InstructionSet> SimdKernelTest::getSupportedInstructionSets()
+{
+	Array<SimdKernels::InstructionSet> sets;
+
+	for (int i = 0; i < (int)SimdKernels::InstructionSet::numInstructionSets; i++)
+	{
+		auto s = (SimdKernels::InstructionSet)i;
+
+		SimdKernels::setInstructionSet(s);
+
+		if (SimdKernels::getInstructionSet() == s)
+			sets.add(s);
+	}
+
+	SimdKernels::setInstructionSet(SimdKernels::getBestInstructionSet());
+
+	return sets;
+}
+
+String SimdKernelTest::getSpeedString(int numBytes, int numIterations, double milliSeconds)
+{
+	const double megaBytes = (double)numBytes * (double)numIterations / (1024.0 * 1024.0);
+
+	return String(megaBytes / jmax(milliSeconds * 0.001, 0.000001), 1) + " MB/s";
+}
+
+static SimdKernelTest simdKernelTest;
+
+#endif
+
+#if HLAC_INCLUDE_TEST_SUITE
+
+ParallelEncoderTest::ParallelEncoderTest() :
+	UnitTest("Testing HLAC parallel encoder", "Benchmark")
+{
+
+}
+
+void ParallelEncoderTest::runTest()
+{
+	testPreset(HlacEncoder::CompressorOptions::Presets::Diff, "Diff");
+	testPreset(HlacEncoder::CompressorOptions::Presets::Delta, "Delta");
+	testPreset(HlacEncoder::CompressorOptions::Presets::WholeBlock, "Whole block");
+}
+
+void ParallelEncoderTest::testPreset(HlacEncoder::CompressorOptions::Presets preset, const String& name)
+{
+	beginTest("Testing parallel encoding with preset " + name);
+
+	// 10 seconds of stereo audio with a partial last block
+	auto source = CodecTest::createTestSignal(441000, 2, CodecTest::SignalType::DecayingSineWithHarmonic, 0.9f);
+
+	const int numCpus = SystemStats::getNumCpus();
+
+	logMessage(String(numCpus) + " CPU cores");
+
+	if (numCpus == 1)
+		logMessage("The speedup can't be measured on a single core, only the output will be checked");
+
+	MemoryBlock serialOutput;
+	Array<uint32> serialOffsets;
+
+	const double serialTime = encodeBestOf(preset, source, nullptr, serialOutput, serialOffsets);
+
+	logMessage("1 thread: " + String(serialTime, 1) + " ms");
+
+	// Always test a few thread counts so that the output is checked on machines with less cores
+	for (int numThreads = 2; numThreads <= jmax<int>(4, numCpus); numThreads *= 2)
+	{
+		ThreadPool pool(numThreads - 1);
+
+		MemoryBlock parallelOutput;
+		Array<uint32> parallelOffsets;
+
+		const double parallelTime = encodeBestOf(preset, source, &pool, parallelOutput, parallelOffsets);
+
+		expect(parallelOutput == serialOutput, String(numThreads) + " threads: encoded data mismatch");
+		expect(parallelOffsets == serialOffsets, String(numThreads) + " threads: block offset mismatch");
+
+		if (numThreads > numCpus)
+		{
+			logMessage(String(numThreads) + " threads: " + String(parallelTime, 1) + " ms (more threads than cores, no speedup expected)");
+			continue;
+		}
+
+		const double speedup = serialTime / jmax(parallelTime, 0.001);
+
+		logMessage(String(numThreads) + " threads: " + String(parallelTime, 1) + " ms, speedup: " + 
+				   String(speedup, 2) + "x (" + String(speedup / (double)numThreads, 2) + "x per core)");
+	}
+}
+
+double ParallelEncoderTest::encodeBestOf(HlacEncoder::CompressorOptions::Presets preset, AudioSampleBuffer& source, ThreadPool* pool, MemoryBlock& output, Array<uint32>& blockOffsets)
+{
+	double bestTime = encode(preset, source, pool, output, blockOffsets);
+
+	for (int i = 1; i < NumRuns; i++)
+	{
+		MemoryBlock unusedOutput;
+		Array<uint32> unusedOffsets;
+
+		bestTime = jmin(bestTime, encode(preset, source, pool, unusedOutput, unusedOffsets));
+	}
+
+	return bestTime;
+}
+
+double ParallelEncoderTest::encode(HlacEncoder::CompressorOptions::Presets preset, AudioSampleBuffer& source, ThreadPool* pool, MemoryBlock& output, Array<uint32>& blockOffsets)
+{
+	auto options = HlacEncoder::CompressorOptions::getPreset(preset);
+
+	HlacEncoder encoder;
+	encoder.setOptions(options);
+	encoder.setThreadPool(pool);
+
+	blockOffsets.insertMultiple(0, 0, source.getNumSamples() / COMPRESSION_BLOCK_SIZE + 1);
+
+	MemoryOutputStream mos(output, false);
+
+	const double start = Time::getMillisecondCounterHiRes();
+
+	encoder.compress(source, mos, blockOffsets.getRawDataPointer());
+
+	return Time::getMillisecondCounterHiRes() - start;
+}
+
+static ParallelEncoderTest parallelEncoderTest;
+
+#endif
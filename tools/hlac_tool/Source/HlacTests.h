@@ -92,6 +92,45 @@ struct CodecTest : public UnitTest
 
 };
 
+/** Checks the SIMD kernels against the scalar code and measures the decoding speed of every instruction set.
+*
+*	Run it with the 'benchmark' mode of the hlac tool.
+*/
+struct SimdKernelTest : public UnitTest
+{
+	SimdKernelTest();
+
+	void runTest() override;
+
+	void testUnpacking(BitCompressors::Base* compressor);
+
+	void testConversion();
+
+	static Array<SimdKernels::InstructionSet> getSupportedInstructionSets();
+
+	static String getSpeedString(int numBytes, int numIterations, double milliSeconds);
+};
+
+/** Checks that the multithreaded encoder creates the same output as the single threaded one and measures the speedup. */
+struct ParallelEncoderTest : public UnitTest
+{
+	ParallelEncoderTest();
+
+	void runTest() override;
+
+	void testPreset(HlacEncoder::CompressorOptions::Presets preset, const String& name);
+
+	static double encode(HlacEncoder::CompressorOptions::Presets preset, AudioSampleBuffer& source, ThreadPool* pool, MemoryBlock& output, Array<uint32>& blockOffsets);
+
+	/** Encodes the source NumRuns times and returns the fastest time. The output of the first run is stored. */
+	static double encodeBestOf(HlacEncoder::CompressorOptions::Presets preset, AudioSampleBuffer& source, ThreadPool* pool, MemoryBlock& output, Array<uint32>& blockOffsets);
+
+	enum
+	{
+		NumRuns = 3
+	};
+};
+
 
 #endif
 
@@ -37,7 +37,7 @@ void printHelp()
 	Logger::writeToLog("Usage: hlac_tool [MODE] [INPUT] [OUTPUT]");
 	Logger::writeToLog("");
 	Logger::writeToLog("modes: 'encode' / 'decode'");
-	Logger::writeToLog("test-modes: 'unit_test' / 'test_directory', 'memory_map_directory'");
+	Logger::writeToLog("test-modes: 'unit_test' / 'benchmark' / 'test_directory', 'memory_map_directory'");
 	Logger::writeToLog("(put '_' before filename to skip samples)");
 	Logger::setCurrentLogger(nullptr);
 }
@@ -215,11 +215,15 @@ int main(int argc, char **argv)
 
 	}
 
-	if (mode == "unit_test")
+	if (mode == "unit_test" || mode == "benchmark")
 	{
 		UnitTestRunner runner;
 		runner.setAssertOnFailure(false);
-		runner.runAllTests();
+
+		if (mode == "benchmark")
+			runner.runTestsInCategory("Benchmark");
+		else
+			runner.runAllTests();
 
 		int numTests = runner.getNumResults();
 		int numFails = 0;